@@ -0,0 +1,72 @@
+// Counting replacements of the global operator new and delete for
+// AllocationProfile (allocation_stats.h). Linked into the benchmarks only,
+// not into cbc_utils: a replacement applies to the whole program, the CBC
+// libraries included, and costs a few atomic adds per allocation.
+
+#include "allocation_stats.h"
+
+#ifdef __GLIBC__
+
+#include <malloc.h>
+
+#include <cstdlib>
+#include <new>
+
+static const bool kCountingEnabled = (enableAllocationCounting(), true);
+
+static void* allocate(std::size_t size, std::size_t alignment, bool nothrow)
+{
+    void* p = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        p = std::malloc(size ? size : 1);
+    } else if (posix_memalign(&p, alignment, size ? size : 1) != 0) {
+        p = nullptr;
+    }
+    if (!p) {
+        if (nothrow)
+            return nullptr;
+        throw std::bad_alloc();
+    }
+    recordAllocation(malloc_usable_size(p));
+    return p;
+}
+
+static void release(void* p) noexcept
+{
+    if (!p)
+        return;
+    recordFree(malloc_usable_size(p));
+    std::free(p);
+}
+
+static const std::size_t kDefault = 0;
+
+void* operator new(std::size_t size) { return allocate(size, kDefault, false); }
+void* operator new[](std::size_t size) { return allocate(size, kDefault, false); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, kDefault, true); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size, kDefault, true); }
+void* operator new(std::size_t size, std::align_val_t al) { return allocate(size, static_cast<std::size_t>(al), false); }
+void* operator new[](std::size_t size, std::align_val_t al) { return allocate(size, static_cast<std::size_t>(al), false); }
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept
+{
+    return allocate(size, static_cast<std::size_t>(al), true);
+}
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept
+{
+    return allocate(size, static_cast<std::size_t>(al), true);
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t) noexcept { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { release(p); }
+
+#endif
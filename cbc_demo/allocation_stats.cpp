@@ -0,0 +1,158 @@
+#include "allocation_stats.h"
+#include "util.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+
+// Constant-initialized, so the counting operators can use them before any
+// dynamic initialization runs.
+static std::atomic<bool> countingEnabled{false};
+static std::atomic<std::uint64_t> allocationCount{0};
+static std::atomic<std::uint64_t> allocatedBytes{0};
+static std::atomic<std::int64_t> liveBytes{0};
+static std::atomic<std::int64_t> peakLiveBytes{0};
+
+bool allocationCountingEnabled()
+{
+    return countingEnabled.load(std::memory_order_relaxed);
+}
+
+void enableAllocationCounting()
+{
+    countingEnabled.store(true, std::memory_order_relaxed);
+}
+
+void recordAllocation(std::size_t bytes)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    std::int64_t live = liveBytes.fetch_add(static_cast<std::int64_t>(bytes), std::memory_order_relaxed) +
+        static_cast<std::int64_t>(bytes);
+    std::int64_t peak = peakLiveBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void recordFree(std::size_t bytes)
+{
+    liveBytes.fetch_sub(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+}
+
+AllocationCounters allocationCounters()
+{
+    AllocationCounters counters;
+    counters.allocations = allocationCount.load(std::memory_order_relaxed);
+    counters.bytes = allocatedBytes.load(std::memory_order_relaxed);
+    counters.liveBytes = liveBytes.load(std::memory_order_relaxed);
+    counters.peakLiveBytes = peakLiveBytes.load(std::memory_order_relaxed);
+    return counters;
+}
+
+void resetAllocationPeak()
+{
+    peakLiveBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+// Value of a "Key:   1234 kB" line of /proc/self/status, in bytes.
+static std::size_t statusBytes(const char* key)
+{
+    std::FILE* file = std::fopen("/proc/self/status", "r");
+    if (!file)
+        return 0;
+    char line[256];
+    std::size_t keyLength = std::strlen(key);
+    std::size_t bytes = 0;
+    while (std::fgets(line, sizeof(line), file)) {
+        if (std::strncmp(line, key, keyLength) == 0 && line[keyLength] == ':') {
+            unsigned long long kb = 0;
+            if (std::sscanf(line + keyLength + 1, "%llu", &kb) == 1)
+                bytes = static_cast<std::size_t>(kb) * 1024;
+            break;
+        }
+    }
+    std::fclose(file);
+    return bytes;
+}
+
+std::size_t currentRssBytes()
+{
+    return statusBytes("VmRSS");
+}
+
+std::size_t peakRssBytes()
+{
+    return statusBytes("VmHWM");
+}
+
+bool resetPeakRss()
+{
+    // "5" resets the peak RSS of the process (Linux 4.0 and later)
+    std::FILE* file = std::fopen("/proc/self/clear_refs", "w");
+    if (!file)
+        return false;
+    bool ok = std::fputs("5", file) >= 0;
+    return std::fclose(file) == 0 && ok;
+}
+
+AllocationProfile::Stage::Stage(AllocationProfile& profile, std::string name)
+    : profile_(&profile)
+{
+    stats_.name = std::move(name);
+    resetPeakRss();
+    resetAllocationPeak();
+    start_ = allocationCounters();
+    started_ = std::chrono::steady_clock::now();
+}
+
+AllocationProfile::Stage::~Stage()
+{
+    if (!finished_)
+        finish();
+}
+
+const StageAllocations& AllocationProfile::Stage::finish()
+{
+    if (finished_)
+        return stats_;
+    finished_ = true;
+    stats_.seconds = secondsSince(started_);
+    AllocationCounters end = allocationCounters();
+    stats_.allocations = end.allocations - start_.allocations;
+    stats_.bytes = end.bytes - start_.bytes;
+    stats_.retainedBytes = end.liveBytes - start_.liveBytes;
+    stats_.peakHeapBytes = end.peakLiveBytes - start_.liveBytes;
+    stats_.peakRssBytes = peakRssBytes();
+    profile_->stages_.push_back(stats_);
+    return stats_;
+}
+
+const StageAllocations* AllocationProfile::find(const std::string& name) const
+{
+    for (const StageAllocations& stage : stages_)
+        if (stage.name == name)
+            return &stage;
+    return nullptr;
+}
+
+void AllocationProfile::print(std::ostream& out) const
+{
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-12s %9s %12s %12s %12s %12s %10s\n", "stage", "time(s)", "allocations",
+        "alloc(MB)", "kept(MB)", "peak(MB)", "rss(MB)");
+    out << line;
+    bool counted = allocationCountingEnabled();
+    for (const StageAllocations& stage : stages_) {
+        if (counted) {
+            std::snprintf(line, sizeof(line), "%-12s %9.3f %12llu %12.1f %12.1f %12.1f %10.1f\n",
+                stage.name.c_str(), stage.seconds, static_cast<unsigned long long>(stage.allocations),
+                stage.bytes / 1048576.0, stage.retainedBytes / 1048576.0, stage.peakHeapBytes / 1048576.0,
+                stage.peakRssBytes / 1048576.0);
+        } else {
+            std::snprintf(line, sizeof(line), "%-12s %9.3f %12s %12s %12s %12s %10.1f\n", stage.name.c_str(),
+                stage.seconds, "-", "-", "-", "-", stage.peakRssBytes / 1048576.0);
+        }
+        out << line;
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Totals of every operator new and delete of the process, kept by the
+// counting operators of allocation_hooks.cpp. Programs not linked with them
+// read zeros; see allocationCountingEnabled().
+struct AllocationCounters
+{
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;        // allocated so far, usable size of each block
+    std::int64_t liveBytes = 0;     // allocated and not freed yet
+    std::int64_t peakLiveBytes = 0; // highest liveBytes since resetAllocationPeak()
+};
+
+bool allocationCountingEnabled();
+AllocationCounters allocationCounters();
+void resetAllocationPeak();
+
+// Called by the counting operators only.
+void enableAllocationCounting();
+void recordAllocation(std::size_t bytes);
+void recordFree(std::size_t bytes);
+
+// Resident set size of the process (VmRSS and VmHWM of /proc/self/status),
+// 0 where it cannot be read. resetPeakRss() restarts the peak at the current
+// RSS through /proc/self/clear_refs and returns false where that fails, in
+// which case the peak stays the one since process start.
+std::size_t currentRssBytes();
+std::size_t peakRssBytes();
+bool resetPeakRss();
+
+struct StageAllocations
+{
+    std::string name;
+    double seconds = 0.0;
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes = 0;
+    std::int64_t retainedBytes = 0; // live at the end minus live at the start
+    std::int64_t peakHeapBytes = 0; // highest live bytes above those at the start
+    std::size_t peakRssBytes = 0;
+};
+
+/*
+  Allocation accounting per stage of a pipeline, e.g. read, build, extract
+  and solve setup: how many allocations each stage made, how many bytes,
+  how much heap it kept and its peak heap and RSS.
+
+    AllocationProfile profile;
+    {
+        AllocationProfile::Stage stage(profile, "read");
+        readModelFile(path, data);
+    }
+    {
+        AllocationProfile::Stage stage(profile, "build");
+        loadProblemData(data, solver);
+    }
+    profile.print(std::cout);
+
+  The counts need allocation_hooks.cpp linked into the program (the
+  benchmarks are); without it only the times and the RSS are filled in.
+  Stages must not nest, each one restarts the peaks.
+*/
+class AllocationProfile
+{
+public:
+    class Stage
+    {
+    public:
+        Stage(AllocationProfile& profile, std::string name);
+        ~Stage();
+        Stage(const Stage&) = delete;
+        Stage& operator=(const Stage&) = delete;
+
+        // Ends the stage early and returns its numbers; the destructor then does nothing.
+        const StageAllocations& finish();
+
+    private:
+        AllocationProfile* profile_;
+        StageAllocations stats_;
+        AllocationCounters start_;
+        std::chrono::steady_clock::time_point started_;
+        bool finished_ = false;
+    };
+
+    const std::vector<StageAllocations>& stages() const { return stages_; }
+    const StageAllocations* find(const std::string& name) const;
+    void clear() { stages_.clear(); }
+
+    // One line per stage: time, allocations, MB allocated, retained and peak heap, peak RSS.
+    void print(std::ostream& out) const;
+
+private:
+    std::vector<StageAllocations> stages_;
+};
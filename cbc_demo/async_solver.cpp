@@ -0,0 +1,370 @@
+#include "async_solver.h"
+#include "problem_instance.h"
+#include "util.h"
+
+#include "CbcEventHandler.hpp"
+#include "CbcModel.hpp"
+#include "ClpEventHandler.hpp"
+#include "CoinFinite.hpp"
+#include "OsiClpSolverInterface.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+
+using Clock = std::chrono::steady_clock;
+
+static const std::int64_t kNoDeadline = std::numeric_limits<std::int64_t>::max();
+static const int kPruneEvery = 64; // submissions between sweeps of the finished states
+
+static std::int64_t ticksOf(Clock::time_point time)
+{
+    return time.time_since_epoch().count();
+}
+
+static std::int64_t deadlineAfter(double seconds)
+{
+    if (seconds <= 0.0)
+        return kNoDeadline;
+    return ticksOf(Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)));
+}
+
+static double secondsBetween(std::int64_t from, std::int64_t to)
+{
+    return std::chrono::duration<double>(Clock::duration(to - from)).count();
+}
+
+struct AsyncSolveState
+{
+    int id = -1;
+    SolveOptions options;
+    std::shared_ptr<const ProblemInstance> instance;
+    std::unique_ptr<OsiSolverInterface> solver; // the clone, when submitted as a solver
+    Clock::time_point submitted;
+
+    std::atomic<bool> cancelled{false};
+    std::atomic<bool> finished{false};
+    std::atomic<std::int64_t> deadline{kNoDeadline}; // steady clock ticks
+    std::atomic<bool> deadlineHit{false};
+    std::atomic<bool> lpStopped{false}; // a simplex was cut short, see AsyncClpHandler
+    std::atomic<bool> lpArmed{true};    // AsyncClpHandler may stop a simplex
+
+    mutable std::mutex mutex; // progress and result
+    mutable std::condition_variable done;
+    SolveProgress progress;
+    BatchResult result;
+};
+
+/*
+  Runs inside the solve: stops it on cancel() or at the deadline, keeps
+  CBC's own time limit on the current deadline (so the root node, which
+  fires few events, stops in time too), and takes the progress snapshots.
+*/
+class AsyncEventHandler : public CbcEventHandler
+{
+public:
+    AsyncEventHandler(CbcModel* model, AsyncSolveState* state, Clock::time_point solveStart)
+        : CbcEventHandler(model), state_(state), solveStart_(solveStart)
+    {
+        interval_ = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(std::max(0.0, state->options.progressInterval)));
+    }
+
+    CbcAction event(CbcEvent whichEvent) override
+    {
+        Clock::time_point now = Clock::now();
+        // once CBC is winding down, its final LPs must run to keep the incumbent
+        if (whichEvent == endSearch) {
+            state_->lpArmed = false;
+            publish(now);
+            return noAction;
+        }
+        if (state_->cancelled.load(std::memory_order_relaxed)) {
+            state_->lpArmed = false;
+            return stop;
+        }
+        std::int64_t deadline = state_->deadline.load(std::memory_order_relaxed);
+        if (ticksOf(now) >= deadline) {
+            state_->deadlineHit = true;
+            state_->lpArmed = false;
+            return stop;
+        }
+        if (deadline != timeLimitFor_) {
+            timeLimitFor_ = deadline;
+            model_->setMaximumSeconds(deadline == kNoDeadline
+                    ? COIN_DBL_MAX
+                    : model_->getCurrentSeconds() + secondsBetween(ticksOf(now), deadline));
+        }
+        if (!state_->lpStopped)
+            boundBeforeStop_ = model_->getBestPossibleObjValue();
+        if (whichEvent == solution || whichEvent == heuristicSolution || now - lastPublished_ >= interval_)
+            publish(now);
+        return noAction;
+    }
+
+    CbcEventHandler* clone() const override { return new AsyncEventHandler(*this); }
+
+    // The deadline the CbcModel time limit was set from before the solve.
+    void setTimeLimitFor(std::int64_t deadline) { timeLimitFor_ = deadline; }
+    // The bound at the last event before AsyncClpHandler stopped a simplex.
+    double boundBeforeStop() const { return boundBeforeStop_; }
+
+private:
+    void publish(Clock::time_point now)
+    {
+        lastPublished_ = now;
+        SolveProgress progress;
+        progress.seconds = std::chrono::duration<double>(now - solveStart_).count();
+        progress.hasIncumbent = model_->bestSolution() != nullptr && model_->getObjValue() < 1e50;
+        progress.bestBound = state_->lpStopped ? boundBeforeStop_ : model_->getBestPossibleObjValue();
+        if (progress.hasIncumbent) {
+            progress.incumbent = model_->getObjValue();
+            progress.gap = std::fabs(progress.incumbent - progress.bestBound)
+                / std::max(1e-10, std::fabs(progress.incumbent));
+        }
+        progress.nodes = model_->getNodeCount();
+        progress.iterations = model_->getIterationCount();
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            progress.updates = state_->progress.updates + 1;
+            state_->progress = progress;
+        }
+        if (state_->options.onProgress)
+            state_->options.onProgress(progress);
+    }
+
+    AsyncSolveState* state_;
+    Clock::time_point solveStart_;
+    Clock::duration interval_;
+    Clock::time_point lastPublished_;
+    std::int64_t timeLimitFor_ = kNoDeadline;
+    double boundBeforeStop_ = -COIN_DBL_MAX;
+};
+
+/*
+  Stops the simplex on cancel() or at the deadline. A long LP, like the root
+  of a large model, runs without CBC events, so cancel() would otherwise wait
+  for it. CBC may take the cut short LP for an infeasible node, so after such
+  a stop the solve reports neither optimality nor infeasibility, and only the
+  bound from before the stop. Once AsyncEventHandler has stopped the search
+  or seen it end, CBC acts on the deadline itself and the handler stands
+  down, so the LPs that finish the incumbent run.
+*/
+class AsyncClpHandler : public ClpEventHandler
+{
+public:
+    explicit AsyncClpHandler(AsyncSolveState* state) : state_(state) {}
+
+    int event(Event whichEvent) override
+    {
+        if (whichEvent != endOfIteration || !state_->lpArmed.load(std::memory_order_relaxed))
+            return -1;
+        bool cancelled = state_->cancelled.load(std::memory_order_relaxed);
+        if (!cancelled && ticksOf(Clock::now()) < state_->deadline.load(std::memory_order_relaxed))
+            return -1;
+        if (!cancelled)
+            state_->deadlineHit = true;
+        state_->lpStopped = true;
+        return 0; // ends the simplex with status 5, stopped by event
+    }
+
+    ClpEventHandler* clone() const override { return new AsyncClpHandler(*this); }
+
+private:
+    AsyncSolveState* state_;
+};
+
+static void runSolve(AsyncSolveState& state)
+{
+    BatchResult& result = state.result;
+    Clock::time_point start = Clock::now();
+    result.waitSeconds = std::chrono::duration<double>(start - state.submitted).count();
+    result.threads = std::max(1, state.options.threads);
+    if (state.cancelled) {
+        result.status = BatchStatus::Cancelled;
+        return;
+    }
+
+    std::unique_ptr<OsiSolverInterface> solver;
+    if (state.instance) {
+        auto clp = std::make_unique<OsiClpSolverInterface>();
+        clp->messageHandler()->setLogLevel(0);
+        loadProblemData(*state.instance, *clp, false);
+        solver = std::move(clp);
+        state.instance.reset();
+    } else {
+        solver = std::move(state.solver);
+        solver->messageHandler()->setLogLevel(0);
+    }
+    result.loadSeconds = secondsSince(start);
+
+    std::int64_t deadline = state.deadline.load();
+    if (ticksOf(Clock::now()) >= deadline) {
+        result.status = BatchStatus::Stopped;
+        result.message = "deadline";
+        return;
+    }
+
+    CbcModel model(*solver);
+    solver.reset();
+    model.setLogLevel(0);
+    model.setUseElapsedTime(true);
+    if (deadline != kNoDeadline)
+        model.setMaximumSeconds(secondsBetween(ticksOf(Clock::now()), deadline));
+    // CBC runs serial code for 0 threads, 1 would still start the thread machinery
+    model.setNumberThreads(result.threads > 1 ? result.threads : 0);
+
+    Clock::time_point solveStart = Clock::now();
+    AsyncEventHandler handler(&model, &state, solveStart);
+    handler.setTimeLimitFor(deadline);
+    model.passInEventHandler(&handler);
+    AsyncClpHandler clpHandler(&state);
+    if (auto* clp = dynamic_cast<OsiClpSolverInterface*>(model.solver()))
+        clp->getModelPtr()->passInEventHandler(&clpHandler);
+    model.branchAndBound();
+    result.solveSeconds = secondsSince(solveStart);
+
+    collectBatchResult(model, state.cancelled, state.options.keepSolution, result);
+    if (state.lpStopped) {
+        result.status = state.cancelled ? BatchStatus::Cancelled : BatchStatus::Stopped;
+        result.message.clear();
+        const auto* used = dynamic_cast<const AsyncEventHandler*>(model.getEventHandler());
+        double bound = used ? used->boundBeforeStop() : -COIN_DBL_MAX;
+        // no CBC event before the stop means no bound at all
+        result.bestBound = bound == -COIN_DBL_MAX ? -COIN_DBL_MAX * model.getObjSense() : bound;
+        if (result.hasSolution)
+            result.gap = std::fabs(result.bestBound) >= 1e50 ? COIN_DBL_MAX
+                : std::fabs(result.objValue - result.bestBound) / std::max(1e-10, std::fabs(result.objValue));
+    }
+    // CBC's time limit only ever runs on the current deadline
+    bool timeLimit = model.secondaryStatus() == 4 && state.deadline.load() != kNoDeadline;
+    if (result.status == BatchStatus::Stopped && (state.deadlineHit || timeLimit))
+        result.message = "deadline";
+}
+
+int SolveHandle::id() const
+{
+    return state_->id;
+}
+
+bool SolveHandle::ready() const
+{
+    return state_->finished.load();
+}
+
+void SolveHandle::wait() const
+{
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->done.wait(lock, [this]() { return state_->finished.load(); });
+}
+
+bool SolveHandle::waitFor(double seconds) const
+{
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    return state_->done.wait_for(lock, std::chrono::duration<double>(std::max(0.0, seconds)),
+        [this]() { return state_->finished.load(); });
+}
+
+const BatchResult& SolveHandle::get() const
+{
+    wait();
+    return state_->result;
+}
+
+SolveProgress SolveHandle::progress() const
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->progress;
+}
+
+bool SolveHandle::cancel()
+{
+    if (state_->finished)
+        return false;
+    state_->cancelled = true;
+    return true;
+}
+
+bool SolveHandle::setDeadline(double secondsFromNow)
+{
+    if (state_->finished)
+        return false;
+    state_->deadline = deadlineAfter(secondsFromNow);
+    return true;
+}
+
+bool SolveHandle::extendDeadline(double seconds)
+{
+    if (state_->finished)
+        return false;
+    Clock::duration extra = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    std::int64_t deadline = state_->deadline.load();
+    while (deadline != kNoDeadline && !state_->deadline.compare_exchange_weak(deadline, deadline + extra.count())) {
+    }
+    return true;
+}
+
+AsyncSolver::AsyncSolver(int numWorkers)
+    : pool_(numWorkers)
+{
+}
+
+AsyncSolver::~AsyncSolver()
+{
+    pool_.wait();
+}
+
+SolveHandle AsyncSolver::solveAsync(std::shared_ptr<const ProblemInstance> instance, SolveOptions options)
+{
+    auto state = std::make_shared<AsyncSolveState>();
+    state->options = std::move(options);
+    state->instance = std::move(instance);
+    return start(std::move(state));
+}
+
+SolveHandle AsyncSolver::solveAsync(const OsiSolverInterface& solver, SolveOptions options)
+{
+    auto state = std::make_shared<AsyncSolveState>();
+    state->options = std::move(options);
+    state->solver.reset(solver.clone());
+    return start(std::move(state));
+}
+
+SolveHandle AsyncSolver::start(std::shared_ptr<AsyncSolveState> state)
+{
+    state->submitted = Clock::now();
+    state->deadline = deadlineAfter(state->options.timeLimit);
+    {
+        std::lock_guard<std::mutex> lock(statesMutex_);
+        state->id = nextId_++;
+        if (state->id % kPruneEvery == 0) {
+            states_.erase(std::remove_if(states_.begin(), states_.end(),
+                              [](const std::weak_ptr<AsyncSolveState>& s) { return s.expired(); }),
+                states_.end());
+        }
+        states_.push_back(state);
+    }
+    state->result.jobId = state->id;
+    state->result.name = state->options.name;
+
+    pool_.submit([state]() {
+        runSolve(*state);
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->finished = true;
+        }
+        state->done.notify_all();
+    });
+    return SolveHandle(state);
+}
+
+void AsyncSolver::cancelAll()
+{
+    std::lock_guard<std::mutex> lock(statesMutex_);
+    for (const auto& weak : states_)
+        if (auto state = weak.lock())
+            state->cancelled = true;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "batch_solver.h"
+#include "thread_pool.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class OsiSolverInterface;
+struct ProblemInstance;
+struct AsyncSolveState;
+
+// One look at a running solve, taken at a CBC event.
+struct SolveProgress
+{
+    double seconds = 0.0;     // since the solve started (after the wait in the queue)
+    bool hasIncumbent = false;
+    double incumbent = 0.0;   // objective of the best solution, in the model's sense
+    double bestBound = 0.0;
+    double gap = 0.0;         // relative, as BatchResult::gap; 0 without an incumbent
+    int nodes = 0;
+    int iterations = 0;
+    int updates = 0;          // snapshots taken so far, to tell a new one from the last
+};
+
+struct SolveOptions
+{
+    std::string name;
+    double timeLimit = 0.0;  // wall seconds from submit, <= 0 for none; see SolveHandle::extendDeadline
+    int threads = 0;         // CBC threads, 0 or 1 for the serial code
+    bool keepSolution = true;
+    double progressInterval = 0.1; // seconds between snapshots; new incumbents always make one
+    // Called with every snapshot on the thread running the solve; keep it short.
+    std::function<void(const SolveProgress&)> onProgress;
+};
+
+/*
+  Future-like handle of one solve started by AsyncSolver::solveAsync. Copies
+  share the solve. Progress, cancel() and the deadline all go through the
+  CbcEventHandler of the solve, so they take effect at the next CBC event
+  (every node and every new solution) and no thread polls the handles.
+*/
+class SolveHandle
+{
+public:
+    SolveHandle() = default;
+
+    bool valid() const { return state_ != nullptr; }
+    int id() const;
+    bool ready() const;
+
+    // Block until the solve has finished; waitFor returns false on timeout.
+    void wait() const;
+    bool waitFor(double seconds) const;
+    // The result, after waiting for it.
+    const BatchResult& get() const;
+
+    // The latest snapshot; all zero until the first CBC event.
+    SolveProgress progress() const;
+
+    // Stops a queued solve before it starts and a running one at its next
+    // event. Returns false once the solve has finished.
+    bool cancel();
+
+    // Moves the deadline to now + seconds (<= 0: no deadline), or pushes it
+    // seconds further out (nothing to push without a deadline). Both return
+    // false once the solve has finished.
+    bool setDeadline(double secondsFromNow);
+    bool extendDeadline(double seconds);
+
+private:
+    friend class AsyncSolver;
+    explicit SolveHandle(std::shared_ptr<AsyncSolveState> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<AsyncSolveState> state_;
+};
+
+/*
+  Runs solves in the background on a fixed pool of numWorkers threads, so a
+  service can keep taking requests while models solve. More submissions than
+  workers wait in the queue; each solve gets its own CbcModel and copy of the
+  solver.
+
+    AsyncSolver solver(4);
+    SolveOptions options;
+    options.timeLimit = 60.0;
+    options.onProgress = [](const SolveProgress& p) { std::cout << p.bestBound << std::endl; };
+    SolveHandle handle = solver.solveAsync(instance, options);
+    ...
+    handle.extendDeadline(30.0);   // needs more time
+    handle.cancel();               // or not at all
+    const BatchResult& result = handle.get();
+
+  A solve that hits its deadline ends Stopped with the message "deadline".
+  The destructor waits for the solves still queued or running; cancelAll()
+  first to drop them.
+*/
+class AsyncSolver
+{
+public:
+    explicit AsyncSolver(int numWorkers = 0); // <= 0 uses every core
+    ~AsyncSolver();
+
+    // The instance is shared with the solve, the solver is cloned here.
+    SolveHandle solveAsync(std::shared_ptr<const ProblemInstance> instance, SolveOptions options = SolveOptions());
+    SolveHandle solveAsync(const OsiSolverInterface& solver, SolveOptions options = SolveOptions());
+
+    void cancelAll();
+    int queued() const { return pool_.queued(); }
+    int running() const { return pool_.running(); }
+
+private:
+    SolveHandle start(std::shared_ptr<AsyncSolveState> state);
+
+    std::mutex statesMutex_;
+    std::vector<std::weak_ptr<AsyncSolveState>> states_;
+    int nextId_ = 0;
+    WorkStealingPool pool_; // last, so it joins before the rest goes away
+};
@@ -0,0 +1,435 @@
+#include "batch_evaluator.h"
+#include "parallel.h"
+#include "problem_instance.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define CBC_UTILS_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+/*
+  Bit compatibility between the kernels rests on three rules: every lane of
+  the batch sees the same sequence of operations (activity = 0, then
+  activity + a_ij * x_j in CSR order, no FMA; the file is built with
+  -ffp-contract=off so the compiler does not fuse them either), maxima are
+  taken as maxOf(a, b) = a > b ? a : b, which is what vmaxpd computes, and
+  rounding uses nearbyint, like vroundpd with the current rounding mode.
+*/
+
+static inline double maxOf(double a, double b)
+{
+    return a > b ? a : b;
+}
+
+void SolutionBatch::setSolution(int solution, const double* x)
+{
+    for (int j = 0; j < numCols; j++)
+        at(j, solution) = x[j];
+}
+
+void SolutionBatch::getSolution(int solution, double* x) const
+{
+    for (int j = 0; j < numCols; j++)
+        x[j] = at(j, solution);
+}
+
+const char* evalKernelName(EvalKernel kernel)
+{
+    switch (kernel) {
+    case EvalKernel::Scalar: return "scalar";
+    case EvalKernel::Avx2: return "avx2";
+    case EvalKernel::Avx512: return "avx512";
+    default: return "auto";
+    }
+}
+
+EvalKernel detectEvalKernel()
+{
+#ifdef CBC_UTILS_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return EvalKernel::Avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return EvalKernel::Avx2;
+#endif
+    return EvalKernel::Scalar;
+}
+
+double BatchEvaluation::maxViolation(int solution) const
+{
+    double worst = maxOf(integralityViolation[solution], boundViolation[solution]);
+    for (int s = 0; s < NumRowSenses; s++)
+        worst = maxOf(worst, rowViolation[s * batchSize + solution]);
+    return worst;
+}
+
+// Everything a kernel needs for one call; senseMax is [sense * batchSize + b].
+struct KernelArgs
+{
+    const BatchEvaluator::Matrix* data;
+    const double* rowLower;
+    const double* rowUpper;
+    const int* rowSense;
+    const int* integerCols;
+    int numIntegerCols;
+    const double* x;
+    int batchSize;
+    double* senseMax;
+    double* activity; // nullptr unless kept
+};
+
+// Rows [rowBegin, rowEnd), lanes [laneBegin, laneEnd); scratch holds batchSize doubles.
+static void rowsScalar(const KernelArgs& a, int rowBegin, int rowEnd, int laneBegin, int laneEnd, double* scratch)
+{
+    const BatchEvaluator::Matrix& data = *a.data;
+    const int batchSize = a.batchSize;
+    for (int i = rowBegin; i < rowEnd; i++) {
+        for (int b = laneBegin; b < laneEnd; b++)
+            scratch[b] = 0.0;
+        for (std::int64_t k = data.rowBegin(i), end = data.rowBegin(i + 1); k < end; k++) {
+            const double coeff = data.colCoeffs[k];
+            const double* xj = a.x + static_cast<std::size_t>(data.colIdxs[k]) * batchSize;
+            for (int b = laneBegin; b < laneEnd; b++)
+                scratch[b] = scratch[b] + coeff * xj[b];
+        }
+        if (a.activity) {
+            for (int b = laneBegin; b < laneEnd; b++)
+                a.activity[static_cast<std::size_t>(i) * batchSize + b] = scratch[b];
+        }
+        int sense = a.rowSense[i];
+        if (sense < 0)
+            continue;
+        double* senseMax = a.senseMax + sense * batchSize;
+        for (int b = laneBegin; b < laneEnd; b++) {
+            double violation = maxOf(maxOf(scratch[b] - a.rowUpper[i], a.rowLower[i] - scratch[b]), 0.0);
+            senseMax[b] = maxOf(senseMax[b], violation);
+        }
+    }
+}
+
+// Objective sums (without the offset), integrality and bound violations for lanes [laneBegin, laneEnd).
+static void columnsScalar(const KernelArgs& a, int laneBegin, int laneEnd, double* objective, double* integrality,
+    double* bounds)
+{
+    const BatchEvaluator::Matrix& data = *a.data;
+    const int batchSize = a.batchSize;
+    for (int j = 0; j < data.numCols; j++) {
+        const double* xj = a.x + static_cast<std::size_t>(j) * batchSize;
+        const double cost = data.objCoeffs[j], lower = data.lb[j], upper = data.ub[j];
+        for (int b = laneBegin; b < laneEnd; b++) {
+            objective[b] = objective[b] + cost * xj[b];
+            bounds[b] = maxOf(bounds[b], maxOf(xj[b] - upper, lower - xj[b]));
+        }
+    }
+    for (int n = 0; n < a.numIntegerCols; n++) {
+        const double* xj = a.x + static_cast<std::size_t>(a.integerCols[n]) * batchSize;
+        for (int b = laneBegin; b < laneEnd; b++)
+            integrality[b] = maxOf(integrality[b], std::fabs(xj[b] - std::nearbyint(xj[b])));
+    }
+}
+
+#ifdef CBC_UTILS_X86_KERNELS
+
+__attribute__((target("avx2"))) static inline void finishRowAvx2(const KernelArgs& a, int i, int b, __m256d activity)
+{
+    if (a.activity)
+        _mm256_storeu_pd(a.activity + static_cast<std::size_t>(i) * a.batchSize + b, activity);
+    int sense = a.rowSense[i];
+    if (sense < 0)
+        return;
+    __m256d violation = _mm256_max_pd(_mm256_max_pd(_mm256_sub_pd(activity, _mm256_set1_pd(a.rowUpper[i])),
+        _mm256_sub_pd(_mm256_set1_pd(a.rowLower[i]), activity)), _mm256_setzero_pd());
+    double* senseMax = a.senseMax + sense * a.batchSize + b;
+    _mm256_storeu_pd(senseMax, _mm256_max_pd(_mm256_loadu_pd(senseMax), violation));
+}
+
+__attribute__((target("avx2"))) static void rowsAvx2(const KernelArgs& a, int rowBegin, int rowEnd, double* scratch)
+{
+    const BatchEvaluator::Matrix& data = *a.data;
+    const int batchSize = a.batchSize;
+    const int vectorEnd = batchSize & ~3;
+    for (int i = rowBegin; i < rowEnd; i++) {
+        const std::int64_t begin = data.rowBegin(i), end = data.rowBegin(i + 1);
+        int b = 0;
+        // four vectors at a time, so one coefficient load feeds 16 lanes
+        for (; b + 16 <= vectorEnd; b += 16) {
+            __m256d acc0 = _mm256_setzero_pd(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+            for (std::int64_t k = begin; k < end; k++) {
+                __m256d coeff = _mm256_set1_pd(data.colCoeffs[k]);
+                const double* xj = a.x + static_cast<std::size_t>(data.colIdxs[k]) * batchSize + b;
+                acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(coeff, _mm256_loadu_pd(xj)));
+                acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(coeff, _mm256_loadu_pd(xj + 4)));
+                acc2 = _mm256_add_pd(acc2, _mm256_mul_pd(coeff, _mm256_loadu_pd(xj + 8)));
+                acc3 = _mm256_add_pd(acc3, _mm256_mul_pd(coeff, _mm256_loadu_pd(xj + 12)));
+            }
+            finishRowAvx2(a, i, b, acc0);
+            finishRowAvx2(a, i, b + 4, acc1);
+            finishRowAvx2(a, i, b + 8, acc2);
+            finishRowAvx2(a, i, b + 12, acc3);
+        }
+        for (; b < vectorEnd; b += 4) {
+            __m256d acc = _mm256_setzero_pd();
+            for (std::int64_t k = begin; k < end; k++) {
+                const double* xj = a.x + static_cast<std::size_t>(data.colIdxs[k]) * batchSize + b;
+                acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_set1_pd(data.colCoeffs[k]), _mm256_loadu_pd(xj)));
+            }
+            finishRowAvx2(a, i, b, acc);
+        }
+        if (vectorEnd < batchSize)
+            rowsScalar(a, i, i + 1, vectorEnd, batchSize, scratch);
+    }
+}
+
+__attribute__((target("avx2"))) static void columnsAvx2(const KernelArgs& a, double* objective, double* integrality,
+    double* bounds)
+{
+    const BatchEvaluator::Matrix& data = *a.data;
+    const int batchSize = a.batchSize;
+    const int vectorEnd = batchSize & ~3;
+    for (int j = 0; j < data.numCols; j++) {
+        const double* xj = a.x + static_cast<std::size_t>(j) * batchSize;
+        __m256d cost = _mm256_set1_pd(data.objCoeffs[j]);
+        __m256d lower = _mm256_set1_pd(data.lb[j]), upper = _mm256_set1_pd(data.ub[j]);
+        for (int b = 0; b < vectorEnd; b += 4) {
+            __m256d x = _mm256_loadu_pd(xj + b);
+            _mm256_storeu_pd(objective + b, _mm256_add_pd(_mm256_loadu_pd(objective + b), _mm256_mul_pd(cost, x)));
+            __m256d outside = _mm256_max_pd(_mm256_sub_pd(x, upper), _mm256_sub_pd(lower, x));
+            _mm256_storeu_pd(bounds + b, _mm256_max_pd(_mm256_loadu_pd(bounds + b), outside));
+        }
+    }
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    for (int n = 0; n < a.numIntegerCols; n++) {
+        const double* xj = a.x + static_cast<std::size_t>(a.integerCols[n]) * batchSize;
+        for (int b = 0; b < vectorEnd; b += 4) {
+            __m256d x = _mm256_loadu_pd(xj + b);
+            __m256d rounded = _mm256_round_pd(x, _MM_FROUND_CUR_DIRECTION);
+            __m256d distance = _mm256_andnot_pd(signMask, _mm256_sub_pd(x, rounded));
+            _mm256_storeu_pd(integrality + b, _mm256_max_pd(_mm256_loadu_pd(integrality + b), distance));
+        }
+    }
+    if (vectorEnd < batchSize)
+        columnsScalar(a, vectorEnd, batchSize, objective, integrality, bounds);
+}
+
+// GCC 12's AVX-512 intrinsics pass _mm512_undefined_pd() as the unused merge
+// operand and warn about it at -O2 (GCC bug 105593); the kernels read nothing uninitialized.
+#ifndef __clang__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+__attribute__((target("avx512f"))) static inline void finishRowAvx512(const KernelArgs& a, int i, int b,
+    __m512d activity)
+{
+    if (a.activity)
+        _mm512_storeu_pd(a.activity + static_cast<std::size_t>(i) * a.batchSize + b, activity);
+    int sense = a.rowSense[i];
+    if (sense < 0)
+        return;
+    __m512d violation = _mm512_max_pd(_mm512_max_pd(_mm512_sub_pd(activity, _mm512_set1_pd(a.rowUpper[i])),
+        _mm512_sub_pd(_mm512_set1_pd(a.rowLower[i]), activity)), _mm512_setzero_pd());
+    double* senseMax = a.senseMax + sense * a.batchSize + b;
+    _mm512_storeu_pd(senseMax, _mm512_max_pd(_mm512_loadu_pd(senseMax), violation));
+}
+
+__attribute__((target("avx512f"))) static void rowsAvx512(const KernelArgs& a, int rowBegin, int rowEnd,
+    double* scratch)
+{
+    const BatchEvaluator::Matrix& data = *a.data;
+    const int batchSize = a.batchSize;
+    const int vectorEnd = batchSize & ~7;
+    for (int i = rowBegin; i < rowEnd; i++) {
+        const std::int64_t begin = data.rowBegin(i), end = data.rowBegin(i + 1);
+        int b = 0;
+        for (; b + 32 <= vectorEnd; b += 32) {
+            __m512d acc0 = _mm512_setzero_pd(), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+            for (std::int64_t k = begin; k < end; k++) {
+                __m512d coeff = _mm512_set1_pd(data.colCoeffs[k]);
+                const double* xj = a.x + static_cast<std::size_t>(data.colIdxs[k]) * batchSize + b;
+                acc0 = _mm512_add_pd(acc0, _mm512_mul_pd(coeff, _mm512_loadu_pd(xj)));
+                acc1 = _mm512_add_pd(acc1, _mm512_mul_pd(coeff, _mm512_loadu_pd(xj + 8)));
+                acc2 = _mm512_add_pd(acc2, _mm512_mul_pd(coeff, _mm512_loadu_pd(xj + 16)));
+                acc3 = _mm512_add_pd(acc3, _mm512_mul_pd(coeff, _mm512_loadu_pd(xj + 24)));
+            }
+            finishRowAvx512(a, i, b, acc0);
+            finishRowAvx512(a, i, b + 8, acc1);
+            finishRowAvx512(a, i, b + 16, acc2);
+            finishRowAvx512(a, i, b + 24, acc3);
+        }
+        for (; b < vectorEnd; b += 8) {
+            __m512d acc = _mm512_setzero_pd();
+            for (std::int64_t k = begin; k < end; k++) {
+                const double* xj = a.x + static_cast<std::size_t>(data.colIdxs[k]) * batchSize + b;
+                acc = _mm512_add_pd(acc, _mm512_mul_pd(_mm512_set1_pd(data.colCoeffs[k]), _mm512_loadu_pd(xj)));
+            }
+            finishRowAvx512(a, i, b, acc);
+        }
+        if (vectorEnd < batchSize)
+            rowsScalar(a, i, i + 1, vectorEnd, batchSize, scratch);
+    }
+}
+
+__attribute__((target("avx512f"))) static void columnsAvx512(const KernelArgs& a, double* objective,
+    double* integrality, double* bounds)
+{
+    const BatchEvaluator::Matrix& data = *a.data;
+    const int batchSize = a.batchSize;
+    const int vectorEnd = batchSize & ~7;
+    for (int j = 0; j < data.numCols; j++) {
+        const double* xj = a.x + static_cast<std::size_t>(j) * batchSize;
+        __m512d cost = _mm512_set1_pd(data.objCoeffs[j]);
+        __m512d lower = _mm512_set1_pd(data.lb[j]), upper = _mm512_set1_pd(data.ub[j]);
+        for (int b = 0; b < vectorEnd; b += 8) {
+            __m512d x = _mm512_loadu_pd(xj + b);
+            _mm512_storeu_pd(objective + b, _mm512_add_pd(_mm512_loadu_pd(objective + b), _mm512_mul_pd(cost, x)));
+            __m512d outside = _mm512_max_pd(_mm512_sub_pd(x, upper), _mm512_sub_pd(lower, x));
+            _mm512_storeu_pd(bounds + b, _mm512_max_pd(_mm512_loadu_pd(bounds + b), outside));
+        }
+    }
+    for (int n = 0; n < a.numIntegerCols; n++) {
+        const double* xj = a.x + static_cast<std::size_t>(a.integerCols[n]) * batchSize;
+        for (int b = 0; b < vectorEnd; b += 8) {
+            __m512d x = _mm512_loadu_pd(xj + b);
+            __m512d rounded = _mm512_roundscale_pd(x, _MM_FROUND_CUR_DIRECTION);
+            __m512d distance = _mm512_abs_pd(_mm512_sub_pd(x, rounded));
+            _mm512_storeu_pd(integrality + b, _mm512_max_pd(_mm512_loadu_pd(integrality + b), distance));
+        }
+    }
+    if (vectorEnd < batchSize)
+        columnsScalar(a, vectorEnd, batchSize, objective, integrality, bounds);
+}
+
+#ifndef __clang__
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+BatchEvaluator::BatchEvaluator(const ProblemInstance& data, EvalKernel kernel)
+    : kernel_(kernel)
+{
+    data_.rowStart = data.rowStart.data();
+    init(data);
+}
+
+BatchEvaluator::BatchEvaluator(const ProblemInstance64& data, EvalKernel kernel)
+    : kernel_(kernel)
+{
+    data_.rowStart64 = data.rowStart.data();
+    init(data);
+}
+
+template <typename Offset>
+void BatchEvaluator::init(const BasicProblemInstance<Offset>& data)
+{
+    // never pick a kernel the CPU cannot run
+    EvalKernel best = detectEvalKernel();
+    if (kernel_ == EvalKernel::Auto || static_cast<int>(kernel_) > static_cast<int>(best))
+        kernel_ = best;
+
+    data_.numCols = data.numCols;
+    data_.numRows = data.numRows;
+    data_.colIdxs = data.colIdxs.data();
+    data_.colCoeffs = data.colCoeffs.data();
+    data_.objCoeffs = data.objCoeffs.data();
+    data_.lb = data.lb.data();
+    data_.ub = data.ub.data();
+    data_.objOffset = data.objOffset;
+
+    rowLower_.resize(data.numRows);
+    rowUpper_.resize(data.numRows);
+    rowSense_.resize(data.numRows);
+    for (int i = 0; i < data.numRows; i++) {
+        senseToRowBounds(data.rowtypes[i], data.rhs[i], data.rhsrange[i], rowLower_[i], rowUpper_[i]);
+        switch (data.rowtypes[i]) {
+        case 'L': rowSense_[i] = SenseL; break;
+        case 'E': rowSense_[i] = SenseE; break;
+        case 'G': rowSense_[i] = SenseG; break;
+        case 'R': rowSense_[i] = SenseR; break;
+        default: rowSense_[i] = -1; break;
+        }
+    }
+    for (int j = 0; j < data.numCols; j++)
+        if (data.varTypes[j] != 'C')
+            integerCols_.push_back(j);
+
+    // about 64 chunks, at least 4096 nonzeros each
+    Offset target = std::max<Offset>(4096, data.numNonZeros / 64);
+    chunkStart_.push_back(0);
+    for (int i = 0; i < data.numRows; i++) {
+        if (data.rowStart[i + 1] - data.rowStart[chunkStart_.back()] >= target)
+            chunkStart_.push_back(i + 1);
+    }
+    if (chunkStart_.back() != data.numRows)
+        chunkStart_.push_back(data.numRows);
+}
+
+bool BatchEvaluator::evaluate(const SolutionBatch& batch, BatchEvaluation& result, int numThreads,
+    bool keepActivities) const
+{
+    if (batch.numCols != data_.numCols || batch.values.size() != static_cast<std::size_t>(batch.numCols) * batch.batchSize)
+        return false;
+    const int batchSize = batch.batchSize;
+    const int numChunks = static_cast<int>(chunkStart_.size()) - 1;
+
+    result.batchSize = batchSize;
+    result.objective.assign(batchSize, 0.0);
+    result.rowViolation.assign(NumRowSenses * batchSize, 0.0);
+    result.integralityViolation.assign(batchSize, 0.0);
+    result.boundViolation.assign(batchSize, 0.0);
+    if (keepActivities)
+        result.activity.assign(static_cast<std::size_t>(data_.numRows) * batchSize, 0.0);
+    else
+        result.activity.clear();
+
+    std::vector<double> chunkMax(static_cast<std::size_t>(numChunks) * NumRowSenses * batchSize, 0.0);
+    KernelArgs args = {&data_, rowLower_.data(), rowUpper_.data(), rowSense_.data(), integerCols_.data(),
+        static_cast<int>(integerCols_.size()), batch.values.data(), batchSize, nullptr,
+        keepActivities ? result.activity.data() : nullptr};
+
+    // chunk 0 is the column pass, the row chunks follow
+    parallelFor(numChunks + 1, numThreads, [&](int chunk) {
+        KernelArgs a = args;
+        std::vector<double> scratch(batchSize);
+        if (chunk == 0) {
+            switch (kernel_) {
+#ifdef CBC_UTILS_X86_KERNELS
+            case EvalKernel::Avx512:
+                columnsAvx512(a, result.objective.data(), result.integralityViolation.data(),
+                    result.boundViolation.data());
+                break;
+            case EvalKernel::Avx2:
+                columnsAvx2(a, result.objective.data(), result.integralityViolation.data(),
+                    result.boundViolation.data());
+                break;
+#endif
+            default:
+                columnsScalar(a, 0, batchSize, result.objective.data(), result.integralityViolation.data(),
+                    result.boundViolation.data());
+                break;
+            }
+            return;
+        }
+        a.senseMax = chunkMax.data() + static_cast<std::size_t>(chunk - 1) * NumRowSenses * batchSize;
+        int rowBegin = chunkStart_[chunk - 1], rowEnd = chunkStart_[chunk];
+        switch (kernel_) {
+#ifdef CBC_UTILS_X86_KERNELS
+        case EvalKernel::Avx512: rowsAvx512(a, rowBegin, rowEnd, scratch.data()); break;
+        case EvalKernel::Avx2: rowsAvx2(a, rowBegin, rowEnd, scratch.data()); break;
+#endif
+        default: rowsScalar(a, rowBegin, rowEnd, 0, batchSize, scratch.data()); break;
+        }
+    });
+
+    for (int chunk = 0; chunk < numChunks; chunk++) {
+        const double* senseMax = chunkMax.data() + static_cast<std::size_t>(chunk) * NumRowSenses * batchSize;
+        for (int k = 0; k < NumRowSenses * batchSize; k++)
+            result.rowViolation[k] = maxOf(result.rowViolation[k], senseMax[k]);
+    }
+    for (int b = 0; b < batchSize; b++)
+        result.objective[b] = result.objective[b] + data_.objOffset;
+    return true;
+}
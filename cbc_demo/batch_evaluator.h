@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+template <typename Offset>
+struct BasicProblemInstance;
+struct ProblemInstance;
+struct ProblemInstance64;
+
+// Candidate solutions stored column-blocked: the batchSize values of column j
+// are contiguous, so a kernel reads one coefficient and updates every
+// solution of the batch with it.
+struct SolutionBatch
+{
+    int numCols = 0;
+    int batchSize = 0;
+    std::vector<double> values; // values[j * batchSize + b]
+
+    SolutionBatch() = default;
+    SolutionBatch(int numCols, int batchSize)
+        : numCols(numCols), batchSize(batchSize), values(static_cast<std::size_t>(numCols) * batchSize, 0.0)
+    {
+    }
+
+    double& at(int col, int solution) { return values[static_cast<std::size_t>(col) * batchSize + solution]; }
+    double at(int col, int solution) const { return values[static_cast<std::size_t>(col) * batchSize + solution]; }
+    void setSolution(int solution, const double* x);
+    void getSolution(int solution, double* x) const;
+};
+
+enum class EvalKernel
+{
+    Auto,   // the widest the CPU supports
+    Scalar,
+    Avx2,
+    Avx512
+};
+
+const char* evalKernelName(EvalKernel kernel);
+
+// Indexes of BatchEvaluation::rowViolation.
+enum RowSense
+{
+    SenseL,
+    SenseE,
+    SenseG,
+    SenseR,
+    NumRowSenses
+};
+
+struct BatchEvaluation
+{
+    int batchSize = 0;
+    std::vector<double> objective;            // c x + objOffset, per solution
+    std::vector<double> rowViolation;         // [sense * batchSize + b], 0 if the rows of that sense hold
+    std::vector<double> integralityViolation; // max |x - round(x)| over the integer columns
+    std::vector<double> boundViolation;       // max distance outside [lb, ub]
+    std::vector<double> activity;             // [row * batchSize + b], only if asked for
+
+    // Largest row, bound and integrality violation of one solution.
+    double maxViolation(int solution) const;
+};
+
+/*
+  Evaluates batches of candidate solutions against the CSR of a
+  ProblemInstance without a solver: row activities, the largest violation
+  per row sense, integrality and bound violations and the objective.
+
+  The rows are split into chunks of about equal nonzeros that run on
+  numThreads threads; the column pass (objective, integrality, bounds) runs
+  as one more chunk. The AVX2 and AVX-512 kernels vectorize across the
+  solutions of the batch and do the same multiplies and adds in the same
+  order as the scalar kernel, without FMA, so every kernel and thread count
+  gives bit-identical results. The instance must outlive the evaluator.
+  Both index widths share the kernels; a ProblemInstance64 evaluates to the
+  same bits as its ProblemInstance.
+
+    BatchEvaluator evaluator(data);
+    SolutionBatch batch(data.numCols, 64);
+    ...
+    BatchEvaluation result;
+    evaluator.evaluate(batch, result);
+*/
+class BatchEvaluator
+{
+public:
+    explicit BatchEvaluator(const ProblemInstance& data, EvalKernel kernel = EvalKernel::Auto);
+    explicit BatchEvaluator(const ProblemInstance64& data, EvalKernel kernel = EvalKernel::Auto);
+
+    // Returns false if the batch does not have data.numCols columns.
+    bool evaluate(const SolutionBatch& batch, BatchEvaluation& result, int numThreads = 0,
+        bool keepActivities = false) const;
+
+    EvalKernel kernel() const { return kernel_; }
+
+    // The arrays of the instance the kernels read; one of rowStart and rowStart64 is set.
+    struct Matrix
+    {
+        int numCols = 0;
+        int numRows = 0;
+        const int* rowStart = nullptr;
+        const std::int64_t* rowStart64 = nullptr;
+        const int* colIdxs = nullptr;
+        const double* colCoeffs = nullptr;
+        const double* objCoeffs = nullptr;
+        const double* lb = nullptr;
+        const double* ub = nullptr;
+        double objOffset = 0.0;
+
+        std::int64_t rowBegin(int i) const { return rowStart64 ? rowStart64[i] : rowStart[i]; }
+    };
+
+private:
+    template <typename Offset>
+    void init(const BasicProblemInstance<Offset>& data);
+
+    Matrix data_;
+    EvalKernel kernel_;
+    std::vector<double> rowLower_;
+    std::vector<double> rowUpper_;
+    std::vector<int> rowSense_;      // RowSense, -1 for free rows
+    std::vector<int> integerCols_;
+    std::vector<int> chunkStart_;    // row chunks, chunkStart_.back() == numRows
+};
+
+// The best kernel this CPU runs.
+EvalKernel detectEvalKernel();
@@ -0,0 +1,303 @@
+#include "batch_solver.h"
+#include "json_writer.h"
+#include "model_reader.h"
+#include "parallel.h"
+#include "problem_instance.h"
+#include "problem_snapshot.h"
+#include "util.h"
+
+#include "CbcEventHandler.hpp"
+#include "CbcModel.hpp"
+#include "OsiClpSolverInterface.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <ostream>
+
+const char* batchStatusName(BatchStatus status)
+{
+    switch (status) {
+    case BatchStatus::Optimal: return "optimal";
+    case BatchStatus::Infeasible: return "infeasible";
+    case BatchStatus::Stopped: return "stopped";
+    case BatchStatus::Cancelled: return "cancelled";
+    default: return "failed";
+    }
+}
+
+// Stops the search at the next node once the job is cancelled.
+class CancelEventHandler : public CbcEventHandler
+{
+public:
+    CancelEventHandler(CbcModel* model, const std::atomic<bool>* cancelled)
+        : CbcEventHandler(model), cancelled_(cancelled)
+    {
+    }
+
+    CbcAction event(CbcEvent whichEvent) override
+    {
+        if (cancelled_->load(std::memory_order_relaxed) && whichEvent != endSearch)
+            return stop;
+        return noAction;
+    }
+
+    CbcEventHandler* clone() const override { return new CancelEventHandler(*this); }
+
+private:
+    const std::atomic<bool>* cancelled_;
+};
+
+static const char* stopReason(int secondaryStatus)
+{
+    switch (secondaryStatus) {
+    case 2: return "gap limit";
+    case 3: return "node limit";
+    case 4: return "time limit";
+    case 5: return "user event";
+    case 6: return "solution limit";
+    case 7: return "relaxation unbounded";
+    case 8: return "iteration limit";
+    default: return "stopped";
+    }
+}
+
+BatchSolver::BatchSolver(int numWorkers, int numCores, int maxCbcThreads)
+    : numCores_(numCores > 0 ? numCores : defaultThreadCount()),
+      maxCbcThreads_(std::max(1, maxCbcThreads)),
+      pool_(numWorkers)
+{
+}
+
+BatchSolver::~BatchSolver()
+{
+    pool_.wait();
+}
+
+int BatchSolver::submit(BatchJob job)
+{
+    if (job.name.empty())
+        job.name = std::filesystem::path(job.path).filename().string();
+
+    auto state = std::make_shared<JobState>();
+    state->job = std::move(job);
+    state->submitted = std::chrono::steady_clock::now();
+
+    int jobId;
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex_);
+        jobId = static_cast<int>(jobs_.size());
+        jobs_.push_back(state);
+    }
+    state->result.jobId = jobId;
+    state->result.name = state->job.name;
+    pool_.submit([this, state]() {
+        runJob(*state);
+        state->finished = true;
+    });
+    return jobId;
+}
+
+bool BatchSolver::cancel(int jobId)
+{
+    std::lock_guard<std::mutex> lock(jobsMutex_);
+    if (jobId < 0 || jobId >= static_cast<int>(jobs_.size()) || jobs_[jobId]->finished)
+        return false;
+    jobs_[jobId]->cancelled = true;
+    return true;
+}
+
+void BatchSolver::cancelAll()
+{
+    std::lock_guard<std::mutex> lock(jobsMutex_);
+    for (auto& state : jobs_)
+        state->cancelled = true;
+}
+
+std::vector<BatchResult> BatchSolver::wait()
+{
+    pool_.wait();
+    std::lock_guard<std::mutex> lock(jobsMutex_);
+    std::vector<BatchResult> results;
+    results.reserve(jobs_.size());
+    for (auto& state : jobs_)
+        results.push_back(state->result);
+    return results;
+}
+
+int BatchSolver::threadsForJob(const BatchJob& job) const
+{
+    // this job is already counted as running
+    int activeJobs = std::max(1, pool_.queued() + pool_.running());
+    int threads = std::min(std::max(1, numCores_ / activeJobs), maxCbcThreads_);
+    if (job.maxThreads > 0)
+        threads = std::min(threads, job.maxThreads);
+    return threads;
+}
+
+void BatchSolver::runJob(JobState& state)
+{
+    const BatchJob& job = state.job;
+    BatchResult& result = state.result;
+    auto start = std::chrono::steady_clock::now();
+    result.waitSeconds = std::chrono::duration<double>(start - state.submitted).count();
+    if (state.cancelled) {
+        result.status = BatchStatus::Cancelled;
+        return;
+    }
+    result.threads = threadsForJob(job);
+
+    OsiClpSolverInterface solver;
+    solver.messageHandler()->setLogLevel(0);
+    if (job.instance) {
+        loadProblemData(*job.instance, solver, false);
+    } else if (endsWith(job.path, ".snap")) {
+        ProblemSnapshot snapshot;
+        if (!snapshot.open(job.path, false)) {
+            result.message = "cannot open snapshot " + job.path;
+            return;
+        }
+        if (!snapshot.loadInto(solver, false)) {
+            result.message = "snapshot " + job.path + " is too large for CBC";
+            return;
+        }
+    } else {
+        ProblemInstance data;
+        int errors = readModelFile(job.path, data, result.threads);
+        if (errors != 0) {
+            result.message = std::to_string(errors) + " errors reading " + job.path;
+            return;
+        }
+        loadProblemData(data, solver, false);
+    }
+    result.loadSeconds = secondsSince(start);
+
+    double remaining = job.timeLimit - result.loadSeconds;
+    if (state.cancelled || (job.timeLimit > 0.0 && remaining <= 0.0)) {
+        result.status = state.cancelled ? BatchStatus::Cancelled : BatchStatus::Stopped;
+        result.message = state.cancelled ? "" : "time limit reached while loading";
+        return;
+    }
+
+    CbcModel model(solver);
+    model.setLogLevel(0);
+    model.setUseElapsedTime(true);
+    if (job.timeLimit > 0.0)
+        model.setMaximumSeconds(remaining);
+    // CBC runs serial code for 0 threads, 1 would still start the thread machinery
+    model.setNumberThreads(result.threads > 1 ? result.threads : 0);
+    CancelEventHandler handler(&model, &state.cancelled);
+    model.passInEventHandler(&handler);
+
+    auto solveStart = std::chrono::steady_clock::now();
+    model.branchAndBound();
+    result.solveSeconds = secondsSince(solveStart);
+
+    collectBatchResult(model, state.cancelled, job.keepSolution, result);
+}
+
+void collectBatchResult(CbcModel& model, bool cancelled, bool keepSolution, BatchResult& result)
+{
+    result.nodes = model.getNodeCount();
+    result.iterations = model.getIterationCount();
+    // CBC keeps bestSolution after a final pass that failed and reports 1e50 then
+    result.hasSolution = model.bestSolution() != nullptr && model.getObjValue() < 1e50;
+    result.bestBound = model.getBestPossibleObjValue();
+    if (result.hasSolution) {
+        result.objValue = model.getObjValue();
+        result.gap = std::fabs(result.objValue - result.bestBound) / std::max(1e-10, std::fabs(result.objValue));
+        if (keepSolution)
+            result.solution.assign(model.bestSolution(), model.bestSolution() + model.getNumCols());
+    }
+
+    if (model.isProvenOptimal()) {
+        result.status = BatchStatus::Optimal;
+    } else if (model.isProvenInfeasible()) {
+        result.status = BatchStatus::Infeasible;
+    } else if (cancelled) {
+        result.status = BatchStatus::Cancelled;
+    } else if (model.status() == 2) {
+        result.status = BatchStatus::Failed;
+        result.message = "abandoned by CBC";
+    } else {
+        result.status = BatchStatus::Stopped;
+        result.message = stopReason(model.secondaryStatus());
+    }
+}
+
+void writeBatchReportJson(const std::vector<BatchResult>& results, std::ostream& out)
+{
+    int counts[5] = {0, 0, 0, 0, 0};
+    double solveSeconds = 0.0;
+    out << "{\n  \"jobs\": [";
+    for (std::size_t k = 0; k < results.size(); k++) {
+        const BatchResult& r = results[k];
+        counts[static_cast<int>(r.status)]++;
+        solveSeconds += r.solveSeconds;
+
+        out << (k == 0 ? "\n" : ",\n") << "    {\"id\": " << r.jobId << ", \"name\": ";
+        writeJsonString(out, r.name);
+        out << ", \"status\": \"" << batchStatusName(r.status) << "\", \"message\": ";
+        writeJsonString(out, r.message);
+        out << ", \"objective\": ";
+        if (r.hasSolution)
+            writeJsonNumber(out, r.objValue);
+        else
+            out << "null";
+        out << ", \"bound\": ";
+        writeJsonNumber(out, r.bestBound);
+        out << ", \"gap\": ";
+        if (r.hasSolution)
+            writeJsonNumber(out, r.gap);
+        else
+            out << "null";
+        out << ", \"nodes\": " << r.nodes << ", \"iterations\": " << r.iterations
+            << ", \"threads\": " << r.threads << ", \"wait_s\": ";
+        writeJsonNumber(out, r.waitSeconds, "%.6f");
+        out << ", \"load_s\": ";
+        writeJsonNumber(out, r.loadSeconds, "%.6f");
+        out << ", \"solve_s\": ";
+        writeJsonNumber(out, r.solveSeconds, "%.6f");
+        out << "}";
+    }
+    out << "\n  ],\n  \"summary\": {\"jobs\": " << results.size();
+    for (int s = 0; s < 5; s++)
+        out << ", \"" << batchStatusName(static_cast<BatchStatus>(s)) << "\": " << counts[s];
+    out << ", \"solve_s\": ";
+    writeJsonNumber(out, solveSeconds, "%.6f");
+    out << "}\n}\n";
+}
+
+// RFC 4180: quoted, inner quotes doubled, so commas and newlines in paths stay in the field.
+static void writeCsvString(std::ostream& out, const std::string& value)
+{
+    out << '"';
+    for (char c : value) {
+        if (c == '"')
+            out << '"';
+        out << c;
+    }
+    out << '"';
+}
+
+void writeBatchReportCsv(const std::vector<BatchResult>& results, std::ostream& out)
+{
+    out << "id,name,status,message,objective,bound,gap,nodes,iterations,threads,wait_s,load_s,solve_s\n";
+    char buffer[256];
+    for (const BatchResult& r : results) {
+        out << r.jobId << ',';
+        writeCsvString(out, r.name);
+        out << ',' << batchStatusName(r.status) << ',';
+        writeCsvString(out, r.message);
+        out << ',';
+        if (r.hasSolution)
+            std::snprintf(buffer, sizeof(buffer), "%.17g,%.17g,%.6g", r.objValue, r.bestBound, r.gap);
+        else
+            std::snprintf(buffer, sizeof(buffer), ",%.17g,", r.bestBound);
+        out << buffer;
+        std::snprintf(buffer, sizeof(buffer), ",%d,%d,%d,%.6f,%.6f,%.6f\n", r.nodes, r.iterations, r.threads,
+            r.waitSeconds, r.loadSeconds, r.solveSeconds);
+        out << buffer;
+    }
+}
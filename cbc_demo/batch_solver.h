@@ -0,0 +1,112 @@
+#pragma once
+
+#include "thread_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class CbcModel;
+struct ProblemInstance;
+
+struct BatchJob
+{
+    std::string name;   // defaults to the file name of path
+    std::string path;   // .mps[.gz], .lp[.gz] or .snap, read on the worker
+    std::shared_ptr<const ProblemInstance> instance; // used instead of path when set
+    double timeLimit = 0.0; // wall seconds including the load, <= 0 for none
+    int maxThreads = 0;     // cap on the CBC threads of this job, <= 0 for the batch cap
+    bool keepSolution = false;
+};
+
+enum class BatchStatus
+{
+    Optimal,
+    Infeasible,
+    Stopped,    // time limit or other CBC limit, see hasSolution
+    Cancelled,
+    Failed      // read or load error, see message
+};
+
+const char* batchStatusName(BatchStatus status);
+
+struct BatchResult
+{
+    int jobId = -1;
+    std::string name;
+    BatchStatus status = BatchStatus::Failed;
+    std::string message;
+
+    bool hasSolution = false;
+    double objValue = 0.0;
+    double bestBound = 0.0;
+    double gap = 0.0;       // relative, |obj - bound| / max(1e-10, |obj|)
+    int nodes = 0;
+    int iterations = 0;
+    int threads = 1;        // CBC threads picked for this job
+
+    double waitSeconds = 0.0;  // submit to start
+    double loadSeconds = 0.0;
+    double solveSeconds = 0.0;
+    std::vector<double> solution; // only with BatchJob::keepSolution
+};
+
+/*
+  Solves many independent models on a work-stealing pool, one CbcModel per
+  job. CBC threads per job follow the load: a job that starts while the
+  queue is deep gets one thread, the tail of a batch spreads the idle cores
+  over the jobs still running (cores / (running + queued), capped by
+  maxCbcThreads and BatchJob::maxThreads).
+
+  Time limits are wall clock (CBC's default CPU clock counts every thread of
+  the process). cancel() stops a queued job before it starts and a running
+  one at its next node, through a CbcEventHandler.
+*/
+class BatchSolver
+{
+public:
+    // numWorkers: jobs solved at once; numCores: cores shared among them (<= 0: all)
+    explicit BatchSolver(int numWorkers = 0, int numCores = 0, int maxCbcThreads = 8);
+    ~BatchSolver(); // waits for the submitted jobs
+
+    int submit(BatchJob job); // returns the job id, ids count up from 0
+    bool cancel(int jobId);   // false for an unknown or finished job
+    void cancelAll();
+
+    // Blocks until every submitted job has finished; results are in job id order.
+    std::vector<BatchResult> wait();
+
+    int queued() const { return pool_.queued(); }
+    int running() const { return pool_.running(); }
+
+private:
+    struct JobState
+    {
+        BatchJob job;
+        std::chrono::steady_clock::time_point submitted;
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> finished{false};
+        BatchResult result;
+    };
+
+    void runJob(JobState& state);
+    int threadsForJob(const BatchJob& job) const;
+
+    int numCores_;
+    int maxCbcThreads_;
+    std::mutex jobsMutex_;
+    std::vector<std::shared_ptr<JobState>> jobs_;
+    WorkStealingPool pool_; // last, so it joins before the job states go away
+};
+
+// Statistics, status and (with keepSolution) the solution of a finished
+// CbcModel; cancelled tells a stop on request from the CBC limits.
+void collectBatchResult(CbcModel& model, bool cancelled, bool keepSolution, BatchResult& result);
+
+// One object per job plus totals, and the same rows as CSV with a header line.
+void writeBatchReportJson(const std::vector<BatchResult>& results, std::ostream& out);
+void writeBatchReportCsv(const std::vector<BatchResult>& results, std::ostream& out);
@@ -0,0 +1,183 @@
+// Re-solve latency of IncrementalSolver (incremental_solver.h) against a
+// full rebuild in a rolling-horizon loop. Each round changes `changes`
+// entries of the model: integer columns frozen at their incumbent value or
+// released again, rhs moved by up to 2% (whole steps on all-integer rows),
+// objective coefficients by up to 10%, plus one added row (a looser copy
+// of a random row) and the deletion of the row added the round before. The rebuild copies the solver and
+// builds a fresh CbcModel (main.cpp: solver2 = solver1); the incremental
+// solve applies the same ModelDelta to its live solver and starts from the
+// previous basis and incumbent.
+//
+//   ./bench_delta [rounds] [changes] [time limit] [models...]
+
+#include "CbcModel.hpp"
+#include "OsiClpSolverInterface.hpp"
+
+#include "batch_solver.h"
+#include "incremental_solver.h"
+#include "model_delta.h"
+#include "model_reader.h"
+#include "problem_instance.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Totals
+{
+    double rebuildSeconds = 0.0;
+    double incrementalSeconds = 0.0;
+    double applySeconds = 0.0;
+    long long lpIterations = 0;
+    int kept = 0;
+    int repaired = 0;
+    int same = 0;
+    int compared = 0;
+};
+
+static BatchResult rebuildSolve(const OsiClpSolverInterface& reference, double timeLimit)
+{
+    OsiClpSolverInterface solver;
+    solver = reference; // copy the model
+    CbcModel model(solver);
+    model.setLogLevel(0);
+    model.setUseElapsedTime(true);
+    if (timeLimit > 0.0)
+        model.setMaximumSeconds(timeLimit);
+    auto start = std::chrono::steady_clock::now();
+    model.branchAndBound();
+    BatchResult result;
+    result.solveSeconds = secondsSince(start);
+    collectBatchResult(model, false, false, result);
+    return result;
+}
+
+static void makeDelta(const ProblemInstance& original, const std::vector<char>& integerRow,
+    const OsiSolverInterface& solver, const std::vector<double>& incumbent, int changes, int& addedRow,
+    std::mt19937_64& random, ModelDelta& delta)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> pickCol(0, original.numCols - 1);
+    std::uniform_int_distribution<int> pickRow(0, original.numRows - 1);
+    const double* lower = solver.getColLower();
+    const double* upper = solver.getColUpper();
+    for (int k = 0; k < changes; k++) {
+        double kind = unit(random);
+        if (kind < 0.4) {
+            int j = pickCol(random);
+            if (original.varTypes[j] == 'C' || incumbent.empty())
+                continue;
+            if (lower[j] == original.lb[j] && upper[j] == original.ub[j])
+                delta.setColBounds(j, std::round(incumbent[j]), std::round(incumbent[j])); // freeze
+            else
+                delta.setColBounds(j, original.lb[j], original.ub[j]); // release
+        } else if (kind < 0.7) {
+            int i = pickRow(random);
+            double step = 0.02 * original.rhs[i] * (2.0 * unit(random) - 1.0);
+            if (integerRow[i])
+                step = std::round(step); // a fractional rhs only cuts an all-integer row off
+            if (original.rowtypes[i] != 'N' && step != 0.0)
+                delta.setRhs(i, original.rhs[i] + step);
+        } else {
+            int j = pickCol(random);
+            delta.setObjCoeff(j, original.objCoeffs[j] * (0.9 + 0.2 * unit(random)));
+        }
+    }
+
+    if (addedRow >= 0)
+        delta.deleteRow(addedRow);
+    int i = pickRow(random);
+    int begin = original.rowStart[i], end = original.rowStart[i + 1];
+    double rowLower, rowUpper;
+    senseToRowBounds(original.rowtypes[i], original.rhs[i], original.rhsrange[i], rowLower, rowUpper);
+    double slack = 0.1 * std::max(1.0, std::max(std::fabs(rowLower), std::fabs(rowUpper)));
+    delta.addRow(end - begin, original.colIdxs.data() + begin, original.colCoeffs.data() + begin,
+        rowLower > -1e30 ? rowLower - slack : rowLower, rowUpper < 1e30 ? rowUpper + slack : rowUpper);
+    // the deletion runs after the addition, so the new row moves up by one
+    addedRow = solver.getNumRows() - (addedRow >= 0 ? 1 : 0);
+}
+
+static void runModel(const std::string& path, int rounds, int changes, double timeLimit)
+{
+    ProblemInstance data;
+    if (readModelFile(path, data) != 0)
+        return;
+    std::string label = path.substr(path.find_last_of('/') + 1);
+    label = label.substr(0, label.find('.'));
+
+    OsiClpSolverInterface reference;
+    reference.messageHandler()->setLogLevel(0);
+    loadProblemData(data, reference, false);
+    IncrementalSolver incremental(data);
+    std::vector<char> integerRow(data.numRows, 1);
+    for (int i = 0; i < data.numRows; i++)
+        for (int p = data.rowStart[i]; p < data.rowStart[i + 1]; p++)
+            if (data.varTypes[data.colIdxs[p]] == 'C' || data.colCoeffs[p] != std::round(data.colCoeffs[p]))
+                integerRow[i] = 0;
+
+    std::mt19937_64 random(11);
+    Totals totals;
+    int addedRow = -1;
+    for (int round = 0; round <= rounds; round++) {
+        if (round > 0) {
+            ModelDelta delta;
+            makeDelta(data, integerRow, incremental.solver(), incremental.incumbent(), changes, addedRow, random,
+                delta);
+            delta.apply(reference);
+            incremental.apply(delta);
+        }
+        auto start = std::chrono::steady_clock::now();
+        BatchResult rebuilt = rebuildSolve(reference, timeLimit);
+        double rebuildSeconds = secondsSince(start);
+        start = std::chrono::steady_clock::now();
+        BatchResult hot = incremental.solve(timeLimit, 0, false);
+        double incrementalSeconds = secondsSince(start) + incremental.lastResolve().applySeconds;
+        if (round == 0)
+            continue; // both cold
+
+        totals.rebuildSeconds += rebuildSeconds;
+        totals.incrementalSeconds += incrementalSeconds;
+        totals.applySeconds += incremental.lastResolve().applySeconds;
+        totals.lpIterations += incremental.lastResolve().lpIterations;
+        totals.kept += incremental.lastResolve().incumbentKept;
+        totals.repaired += incremental.lastResolve().incumbentRepaired;
+        if (rebuilt.status == BatchStatus::Optimal || hot.status == BatchStatus::Optimal) {
+            totals.compared++;
+            bool same = rebuilt.status == hot.status &&
+                std::fabs(rebuilt.objValue - hot.objValue) <= 1e-6 * std::max(1.0, std::fabs(rebuilt.objValue));
+            totals.same += same;
+        }
+    }
+
+    std::printf("%-10s %6d %6d %11.1f %11.1f %9.3f %8.1fx %9lld %5d %5d %4d/%d\n", label.c_str(), data.numRows,
+        data.numCols, totals.rebuildSeconds * 1e3 / rounds, totals.incrementalSeconds * 1e3 / rounds,
+        totals.applySeconds * 1e3 / rounds, totals.rebuildSeconds / std::max(1e-9, totals.incrementalSeconds),
+        totals.lpIterations / rounds, totals.kept, totals.repaired, totals.same, totals.compared);
+}
+
+int main(int argc, const char *argv[])
+{
+    int rounds = argc > 1 ? std::max(1, std::atoi(argv[1])) : 10;
+    int changes = argc > 2 ? std::max(0, std::atoi(argv[2])) : 100;
+    double timeLimit = argc > 3 ? std::atof(argv[3]) : 60.0;
+    std::vector<std::string> files;
+    for (int i = 4; i < argc; i++)
+        files.push_back(argv[i]);
+    if (files.empty()) {
+        for (const char* name : {"p0201", "stein27", "misc06", "air03"})
+            files.push_back(std::string(CBC_DATA_DIR) + "/miplib3/" + name + ".gz");
+    }
+
+    std::printf("%d rounds of %d changes, time limit %g s; times are per round\n", rounds, changes, timeLimit);
+    std::printf("%-10s %6s %6s %11s %11s %9s %9s %9s %5s %5s %6s\n", "model", "rows", "cols", "rebuild(ms)",
+        "hot(ms)", "apply(ms)", "speedup", "root it", "kept", "fixed", "same");
+    for (const std::string& path : files)
+        runModel(path, rounds, changes, timeLimit);
+    return 0;
+}
@@ -0,0 +1,153 @@
+// Throughput of BatchEvaluator (batch_evaluator.h) per kernel and thread
+// count, checked bit for bit against the scalar kernel. The candidates are
+// randomized roundings of the LP solution, the kind of assignment a rounding
+// heuristic produces. The baseline evaluates one solution at a time through
+// the solver's row matrix (CoinPackedMatrix::times), as a heuristic calling
+// back into the solver would.
+//
+//   ./bench_evaluator [batch size] [repeats] [model files...]
+
+#include "CoinPackedMatrix.hpp"
+#include "OsiClpSolverInterface.hpp"
+
+#include "batch_evaluator.h"
+#include "model_reader.h"
+#include "parallel.h"
+#include "problem_instance.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+static bool sameBits(const std::vector<double>& a, const std::vector<double>& b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+}
+
+static bool sameBits(const BatchEvaluation& a, const BatchEvaluation& b)
+{
+    return sameBits(a.objective, b.objective) && sameBits(a.rowViolation, b.rowViolation)
+        && sameBits(a.integralityViolation, b.integralityViolation) && sameBits(a.boundViolation, b.boundViolation)
+        && sameBits(a.activity, b.activity);
+}
+
+// One solution at a time through the solver: row activities, the worst row violation and the objective.
+static double solverBaseline(const OsiSolverInterface& solver, const SolutionBatch& batch, std::vector<double>& worst)
+{
+    const CoinPackedMatrix* byRow = solver.getMatrixByRow();
+    std::vector<double> x(batch.numCols), activity(solver.getNumRows());
+    double sum = 0.0;
+    worst.assign(batch.batchSize, 0.0);
+    for (int b = 0; b < batch.batchSize; b++) {
+        batch.getSolution(b, x.data());
+        byRow->times(x.data(), activity.data());
+        for (int i = 0; i < solver.getNumRows(); i++)
+            worst[b] = std::max(worst[b], std::max(activity[i] - solver.getRowUpper()[i], solver.getRowLower()[i] - activity[i]));
+        double objective = 0.0;
+        for (int j = 0; j < batch.numCols; j++)
+            objective += solver.getObjCoefficients()[j] * x[j];
+        sum += objective;
+    }
+    return sum;
+}
+
+int main(int argc, const char *argv[])
+{
+    int batchSize = argc > 1 ? std::max(1, std::atoi(argv[1])) : 64;
+    int repeats = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+    std::vector<std::string> files;
+    for (int i = 3; i < argc; i++)
+        files.push_back(argv[i]);
+    if (files.empty()) {
+        for (const char* name : {"fast0507", "air04", "nw04", "dano3mip", "mitre", "p0201"})
+            files.push_back(std::string(CBC_DATA_DIR) + "/miplib3/" + name + ".gz");
+    }
+
+    std::vector<EvalKernel> kernels = {EvalKernel::Scalar};
+    if (static_cast<int>(detectEvalKernel()) >= static_cast<int>(EvalKernel::Avx2))
+        kernels.push_back(EvalKernel::Avx2);
+    if (detectEvalKernel() == EvalKernel::Avx512)
+        kernels.push_back(EvalKernel::Avx512);
+    // more than one thread even on a single core, to check the results do not depend on it
+    std::vector<int> threadCounts = {1, std::max(4, defaultThreadCount())};
+
+    std::printf("batch of %d solutions, median of %d\n", batchSize, repeats);
+    std::printf("%-12s %9s %-8s %8s %12s %14s %9s %s\n", "model", "nnz", "kernel", "threads", "batch(ms)",
+        "solutions/s", "speedup", "bits");
+    for (const std::string& path : files) {
+        ProblemInstance data;
+        if (readModelFile(path, data) != 0)
+            continue;
+        OsiClpSolverInterface solver;
+        solver.messageHandler()->setLogLevel(0);
+        solver.setHintParam(OsiDoReducePrint, true, OsiHintTry);
+        loadProblemData(data, solver, false);
+        solver.initialSolve();
+
+        std::mt19937_64 random(42);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        SolutionBatch batch(data.numCols, batchSize);
+        const double* lp = solver.getColSolution();
+        for (int j = 0; j < data.numCols; j++) {
+            for (int b = 0; b < batchSize; b++) {
+                double value = lp[j];
+                if (data.varTypes[j] != 'C')
+                    value = unit(random) < value - std::floor(value) ? std::ceil(value) : std::floor(value);
+                batch.at(j, b) = value;
+            }
+        }
+        std::string name = path.substr(path.find_last_of('/') + 1);
+        name = name.substr(0, name.find('.'));
+
+        std::vector<double> baselineWorst;
+        std::vector<double> times;
+        for (int r = 0; r < repeats; r++) {
+            auto start = std::chrono::steady_clock::now();
+            solverBaseline(solver, batch, baselineWorst);
+            times.push_back(elapsedMs(start));
+        }
+        std::sort(times.begin(), times.end());
+        double baselineMs = times[times.size() / 2];
+        std::printf("%-12s %9d %-8s %8s %12.3f %14.0f %9s %s\n", name.c_str(), data.numNonZeros, "solver", "1",
+            baselineMs, batchSize / baselineMs * 1000.0, "1.00x", "");
+
+        BatchEvaluation reference;
+        BatchEvaluator(data, EvalKernel::Scalar).evaluate(batch, reference, 1, true);
+        for (int b = 0; b < batchSize; b++) {
+            double worst = 0.0;
+            for (int s = 0; s < NumRowSenses; s++)
+                worst = std::max(worst, reference.rowViolation[s * batchSize + b]);
+            if (std::fabs(worst - baselineWorst[b]) > 1e-9 * (1.0 + std::fabs(worst)))
+                std::printf("%s: solution %d violates rows by %g, the solver says %g\n", name.c_str(), b, worst,
+                    baselineWorst[b]);
+        }
+        for (EvalKernel kernel : kernels) {
+            BatchEvaluator evaluator(data, kernel);
+            for (int threads : threadCounts) {
+                BatchEvaluation result;
+                times.clear();
+                bool identical = true;
+                for (int r = 0; r < repeats; r++) {
+                    auto start = std::chrono::steady_clock::now();
+                    evaluator.evaluate(batch, result, threads);
+                    times.push_back(elapsedMs(start));
+                }
+                evaluator.evaluate(batch, result, threads, true);
+                identical = sameBits(result, reference);
+                std::sort(times.begin(), times.end());
+                double ms = times[times.size() / 2];
+                std::printf("%-12s %9d %-8s %8d %12.3f %14.0f %8.2fx %s\n", name.c_str(), data.numNonZeros,
+                    evalKernelName(kernel), threads, ms, batchSize / ms * 1000.0, baselineMs / ms,
+                    identical ? "identical" : "DIFFERENT");
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+// Compares the deep-copying getProblemData against the zero-copy ProblemView
+// on the miplib3 instances bundled with CBC.
+//
+//   ./bench_extract [repeats] [model files...]
+
+#include "OsiClpSolverInterface.hpp"
+
+#include "problem_instance.h"
+#include "problem_view.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// reads every coefficient so the view path pays for touching the data too
+static double checksum(const ProblemView& view)
+{
+    double sum = 0.0;
+    for (double v : view.colCoeffs) sum += v;
+    for (double v : view.objCoeffs) sum += v;
+    for (double v : view.rhs) sum += v;
+    return sum;
+}
+
+static double checksum(const ProblemInstance& data)
+{
+    double sum = 0.0;
+    for (double v : data.colCoeffs) sum += v;
+    for (double v : data.objCoeffs) sum += v;
+    for (double v : data.rhs) sum += v;
+    return sum;
+}
+
+int main(int argc, const char *argv[])
+{
+    int repeats = argc > 1 ? std::atoi(argv[1]) : 5;
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; i++)
+        files.push_back(argv[i]);
+
+    if (files.empty()) {
+        for (const auto& entry : std::filesystem::directory_iterator(std::string(CBC_DATA_DIR) + "/miplib3"))
+            if (entry.path().extension() == ".gz")
+                files.push_back(entry.path().string());
+        std::sort(files.begin(), files.end());
+    }
+
+    std::printf("%-14s %8s %8s %9s %12s %12s %12s %8s\n",
+        "model", "rows", "cols", "nnz", "copy(ms)", "copy+nm(ms)", "view(ms)", "speedup");
+
+    double totalCopy = 0.0, totalView = 0.0;
+    for (const std::string& file : files) {
+        OsiClpSolverInterface solver;
+        solver.messageHandler()->setLogLevel(0);
+        if (solver.readMps(file.c_str(), "") != 0) {
+            std::cout << "Read " << file << " failed" << std::endl;
+            continue;
+        }
+        // build the cached row copy up front, both paths share it
+        solver.getMatrixByRow();
+
+        double copyMs = 1e100, copyNamesMs = 1e100, viewMs = 1e100;
+        double sink = 0.0;
+        for (int r = 0; r < repeats; r++) {
+            auto start = std::chrono::steady_clock::now();
+            ProblemInstance data = getProblemData(solver);
+            sink += checksum(data);
+            copyNamesMs = std::min(copyNamesMs, elapsedMs(start));
+
+            // copy without names, i.e. the part the view replaces one-for-one
+            start = std::chrono::steady_clock::now();
+            ProblemView copied = getProblemView(solver);
+            std::vector<double> lb(copied.lb.begin(), copied.lb.end());
+            std::vector<double> ub(copied.ub.begin(), copied.ub.end());
+            std::vector<double> obj(copied.objCoeffs.begin(), copied.objCoeffs.end());
+            std::vector<double> rhs(copied.rhs.begin(), copied.rhs.end());
+            std::vector<int> rowStart(copied.rowStart.begin(), copied.rowStart.end());
+            std::vector<int> colIdxs(copied.colIdxs.begin(), copied.colIdxs.end());
+            std::vector<double> colCoeffs(copied.colCoeffs.begin(), copied.colCoeffs.end());
+            sink += colCoeffs.empty() ? 0.0 : colCoeffs[0] + lb[0] + ub[0] + obj[0] + rowStart.back() + colIdxs[0];
+            sink += rhs.empty() ? 0.0 : rhs[0];
+            copyMs = std::min(copyMs, elapsedMs(start));
+
+            start = std::chrono::steady_clock::now();
+            ProblemView view = getProblemView(solver);
+            sink += checksum(view);
+            viewMs = std::min(viewMs, elapsedMs(start));
+        }
+
+        std::string name = std::filesystem::path(file).stem().string();
+        std::printf("%-14s %8d %8d %9d %12.3f %12.3f %12.3f %7.1fx\n",
+            name.c_str(), solver.getNumRows(), solver.getNumCols(), solver.getNumElements(),
+            copyMs, copyNamesMs, viewMs, copyNamesMs / std::max(viewMs, 1e-6));
+        totalCopy += copyNamesMs;
+        totalView += viewMs;
+        if (sink == 42.4242) std::cout << "";
+    }
+
+    std::printf("total: getProblemData %.3f ms, getProblemView %.3f ms\n", totalCopy, totalView);
+    return 0;
+}
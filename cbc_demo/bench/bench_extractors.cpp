@@ -0,0 +1,164 @@
+// Model extraction through ModelExtractor (model_extractor.h) on the
+// miplib3 instances bundled with CBC. Each model is extracted from Clp,
+// recorded as a snapshot and replayed by ScriptedExtractor with a simulated
+// cost per backend call, three ways: the rows in one call (CPXXgetrows,
+// getMatrixByRow), one call per row (GRBModel::getRow), and one call per
+// coefficient, the rows x cols probe loop the Gurobi demo used to run. The
+// probe is skipped above 4M row/column pairs, and its cost estimated from
+// the calls it would make. Every extraction is checked against the recording.
+//
+//   ./bench_extractors [latency in microseconds=1] [model files...]
+
+#include "OsiClpSolverInterface.hpp"
+
+#include "model_extractor.h"
+#include "model_reader.h"
+#include "name_table.h"
+#include "problem_instance.h"
+#include "scripted_extractor.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+static const double kMaxProbes = 4e6;
+
+template <typename A, typename B>
+static bool sameArray(const A& a, const B& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+static bool sameNames(const NameTable& a, const NameTable& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (int i = 0; i < a.size(); i++)
+        if (a[i] != b[i])
+            return false;
+    return true;
+}
+
+static bool sameInstance(const ProblemInstance& a, const ProblemInstance64& b)
+{
+    return a.numCols == b.numCols && a.numRows == b.numRows && a.numNonZeros == b.numNonZeros
+        && a.objSense == b.objSense && a.objOffset == b.objOffset && sameArray(a.varTypes, b.varTypes)
+        && sameArray(a.lb, b.lb) && sameArray(a.ub, b.ub) && sameArray(a.objCoeffs, b.objCoeffs)
+        && sameArray(a.rowtypes, b.rowtypes) && sameArray(a.rhs, b.rhs) && sameArray(a.rhsrange, b.rhsrange)
+        && sameArray(a.rowStart, b.rowStart) && sameArray(a.colIdxs, b.colIdxs)
+        && sameArray(a.colCoeffs, b.colCoeffs) && sameNames(a.colName, b.colName)
+        && sameNames(a.rowName, b.rowName);
+}
+
+// The old extraction: one coefficient call per row and column.
+static bool probeMatrix(ScriptedExtractor& source, const ProblemInstance64& recording)
+{
+    std::vector<std::int64_t> rowStart(1, 0);
+    std::vector<int> colIdxs;
+    std::vector<double> colCoeffs;
+    for (int i = 0; i < recording.numRows; i++) {
+        for (int j = 0; j < recording.numCols; j++) {
+            double coeff = source.coefficient(i, j);
+            if (coeff != 0) {
+                colIdxs.push_back(j);
+                colCoeffs.push_back(coeff);
+            }
+        }
+        rowStart.push_back(static_cast<std::int64_t>(colIdxs.size()));
+    }
+    return sameArray(rowStart, recording.rowStart) && sameArray(colIdxs, recording.colIdxs)
+        && sameArray(colCoeffs, recording.colCoeffs);
+}
+
+int main(int argc, const char *argv[])
+{
+    double latency = (argc > 1 ? std::atof(argv[1]) : 1.0) * 1e-6;
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; i++)
+        files.push_back(argv[i]);
+    if (files.empty()) {
+        for (const auto& entry : std::filesystem::directory_iterator(std::string(CBC_DATA_DIR) + "/miplib3"))
+            if (entry.path().extension() == ".gz")
+                files.push_back(entry.path().string());
+        std::sort(files.begin(), files.end());
+    }
+    std::string snapshotPath = (std::filesystem::temp_directory_path() / "bench_extractors.snap").string();
+
+    std::printf("%-10s %6s %6s %7s | %8s | %8s %9s | %8s %9s | %10s %10s\n", "model", "rows", "cols", "nnz",
+        "osi(ms)", "bulk(ms)", "calls", "rows(ms)", "calls", "probe(ms)", "calls");
+    int mismatches = 0, checked = 0;
+    for (const std::string& file : files) {
+        ProblemInstance read;
+        if (readModelFile(file, read) != 0)
+            continue;
+        OsiClpSolverInterface solver;
+        solver.messageHandler()->setLogLevel(0);
+        loadProblemData(read, solver);
+
+        auto start = std::chrono::steady_clock::now();
+        OsiModelExtractor osi(solver);
+        ProblemInstance data;
+        bool ok = extractProblemData(osi, data);
+        double osiMs = elapsedMs(start);
+        ProblemInstance reference = getProblemData(solver);
+        ok = ok && sameInstance(data, widenProblemInstance(reference));
+
+        ScriptedExtractor scripted;
+        ok = ok && recordModel(osi, snapshotPath) && scripted.open(snapshotPath);
+        scripted.setCallLatency(latency);
+        double ms[2];
+        long calls[2];
+        for (int perRow = 0; perRow < 2; perRow++) {
+            scripted.setRowsPerCall(perRow);
+            scripted.resetCalls();
+            start = std::chrono::steady_clock::now();
+            ProblemInstance replayed;
+            ok = ok && extractProblemData(scripted, replayed) && sameInstance(replayed, scripted.recording());
+            ms[perRow] = elapsedMs(start);
+            calls[perRow] = scripted.numCalls();
+        }
+
+        double probes = static_cast<double>(data.numRows) * data.numCols;
+        char probeMs[32] = "-";
+        if (probes <= kMaxProbes) {
+            scripted.resetCalls();
+            start = std::chrono::steady_clock::now();
+            ok = ok && probeMatrix(scripted, scripted.recording());
+            std::snprintf(probeMs, sizeof(probeMs), "%.3f", elapsedMs(start));
+        } else {
+            std::snprintf(probeMs, sizeof(probeMs), "~%.0f", probes * latency * 1e3);
+        }
+
+        std::printf("%-10s %6d %6d %7d | %8.3f | %8.3f %9ld | %8.3f %9ld | %10s %10.0f\n",
+            std::filesystem::path(file).stem().stem().string().c_str(), data.numRows, data.numCols,
+            data.numNonZeros, osiMs, ms[0], calls[0], ms[1], calls[1], probeMs, probes);
+        checked++;
+        if (!ok) {
+            std::printf("%s: extraction DIFFERS from the recording\n", file.c_str());
+            mismatches++;
+        }
+    }
+
+    // error paths: a failing call fails the extraction, except the name calls, which only drop the names
+    ScriptedExtractor faulty;
+    int caught = 0, calls = 0;
+    if (faulty.open(snapshotPath)) {
+        ProblemInstance data;
+        extractProblemData(faulty, data);
+        calls = static_cast<int>(faulty.numCalls());
+        for (int call = 0; call < calls; call++) {
+            faulty.resetCalls();
+            faulty.setFailingCall(call);
+            caught += !extractProblemData(faulty, data);
+        }
+    }
+    std::filesystem::remove(snapshotPath);
+    std::printf("%d models, %s; %d of %d failing backend calls failed the extraction (2 are the names)\n",
+        checked, mismatches == 0 ? "every extraction matches" : "extractions DIFFER", caught, calls);
+    return mismatches == 0 ? 0 : 1;
+}
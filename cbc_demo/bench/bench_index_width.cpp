@@ -0,0 +1,186 @@
+// Memory and bandwidth cost of 32 against 64-bit nonzero offsets
+// (ProblemInstance against ProblemInstance64) on a generated model:
+// bytes held, transpose, batch evaluation, snapshot write and open, and the
+// load into Clp, where the 64-bit model is narrowed on the way. A last
+// table times a plain row-activity pass with 32 and 64-bit column indices,
+// the cost of widening those too, which the 64-bit instance does not do.
+//
+//   ./bench_index_width [rows=1000000] [nonzeros per row=16] [snapshot dir=/tmp]
+
+#include "OsiClpSolverInterface.hpp"
+
+#include "batch_evaluator.h"
+#include "model_builder.h"
+#include "problem_instance.h"
+#include "problem_snapshot.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+// rows x perRow random nonzeros over as many columns as rows, a third of them integer
+static ProblemInstance generate(int rows, int perRow)
+{
+    ModelBuilder builder;
+    builder.reserve(rows, rows, rows * perRow);
+    std::mt19937_64 random(5);
+    std::uniform_int_distribution<int> pickCol(0, rows - 1);
+    std::uniform_real_distribution<double> coeff(-10.0, 10.0);
+    for (int j = 0; j < rows; j++)
+        builder.addVar(0.0, 10.0, coeff(random), j % 3 == 0 ? 'I' : 'C');
+    LinExpr row;
+    row.reserve(perRow);
+    for (int i = 0; i < rows; i++) {
+        row.clear();
+        for (int k = 0; k < perRow; k++)
+            row.add(pickCol(random), coeff(random));
+        builder.addConstr(row <= 100.0);
+    }
+    return builder.release();
+}
+
+template <typename Offset>
+static std::size_t csrBytes(const BasicProblemInstance<Offset>& data)
+{
+    return data.rowStart.size() * sizeof(Offset) + data.colIdxs.size() * sizeof(int) +
+        data.colCoeffs.size() * sizeof(double);
+}
+
+template <typename Offset>
+static std::size_t cscBytes(const BasicColumnMajor<Offset>& columns)
+{
+    return columns.colStart.size() * sizeof(Offset) + columns.rowIdxs.size() * sizeof(int) +
+        columns.rowCoeffs.size() * sizeof(double);
+}
+
+struct WidthResult
+{
+    std::size_t csrBytes = 0;
+    std::size_t cscBytes = 0;
+    std::uintmax_t snapshotBytes = 0;
+    double transposeSeconds = 0.0;
+    double evaluateSeconds = 0.0;
+    double writeSeconds = 0.0;
+    double openSeconds = 0.0;
+    double loadSeconds = 0.0;
+    double objective = 0.0; // of the first solution, to check both widths agree
+};
+
+template <typename Instance>
+static WidthResult measure(const Instance& data, const SolutionBatch& batch, const std::string& snapshotPath)
+{
+    WidthResult result;
+    result.csrBytes = csrBytes(data);
+
+    auto start = std::chrono::steady_clock::now();
+    auto columns = data.columns();
+    result.transposeSeconds = secondsSince(start);
+    result.cscBytes = cscBytes(*columns);
+
+    BatchEvaluator evaluator(data);
+    BatchEvaluation evaluation;
+    const int repeats = 5;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++)
+        evaluator.evaluate(batch, evaluation);
+    result.evaluateSeconds = secondsSince(start) / repeats;
+    result.objective = evaluation.objective[0];
+
+    start = std::chrono::steady_clock::now();
+    writeSnapshot(data, snapshotPath);
+    result.writeSeconds = secondsSince(start);
+    result.snapshotBytes = std::filesystem::file_size(snapshotPath);
+    ProblemSnapshot snapshot;
+    start = std::chrono::steady_clock::now();
+    snapshot.open(snapshotPath);
+    result.openSeconds = secondsSince(start);
+    snapshot.close();
+    std::filesystem::remove(snapshotPath);
+
+    OsiClpSolverInterface solver;
+    solver.messageHandler()->setLogLevel(0);
+    start = std::chrono::steady_clock::now();
+    loadProblemData(data, solver, false);
+    result.loadSeconds = secondsSince(start);
+    return result;
+}
+
+// One solution, activity of every row; Index is the column index type.
+template <typename Index>
+static double rowActivities(const std::vector<std::int64_t>& rowStart, const std::vector<Index>& colIdxs,
+    const std::vector<double>& coeffs, const std::vector<double>& x, std::vector<double>& activity)
+{
+    double sum = 0.0;
+    for (std::size_t i = 0; i + 1 < rowStart.size(); i++) {
+        double value = 0.0;
+        for (std::int64_t k = rowStart[i]; k < rowStart[i + 1]; k++)
+            value += coeffs[k] * x[colIdxs[k]];
+        activity[i] = value;
+        sum += value;
+    }
+    return sum;
+}
+
+int main(int argc, const char *argv[])
+{
+    int rows = argc > 1 ? std::max(1, std::atoi(argv[1])) : 1000000;
+    int perRow = argc > 2 ? std::max(1, std::atoi(argv[2])) : 16;
+    std::string dir = argc > 3 ? argv[3] : "/tmp";
+
+    auto start = std::chrono::steady_clock::now();
+    ProblemInstance narrow = generate(rows, perRow);
+    std::printf("generated %d rows, %d cols, %d nonzeros in %.2f s\n", narrow.numRows, narrow.numCols,
+        narrow.numNonZeros, secondsSince(start));
+    ProblemInstance64 wide = widenProblemInstance(narrow);
+
+    SolutionBatch batch(narrow.numCols, 8);
+    std::mt19937_64 random(7);
+    std::uniform_real_distribution<double> value(0.0, 10.0);
+    for (double& v : batch.values)
+        v = value(random);
+
+    WidthResult results[2] = {measure(narrow, batch, dir + "/bench_index_width32.snap"),
+        measure(wide, batch, dir + "/bench_index_width64.snap")};
+
+    std::printf("\n%-8s %9s %9s %9s %12s %13s %10s %9s %9s %9s\n", "offsets", "csr(MB)", "csc(MB)", "snap(MB)",
+        "transpose(s)", "evaluate(ms)", "eval GB/s", "write(s)", "open(s)", "load(s)");
+    const char* names[2] = {"32-bit", "64-bit"};
+    for (int w = 0; w < 2; w++) {
+        const WidthResult& r = results[w];
+        std::printf("%-8s %9.1f %9.1f %9.1f %12.3f %13.2f %10.2f %9.3f %9.3f %9.3f\n", names[w],
+            r.csrBytes / 1048576.0, r.cscBytes / 1048576.0, r.snapshotBytes / 1048576.0, r.transposeSeconds,
+            r.evaluateSeconds * 1e3, r.csrBytes / r.evaluateSeconds / 1e9, r.writeSeconds, r.openSeconds,
+            r.loadSeconds);
+    }
+    std::printf("same objective: %s\n", results[0].objective == results[1].objective ? "yes" : "NO");
+
+    // the cost of 64-bit column indices on top
+    std::vector<std::int64_t> rowStart(wide.rowStart.begin(), wide.rowStart.end());
+    std::vector<int> cols32(narrow.colIdxs.begin(), narrow.colIdxs.end());
+    std::vector<std::int64_t> cols64(narrow.colIdxs.begin(), narrow.colIdxs.end());
+    std::vector<double> coeffs(narrow.colCoeffs.begin(), narrow.colCoeffs.end());
+    std::vector<double> x(narrow.numCols), activity(narrow.numRows);
+    for (double& v : x)
+        v = value(random);
+    std::printf("\n%-14s %12s %12s %10s\n", "column index", "matrix(MB)", "pass(ms)", "GB/s");
+    double sums[2];
+    for (int w = 0; w < 2; w++) {
+        const int repeats = 5;
+        std::size_t bytes = rowStart.size() * 8 + coeffs.size() * (8 + (w == 0 ? 4 : 8));
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repeats; r++)
+            sums[w] = w == 0 ? rowActivities(rowStart, cols32, coeffs, x, activity)
+                             : rowActivities(rowStart, cols64, coeffs, x, activity);
+        double seconds = secondsSince(start) / repeats;
+        std::printf("%-14s %12.1f %12.2f %10.2f\n", w == 0 ? "32-bit" : "64-bit", bytes / 1048576.0,
+            seconds * 1e3, bytes / seconds / 1e9);
+    }
+    return results[0].objective == results[1].objective && sums[0] == sums[1] ? 0 : 1;
+}
@@ -0,0 +1,159 @@
+// Memory per name and name -> index lookup latency of NameTable (name_table.h)
+// against one std::string per name with a std::map index, the way the cbc
+// driver resolves setMIPStart names, and with a std::unordered_map index.
+// Names come from the largest miplib3 models and from synthetic models with
+// short (fits std::string's inline buffer) and long names.
+//
+//   ./bench_names [synthetic names] [lookups] [model files...]
+
+#include "model_reader.h"
+#include "name_table.h"
+#include "problem_instance.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+// Bytes currently allocated from the heap, 0 where malloc cannot tell.
+static double heapBytes()
+{
+#ifdef __GLIBC__
+    struct mallinfo2 info = mallinfo2();
+    return static_cast<double>(info.uordblks + info.hblkhd);
+#else
+    return 0.0;
+#endif
+}
+
+struct Result
+{
+    double bytesPerName = 0.0;
+    double buildMs = 0.0;
+    double lookupNs = 0.0;
+    long long checksum = 0;
+};
+
+template <typename Map>
+static Result runStrings(const std::vector<std::string>& source, const std::vector<std::string>& queries)
+{
+    Result result;
+    double before = heapBytes();
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::string> names(source.begin(), source.end());
+        Map index;
+        for (int i = 0; i < static_cast<int>(names.size()); i++)
+            index.emplace(names[i], i);
+        result.buildMs = elapsedMs(start);
+        result.bytesPerName = (heapBytes() - before) / names.size();
+
+        start = std::chrono::steady_clock::now();
+        for (const std::string& query : queries) {
+            auto it = index.find(query);
+            result.checksum += it == index.end() ? -1 : it->second;
+        }
+        result.lookupNs = elapsedMs(start) * 1e6 / queries.size();
+    }
+    return result;
+}
+
+static Result runNameTable(const std::vector<std::string>& source, const std::vector<std::string>& queries)
+{
+    Result result;
+    double before = heapBytes();
+    auto start = std::chrono::steady_clock::now();
+    {
+        NameTable names;
+        std::size_t chars = 0;
+        for (const std::string& name : source)
+            chars += name.size();
+        names.reserve(static_cast<int>(source.size()), chars);
+        for (const std::string& name : source)
+            names.push_back(name);
+        names.find(""); // builds the index
+        result.buildMs = elapsedMs(start);
+        result.bytesPerName = (heapBytes() - before) / names.size();
+
+        start = std::chrono::steady_clock::now();
+        for (const std::string& query : queries)
+            result.checksum += names.find(query);
+        result.lookupNs = elapsedMs(start) * 1e6 / queries.size();
+    }
+    return result;
+}
+
+static void report(const std::string& label, const std::vector<std::string>& names, int numLookups)
+{
+    std::mt19937_64 random(7);
+    std::vector<std::string> queries;
+    queries.reserve(numLookups);
+    std::uniform_int_distribution<std::size_t> pick(0, names.size() - 1);
+    for (int q = 0; q < numLookups; q++)
+        queries.push_back(names[pick(random)]);
+
+    double averageLength = 0.0;
+    for (const std::string& name : names)
+        averageLength += name.size();
+    averageLength /= names.size();
+
+    Result ordered = runStrings<std::map<std::string, int>>(names, queries);
+    Result hashed = runStrings<std::unordered_map<std::string, int>>(names, queries);
+    Result table = runNameTable(names, queries);
+    if (ordered.checksum != table.checksum || hashed.checksum != table.checksum)
+        std::printf("%s: lookups DIFFER\n", label.c_str());
+
+    const char* rowFormat = "%-16s %9zu %6.1f %-22s %10.1f %10.1f %11.1f\n";
+    std::printf(rowFormat, label.c_str(), names.size(), averageLength, "string + std::map", ordered.bytesPerName,
+        ordered.buildMs, ordered.lookupNs);
+    std::printf(rowFormat, label.c_str(), names.size(), averageLength, "string + unordered_map",
+        hashed.bytesPerName, hashed.buildMs, hashed.lookupNs);
+    std::printf(rowFormat, label.c_str(), names.size(), averageLength, "NameTable", table.bytesPerName,
+        table.buildMs, table.lookupNs);
+}
+
+int main(int argc, const char *argv[])
+{
+    int numSynthetic = argc > 1 ? std::max(1, std::atoi(argv[1])) : 2000000;
+    int numLookups = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1000000;
+    std::vector<std::string> files;
+    for (int i = 3; i < argc; i++)
+        files.push_back(argv[i]);
+    if (files.empty()) {
+        for (const char* name : {"nw04", "fast0507", "air05"})
+            files.push_back(std::string(CBC_DATA_DIR) + "/miplib3/" + name + ".gz");
+    }
+
+    std::printf("%d lookups of random existing names\n", numLookups);
+    std::printf("%-16s %9s %6s %-22s %10s %10s %11s\n", "names", "count", "chars", "storage", "bytes/name",
+        "build(ms)", "lookup(ns)");
+    for (const std::string& path : files) {
+        ProblemInstance data;
+        if (readModelFile(path, data) != 0 || data.colName.empty())
+            continue;
+        std::string label = path.substr(path.find_last_of('/') + 1);
+        label = label.substr(0, label.find('.'));
+        std::vector<std::string> names = data.colName.toStrings();
+        data = ProblemInstance(); // only the copies are measured
+        report(label, names, numLookups);
+    }
+
+    std::vector<std::string> names(numSynthetic);
+    for (int i = 0; i < numSynthetic; i++)
+        names[i] = "x" + std::to_string(i);
+    report("synthetic short", names, numLookups);
+    for (int i = 0; i < numSynthetic; i++)
+        names[i] = "flow[" + std::to_string(i % 1000) + ",node" + std::to_string(i / 1000) + ",t1]";
+    report("synthetic long", names, numLookups);
+    return 0;
+}
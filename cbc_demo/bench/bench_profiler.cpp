@@ -0,0 +1,151 @@
+// Measures the component profiler (component_profiler.h) on model files,
+// by default miplib3 instances bundled with CBC, each with the standard
+// generators and heuristics: a plain solve, an adaptive solve that learns and
+// stores a profile, and a solve with that profile preloaded. Prints the time
+// to optimal of each and checks the objectives agree. A run stopped by the
+// time limit is marked with * and left out of the speedups and the totals.
+//
+//   ./bench_profiler [time limit] [model files...]
+
+#include "CbcModel.hpp"
+#include "OsiClpSolverInterface.hpp"
+
+#include "component_profiler.h"
+#include "fingerprint.h"
+#include "model_reader.h"
+#include "problem_instance.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct SolveStats
+{
+    double seconds = 0.0;
+    bool optimal = false;
+    int nodes = 0;
+    double objective = 0.0;
+    int disabled = 0;
+    int throttled = 0;
+};
+
+static SolveStats solve(const ProblemInstance& data, double timeLimit, ComponentProfiler* profiler)
+{
+    OsiClpSolverInterface solver;
+    solver.messageHandler()->setLogLevel(0);
+    loadProblemData(data, solver);
+
+    auto start = std::chrono::steady_clock::now();
+    CbcModel model(solver);
+    model.setLogLevel(0);
+    model.setUseElapsedTime(true);
+    model.setMaximumSeconds(timeLimit);
+    addStandardComponents(model);
+    if (profiler)
+        profiler->attach(model);
+    model.branchAndBound();
+    if (profiler)
+        profiler->finish(model);
+
+    SolveStats stats;
+    stats.seconds = secondsSince(start);
+    stats.optimal = model.isProvenOptimal();
+    stats.nodes = model.getNodeCount();
+    stats.objective = model.bestSolution() ? model.getObjValue() : NAN;
+    if (profiler) {
+        stats.disabled = profiler->numDisabled();
+        stats.throttled = profiler->numThrottled();
+    }
+    return stats;
+}
+
+// NAN is no solution, which agrees with itself
+static bool sameObjective(double a, double b)
+{
+    if (std::isnan(a) || std::isnan(b))
+        return std::isnan(a) && std::isnan(b);
+    return std::fabs(a - b) <= 1e-6 * std::max(1.0, std::fabs(a));
+}
+
+static void printSpeedup(const SolveStats& plain, const SolveStats& run)
+{
+    if (plain.optimal && run.optimal)
+        std::printf(" %7.2fx", plain.seconds / std::max(1e-9, run.seconds));
+    else
+        std::printf(" %8s", "-");
+}
+
+int main(int argc, const char *argv[])
+{
+    double timeLimit = argc > 1 ? std::atof(argv[1]) : 60.0;
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; i++)
+        files.push_back(argv[i]);
+    if (files.empty()) {
+        for (const char* name : {"p0201", "p0282", "lseu", "stein27", "vpm2", "bell5", "misc03", "fiber"})
+            files.push_back(std::string(CBC_DATA_DIR) + "/miplib3/" + name + ".gz");
+    }
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "bench_profiler";
+    std::filesystem::remove_all(directory);
+
+    std::printf("%-10s | %9s %7s | %9s %7s %4s %4s | %9s %7s %4s %4s | %8s %8s\n", "model", "plain(s)", "nodes",
+        "adapt(s)", "nodes", "off", "thr", "known(s)", "nodes", "off", "thr", "adapt", "known");
+    double total[3] = {0.0, 0.0, 0.0};
+    int mismatches = 0, stopped = 0;
+    for (const std::string& path : files) {
+        ProblemInstance data;
+        if (readModelFile(path, data) != 0)
+            continue;
+        std::string name = std::filesystem::path(path).stem().stem().string();
+        std::uint64_t fingerprint = structuralFingerprint(data);
+
+        SolveStats plain = solve(data, timeLimit, nullptr);
+        ComponentProfiler learning;
+        SolveStats adaptive = solve(data, timeLimit, &learning);
+        learning.store(directory.string(), fingerprint);
+        ComponentProfiler known;
+        if (!known.preload(directory.string(), fingerprint))
+            std::printf("%s: profile not found\n", name.c_str());
+        SolveStats preloaded = solve(data, timeLimit, &known);
+
+        auto mark = [](const SolveStats& run) { return run.optimal ? ' ' : '*'; };
+        std::printf("%-10s | %8.3f%c %7d | %8.3f%c %7d %4d %4d | %8.3f%c %7d %4d %4d |", name.c_str(),
+            plain.seconds, mark(plain), plain.nodes, adaptive.seconds, mark(adaptive), adaptive.nodes,
+            adaptive.disabled, adaptive.throttled, preloaded.seconds, mark(preloaded), preloaded.nodes,
+            preloaded.disabled, preloaded.throttled);
+        printSpeedup(plain, adaptive);
+        printSpeedup(plain, preloaded);
+        std::printf("\n");
+        if (path == files.back())
+            known.print(std::cout);
+        if (!plain.optimal || !adaptive.optimal || !preloaded.optimal) {
+            stopped++;
+            continue; // objectives at a time limit need not agree
+        }
+        total[0] += plain.seconds;
+        total[1] += adaptive.seconds;
+        total[2] += preloaded.seconds;
+        for (const SolveStats* run : {&adaptive, &preloaded}) {
+            if (!sameObjective(plain.objective, run->objective)) {
+                std::printf("%s: objective %.10g plain vs %.10g profiled\n", name.c_str(), plain.objective,
+                    run->objective);
+                mismatches++;
+            }
+        }
+    }
+    std::printf("total: plain %.3f s, adaptive %.3f s (%.2fx), preloaded %.3f s (%.2fx)", total[0], total[1],
+        total[0] / std::max(1e-9, total[1]), total[2], total[0] / std::max(1e-9, total[2]));
+    if (stopped > 0)
+        std::printf(", %d models at the time limit left out", stopped);
+    std::printf("\n");
+    std::filesystem::remove_all(directory);
+    return mismatches == 0 ? 0 : 1;
+}
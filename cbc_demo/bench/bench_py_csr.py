@@ -0,0 +1,136 @@
+"""
+CSR of a model in Python: get_csr_matrix (cplex_py_demo/utils.py), which
+builds lists row by row from linear_constraints.get_rows(), against the
+zero-copy buffers of the cbc_py module (python/cbc_py.cpp).
+
+    PYTHONPATH=build python3 bench/bench_py_csr.py [--rows N] [model files...]
+
+--rows adds a synthetic LP with N rows of 8 nonzeros (default 200000), since
+the list building costs per row and the bundled models have few rows.
+
+Without CPLEX the rows come from a stand-in that returns the same
+SparsePair-like objects as get_rows(); building them is timed on its own,
+as "get_rows", and is part of what get_csr_matrix costs with CPLEX.
+"access" is get_rows plus the list building over model.csr(); reading the
+file ("read") is left out of it, as CPLEX reads the model before either.
+"""
+import importlib.util
+import os
+import random
+import sys
+import tempfile
+import time
+
+import cbc_py
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+DATA_DIR = os.path.join(HERE, "..", "third_party", "Cbc", "Cbc-releases.2.10.9-x86_64-ubuntu20-gcc940",
+                        "share", "coin", "Data", "miplib3")
+
+
+def load_get_csr_matrix():
+    path = os.path.join(HERE, "..", "..", "cplex_py_demo", "utils.py")
+    spec = importlib.util.spec_from_file_location("cplex_utils", path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module.get_csr_matrix
+
+
+class SparsePair:
+    __slots__ = ("ind", "val")
+
+    def __init__(self, ind, val):
+        self.ind = ind
+        self.val = val
+
+
+class StandInModel:
+    """Just enough of cplex.Cplex for get_csr_matrix."""
+
+    class LinearConstraints:
+        def __init__(self, rows):
+            self.rows = rows
+
+        def get_rows(self):
+            return self.rows
+
+    def __init__(self, rows):
+        self.linear_constraints = StandInModel.LinearConstraints(rows)
+
+
+def stand_in_rows(model):
+    row_start, col_idx, col_val = model.csr()
+    starts = row_start.tolist()
+    idx = col_idx.tolist()
+    val = col_val.tolist()
+    return [SparsePair(idx[starts[i]:starts[i + 1]], val[starts[i]:starts[i + 1]])
+            for i in range(model.num_rows)]
+
+
+def write_synthetic(path, num_rows, num_cols=100000, per_row=8):
+    rng = random.Random(7)
+    with open(path, "w") as out:
+        out.write("Minimize\n obj: x0\nSubject To\n")
+        for i in range(num_rows):
+            cols = sorted(rng.sample(range(num_cols), per_row))
+            out.write(" c%d: %s <= %d\n" % (i, " + ".join("%d x%d" % (rng.randint(1, 9), j) for j in cols), per_row))
+        out.write("End\n")
+
+
+def seconds(fn):
+    start = time.perf_counter()
+    value = fn()
+    return time.perf_counter() - start, value
+
+
+def main():
+    get_csr_matrix = load_get_csr_matrix()
+    try:
+        import numpy
+    except ImportError:
+        numpy = None
+    try:
+        import cplex
+    except ImportError:
+        cplex = None
+
+    args = sys.argv[1:]
+    num_rows = 200000
+    if len(args) >= 2 and args[0] == "--rows":
+        num_rows = int(args[1])
+        args = args[2:]
+    paths = args or [os.path.join(DATA_DIR, name + ".gz") for name in ("air05", "fast0507", "nw04")]
+    temp_dir = tempfile.TemporaryDirectory()
+    if num_rows > 0:
+        paths.append(os.path.join(temp_dir.name, "synthetic.lp"))
+        write_synthetic(paths[-1], num_rows)
+
+    print("%-10s %8s %9s %10s %10s %10s %10s %10s %10s" % ("model", "rows", "nonzeros", "get_rows", "lists(s)",
+                                                        "read(s)", "csr(ms)", "numpy(ms)", "access"))
+    for path in paths:
+        name = os.path.basename(path).split(".")[0]
+        read_time, model = seconds(lambda: cbc_py.Model(path))
+
+        if cplex:
+            cpx = cplex.Cplex(path)
+            cpx.set_results_stream(None)
+            rows_time = 0.0
+        else:
+            rows_time, rows = seconds(lambda: stand_in_rows(model))
+            cpx = StandInModel(rows)
+        lists_time, (row_ptr, col_ind, col_val) = seconds(lambda: get_csr_matrix(cpx))
+
+        csr_time, (row_start, col_idx, val) = seconds(model.csr)
+        numpy_time = float("nan")
+        if numpy:
+            numpy_time, arrays = seconds(lambda: [numpy.asarray(view) for view in (row_start, col_idx, val)])
+        if row_start.tolist() != row_ptr or col_idx.tolist() != col_ind or val.tolist() != col_val:
+            print("%s: CSR DIFFERS" % name)
+
+        print("%-10s %8d %9d %10.3f %10.3f %10.3f %10.4f %10.4f %9.0fx" % (
+            name, model.num_rows, model.num_nonzeros, rows_time, lists_time, read_time, csr_time * 1e3,
+            numpy_time * 1e3, (rows_time + lists_time) / max(csr_time, 1e-9)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,138 @@
+// Validates the native MPS/LP reader against CoinMpsIO/CoinLpIO on every model
+// in Data/Sample and Data/miplib3, and reports the throughput of both in MB/s
+// (of uncompressed text, gzip inflation included in both timings).
+//
+//   ./bench_reader [threads] [model files...]
+
+#include "OsiClpSolverInterface.hpp"
+
+#include "model_reader.h"
+#include "parallel.h"
+#include "problem_instance.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static bool close(double a, double b)
+{
+    return a == b || std::fabs(a - b) <= 1e-12 * std::max(std::fabs(a), std::fabs(b));
+}
+
+// Compares by names, so a different column order is not a mismatch. Returns "" if equal.
+static std::string compareInstances(const ProblemInstance& ref, const ProblemInstance& got)
+{
+    std::ostringstream diff;
+    if (ref.numRows != got.numRows || ref.numCols != got.numCols || ref.numNonZeros != got.numNonZeros) {
+        diff << "size " << ref.numRows << "x" << ref.numCols << "/" << ref.numNonZeros << " vs "
+             << got.numRows << "x" << got.numCols << "/" << got.numNonZeros;
+        return diff.str();
+    }
+    if (ref.objSense != got.objSense || !close(ref.objOffset, got.objOffset))
+        return "objective sense or offset";
+
+    std::vector<int> colMap(ref.numCols);
+    for (int j = 0; j < ref.numCols; j++) {
+        int k = colMap[j] = got.colName.find(ref.colName[j]);
+        if (k < 0)
+            return "missing column " + std::string(ref.colName[j]);
+        if (!close(ref.lb[j], got.lb[k]) || !close(ref.ub[j], got.ub[k]) || !close(ref.objCoeffs[j], got.objCoeffs[k])
+            || ref.varTypes[j] != got.varTypes[k])
+            return "column " + std::string(ref.colName[j]);
+    }
+
+    std::vector<std::pair<int, double>> a, b;
+    for (int i = 0; i < ref.numRows; i++) {
+        int k = got.rowName.find(ref.rowName[i]);
+        if (k < 0)
+            return "missing row " + std::string(ref.rowName[i]);
+        if (ref.rowtypes[i] != got.rowtypes[k] || !close(ref.rhs[i], got.rhs[k]) || !close(ref.rhsrange[i], got.rhsrange[k]))
+            return "row bounds " + std::string(ref.rowName[i]);
+
+        a.clear();
+        b.clear();
+        for (int p = ref.rowStart[i]; p < ref.rowStart[i + 1]; p++)
+            a.emplace_back(colMap[ref.colIdxs[p]], ref.colCoeffs[p]);
+        for (int p = got.rowStart[k]; p < got.rowStart[k + 1]; p++)
+            b.emplace_back(got.colIdxs[p], got.colCoeffs[p]);
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        if (a.size() != b.size())
+            return "row length " + std::string(ref.rowName[i]);
+        for (std::size_t p = 0; p < a.size(); p++)
+            if (a[p].first != b[p].first || !close(a[p].second, b[p].second))
+                return "row entries " + std::string(ref.rowName[i]);
+    }
+    return "";
+}
+
+int main(int argc, const char *argv[])
+{
+    int numThreads = argc > 1 ? std::atoi(argv[1]) : defaultThreadCount();
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; i++)
+        files.push_back(argv[i]);
+
+    if (files.empty()) {
+        for (const char* dir : {"/Sample", "/miplib3"}) {
+            for (const auto& entry : std::filesystem::directory_iterator(std::string(CBC_DATA_DIR) + dir)) {
+                std::string path = entry.path().string();
+                if (endsWith(path, ".mps") || endsWith(path, ".lp") || endsWith(path, ".gz"))
+                    files.push_back(path);
+            }
+        }
+        std::sort(files.begin(), files.end());
+    }
+
+    std::printf("%-16s %10s %12s %12s %8s  %s\n", "model", "size(KB)", "coin(MB/s)", "native(MB/s)", "speedup", "check");
+    int mismatches = 0;
+    double totalBytes = 0.0, totalCoin = 0.0, totalNative = 0.0;
+    for (const std::string& file : files) {
+        std::string name = std::filesystem::path(file).filename().string();
+        bool isLp = endsWith(file, ".lp");
+
+        std::string text;
+        if (!readTextFile(file, text))
+            continue;
+        double megabytes = text.size() / 1e6;
+
+        OsiClpSolverInterface solver;
+        solver.messageHandler()->setLogLevel(0);
+        auto start = std::chrono::steady_clock::now();
+        int coinErrors = isLp ? solver.readLp(file.c_str()) : solver.readMps(file.c_str(), "");
+        solver.getMatrixByRow();
+        double coinSeconds = secondsSince(start);
+        if (coinErrors != 0) {
+            std::printf("%-16s %10.0f %12s %12s %8s  skipped, CoinMpsIO/CoinLpIO reports %d errors\n",
+                name.c_str(), text.size() / 1024.0, "-", "-", "-", coinErrors);
+            continue;
+        }
+        ProblemInstance ref = getProblemData(solver);
+
+        ProblemInstance data;
+        start = std::chrono::steady_clock::now();
+        int errors = readModelFile(file, data, numThreads);
+        double nativeSeconds = secondsSince(start);
+
+        std::string diff = errors != 0 ? "read errors" : compareInstances(ref, data);
+        if (!diff.empty())
+            mismatches++;
+        std::printf("%-16s %10.0f %12.1f %12.1f %7.1fx  %s\n", name.c_str(), text.size() / 1024.0,
+            megabytes / coinSeconds, megabytes / nativeSeconds, coinSeconds / nativeSeconds,
+            diff.empty() ? "ok" : ("MISMATCH: " + diff).c_str());
+        totalBytes += megabytes;
+        totalCoin += coinSeconds;
+        totalNative += nativeSeconds;
+    }
+    std::printf("total %.1f MB: CoinMpsIO %.1f MB/s, native (%d threads) %.1f MB/s, %d mismatches\n",
+        totalBytes, totalBytes / totalCoin, numThreads, totalBytes / totalNative, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
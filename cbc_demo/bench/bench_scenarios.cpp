@@ -0,0 +1,119 @@
+// Scenario solves over the SMPS samples bundled with CBC (app0110,
+// app0110R, bug): every scenario from the core's optimal basis against
+// every scenario from scratch, with the objectives compared. Then the
+// throughput of each on a larger set, app0110 with its stochastic right hand
+// sides perturbed into many scenarios, as LPs and as MIPs, on 1, 2, 4, ...
+// threads.
+//
+//   ./bench_scenarios [scenarios=5000] [max threads=cores]
+
+#include "parallel.h"
+#include "scenario_set.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+// Copies of the scenarios of set, each right hand side they change moved by
+// up to 20%, until there are count of them.
+static ScenarioSet perturbed(const ScenarioSet& set, int count)
+{
+    ScenarioSet big;
+    big.core = set.core;
+    big.periods = set.periods;
+    big.rowPeriod = set.rowPeriod;
+    big.colPeriod = set.colPeriod;
+    std::mt19937_64 random(3);
+    std::uniform_real_distribution<double> factor(0.8, 1.2);
+    for (int s = 0; s < count; s++) {
+        Scenario scenario = set.scenarios[s % set.scenarios.size()];
+        scenario.name = "P" + std::to_string(s + 1);
+        scenario.parent = -1;
+        scenario.probability = 1.0 / count;
+        for (double& rhs : scenario.rhs)
+            rhs *= factor(random);
+        big.scenarios.push_back(std::move(scenario));
+    }
+    return big;
+}
+
+static int countDifferences(const ScenarioSolveResult& a, const ScenarioSolveResult& b)
+{
+    int differences = 0;
+    for (std::size_t s = 0; s < a.scenarios.size(); s++) {
+        const BatchResult& x = a.scenarios[s];
+        const BatchResult& y = b.scenarios[s];
+        differences += x.status != y.status ||
+            (x.hasSolution && std::fabs(x.objValue - y.objValue) > 1e-6 * std::max(1.0, std::fabs(x.objValue)));
+    }
+    return differences;
+}
+
+int main(int argc, const char *argv[])
+{
+    int count = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5000;
+    int maxThreads = argc > 2 ? std::max(1, std::atoi(argv[2])) : defaultThreadCount();
+
+    std::printf("%-10s %6s %5s %9s %-5s %16s %10s %10s %10s\n", "model", "rows", "cols", "scenarios", "mode",
+        "expected obj", "iters", "time(ms)", "scen/s");
+    int differences = 0;
+    ScenarioSet app0110;
+    for (const char* name : {"app0110", "app0110R", "bug"}) {
+        ScenarioSet set;
+        if (readSmps(std::string(CBC_DATA_DIR) + "/Sample/" + name, set) != 0)
+            return 1;
+        ScenarioSolveResult runs[2];
+        for (int warm = 1; warm >= 0; warm--) {
+            ScenarioSolveOptions options;
+            options.warmStart = warm;
+            ScenarioSolveResult& result = runs[1 - warm];
+            result = solveScenarios(set, options);
+            long iterations = 0;
+            for (const BatchResult& r : result.scenarios)
+                iterations += r.iterations;
+            std::printf("%-10s %6d %5d %9zu %-5s %16.8g %10ld %10.3f %10.1f\n", name, set.core.numRows,
+                set.core.numCols, set.scenarios.size(), warm ? "warm" : "cold", result.expectedObjective,
+                iterations, result.seconds * 1e3, result.scenariosPerSecond);
+        }
+        differences += countDifferences(runs[0], runs[1]);
+        if (std::string(name) == "app0110")
+            app0110 = std::move(set);
+    }
+    std::printf("warm and cold %s\n", differences == 0 ? "agree" : "DIFFER");
+
+    ScenarioSet big = perturbed(app0110, count);
+    std::printf("\n%d perturbed app0110 scenarios\n", count);
+    std::printf("%-4s %8s %12s %12s %12s %12s %10s\n", "kind", "threads", "warm scen/s", "cold scen/s",
+        "warm iters", "cold iters", "speedup");
+    for (int relax = 1; relax >= 0; relax--) {
+        double base = 0.0;
+        for (int step = 1;; step *= 2) {
+            int threads = std::min(step, maxThreads);
+            ScenarioSolveResult runs[2];
+            long iterations[2] = {0, 0};
+            for (int warm = 1; warm >= 0; warm--) {
+                ScenarioSolveOptions options;
+                options.numThreads = threads;
+                options.warmStart = warm;
+                options.relax = relax;
+                runs[1 - warm] = solveScenarios(big, options);
+                for (const BatchResult& r : runs[1 - warm].scenarios)
+                    iterations[1 - warm] += r.iterations;
+            }
+            differences += countDifferences(runs[0], runs[1]);
+            if (threads == 1)
+                base = runs[0].scenariosPerSecond;
+            std::printf("%-4s %8d %12.1f %12.1f %12ld %12ld %9.2fx\n", relax ? "LP" : "MIP", threads,
+                runs[0].scenariosPerSecond, runs[1].scenariosPerSecond, iterations[0], iterations[1],
+                runs[0].scenariosPerSecond / std::max(1e-9, base));
+            if (threads == maxThreads)
+                break;
+        }
+    }
+    std::printf("warm and cold %s\n", differences == 0 ? "agree" : "DIFFER");
+    return differences == 0 ? 0 : 1;
+}
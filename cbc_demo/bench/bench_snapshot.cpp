@@ -0,0 +1,91 @@
+// Startup cost of readMps on the gzipped text models against mapping a
+// snapshot of the same model and loading it into a fresh solver.
+//
+//   ./bench_snapshot [model files...]
+
+#include "OsiClpSolverInterface.hpp"
+
+#include "problem_instance.h"
+#include "problem_snapshot.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// cheap equality check of the two loaded models
+static bool sameModel(const OsiSolverInterface& a, const OsiSolverInterface& b)
+{
+    if (a.getNumRows() != b.getNumRows() || a.getNumCols() != b.getNumCols()
+        || a.getNumElements() != b.getNumElements())
+        return false;
+    for (int i = 0; i < a.getNumCols(); i++) {
+        if (a.getColLower()[i] != b.getColLower()[i] || a.getColUpper()[i] != b.getColUpper()[i]
+            || a.getObjCoefficients()[i] != b.getObjCoefficients()[i] || a.isInteger(i) != b.isInteger(i))
+            return false;
+    }
+    for (int i = 0; i < a.getNumRows(); i++) {
+        if (a.getRowLower()[i] != b.getRowLower()[i] || a.getRowUpper()[i] != b.getRowUpper()[i])
+            return false;
+    }
+    return a.getMatrixByRow()->isEquivalent(*b.getMatrixByRow());
+}
+
+int main(int argc, const char *argv[])
+{
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++)
+        files.push_back(argv[i]);
+
+    if (files.empty()) {
+        for (const auto& entry : std::filesystem::directory_iterator(std::string(CBC_DATA_DIR) + "/miplib3"))
+            if (entry.path().extension() == ".gz")
+                files.push_back(entry.path().string());
+        std::sort(files.begin(), files.end());
+    }
+
+    std::filesystem::path tmpDir = std::filesystem::temp_directory_path() / "cbc_bench_snapshot";
+    std::filesystem::create_directories(tmpDir);
+
+    std::printf("%-14s %12s %12s %12s %10s %6s\n", "model", "readMps(ms)", "open(ms)", "load(ms)", "size(KB)", "same");
+    double totalRead = 0.0, totalSnap = 0.0;
+    for (const std::string& file : files) {
+        OsiClpSolverInterface text;
+        text.messageHandler()->setLogLevel(0);
+        auto start = std::chrono::steady_clock::now();
+        if (text.readMps(file.c_str(), "") != 0) {
+            std::cout << "Read " << file << " failed" << std::endl;
+            continue;
+        }
+        double readMs = elapsedMs(start);
+
+        std::string name = std::filesystem::path(file).stem().string();
+        std::string snapFile = (tmpDir / (name + ".snap")).string();
+        if (!writeSnapshot(getProblemData(text), snapFile))
+            continue;
+
+        OsiClpSolverInterface mapped;
+        mapped.messageHandler()->setLogLevel(0);
+        ProblemSnapshot snapshot;
+        start = std::chrono::steady_clock::now();
+        if (!snapshot.open(snapFile))
+            continue;
+        double openMs = elapsedMs(start);
+        start = std::chrono::steady_clock::now();
+        snapshot.loadInto(mapped);
+        double loadMs = elapsedMs(start);
+
+        std::printf("%-14s %12.3f %12.3f %12.3f %10.0f %6s\n", name.c_str(), readMs, openMs, loadMs,
+            std::filesystem::file_size(snapFile) / 1024.0, sameModel(text, mapped) ? "yes" : "NO");
+        totalRead += readMs;
+        totalSnap += openMs + loadMs;
+        std::filesystem::remove(snapFile);
+    }
+    std::printf("total: readMps %.3f ms, snapshot open+load %.3f ms\n", totalRead, totalSnap);
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Subtree distribution (subtree_solver.h) on miplib3 instances: one serial
+// CbcModel with the default racing configuration against forked workers,
+// 1, 2, 4, ... of them, each solving subtrees with the same configuration.
+// Checks that every run reaches the serial objective.
+//
+//   ./bench_subtrees [max workers=4] [time limit=60] [models...]
+
+#include "CbcModel.hpp"
+#include "OsiClpSolverInterface.hpp"
+
+#include "model_reader.h"
+#include "problem_instance.h"
+#include "racing_solver.h"
+#include "subtree_solver.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+int main(int argc, const char *argv[])
+{
+    int maxWorkers = argc > 1 ? std::max(1, std::atoi(argv[1])) : 4;
+    double timeLimit = argc > 2 ? std::atof(argv[2]) : 60.0;
+    std::vector<std::string> models;
+    for (int i = 3; i < argc; i++)
+        models.push_back(argv[i]);
+    if (models.empty())
+        models = {"p0201", "p0282", "lseu", "stein27", "vpm2", "misc03", "bell5"};
+
+    std::printf("%-10s %8s | %16s %10s %9s | %7s %9s %10s %6s %6s %8s %9s\n", "model", "workers", "objective",
+        "nodes", "time(s)", "ramp", "subtrees", "nodes", "steals", "cuts", "time(s)", "speedup");
+    int mismatches = 0;
+    for (const std::string& name : models) {
+        ProblemInstance data;
+        if (readModelFile(std::string(CBC_DATA_DIR) + "/miplib3/" + name + ".gz", data) != 0)
+            continue;
+        OsiClpSolverInterface solver;
+        solver.messageHandler()->setLogLevel(0);
+        loadProblemData(data, solver, false);
+
+        auto start = std::chrono::steady_clock::now();
+        CbcModel serial(solver);
+        configureRacer(serial, RaceConfig(), timeLimit);
+        serial.branchAndBound();
+        double serialSeconds = secondsSince(start);
+        double objective = serial.bestSolution() ? serial.getObjValue() : NAN;
+
+        for (int workers = 1;; workers *= 2) {
+            workers = std::min(workers, maxWorkers);
+            SubtreeSolveOptions options;
+            options.numWorkers = workers;
+            options.timeLimit = timeLimit;
+            SubtreeSolveResult result = solveSubtrees(solver, options);
+            std::printf("%-10s %8d | %16.8g %10d %9.3f | %7d %9d %10ld %6d %6d %8.3f %8.2fx\n", name.c_str(),
+                workers, objective, serial.getNodeCount(), serialSeconds, result.rampUpLps, result.subtreesSolved,
+                result.nodes, result.steals, result.cutoffBroadcasts, result.seconds,
+                serialSeconds / std::max(1e-9, result.seconds));
+            bool same = result.hasSolution && serial.isProvenOptimal() && result.status == BatchStatus::Optimal
+                && std::fabs(result.objValue - objective) <= 1e-6 * std::max(1.0, std::fabs(objective));
+            if (!same && serial.isProvenOptimal() && result.status != BatchStatus::Stopped) {
+                std::printf("%s: %s %.10g against serial %.10g\n", name.c_str(), batchStatusName(result.status),
+                    result.objValue, objective);
+                mismatches++;
+            }
+            if (workers == maxWorkers)
+                break;
+        }
+    }
+    std::printf("%s\n", mismatches == 0 ? "all objectives agree" : "objectives DIFFER");
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+// Measures the cost of SolveTelemetry (solve_telemetry.h): every model is
+// solved without a handler, with the handler attached but disabled, and
+// enabled, interleaved over a few repeats. Single-threaded CBC is
+// deterministic, so the node counts must agree and nodes/s is comparable.
+// The enabled run of each model writes <model>.trace.json and <model>.curve.
+//
+//   ./bench_telemetry [repeats] [output dir] [models...]
+
+#include "CbcModel.hpp"
+#include "CglGomory.hpp"
+#include "CglKnapsackCover.hpp"
+#include "CglProbing.hpp"
+#include "OsiClpSolverInterface.hpp"
+
+#include "model_reader.h"
+#include "problem_instance.h"
+#include "solve_telemetry.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+enum Mode { NoHandler, Disabled, Enabled };
+
+struct SolveRun
+{
+    double seconds = 0.0;
+    int nodes = 0;
+    std::size_t records = 0;
+    std::uint64_t dropped = 0;
+};
+
+static SolveRun solve(OsiClpSolverInterface& solver, Mode mode, const std::string& outputStem)
+{
+    CbcModel model(solver);
+    model.setLogLevel(0);
+    CglProbing probing;
+    CglGomory gomory;
+    CglKnapsackCover knapsack;
+    model.addCutGenerator(&probing, -1, "Probing");
+    model.addCutGenerator(&gomory, -1, "Gomory");
+    model.addCutGenerator(&knapsack, -1, "Knapsack");
+
+    SolveTelemetry telemetry;
+    if (mode != NoHandler) {
+        telemetry.setEnabled(mode == Enabled);
+        telemetry.attach(model);
+    }
+    auto start = std::chrono::steady_clock::now();
+    model.branchAndBound();
+    SolveRun run;
+    run.seconds = secondsSince(start);
+    run.nodes = model.getNodeCount();
+    if (mode != NoHandler) {
+        telemetry.finish(model);
+        run.records = telemetry.records().size();
+        run.dropped = telemetry.droppedRecords();
+        if (mode == Enabled && !outputStem.empty()) {
+            telemetry.writeChromeTrace(outputStem + ".trace.json");
+            telemetry.writeCurveLog(outputStem + ".curve");
+        }
+    }
+    return run;
+}
+
+static double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+int main(int argc, const char *argv[])
+{
+    int repeats = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+    std::string outputDir = argc > 2 ? argv[2] : std::filesystem::temp_directory_path().string();
+    std::vector<std::string> models;
+    for (int i = 3; i < argc; i++)
+        models.push_back(argv[i]);
+    if (models.empty())
+        models = {"p0201", "stein27", "misc03", "lseu", "vpm2"};
+
+    std::printf("%-10s %8s %12s %12s %12s %10s %10s %9s %8s\n", "model", "nodes", "none(n/s)", "off(n/s)",
+        "on(n/s)", "off cost", "on cost", "records", "dropped");
+    double totalNone = 0.0, totalOff = 0.0, totalOn = 0.0;
+    for (const std::string& name : models) {
+        ProblemInstance data;
+        if (readModelFile(std::string(CBC_DATA_DIR) + "/miplib3/" + name + ".gz", data) != 0)
+            continue;
+        OsiClpSolverInterface solver;
+        solver.messageHandler()->setLogLevel(0);
+        loadProblemData(data, solver, false);
+
+        std::vector<double> seconds[3];
+        int nodes[3] = {0, 0, 0};
+        SolveRun enabledRun;
+        for (int r = 0; r < repeats; r++) {
+            for (int mode = NoHandler; mode <= Enabled; mode++) {
+                std::string stem = (mode == Enabled && r == 0) ? (std::filesystem::path(outputDir) / name).string() : "";
+                SolveRun run = solve(solver, static_cast<Mode>(mode), stem);
+                seconds[mode].push_back(run.seconds);
+                nodes[mode] = run.nodes;
+                if (mode == Enabled)
+                    enabledRun = run;
+            }
+        }
+        if (nodes[0] != nodes[1] || nodes[0] != nodes[2])
+            std::printf("%s: node counts differ %d / %d / %d\n", name.c_str(), nodes[0], nodes[1], nodes[2]);
+
+        double none = median(seconds[NoHandler]), off = median(seconds[Disabled]), on = median(seconds[Enabled]);
+        totalNone += none;
+        totalOff += off;
+        totalOn += on;
+        std::printf("%-10s %8d %12.1f %12.1f %12.1f %9.2f%% %9.2f%% %9zu %8llu\n", name.c_str(), nodes[0],
+            nodes[0] / none, nodes[0] / off, nodes[0] / on, 100.0 * (off / none - 1.0), 100.0 * (on / none - 1.0),
+            enabledRun.records, static_cast<unsigned long long>(enabledRun.dropped));
+    }
+    std::printf("total: disabled %+.2f%%, enabled %+.2f%% solve time against no handler (median of %d)\n",
+        100.0 * (totalOff / totalNone - 1.0), 100.0 * (totalOn / totalNone - 1.0), repeats);
+    std::printf("traces and curves written to %s\n", outputDir.c_str());
+    return 0;
+}
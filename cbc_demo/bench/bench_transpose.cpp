@@ -0,0 +1,119 @@
+// Throughput of the CSR -> CSC transpose behind ProblemInstance::columns()
+// against CoinPackedMatrix::reverseOrdering, the transpose the solvers use,
+// on the largest miplib3 instances bundled with CBC. Every result is checked
+// entry by entry against the CoinPackedMatrix one.
+//
+//   ./bench_transpose [repeats] [model files...]
+
+#include "CoinPackedMatrix.hpp"
+
+#include "model_reader.h"
+#include "parallel.h"
+#include "problem_instance.h"
+#include "util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+static double median(std::vector<double>& times)
+{
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+static bool sameColumns(const ColumnMajor& columns, const CoinPackedMatrix& byCol)
+{
+    const CoinBigIndex* starts = byCol.getVectorStarts();
+    const int* lengths = byCol.getVectorLengths();
+    for (int j = 0; j < byCol.getMajorDim(); j++) {
+        if (columns.colStart[j + 1] - columns.colStart[j] != lengths[j])
+            return false;
+        for (int p = 0; p < lengths[j]; p++) {
+            int q = columns.colStart[j] + p;
+            if (columns.rowIdxs[q] != byCol.getIndices()[starts[j] + p]
+                || columns.rowCoeffs[q] != byCol.getElements()[starts[j] + p])
+                return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, const char *argv[])
+{
+    int repeats = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+    std::vector<std::string> files;
+    for (int i = 2; i < argc; i++)
+        files.push_back(argv[i]);
+    if (files.empty()) {
+        for (const char* name : {"nw04", "fast0507", "dano3mip", "air05", "air04", "mitre", "cap6000"})
+            files.push_back(std::string(CBC_DATA_DIR) + "/miplib3/" + name + ".gz");
+    }
+    // more than one thread even on a single core, to check the results do not depend on it
+    std::vector<int> threadCounts = {1, std::max(4, defaultThreadCount())};
+
+    std::printf("median of %d\n", repeats);
+    std::printf("%-12s %9s %-16s %10s %12s %9s %s\n", "model", "nnz", "transpose", "time(ms)", "Mnnz/s",
+        "speedup", "check");
+    for (const std::string& path : files) {
+        ProblemInstance data;
+        if (readModelFile(path, data) != 0)
+            continue;
+        std::string name = path.substr(path.find_last_of('/') + 1);
+        name = name.substr(0, name.find('.'));
+        double mnnz = data.numNonZeros / 1e6;
+
+        CoinPackedMatrix byRow(false, data.numCols, data.numRows, data.numNonZeros,
+            data.colCoeffs.data(), data.colIdxs.data(), data.rowStart.data(), nullptr);
+        CoinPackedMatrix byCol;
+        std::vector<double> times;
+        for (int r = 0; r < repeats; r++) {
+            byCol = byRow; // reverseOrdering works in place, the copy is not timed
+            auto start = std::chrono::steady_clock::now();
+            byCol.reverseOrdering();
+            times.push_back(elapsedMs(start));
+        }
+        double coinMs = median(times);
+        std::printf("%-12s %9d %-16s %10.3f %12.1f %9s %s\n", name.c_str(), data.numNonZeros, "reverseOrdering",
+            coinMs, mnnz / coinMs * 1000.0, "1.00x", "");
+
+        for (int threads : threadCounts) {
+            ColumnMajor columns;
+            times.clear();
+            for (int r = 0; r < repeats; r++) {
+                auto start = std::chrono::steady_clock::now();
+                transposeToColumns(data, columns, threads);
+                times.push_back(elapsedMs(start));
+            }
+            double ms = median(times);
+            std::string label = "counting sort/" + std::to_string(threads);
+            std::printf("%-12s %9d %-16s %10.3f %12.1f %8.2fx %s\n", name.c_str(), data.numNonZeros, label.c_str(),
+                ms, mnnz / ms * 1000.0, coinMs / ms, sameColumns(columns, byCol) ? "identical" : "DIFFERENT");
+        }
+
+        // what a consumer pays: the first access builds, later ones hit the cache
+        times.clear();
+        std::vector<double> cachedTimes;
+        bool identical = true;
+        for (int r = 0; r < repeats; r++) {
+            data.invalidateColumns();
+            auto start = std::chrono::steady_clock::now();
+            data.columns();
+            times.push_back(elapsedMs(start));
+            start = std::chrono::steady_clock::now();
+            std::shared_ptr<const ColumnMajor> cached = data.columns();
+            cachedTimes.push_back(elapsedMs(start));
+            identical = identical && sameColumns(*cached, byCol);
+        }
+        double firstMs = median(times), cachedMs = median(cachedTimes);
+        std::printf("%-12s %9d %-16s %10.3f %12.1f %8.2fx %s\n", name.c_str(), data.numNonZeros, "columns() first",
+            firstMs, mnnz / firstMs * 1000.0, coinMs / firstMs, identical ? "identical" : "DIFFERENT");
+        std::printf("%-12s %9d %-16s %10.4f %12s %9s %s\n", name.c_str(), data.numNonZeros, "columns() cached",
+            cachedMs, "-", "-", "");
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Measures the warm start cache (warm_start_cache.h) on miplib3 instances:
+// a cold solve that fills the cache, the same model again (exact hit: basis,
+// MIP start and root cuts), and a copy with relaxed rhs (structural hit:
+// basis and MIP start), the latter also solved cold for reference.
+//
+//   ./bench_warm_start [time limit] [models...]
+
+#include "CbcModel.hpp"
+#include "CglGomory.hpp"
+#include "CglKnapsackCover.hpp"
+#include "CglMixedIntegerRounding2.hpp"
+#include "CglProbing.hpp"
+#include "OsiClpSolverInterface.hpp"
+
+#include "fingerprint.h"
+#include "model_reader.h"
+#include "problem_instance.h"
+#include "util.h"
+#include "warm_start_cache.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct SolveStats
+{
+    double seconds = 0.0;
+    int nodes = 0;
+    int iterations = 0;
+    double objective = 0.0;
+};
+
+static SolveStats solve(const ProblemInstance& data, double timeLimit, WarmStartCache* cache)
+{
+    OsiClpSolverInterface solver;
+    solver.messageHandler()->setLogLevel(0);
+    loadProblemData(data, solver);
+
+    auto start = std::chrono::steady_clock::now();
+    CbcModel model(solver);
+    model.setLogLevel(0);
+    model.setUseElapsedTime(true);
+    model.setMaximumSeconds(timeLimit);
+    CglProbing probing;
+    CglGomory gomory;
+    CglKnapsackCover knapsack;
+    CglMixedIntegerRounding2 mixedIntegerRounding;
+    model.addCutGenerator(&probing, -1, "Probing");
+    model.addCutGenerator(&gomory, -1, "Gomory");
+    model.addCutGenerator(&knapsack, -1, "Knapsack");
+    model.addCutGenerator(&mixedIntegerRounding, -1, "MixedIntegerRounding2");
+    if (cache)
+        cache->apply(data, model);
+    model.branchAndBound();
+    if (cache)
+        cache->store(data, model);
+
+    SolveStats stats;
+    stats.seconds = secondsSince(start);
+    stats.nodes = model.getNodeCount();
+    stats.iterations = model.getIterationCount();
+    stats.objective = model.bestSolution() ? model.getObjValue() : NAN;
+    return stats;
+}
+
+// Loosens every inequality by 0.5% of its rhs, so the old optimum stays feasible.
+static void relaxRhs(ProblemInstance& data)
+{
+    for (int i = 0; i < data.numRows; i++) {
+        double slack = 0.005 * std::max(1.0, std::fabs(data.rhs[i]));
+        if (data.rowtypes[i] == 'L')
+            data.rhs[i] += slack;
+        else if (data.rowtypes[i] == 'G')
+            data.rhs[i] -= slack;
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    double timeLimit = argc > 1 ? std::atof(argv[1]) : 60.0;
+    std::vector<std::string> models;
+    for (int i = 2; i < argc; i++)
+        models.push_back(argv[i]);
+    if (models.empty())
+        models = {"p0033", "p0201", "p0282", "lseu", "stein27", "mod008", "bell5", "misc03", "vpm2", "fiber"};
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "bench_warm_start";
+    std::filesystem::remove_all(directory);
+    WarmStartCache cache(directory.string());
+
+    std::printf("%-10s %8s | %10s %8s %8s | %10s %8s %8s | %10s %8s | %10s %8s\n", "model", "hash(ms)", "cold(s)",
+        "nodes", "iters", "exact(s)", "nodes", "iters", "relaxed(s)", "nodes", "warm(s)", "nodes");
+    for (const std::string& name : models) {
+        ProblemInstance data;
+        if (readModelFile(std::string(CBC_DATA_DIR) + "/miplib3/" + name + ".gz", data) != 0)
+            continue;
+
+        auto start = std::chrono::steady_clock::now();
+        std::uint64_t fingerprint = structuralFingerprint(data);
+        double hashMs = elapsedMs(start);
+
+        SolveStats cold = solve(data, timeLimit, &cache);
+        SolveStats exact = solve(data, timeLimit, &cache);
+
+        ProblemInstance relaxed = data;
+        relaxRhs(relaxed);
+        if (structuralFingerprint(relaxed) != fingerprint)
+            std::printf("%s: fingerprint changed with the rhs\n", name.c_str());
+        SolveStats relaxedCold = solve(relaxed, timeLimit, nullptr);
+        SolveStats relaxedWarm = solve(relaxed, timeLimit, &cache);
+
+        std::printf("%-10s %8.3f | %10.3f %8d %8d | %10.3f %8d %8d | %10.3f %8d | %10.3f %8d\n", name.c_str(), hashMs,
+            cold.seconds, cold.nodes, cold.iterations, exact.seconds, exact.nodes, exact.iterations,
+            relaxedCold.seconds, relaxedCold.nodes, relaxedWarm.seconds, relaxedWarm.nodes);
+        if (std::fabs(cold.objective - exact.objective) > 1e-6 * std::max(1.0, std::fabs(cold.objective)))
+            std::printf("%s: objective %.10g cold vs %.10g warm\n", name.c_str(), cold.objective, exact.objective);
+    }
+
+    WarmStartStats stats = cache.stats();
+    std::printf("cache: %d hits (%d exact), %d misses, %d stores, %.3f s saved against the cold solves\n",
+        stats.hits, stats.exactHits, stats.misses, stats.stores, stats.secondsSaved);
+    return 0;
+}
@@ -0,0 +1,767 @@
+// Benchmark matrix over the instances bundled with CBC (Data/Sample and Data/miplib3).
+//
+//   ./cbc_bench [--set sample|miplib3|all] [--models p0033,lseu,...] [--threads 1,4]
+//               [--time 10,60] [--cuts off,on] [--heuristics off,on] [--mipstart off,on]
+//               [--arena off,on] [--repeat n] [-o results.json|results.csv]
+//   ./cbc_bench --compare base.json new.json [--threshold 0.10] [--min-seconds 0.05]
+//
+// Every (instance, threads, time limit, cuts, heuristics, MIP start, repeat) run
+// happens in a forked child, so peak RSS is per run and a crash only loses one
+// run. "cuts on" adds the usual Cgl generators, "heuristics on" rounding, local
+// search, feasibility pump and RINS; "off" is plain branchAndBound as in main.cpp.
+// The MIP start is the incumbent of an untimed solve with the same settings.
+// Each run also records allocations, MB allocated and peak RSS of its stages
+// (allocation_stats.h): read the file, build the solver, extract the model
+// back (getProblemData) and set the CbcModel up; "arena on" reads and
+// extracts into a std::pmr::monotonic_buffer_resource.
+//
+// Compare mode matches runs by instance and configuration (the median solve time
+// over repeats) and exits with 1 if it finds a regression: a lost optimum, a
+// different optimal objective, or a slower solve, bigger gap, slower load or
+// bigger peak RSS beyond the threshold, or more allocations or allocated MB in
+// a stage.
+
+#include "CbcEventHandler.hpp"
+#include "CbcModel.hpp"
+#include "OsiClpSolverInterface.hpp"
+
+#include "allocation_stats.h"
+#include "model_reader.h"
+#include "parallel.h"
+#include "problem_instance.h"
+#include "racing_solver.h"
+#include "util.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct BenchConfig
+{
+    int threads = 1;
+    double timeLimit = 10.0;
+    bool cuts = true;
+    bool heuristics = true;
+    bool mipStart = false;
+    bool arena = false;
+};
+
+enum BenchStage { StageRead, StageBuild, StageExtract, StageSetup, kNumStages };
+static const char* kStageNames[kNumStages] = {"read", "build", "extract", "setup"};
+
+// Sent from the child through a pipe, so plain data only. Times < 0 mean "never".
+struct BenchRun
+{
+    char status[16];
+    int hasSolution;
+    double loadSeconds;
+    double firstIncumbentSeconds;
+    double optimalSeconds;
+    double solveSeconds;
+    double objective;
+    double bound;
+    double gap;
+    long long nodes;
+    long long iterations;
+    long peakRssKb;
+    long long stageAllocations[kNumStages];
+    double stageMb[kNumStages];
+    double stagePeakRssMb[kNumStages];
+};
+
+static std::vector<std::string> splitList(const std::string& value)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+}
+
+static std::string instanceName(const std::string& path)
+{
+    std::filesystem::path name = std::filesystem::path(path).filename();
+    while (name.has_extension() && (name.extension() == ".gz" || name.extension() == ".mps" || name.extension() == ".lp"))
+        name = name.stem();
+    return name.string();
+}
+
+// Records when an incumbent first shows up; shared by the clones CBC makes per thread.
+struct IncumbentClock
+{
+    std::chrono::steady_clock::time_point start;
+    std::atomic<bool> seen{false};
+    double seconds = -1.0;
+};
+
+class IncumbentWatcher : public CbcEventHandler
+{
+public:
+    IncumbentWatcher(CbcModel* model, IncumbentClock* clock) : CbcEventHandler(model), clock_(clock) {}
+
+    CbcAction event(CbcEvent whichEvent) override
+    {
+        bool found = whichEvent == solution || whichEvent == heuristicSolution
+            || (model_ && model_->bestSolution());
+        bool expected = false;
+        if (found && clock_->seen.compare_exchange_strong(expected, true))
+            clock_->seconds = secondsSince(clock_->start);
+        return noAction;
+    }
+
+    CbcEventHandler* clone() const override { return new IncumbentWatcher(*this); }
+
+private:
+    IncumbentClock* clock_;
+};
+
+// the racers' setup with CBC's default branching, so the bench measures what raceSolve runs
+static void configureModel(CbcModel& model, const BenchConfig& config)
+{
+    RaceConfig settings;
+    settings.cuts = config.cuts ? 1 : 0;
+    settings.heuristics = config.heuristics;
+    configureRacer(model, settings, config.timeLimit);
+    model.setNumberThreads(config.threads > 1 ? config.threads : 0);
+}
+
+static void setStatus(BenchRun& run, const char* status)
+{
+    std::snprintf(run.status, sizeof(run.status), "%s", status);
+}
+
+static void recordStage(BenchRun& run, BenchStage stage, AllocationProfile::Stage& profiled)
+{
+    const StageAllocations& stats = profiled.finish();
+    run.stageAllocations[stage] = static_cast<long long>(stats.allocations);
+    run.stageMb[stage] = stats.bytes / 1048576.0;
+    run.stagePeakRssMb[stage] = stats.peakRssBytes / 1048576.0;
+}
+
+// Runs in the child process.
+static void runConfig(const std::string& path, const BenchConfig& config, BenchRun& run)
+{
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::memory_resource* resource = config.arena ? &arena : std::pmr::get_default_resource();
+    AllocationProfile profile;
+
+    auto start = std::chrono::steady_clock::now();
+    ProblemInstance data(resource);
+    AllocationProfile::Stage read(profile, kStageNames[StageRead]);
+    if (readModelFile(path, data, 1) != 0) {
+        setStatus(run, "read_error");
+        return;
+    }
+    recordStage(run, StageRead, read);
+    OsiClpSolverInterface solver;
+    AllocationProfile::Stage build(profile, kStageNames[StageBuild]);
+    solver.messageHandler()->setLogLevel(0);
+    loadProblemData(data, solver, false);
+    recordStage(run, StageBuild, build);
+    run.loadSeconds = secondsSince(start);
+
+    {
+        AllocationProfile::Stage extract(profile, kStageNames[StageExtract]);
+        ProblemInstance extracted = getProblemData(solver, resource);
+        recordStage(run, StageExtract, extract);
+    }
+
+    std::vector<double> mipStart;
+    if (config.mipStart) {
+        CbcModel prepare(solver);
+        configureModel(prepare, config);
+        prepare.branchAndBound();
+        if (const double* best = prepare.bestSolution())
+            mipStart.assign(best, best + data.numCols);
+    }
+
+    AllocationProfile::Stage setup(profile, kStageNames[StageSetup]);
+    CbcModel model(solver);
+    configureModel(model, config);
+    recordStage(run, StageSetup, setup);
+    // setMIPStart is only read by the CbcMain driver, branchAndBound takes the start this way
+    if (!mipStart.empty())
+        model.setBestSolution(mipStart.data(), data.numCols, COIN_DBL_MAX, true);
+    IncumbentClock clock;
+    IncumbentWatcher watcher(&model, &clock);
+    model.passInEventHandler(&watcher);
+
+    clock.start = std::chrono::steady_clock::now();
+    model.branchAndBound();
+    run.solveSeconds = secondsSince(clock.start);
+
+    run.nodes = model.getNodeCount();
+    run.iterations = model.getIterationCount();
+    run.hasSolution = model.bestSolution() != nullptr;
+    run.bound = model.getBestPossibleObjValue();
+    if (run.hasSolution) {
+        run.objective = model.getObjValue();
+        run.gap = std::fabs(run.objective - run.bound) / std::max(1e-10, std::fabs(run.objective));
+        run.firstIncumbentSeconds = clock.seen ? clock.seconds : run.solveSeconds;
+    }
+    if (model.isProvenOptimal()) {
+        setStatus(run, "optimal");
+        run.optimalSeconds = run.solveSeconds;
+    } else if (model.isProvenInfeasible()) {
+        setStatus(run, "infeasible");
+    } else if (model.status() == 2) {
+        setStatus(run, "abandoned");
+    } else {
+        setStatus(run, model.secondaryStatus() == 4 ? "time_limit" : "stopped");
+    }
+}
+
+static BenchRun runInChild(const std::string& path, const BenchConfig& config)
+{
+    BenchRun run;
+    std::memset(&run, 0, sizeof(run));
+    run.firstIncumbentSeconds = run.optimalSeconds = -1.0;
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        setStatus(run, "pipe_error");
+        return run;
+    }
+    std::cout.flush();
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        runConfig(path, config, run);
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        run.peakRssKb = usage.ru_maxrss;
+        ssize_t written = write(fds[1], &run, sizeof(run));
+        _exit(written == static_cast<ssize_t>(sizeof(run)) ? 0 : 1);
+    }
+    close(fds[1]);
+    if (pid < 0) {
+        close(fds[0]);
+        setStatus(run, "fork_error");
+        return run;
+    }
+
+    // CBC checks its limit at nodes only, give it a generous margin before killing
+    double budget = (config.timeLimit > 0.0 ? config.timeLimit * (config.mipStart ? 2 : 1) * 2 : 86400.0) + 120.0;
+    struct pollfd waitFd = {fds[0], POLLIN, 0};
+    bool received = false;
+    if (poll(&waitFd, 1, static_cast<int>(budget * 1000)) > 0) {
+        BenchRun result;
+        std::size_t got = 0;
+        char* bytes = reinterpret_cast<char*>(&result);
+        for (ssize_t n; got < sizeof(result) && (n = read(fds[0], bytes + got, sizeof(result) - got)) > 0;)
+            got += n;
+        if (got == sizeof(result)) {
+            run = result;
+            received = true;
+        } else {
+            setStatus(run, "crashed");
+        }
+    } else {
+        kill(pid, SIGKILL);
+        setStatus(run, "killed");
+    }
+    close(fds[0]);
+    int childStatus = 0;
+    waitpid(pid, &childStatus, 0);
+    if (!received && std::strcmp(run.status, "killed") != 0)
+        setStatus(run, "crashed");
+    return run;
+}
+
+struct RunRecord
+{
+    std::string instance;
+    std::string set;
+    BenchConfig config;
+    int repeat = 0;
+    BenchRun run;
+};
+
+static const char* onOff(bool value)
+{
+    return value ? "on" : "off";
+}
+
+static std::string formatNumber(double value, const char* format, bool valid)
+{
+    if (!valid || !std::isfinite(value) || std::fabs(value) >= 1e50)
+        return "";
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), format, value);
+    return buffer;
+}
+
+static const char* kColumns[] = {"instance", "set", "threads", "time_limit", "cuts", "heuristics", "mipstart",
+    "arena", "repeat", "status", "load_s", "first_incumbent_s", "optimal_s", "solve_s", "nodes", "nodes_per_s",
+    "iterations", "objective", "bound", "gap", "peak_rss_mb", "read_allocs", "read_mb", "read_peak_rss_mb",
+    "build_allocs", "build_mb", "build_peak_rss_mb", "extract_allocs", "extract_mb", "extract_peak_rss_mb",
+    "setup_allocs", "setup_mb", "setup_peak_rss_mb"};
+
+// Values in kColumns order, "" for missing ones.
+static std::vector<std::string> recordValues(const RunRecord& record)
+{
+    const BenchRun& run = record.run;
+    char buffer[64];
+    std::vector<std::string> values;
+    values.push_back(record.instance);
+    values.push_back(record.set);
+    values.push_back(std::to_string(record.config.threads));
+    values.push_back(formatNumber(record.config.timeLimit, "%g", true));
+    values.push_back(onOff(record.config.cuts));
+    values.push_back(onOff(record.config.heuristics));
+    values.push_back(onOff(record.config.mipStart));
+    values.push_back(onOff(record.config.arena));
+    values.push_back(std::to_string(record.repeat));
+    values.push_back(run.status);
+    values.push_back(formatNumber(run.loadSeconds, "%.6f", true));
+    values.push_back(formatNumber(run.firstIncumbentSeconds, "%.6f", run.firstIncumbentSeconds >= 0.0));
+    values.push_back(formatNumber(run.optimalSeconds, "%.6f", run.optimalSeconds >= 0.0));
+    values.push_back(formatNumber(run.solveSeconds, "%.6f", true));
+    std::snprintf(buffer, sizeof(buffer), "%lld", run.nodes);
+    values.push_back(buffer);
+    values.push_back(formatNumber(run.nodes / std::max(1e-6, run.solveSeconds), "%.1f", true));
+    std::snprintf(buffer, sizeof(buffer), "%lld", run.iterations);
+    values.push_back(buffer);
+    values.push_back(formatNumber(run.objective, "%.17g", run.hasSolution != 0));
+    values.push_back(formatNumber(run.bound, "%.17g", true));
+    values.push_back(formatNumber(run.gap, "%.6g", run.hasSolution != 0));
+    values.push_back(formatNumber(run.peakRssKb / 1024.0, "%.1f", true));
+    // no counts without the counting operators, e.g. when a stage never ran
+    bool counted = allocationCountingEnabled();
+    for (int stage = 0; stage < kNumStages; stage++) {
+        bool ran = run.stagePeakRssMb[stage] > 0.0;
+        values.push_back(ran && counted ? std::to_string(run.stageAllocations[stage]) : "");
+        values.push_back(formatNumber(run.stageMb[stage], "%.3f", ran && counted));
+        values.push_back(formatNumber(run.stagePeakRssMb[stage], "%.1f", ran));
+    }
+    return values;
+}
+
+static bool isTextColumn(int column)
+{
+    return column <= 1 || (column >= 4 && column <= 7) || column == 9;
+}
+
+static void writeJson(const std::vector<RunRecord>& records, std::ostream& out)
+{
+    char created[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(created, sizeof(created), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    out << "{\n  \"cbc_version\": \"" << CBC_VERSION << "\", \"cores\": " << defaultThreadCount()
+        << ", \"created\": \"" << created << "\",\n  \"runs\": [";
+    for (std::size_t k = 0; k < records.size(); k++) {
+        std::vector<std::string> values = recordValues(records[k]);
+        out << (k == 0 ? "\n    {" : ",\n    {");
+        for (int c = 0; c < static_cast<int>(values.size()); c++) {
+            out << (c == 0 ? "" : ", ") << '"' << kColumns[c] << "\": ";
+            if (isTextColumn(c))
+                out << '"' << values[c] << '"';
+            else
+                out << (values[c].empty() ? "null" : values[c]);
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void writeCsv(const std::vector<RunRecord>& records, std::ostream& out)
+{
+    for (const char* column : kColumns)
+        out << (column == kColumns[0] ? "" : ",") << column;
+    out << "\n";
+    for (const RunRecord& record : records) {
+        std::vector<std::string> values = recordValues(record);
+        for (std::size_t c = 0; c < values.size(); c++)
+            out << (c == 0 ? "" : ",") << values[c];
+        out << "\n";
+    }
+}
+
+// ---- compare mode ----
+
+using Fields = std::map<std::string, std::string>;
+
+// Parses the one-object-per-line JSON written above; null becomes "".
+static bool parseJsonObject(const std::string& line, Fields& fields)
+{
+    std::size_t p = line.find('{');
+    if (p == std::string::npos)
+        return false;
+    auto skipBlanks = [&]() {
+        while (p < line.size() && (line[p] == ' ' || line[p] == '\t'))
+            p++;
+    };
+    auto readString = [&](std::string& value) {
+        value.clear();
+        for (p++; p < line.size() && line[p] != '"'; p++) {
+            if (line[p] == '\\' && p + 1 < line.size())
+                p++;
+            value += line[p];
+        }
+        p++;
+    };
+    p++;
+    while (p < line.size()) {
+        skipBlanks();
+        if (line[p] == '}')
+            return true;
+        if (line[p] != '"')
+            return false;
+        std::string key, value;
+        readString(key);
+        skipBlanks();
+        if (p >= line.size() || line[p] != ':')
+            return false;
+        p++;
+        skipBlanks();
+        if (p < line.size() && line[p] == '"') {
+            readString(value);
+        } else {
+            std::size_t end = line.find_first_of(",}", p);
+            value = line.substr(p, end - p);
+            p = end;
+            while (!value.empty() && value.back() == ' ')
+                value.pop_back();
+            if (value == "null")
+                value.clear();
+        }
+        fields[key] = value;
+        skipBlanks();
+        if (p < line.size() && line[p] == ',')
+            p++;
+    }
+    return false;
+}
+
+static bool readResults(const std::string& path, std::vector<Fields>& runs)
+{
+    std::ifstream in(path);
+    if (!in) {
+        std::cout << "Cannot open " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    if (endsWith(path, ".csv")) {
+        std::vector<std::string> header;
+        if (std::getline(in, line))
+            header = splitList(line);
+        while (std::getline(in, line)) {
+            Fields fields;
+            std::stringstream stream(line);
+            std::string value;
+            for (std::size_t c = 0; c < header.size() && std::getline(stream, value, ','); c++)
+                fields[header[c]] = value;
+            runs.push_back(fields);
+        }
+    } else {
+        while (std::getline(in, line)) {
+            Fields fields;
+            if (line.find("\"instance\"") != std::string::npos && parseJsonObject(line, fields))
+                runs.push_back(fields);
+        }
+    }
+    return true;
+}
+
+static std::string configKey(const Fields& run)
+{
+    return run.at("set") + "/" + run.at("instance") + " t=" + run.at("threads") + " tl=" + run.at("time_limit") + " cuts=" + run.at("cuts")
+        + " heur=" + run.at("heuristics") + " start=" + run.at("mipstart")
+        + (run.count("arena") && run.at("arena") == "on" ? " arena=on" : ""); // absent before the arena switch
+}
+
+// Median run (by solve time) of every configuration.
+static std::map<std::string, Fields> medianRuns(const std::vector<Fields>& runs)
+{
+    std::map<std::string, std::vector<Fields>> groups;
+    for (const Fields& run : runs)
+        if (run.count("instance") && run.count("set") && run.count("solve_s"))
+            groups[configKey(run)].push_back(run);
+    std::map<std::string, Fields> medians;
+    for (auto& group : groups) {
+        std::vector<Fields>& members = group.second;
+        std::sort(members.begin(), members.end(), [](const Fields& a, const Fields& b) {
+            return std::atof(a.at("solve_s").c_str()) < std::atof(b.at("solve_s").c_str());
+        });
+        medians[group.first] = members[members.size() / 2];
+    }
+    return medians;
+}
+
+static bool number(const Fields& run, const char* key, double& value)
+{
+    auto it = run.find(key);
+    if (it == run.end() || it->second.empty())
+        return false;
+    value = std::atof(it->second.c_str());
+    return true;
+}
+
+static int compareResults(const std::string& basePath, const std::string& newPath, double threshold, double minSeconds)
+{
+    std::vector<Fields> baseRuns, newRuns;
+    if (!readResults(basePath, baseRuns) || !readResults(newPath, newRuns))
+        return 2;
+    std::map<std::string, Fields> base = medianRuns(baseRuns), current = medianRuns(newRuns);
+
+    int regressions = 0, improvements = 0, compared = 0, timed = 0;
+    double logRatioSum = 0.0;
+    auto report = [&](const std::string& key, const char* verdict, const std::string& what) {
+        std::printf("%-11s %-64s %s\n", verdict, key.c_str(), what.c_str());
+    };
+    auto change = [](const char* metric, double a, double b, const char* unit) {
+        char buffer[128];
+        std::snprintf(buffer, sizeof(buffer), "%s %.4g%s -> %.4g%s (%+.1f%%)", metric, a, unit, b, unit,
+            100.0 * (b - a) / std::max(1e-12, std::fabs(a)));
+        return std::string(buffer);
+    };
+    // flags b against a when it grew by more than threshold and more than minDelta
+    auto checkGrowth = [&](const std::string& key, const char* metric, double a, double b, double minDelta, const char* unit) {
+        double scale = std::max(std::fabs(a), minDelta);
+        if (b - a > minDelta && (b - a) / scale > threshold) {
+            report(key, "REGRESSION", change(metric, a, b, unit));
+            regressions++;
+        } else if (a - b > minDelta && (a - b) / scale > threshold) {
+            report(key, "improved", change(metric, a, b, unit));
+            improvements++;
+        }
+    };
+
+    for (const auto& entry : base) {
+        const std::string& key = entry.first;
+        const Fields& a = entry.second;
+        auto found = current.find(key);
+        if (found == current.end()) {
+            report(key, "REGRESSION", "missing from " + newPath);
+            regressions++;
+            continue;
+        }
+        const Fields& b = found->second;
+        compared++;
+
+        bool aOptimal = a.at("status") == "optimal", bOptimal = b.at("status") == "optimal";
+        double x, y;
+        if (aOptimal && !bOptimal) {
+            report(key, "REGRESSION", "status optimal -> " + b.at("status"));
+            regressions++;
+        } else if (!aOptimal && bOptimal) {
+            report(key, "improved", "status " + a.at("status") + " -> optimal");
+            improvements++;
+        } else if (aOptimal && bOptimal) {
+            if (number(a, "objective", x) && number(b, "objective", y)
+                && std::fabs(x - y) > 1e-6 * std::max(1.0, std::fabs(x))) {
+                report(key, "REGRESSION", change("optimal objective", x, y, ""));
+                regressions++;
+            }
+            number(a, "optimal_s", x);
+            number(b, "optimal_s", y);
+            checkGrowth(key, "time to optimal", x, y, minSeconds, "s");
+            logRatioSum += std::log(std::max(y, minSeconds) / std::max(x, minSeconds));
+            timed++;
+        } else {
+            // neither optimal: compare the gap, a missing incumbent counts as an infinite gap
+            bool hasA = number(a, "gap", x), hasB = number(b, "gap", y);
+            if (hasA && !hasB) {
+                report(key, "REGRESSION", "incumbent lost");
+                regressions++;
+            } else if (!hasA && hasB) {
+                report(key, "improved", "incumbent found");
+                improvements++;
+            } else if (hasA && hasB) {
+                checkGrowth(key, "gap", x, y, 1e-4, "");
+            }
+        }
+
+        if (number(a, "load_s", x) && number(b, "load_s", y))
+            checkGrowth(key, "load time", x, y, minSeconds, "s");
+        if (number(a, "peak_rss_mb", x) && number(b, "peak_rss_mb", y))
+            checkGrowth(key, "peak RSS", x, y, 1.0, "MB");
+        for (const char* stage : kStageNames) {
+            std::string allocs = std::string(stage) + "_allocs", mb = std::string(stage) + "_mb";
+            if (number(a, allocs.c_str(), x) && number(b, allocs.c_str(), y))
+                checkGrowth(key, (std::string(stage) + " allocations").c_str(), x, y, 100.0, "");
+            if (number(a, mb.c_str(), x) && number(b, mb.c_str(), y))
+                checkGrowth(key, (std::string(stage) + " allocated").c_str(), x, y, 1.0, "MB");
+        }
+    }
+    for (const auto& entry : current)
+        if (!base.count(entry.first))
+            report(entry.first, "new", "not in " + basePath);
+
+    std::printf("%d configurations compared, %d regressions, %d improvements", compared, regressions, improvements);
+    if (timed > 0)
+        std::printf(", time to optimal %.3fx (geometric mean over %d)", std::exp(logRatioSum / timed), timed);
+    std::printf("\n");
+    return regressions == 0 ? 0 : 1;
+}
+
+// ---- matrix mode ----
+
+static bool parseSwitches(const std::string& value, std::vector<bool>& switches)
+{
+    switches.clear();
+    for (const std::string& item : splitList(value)) {
+        if (item != "on" && item != "off")
+            return false;
+        switches.push_back(item == "on");
+    }
+    return !switches.empty();
+}
+
+int main(int argc, const char *argv[])
+{
+    std::string set = "all", outputPath;
+    std::vector<std::string> models;
+    std::vector<int> threads = {1};
+    std::vector<double> timeLimits = {10.0};
+    std::vector<bool> cuts = {true}, heuristics = {true}, mipStarts = {false}, arenas = {false};
+    int repeats = 1;
+    std::string compareBase, compareNew;
+    double threshold = 0.10, minSeconds = 0.05;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        bool ok = true;
+        if (arg == "--compare" && i + 2 < argc) {
+            compareBase = argv[++i];
+            compareNew = argv[++i];
+        } else if (arg == "--threshold" && hasValue) {
+            threshold = std::atof(argv[++i]);
+        } else if (arg == "--min-seconds" && hasValue) {
+            minSeconds = std::atof(argv[++i]);
+        } else if (arg == "--set" && hasValue) {
+            set = argv[++i];
+        } else if (arg == "--models" && hasValue) {
+            models = splitList(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            threads.clear();
+            for (const std::string& item : splitList(argv[++i]))
+                threads.push_back(std::max(1, std::atoi(item.c_str())));
+            ok = !threads.empty();
+        } else if (arg == "--time" && hasValue) {
+            timeLimits.clear();
+            for (const std::string& item : splitList(argv[++i]))
+                timeLimits.push_back(std::atof(item.c_str()));
+            ok = !timeLimits.empty();
+        } else if (arg == "--cuts" && hasValue) {
+            ok = parseSwitches(argv[++i], cuts);
+        } else if (arg == "--heuristics" && hasValue) {
+            ok = parseSwitches(argv[++i], heuristics);
+        } else if (arg == "--mipstart" && hasValue) {
+            ok = parseSwitches(argv[++i], mipStarts);
+        } else if (arg == "--arena" && hasValue) {
+            ok = parseSwitches(argv[++i], arenas);
+        } else if (arg == "--repeat" && hasValue) {
+            repeats = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "-o" && hasValue) {
+            outputPath = argv[++i];
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cout << "Bad argument " << arg << ", see the usage at the top of bench/cbc_bench.cpp" << std::endl;
+            return 2;
+        }
+    }
+
+    if (!compareBase.empty())
+        return compareResults(compareBase, compareNew, threshold, minSeconds);
+
+    std::vector<std::pair<std::string, std::string>> instances; // (set, path)
+    for (const char* dir : {"Sample", "miplib3"}) {
+        std::string dirName = dir;
+        if (set != "all" && set != dirName && !(set == "sample" && dirName == "Sample"))
+            continue;
+        std::vector<std::string> paths;
+        for (const auto& entry : std::filesystem::directory_iterator(std::string(CBC_DATA_DIR) + "/" + dirName)) {
+            std::string path = entry.path().string();
+            if (endsWith(path, ".mps") || endsWith(path, ".lp") || endsWith(path, ".gz"))
+                paths.push_back(path);
+        }
+        std::sort(paths.begin(), paths.end());
+        for (const std::string& path : paths)
+            if (models.empty() || std::find(models.begin(), models.end(), instanceName(path)) != models.end())
+                instances.emplace_back(dirName, path);
+    }
+    if (instances.empty()) {
+        std::cout << "No instances selected" << std::endl;
+        return 2;
+    }
+
+    std::printf("%-14s %-32s %-11s %9s %9s %9s %10s %12s %9s %8s %10s\n", "instance", "config", "status", "load(s)",
+        "first(s)", "solve(s)", "nodes/s", "iterations", "gap", "rss(MB)", "allocs");
+    std::vector<RunRecord> records;
+    for (const auto& instance : instances) {
+        for (int numThreads : threads)
+        for (double timeLimit : timeLimits)
+        for (bool useCuts : cuts)
+        for (bool useHeuristics : heuristics)
+        for (bool useMipStart : mipStarts)
+        for (bool useArena : arenas)
+        for (int repeat = 0; repeat < repeats; repeat++) {
+            RunRecord record;
+            record.instance = instanceName(instance.second);
+            record.set = instance.first;
+            record.config.threads = numThreads;
+            record.config.timeLimit = timeLimit;
+            record.config.cuts = useCuts;
+            record.config.heuristics = useHeuristics;
+            record.config.mipStart = useMipStart;
+            record.config.arena = useArena;
+            record.repeat = repeat;
+            record.run = runInChild(instance.second, record.config);
+            records.push_back(record);
+
+            const BenchRun& run = record.run;
+            char config[64];
+            std::snprintf(config, sizeof(config), "t%d tl%g c:%s h:%s s:%s a:%s", numThreads, timeLimit,
+                onOff(useCuts), onOff(useHeuristics), onOff(useMipStart), onOff(useArena));
+            long long allocations = 0;
+            for (int stage = 0; stage < kNumStages; stage++)
+                allocations += run.stageAllocations[stage];
+            std::printf("%-14s %-32s %-11s %9.3f %9s %9.3f %10.1f %12lld %9s %8.1f %10lld\n", record.instance.c_str(),
+                config, run.status, run.loadSeconds,
+                formatNumber(run.firstIncumbentSeconds, "%.3f", run.firstIncumbentSeconds >= 0.0).c_str(),
+                run.solveSeconds, run.nodes / std::max(1e-6, run.solveSeconds), run.iterations,
+                formatNumber(run.gap, "%.2e", run.hasSolution != 0).c_str(), run.peakRssKb / 1024.0, allocations);
+            std::fflush(stdout);
+        }
+    }
+
+    if (!outputPath.empty()) {
+        std::ofstream out(outputPath);
+        if (!out) {
+            std::cout << "Cannot write " << outputPath << std::endl;
+            return 2;
+        }
+        if (endsWith(outputPath, ".csv"))
+            writeCsv(records, out);
+        else
+            writeJson(records, out);
+        std::cout << records.size() << " runs written to " << outputPath << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,424 @@
+#include "block_structure.h"
+#include "model_reader.h"
+#include "problem_instance.h"
+#include "util.h"
+
+#include "CbcModel.hpp"
+#include "CoinFinite.hpp"
+#include "OsiClpSolverInterface.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <unordered_map>
+
+// Union-find over the columns, with path halving.
+static int findRoot(std::vector<int>& parent, int col)
+{
+    while (parent[col] != col) {
+        parent[col] = parent[parent[col]];
+        col = parent[col];
+    }
+    return col;
+}
+
+// Component of every column over the active rows, -1 for a column in no
+// active row; components are numbered by their first column. Returns the count.
+static int columnComponents(const ProblemInstance& data, const std::vector<char>& rowActive,
+    std::vector<int>& component)
+{
+    std::vector<int> parent(data.numCols);
+    std::iota(parent.begin(), parent.end(), 0);
+    std::vector<char> covered(data.numCols, 0);
+    for (int i = 0; i < data.numRows; i++) {
+        if (!rowActive[i] || data.rowStart[i] == data.rowStart[i + 1])
+            continue;
+        int first = findRoot(parent, data.colIdxs[data.rowStart[i]]);
+        for (int k = data.rowStart[i]; k < data.rowStart[i + 1]; k++) {
+            int col = data.colIdxs[k];
+            covered[col] = 1;
+            int root = findRoot(parent, col);
+            if (root != first)
+                parent[root] = first;
+        }
+    }
+
+    component.assign(data.numCols, -1);
+    std::vector<int> rootComponent(data.numCols, -1);
+    int count = 0;
+    for (int j = 0; j < data.numCols; j++) {
+        if (!covered[j])
+            continue;
+        int root = findRoot(parent, j);
+        if (rootComponent[root] < 0)
+            rootComponent[root] = count++;
+        component[j] = rootComponent[root];
+    }
+    return count;
+}
+
+// Fills rowBlock and linkingRows from colBlock: a row is linking if it is
+// not active or its columns lie in more than one block.
+static void assignRows(const ProblemInstance& data, const std::vector<char>& rowActive, BlockStructure& blocks)
+{
+    blocks.rowBlock.assign(data.numRows, 0);
+    blocks.linkingRows.clear();
+    for (int i = 0; i < data.numRows; i++) {
+        int block = data.rowStart[i] < data.rowStart[i + 1] ? blocks.colBlock[data.colIdxs[data.rowStart[i]]] : 0;
+        bool linking = !rowActive[i];
+        for (int k = data.rowStart[i]; k < data.rowStart[i + 1] && !linking; k++)
+            linking = blocks.colBlock[data.colIdxs[k]] != block;
+        blocks.rowBlock[i] = linking ? -1 : block;
+        if (linking)
+            blocks.linkingRows.push_back(i);
+    }
+}
+
+BlockStructure detectBlocks(const ProblemInstance& data, int maxLinkingRows)
+{
+    if (maxLinkingRows < 0)
+        maxLinkingRows = std::max(1, data.numRows / 20);
+
+    BlockStructure blocks;
+    std::vector<char> rowActive(data.numRows, 1);
+    std::vector<int> component;
+    int count = columnComponents(data, rowActive, component);
+
+    if (count < 2 && maxLinkingRows > 0 && data.numRows > 0) {
+        std::vector<int> byLength(data.numRows);
+        std::iota(byLength.begin(), byLength.end(), 0);
+        std::stable_sort(byLength.begin(), byLength.end(), [&](int a, int b) {
+            return data.rowStart[a + 1] - data.rowStart[a] > data.rowStart[b + 1] - data.rowStart[b];
+        });
+        int limit = std::min(maxLinkingRows, data.numRows);
+        for (int k = 1; count < 2; k = std::min(2 * k, limit)) {
+            std::fill(rowActive.begin(), rowActive.end(), 1);
+            for (int r = 0; r < k; r++)
+                rowActive[byLength[r]] = 0;
+            count = columnComponents(data, rowActive, component);
+            if (k == limit)
+                break;
+        }
+        if (count < 2) {
+            std::fill(rowActive.begin(), rowActive.end(), 1);
+            count = columnComponents(data, rowActive, component);
+        } else {
+            // removed rows that stay inside one component are block rows after all
+            for (int i = 0; i < data.numRows; i++)
+                rowActive[i] = 1;
+        }
+    }
+
+    // columns in no block row go to block 0
+    blocks.numBlocks = std::max(1, count);
+    blocks.colBlock.resize(data.numCols);
+    for (int j = 0; j < data.numCols; j++)
+        blocks.colBlock[j] = std::max(0, component[j]);
+    assignRows(data, rowActive, blocks);
+    return blocks;
+}
+
+static bool isNumber(const std::string& token)
+{
+    char* end = nullptr;
+    std::strtol(token.c_str(), &end, 10);
+    return !token.empty() && *end == '\0';
+}
+
+bool readBlockHints(const std::string& path, const ProblemInstance& data, BlockStructure& blocks)
+{
+    std::string text;
+    if (!readTextFile(path, text)) {
+        std::cout << "cannot read block hints " << path << std::endl;
+        return false;
+    }
+    std::istringstream in(text);
+    std::vector<std::string> tokens;
+    for (std::string token; in >> token;)
+        tokens.push_back(token);
+
+    // DIP writes either "block row" pairs or, per block, a "block count" line
+    // followed by a line of count rows; only the latter has every other line
+    // hold exactly the count of the line before
+    bool counted = false;
+    if (!tokens.empty() && isNumber(tokens[0])) {
+        std::istringstream lines(text);
+        std::vector<std::vector<std::string>> rows;
+        for (std::string line; std::getline(lines, line);) {
+            std::istringstream lineIn(line);
+            std::vector<std::string> row;
+            for (std::string token; lineIn >> token;)
+                row.push_back(token);
+            if (!row.empty())
+                rows.push_back(row);
+        }
+        counted = rows.size() % 2 == 0;
+        for (std::size_t r = 0; counted && r < rows.size(); r += 2)
+            counted = rows[r].size() == 2 && isNumber(rows[r][1])
+                && static_cast<long>(rows[r + 1].size()) == std::atol(rows[r][1].c_str());
+    }
+
+    // block id as written in the file for each row, -1 if not placed
+    std::vector<int> fileBlock(data.numRows, -1);
+    auto place = [&](int row, int block) {
+        if (row < 0 || row >= data.numRows) {
+            std::cout << path << ": row " << row << " out of range" << std::endl;
+            return false;
+        }
+        if (fileBlock[row] >= 0) {
+            std::cout << path << ": row " << row << " is in two blocks" << std::endl;
+            return false;
+        }
+        fileBlock[row] = block;
+        return true;
+    };
+
+    if (counted) {
+        // DIP: block id and row count, then the rows
+        for (std::size_t t = 0; t < tokens.size();) {
+            int block = std::atoi(tokens[t].c_str());
+            int count = std::atoi(tokens[t + 1].c_str());
+            t += 2;
+            for (int k = 0; k < count; k++, t++) {
+                if (!place(std::atoi(tokens[t].c_str()), block))
+                    return false;
+            }
+        }
+    } else if (!tokens.empty() && isNumber(tokens[0])) {
+        // DIP: pairs of block id and row index
+        for (std::size_t t = 0; t + 1 < tokens.size(); t += 2) {
+            if (!place(std::atoi(tokens[t + 1].c_str()), std::atoi(tokens[t].c_str())))
+                return false;
+        }
+    } else {
+        // GCG: sections of row names
+        int block = -1; // -1 outside a BLOCK section
+        for (std::size_t t = 0; t < tokens.size(); t++) {
+            std::string keyword = tokens[t];
+            std::transform(keyword.begin(), keyword.end(), keyword.begin(), ::toupper);
+            if (keyword == "NBLOCKS" || keyword == "PRESOLVED" || keyword == "CONSDEFAULTMASTER") {
+                t++;
+                block = -1;
+            } else if (keyword == "BLOCK" || keyword == "BLOCKCONSS") {
+                block = t + 1 < tokens.size() ? std::atoi(tokens[++t].c_str()) : -1;
+            } else if (keyword == "MASTERCONSS" || keyword == "BLOCKVARS" || keyword == "MASTERVARS"
+                || keyword == "LINKINGVARS") {
+                block = -1;
+            } else if (block >= 0) {
+                int row = data.rowName.find(tokens[t]);
+                if (row < 0) {
+                    std::cout << path << ": unknown row " << tokens[t] << std::endl;
+                    return false;
+                }
+                if (!place(row, block))
+                    return false;
+            }
+        }
+    }
+
+    // columns follow their rows; then renumber the blocks by first column
+    std::vector<int> colFileBlock(data.numCols, -1);
+    for (int i = 0; i < data.numRows; i++) {
+        if (fileBlock[i] < 0)
+            continue;
+        for (int k = data.rowStart[i]; k < data.rowStart[i + 1]; k++) {
+            int& b = colFileBlock[data.colIdxs[k]];
+            if (b >= 0 && b != fileBlock[i]) {
+                std::cout << path << ": column " << data.colIdxs[k] << " is in blocks " << b << " and "
+                          << fileBlock[i] << std::endl;
+                return false;
+            }
+            b = fileBlock[i];
+        }
+    }
+    std::unordered_map<int, int> dense;
+    blocks.colBlock.assign(data.numCols, 0);
+    for (int j = 0; j < data.numCols; j++) {
+        if (colFileBlock[j] < 0)
+            continue;
+        auto inserted = dense.emplace(colFileBlock[j], static_cast<int>(dense.size()));
+        blocks.colBlock[j] = inserted.first->second;
+    }
+    blocks.numBlocks = std::max<int>(1, dense.size());
+
+    std::vector<char> rowActive(data.numRows);
+    for (int i = 0; i < data.numRows; i++)
+        rowActive[i] = fileBlock[i] >= 0;
+    assignRows(data, rowActive, blocks);
+    return true;
+}
+
+ProblemInstance extractBlock(const ProblemInstance& data, const BlockStructure& blocks, int block)
+{
+    ProblemInstance sub;
+    std::vector<int> localCol(data.numCols, -1);
+    sub.numCols = 0;
+    for (int j = 0; j < data.numCols; j++) {
+        if (blocks.colBlock[j] != block)
+            continue;
+        localCol[j] = sub.numCols++;
+        sub.varTypes.push_back(data.varTypes[j]);
+        sub.lb.push_back(data.lb[j]);
+        sub.ub.push_back(data.ub[j]);
+        sub.objCoeffs.push_back(data.objCoeffs[j]);
+        if (!data.colName.empty())
+            sub.colName.push_back(data.colName[j]);
+    }
+
+    sub.numRows = 0;
+    sub.objSense = data.objSense;
+    sub.rowStart.push_back(0);
+    for (int i = 0; i < data.numRows; i++) {
+        if (blocks.rowBlock[i] != block)
+            continue;
+        sub.numRows++;
+        sub.rowtypes.push_back(data.rowtypes[i]);
+        sub.rhs.push_back(data.rhs[i]);
+        sub.rhsrange.push_back(data.rhsrange[i]);
+        if (!data.rowName.empty())
+            sub.rowName.push_back(data.rowName[i]);
+        for (int k = data.rowStart[i]; k < data.rowStart[i + 1]; k++) {
+            sub.colIdxs.push_back(localCol[data.colIdxs[k]]);
+            sub.colCoeffs.push_back(data.colCoeffs[k]);
+        }
+        sub.rowStart.push_back(static_cast<int>(sub.colIdxs.size()));
+    }
+    sub.numNonZeros = static_cast<int>(sub.colIdxs.size());
+    return sub;
+}
+
+// True if the solution satisfies every linking row.
+static bool linkingRowsHold(const ProblemInstance& data, const BlockStructure& blocks,
+    const std::vector<double>& solution)
+{
+    for (int i : blocks.linkingRows) {
+        double activity = 0.0;
+        for (int k = data.rowStart[i]; k < data.rowStart[i + 1]; k++)
+            activity += data.colCoeffs[k] * solution[data.colIdxs[k]];
+        double lower, upper;
+        senseToRowBounds(data.rowtypes[i], data.rhs[i], data.rhsrange[i], lower, upper);
+        double tolerance = 1e-6 * std::max(1.0, std::fabs(activity));
+        if (activity < lower - tolerance || activity > upper + tolerance)
+            return false;
+    }
+    return true;
+}
+
+BlockSolveResult solveBlocks(const ProblemInstance& data, const BlockStructure& blocks, int numThreads,
+    double timeLimit)
+{
+    BlockSolveResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    // largest blocks first, so the small ones fill in at the end
+    std::vector<std::shared_ptr<ProblemInstance>> parts(blocks.numBlocks);
+    std::vector<int> order(blocks.numBlocks);
+    std::iota(order.begin(), order.end(), 0);
+    for (int b = 0; b < blocks.numBlocks; b++)
+        parts[b] = std::make_shared<ProblemInstance>(extractBlock(data, blocks, b));
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return parts[a]->numNonZeros > parts[b]->numNonZeros;
+    });
+
+    std::vector<BatchResult> solved;
+    {
+        BatchSolver batch(numThreads, numThreads);
+        for (int b : order) {
+            BatchJob job;
+            job.name = "block " + std::to_string(b);
+            job.instance = parts[b];
+            job.timeLimit = timeLimit;
+            job.keepSolution = true;
+            batch.submit(job);
+        }
+        solved = batch.wait();
+    }
+    result.blocks.resize(blocks.numBlocks);
+    for (std::size_t k = 0; k < order.size(); k++) {
+        result.blocks[order[k]] = std::move(solved[k]);
+        result.blocks[order[k]].jobId = order[k];
+    }
+
+    // merge in original column order
+    bool allOptimal = true, allSolutions = true;
+    result.status = BatchStatus::Optimal;
+    result.objValue = result.relaxationBound = data.objOffset;
+    result.solution.assign(data.numCols, 0.0);
+    std::vector<int> nextLocal(blocks.numBlocks, 0);
+    for (int j = 0; j < data.numCols; j++) {
+        const BatchResult& part = result.blocks[blocks.colBlock[j]];
+        int local = nextLocal[blocks.colBlock[j]]++;
+        if (part.hasSolution)
+            result.solution[j] = part.solution[local];
+    }
+    for (const BatchResult& part : result.blocks) {
+        allOptimal = allOptimal && part.status == BatchStatus::Optimal;
+        allSolutions = allSolutions && part.hasSolution;
+        result.objValue += part.objValue;
+        result.relaxationBound += part.bestBound;
+        if (part.status == BatchStatus::Failed) {
+            result.status = BatchStatus::Failed;
+            result.message = part.name + ": " + part.message;
+        } else if (part.status == BatchStatus::Infeasible && result.status != BatchStatus::Failed) {
+            // a block on its own is a relaxation, so this holds with linking rows too
+            result.status = BatchStatus::Infeasible;
+            result.message = part.name + " is infeasible";
+        } else if (part.status != BatchStatus::Optimal && result.status == BatchStatus::Optimal) {
+            result.status = BatchStatus::Stopped;
+            result.message = part.name + ": " + part.message;
+        }
+    }
+    result.hasSolution = allSolutions && result.status != BatchStatus::Infeasible
+        && result.status != BatchStatus::Failed;
+    result.bestBound = result.relaxationBound;
+
+    bool merged = blocks.linkingRows.empty()
+        || (allOptimal && result.hasSolution && linkingRowsHold(data, blocks, result.solution));
+    if (merged || result.status == BatchStatus::Infeasible || result.status == BatchStatus::Failed) {
+        if (!result.hasSolution)
+            result.solution.clear();
+        result.seconds = secondsSince(start);
+        return result;
+    }
+
+    // the block optima violate a linking row: solve the whole model
+    result.solvedWhole = true;
+    result.message.clear();
+    OsiClpSolverInterface solver;
+    solver.messageHandler()->setLogLevel(0);
+    loadProblemData(data, solver, false);
+    CbcModel model(solver);
+    model.setLogLevel(0);
+    model.setUseElapsedTime(true);
+    if (timeLimit > 0.0)
+        model.setMaximumSeconds(timeLimit);
+    model.branchAndBound();
+
+    result.hasSolution = model.bestSolution() != nullptr;
+    result.objValue = result.hasSolution ? model.getObjValue() : 0.0;
+    if (result.hasSolution)
+        result.solution.assign(model.bestSolution(), model.bestSolution() + data.numCols);
+    else
+        result.solution.clear();
+    // keep the tighter of the two bounds
+    double bound = model.getBestPossibleObjValue();
+    result.bestBound = data.objSense * bound > data.objSense * result.relaxationBound ? bound : result.relaxationBound;
+    if (model.isProvenOptimal()) {
+        result.status = BatchStatus::Optimal;
+        result.bestBound = result.objValue;
+    } else if (model.isProvenInfeasible()) {
+        result.status = BatchStatus::Infeasible;
+    } else if (model.status() == 2) {
+        result.status = BatchStatus::Failed;
+        result.message = "abandoned by CBC";
+    } else {
+        result.status = BatchStatus::Stopped;
+    }
+    result.seconds = secondsSince(start);
+    return result;
+}
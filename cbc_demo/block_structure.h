@@ -0,0 +1,71 @@
+#pragma once
+
+#include "batch_solver.h"
+
+#include <string>
+#include <vector>
+
+struct ProblemInstance;
+
+/*
+  A partition of the rows and columns into blocks that share no nonzero once
+  the linking rows are taken out. Every column belongs to a block; columns
+  that appear in no block row go to block 0. Rows are numbered as in the
+  ProblemInstance, blocks in the order of their first column.
+*/
+struct BlockStructure
+{
+    int numBlocks = 0;
+    std::vector<int> rowBlock;    // block of each row, -1 for a linking row
+    std::vector<int> colBlock;    // block of each column
+    std::vector<int> linkingRows; // ascending
+};
+
+/*
+  Finds the connected components of the row/column graph of the CSR. When
+  the whole model is one component, the longest rows are tried as linking
+  rows (1, 2, 4, ... up to maxLinkingRows of them); the first set that splits
+  the model is kept, minus the rows that turn out to lie inside one block.
+  maxLinkingRows < 0 allows 5% of the rows. Returns a single block if
+  nothing splits.
+*/
+BlockStructure detectBlocks(const ProblemInstance& data, int maxLinkingRows = -1);
+
+/*
+  Reads a block hint: GCG's .dec (NBLOCKS, BLOCK k and MASTERCONSS sections
+  listing row names) or DIP's .block, either "block row" index pairs or a
+  "block count" line per block followed by its count row indices. Rows the
+  file does not place in a block are linking rows. Returns false, with a
+  message, if the file cannot be read or names a row twice or a column in
+  two blocks.
+*/
+bool readBlockHints(const std::string& path, const ProblemInstance& data, BlockStructure& blocks);
+
+struct BlockSolveResult
+{
+    BatchStatus status = BatchStatus::Failed;
+    std::string message;
+    bool hasSolution = false;
+    double objValue = 0.0;   // including the objective offset
+    double bestBound = 0.0;
+    double relaxationBound = 0.0; // sum of the block bounds, valid even with linking rows
+    bool solvedWhole = false;     // the linking rows were violated, the whole model was solved
+    std::vector<double> solution; // original column order
+    std::vector<BatchResult> blocks; // one per block, jobId is the block index
+    double seconds = 0.0;
+};
+
+/*
+  Solves each block as its own CbcModel, numThreads blocks at a time, largest
+  first, and merges the solutions and objectives. Without linking rows that
+  is the solution of the model. With linking rows the blocks solve a
+  relaxation: if the merged solution satisfies the linking rows it is still
+  optimal, otherwise the whole model is solved, with the relaxation bound
+  reported alongside. timeLimit is wall seconds per solve.
+*/
+BlockSolveResult solveBlocks(const ProblemInstance& data, const BlockStructure& blocks, int numThreads = 0,
+    double timeLimit = 0.0);
+
+// Copies the rows and columns of one block into a ProblemInstance of its own;
+// the objective offset stays with the full model.
+ProblemInstance extractBlock(const ProblemInstance& data, const BlockStructure& blocks, int block);
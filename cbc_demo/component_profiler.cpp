@@ -0,0 +1,548 @@
+#include "component_profiler.h"
+#include "util.h"
+
+#include "CbcModel.hpp"
+#include "CbcCutGenerator.hpp"
+#include "CbcEventHandler.hpp"
+#include "CbcHeuristic.hpp"
+#include "CbcHeuristicDiveCoefficient.hpp"
+#include "CbcHeuristicDiveFractional.hpp"
+#include "CbcHeuristicFPump.hpp"
+#include "CbcHeuristicLocal.hpp"
+#include "CbcHeuristicRINS.hpp"
+#include "CglClique.hpp"
+#include "CglFlowCover.hpp"
+#include "CglGomory.hpp"
+#include "CglKnapsackCover.hpp"
+#include "CglMixedIntegerRounding2.hpp"
+#include "CglProbing.hpp"
+#include "CglTwomir.hpp"
+#include "OsiSolverInterface.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+static const char kProfileMagic[] = "CBCPROFILE";
+static const int kProfileVersion = 1;
+
+// Generators first (index = CBC's generator index), then heuristics.
+struct ProfilerShared
+{
+    ProfilerPolicy policy;
+    std::mutex mutex;
+    std::vector<ComponentStats> components;
+    int numGenerators = 0;
+    std::chrono::steady_clock::time_point start;
+    double lastCheck = 0.0;
+
+    // per component, as it was at its last decision
+    std::vector<double> decidedAt;
+    std::vector<double> decidedSeconds;
+    std::vector<double> decidedGain;
+    std::vector<int> decidedSolutions;
+    std::vector<int> skipped; // calls of a throttled heuristic since it last ran
+
+    double elapsed() const
+    {
+        return secondsSince(start);
+    }
+
+    // Whether a heuristic runs on this call.
+    bool admit(int k)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const ComponentStats& c = components[k];
+        if (c.action == ComponentAction::Disabled)
+            return false;
+        if (c.action == ComponentAction::Throttled && ++skipped[k] < c.throttle)
+            return false;
+        skipped[k] = 0;
+        return true;
+    }
+
+    void recordHeuristic(int k, double seconds, bool found)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        components[k].calls++;
+        components[k].seconds += seconds;
+        components[k].solutions += found;
+    }
+};
+
+static void applyToGenerator(CbcCutGenerator* generator, const ComponentStats& c)
+{
+    if (c.action == ComponentAction::Disabled) {
+        generator->setHowOften(-100);
+    } else if (c.action == ComponentAction::Throttled) {
+        // CBC's own 1000000 + k means off in the tree already
+        int howOften = generator->howOften();
+        if (howOften < 1000000)
+            generator->setHowOften(std::max(howOften, 1) < c.throttle ? c.throttle : std::max(howOften, 1) * 4);
+    }
+}
+
+// Judges every component on what it did since its last decision; called
+// with the mutex held. scale is the magnitude of the current bound.
+static void evaluateComponents(ProfilerShared& shared, CbcModel& model, double now, double scale)
+{
+    const ProfilerPolicy& policy = shared.policy;
+    for (std::size_t k = 0; k < shared.components.size(); k++) {
+        ComponentStats& c = shared.components[k];
+        if (c.action == ComponentAction::Disabled)
+            continue;
+        double used = c.seconds - shared.decidedSeconds[k];
+        double window = now - shared.decidedAt[k];
+        if (used < policy.minSeconds || used < policy.minTimeShare * window)
+            continue;
+        bool productive = c.isHeuristic ? c.solutions > shared.decidedSolutions[k]
+                                        : c.boundGain - shared.decidedGain[k] > policy.gainTolerance * scale;
+        shared.decidedAt[k] = now;
+        shared.decidedSeconds[k] = c.seconds;
+        shared.decidedGain[k] = c.boundGain;
+        shared.decidedSolutions[k] = c.solutions;
+        if (productive)
+            continue;
+        if (c.throttle * 4 > policy.maxThrottle) {
+            c.action = ComponentAction::Disabled;
+        } else {
+            c.action = ComponentAction::Throttled;
+            c.throttle *= 4;
+        }
+        if (!c.isHeuristic && static_cast<int>(k) < model.numberCutGenerators())
+            applyToGenerator(model.cutGenerator(static_cast<int>(k)), c);
+    }
+}
+
+// Times a heuristic and lets the profiler skip it; everything else goes to
+// the wrapped heuristic.
+class ProfiledHeuristic : public CbcHeuristic
+{
+public:
+    ProfiledHeuristic(CbcHeuristic* inner, std::shared_ptr<ProfilerShared> shared, int index)
+        : CbcHeuristic(*inner), inner_(inner), shared_(std::move(shared)), index_(index), innerModel_(model_)
+    {
+    }
+
+    CbcHeuristic* clone() const override
+    {
+        return new ProfiledHeuristic(inner_->clone(), shared_, index_);
+    }
+
+    void setModel(CbcModel* model) override
+    {
+        inner_->setModel(model);
+        CbcHeuristic::setModel(model);
+        innerModel_ = model;
+    }
+
+    void resetModel(CbcModel* model) override
+    {
+        inner_->resetModel(model);
+        model_ = model;
+        innerModel_ = model;
+    }
+
+    int solution(double& objectiveValue, double* newSolution) override
+    {
+        if (!shared_->admit(index_))
+            return 0;
+        syncModel();
+        auto start = std::chrono::steady_clock::now();
+        int found = inner_->solution(objectiveValue, newSolution);
+        shared_->recordHeuristic(index_, secondsSince(start), found > 0);
+        return found;
+    }
+
+    int solution2(double& objectiveValue, double* newSolution, OsiCuts& cs) override
+    {
+        if (!shared_->admit(index_))
+            return 0;
+        syncModel();
+        auto start = std::chrono::steady_clock::now();
+        int found = inner_->solution2(objectiveValue, newSolution, cs);
+        shared_->recordHeuristic(index_, secondsSince(start), found > 0);
+        return found;
+    }
+
+    void validate() override
+    {
+        inner_->validate();
+        setWhen(inner_->when());
+    }
+
+    bool shouldHeurRun(int whereFrom) override
+    {
+        syncModel();
+        return inner_->shouldHeurRun(whereFrom);
+    }
+
+    bool canDealWithOdd() const override { return inner_->canDealWithOdd(); }
+    void generateCpp(FILE* fp) override { inner_->generateCpp(fp); }
+
+private:
+    // CBC moves heuristics between models with the non-virtual setModelOnly
+    void syncModel()
+    {
+        if (innerModel_ != model_) {
+            inner_->setModelOnly(model_);
+            innerModel_ = model_;
+        }
+    }
+
+    std::unique_ptr<CbcHeuristic> inner_;
+    std::shared_ptr<ProfilerShared> shared_;
+    int index_;
+    CbcModel* innerModel_;
+};
+
+// Collects generator statistics at each cut round, shares out the bound
+// movement and triggers the evaluations.
+class ProfilerEventHandler : public CbcEventHandler
+{
+public:
+    ProfilerEventHandler(CbcModel* model, std::shared_ptr<ProfilerShared> shared)
+        : CbcEventHandler(model), shared_(std::move(shared))
+    {
+    }
+
+    CbcEventHandler* clone() const override { return new ProfilerEventHandler(*this); }
+
+    CbcAction event(CbcEvent whichEvent) override
+    {
+        if (model_)
+            onEvent(whichEvent);
+        return noAction;
+    }
+
+    CbcAction event(CbcEvent whichEvent, void*) override
+    {
+        if (model_)
+            onEvent(whichEvent);
+        return noAction;
+    }
+
+    // Adds what each generator did since the last call; returns the cuts per generator.
+    const std::vector<std::int64_t>& collectGenerators()
+    {
+        int count = std::min(model_->numberCutGenerators(), shared_->numGenerators);
+        seconds_.resize(count, 0.0);
+        cuts_.resize(count, 0);
+        calls_.resize(count, 0);
+        roundCuts_.assign(count, 0);
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        for (int i = 0; i < count; i++) {
+            const CbcCutGenerator* generator = model_->cutGenerator(i);
+            ComponentStats& c = shared_->components[i];
+            c.seconds += generator->timeInCutGenerator() - seconds_[i];
+            c.calls += generator->numberTimesEntered() - calls_[i];
+            roundCuts_[i] = generator->numberCutsInTotal() - cuts_[i];
+            c.cuts += roundCuts_[i];
+            seconds_[i] = generator->timeInCutGenerator();
+            calls_[i] = generator->numberTimesEntered();
+            cuts_[i] = generator->numberCutsInTotal();
+        }
+        return roundCuts_;
+    }
+
+private:
+    void onEvent(CbcEvent whichEvent)
+    {
+        switch (whichEvent) {
+        case generatedCuts:
+            onCutRound(false);
+            break;
+        case afterRootCuts:
+            onCutRound(true);
+            break;
+        case node: {
+            double now = shared_->elapsed();
+            if (shared_->policy.adapt && now - shared_->lastCheck >= shared_->policy.checkInterval) {
+                collectGenerators();
+                evaluate(now);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    // The LP bound now against the one at the round before, at the same
+    // node, is what the cuts of that round bought.
+    void onCutRound(bool rootDone)
+    {
+        const OsiSolverInterface* solver = model_->solver();
+        bool optimal = solver->isProvenOptimal();
+        double bound = optimal ? solver->getObjValue() * solver->getObjSense() : 0.0;
+        int nodeCount = model_->getNodeCount();
+        std::vector<std::int64_t> previous = roundCuts_;
+        collectGenerators();
+
+        if (optimal && havePrevious_ && nodeCount == previousNode_ && bound > previousBound_) {
+            std::int64_t total = 0;
+            for (std::int64_t cuts : previous)
+                total += cuts;
+            if (total > 0) {
+                std::lock_guard<std::mutex> lock(shared_->mutex);
+                for (std::size_t i = 0; i < previous.size(); i++)
+                    shared_->components[i].boundGain += (bound - previousBound_) * previous[i] / total;
+            }
+        }
+        havePrevious_ = optimal && !rootDone;
+        previousBound_ = bound;
+        previousNode_ = nodeCount;
+        if (rootDone && shared_->policy.adapt)
+            evaluate(shared_->elapsed());
+    }
+
+    void evaluate(double now)
+    {
+        double scale = std::max(1.0, std::fabs(model_->solver()->getObjValue()));
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        shared_->lastCheck = now;
+        evaluateComponents(*shared_, *model_, now, scale);
+    }
+
+    std::shared_ptr<ProfilerShared> shared_;
+    std::vector<double> seconds_;
+    std::vector<std::int64_t> cuts_;
+    std::vector<int> calls_;
+    std::vector<std::int64_t> roundCuts_; // cuts per generator in the last collection
+    bool havePrevious_ = false;
+    double previousBound_ = 0.0;
+    int previousNode_ = -1;
+};
+
+const char* componentActionName(ComponentAction action)
+{
+    switch (action) {
+    case ComponentAction::Run: return "run";
+    case ComponentAction::Throttled: return "throttled";
+    case ComponentAction::Disabled: return "disabled";
+    }
+    return "";
+}
+
+ComponentProfiler::ComponentProfiler(ProfilerPolicy policy)
+    : shared_(std::make_shared<ProfilerShared>())
+{
+    shared_->policy = policy;
+}
+
+ComponentProfiler::~ComponentProfiler() = default;
+
+void ComponentProfiler::attach(CbcModel& model)
+{
+    ProfilerShared& shared = *shared_;
+    shared.components.clear();
+    shared.numGenerators = model.numberCutGenerators();
+    for (int i = 0; i < shared.numGenerators; i++) {
+        CbcCutGenerator* generator = model.cutGenerator(i);
+        generator->setTiming(true);
+        ComponentStats c;
+        c.name = generator->cutGeneratorName() ? generator->cutGeneratorName() : "generator" + std::to_string(i);
+        shared.components.push_back(c);
+    }
+
+    // take the heuristics out of the model and add them back wrapped
+    int numHeuristics = model.numberHeuristics();
+    std::vector<CbcHeuristic*> heuristics;
+    for (int h = 0; h < numHeuristics; h++)
+        heuristics.push_back(model.heuristic(h));
+    model.setNumberHeuristics(0);
+    for (int h = 0; h < numHeuristics; h++) {
+        ComponentStats c;
+        c.name = heuristics[h]->heuristicName();
+        c.isHeuristic = true;
+        int index = static_cast<int>(shared.components.size());
+        shared.components.push_back(c);
+        ProfiledHeuristic wrapper(heuristics[h], shared_, index); // owns the original from here
+        model.addHeuristic(&wrapper, c.name.c_str());
+    }
+
+    std::size_t count = shared.components.size();
+    shared.decidedAt.assign(count, 0.0);
+    shared.decidedSeconds.assign(count, 0.0);
+    shared.decidedGain.assign(count, 0.0);
+    shared.decidedSolutions.assign(count, 0);
+    shared.skipped.assign(count, 0);
+
+    for (ComponentStats& c : shared.components) {
+        for (const ComponentStats& stored : preloaded_) {
+            if (stored.name != c.name || stored.isHeuristic != c.isHeuristic || stored.action == ComponentAction::Run)
+                continue;
+            c.action = stored.action;
+            c.throttle = stored.throttle;
+            c.preloaded = true;
+        }
+    }
+    for (int i = 0; i < shared.numGenerators; i++)
+        if (shared.components[i].preloaded)
+            applyToGenerator(model.cutGenerator(i), shared.components[i]);
+
+    ProfilerEventHandler handler(&model, shared_);
+    model.passInEventHandler(&handler);
+    shared.start = std::chrono::steady_clock::now();
+    shared.lastCheck = 0.0;
+}
+
+void ComponentProfiler::finish(CbcModel& model)
+{
+    if (auto* handler = dynamic_cast<ProfilerEventHandler*>(model.getEventHandler()))
+        handler->collectGenerators();
+}
+
+std::vector<ComponentStats> ComponentProfiler::stats() const
+{
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    return shared_->components;
+}
+
+int ComponentProfiler::numDisabled() const
+{
+    std::vector<ComponentStats> all = stats();
+    return static_cast<int>(std::count_if(all.begin(), all.end(),
+        [](const ComponentStats& c) { return c.action == ComponentAction::Disabled; }));
+}
+
+int ComponentProfiler::numThrottled() const
+{
+    std::vector<ComponentStats> all = stats();
+    return static_cast<int>(std::count_if(all.begin(), all.end(),
+        [](const ComponentStats& c) { return c.action == ComponentAction::Throttled; }));
+}
+
+void ComponentProfiler::print(std::ostream& out) const
+{
+    char line[200];
+    std::snprintf(line, sizeof(line), "%-22s %-9s %8s %9s %10s %12s %9s %-10s\n", "component", "kind", "calls",
+        "time(s)", "cuts", "bound gain", "solutions", "action");
+    out << line;
+    for (const ComponentStats& c : stats()) {
+        std::snprintf(line, sizeof(line), "%-22s %-9s %8d %9.3f %10lld %12.6g %9d %s%s\n", c.name.c_str(),
+            c.isHeuristic ? "heuristic" : "cuts", c.calls, c.seconds, static_cast<long long>(c.cuts), c.boundGain,
+            c.solutions, componentActionName(c.action), c.preloaded ? " (profile)" : "");
+        out << line;
+    }
+}
+
+static std::string profilePath(const std::string& directory, std::uint64_t fingerprint)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.profile", static_cast<unsigned long long>(fingerprint));
+    return (std::filesystem::path(directory) / name).string();
+}
+
+bool ComponentProfiler::preload(const std::string& directory, std::uint64_t fingerprint)
+{
+    std::ifstream in(profilePath(directory, fingerprint));
+    std::string magic;
+    int version = 0;
+    std::string stored;
+    if (!(in >> magic >> version >> stored) || magic != kProfileMagic || version != kProfileVersion)
+        return false;
+
+    // kind action throttle calls seconds cuts gain solutions name
+    std::vector<ComponentStats> components;
+    std::string line;
+    std::getline(in, line);
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        char kind;
+        int action;
+        ComponentStats c;
+        long long cuts;
+        if (!(fields >> kind >> action >> c.throttle >> c.calls >> c.seconds >> cuts >> c.boundGain >> c.solutions)
+            || action < 0 || action > 2)
+            return false;
+        std::getline(fields >> std::ws, c.name);
+        c.isHeuristic = kind == 'H';
+        c.action = static_cast<ComponentAction>(action);
+        c.cuts = cuts;
+        components.push_back(c);
+    }
+    preloaded_ = std::move(components);
+    return true;
+}
+
+bool ComponentProfiler::store(const std::string& directory, std::uint64_t fingerprint) const
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    std::string path = profilePath(directory, fingerprint);
+    // write aside and rename, so a concurrent preload never sees half a file
+    std::string tmpPath = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream out(tmpPath);
+        char header[64];
+        std::snprintf(header, sizeof(header), "%s %d %016llx\n", kProfileMagic, kProfileVersion,
+            static_cast<unsigned long long>(fingerprint));
+        out << header;
+        char line[200];
+        for (const ComponentStats& c : stats()) {
+            std::snprintf(line, sizeof(line), "%c %d %d %d %.6f %lld %.10g %d %s\n", c.isHeuristic ? 'H' : 'G',
+                static_cast<int>(c.action), c.throttle, c.calls, c.seconds, static_cast<long long>(c.cuts),
+                c.boundGain, c.solutions, c.name.c_str());
+            out << line;
+        }
+        if (!out) {
+            std::cout << "Cannot write " << tmpPath << std::endl;
+            std::filesystem::remove(tmpPath, error);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmpPath, path, error);
+    if (error) {
+        std::cout << "Cannot write " << path << std::endl;
+        std::filesystem::remove(tmpPath, error);
+        return false;
+    }
+    return true;
+}
+
+void addStandardComponents(CbcModel& model)
+{
+    CglProbing probing;
+    probing.setUsingObjective(true);
+    probing.setMaxPass(3);
+    probing.setMaxProbe(100);
+    probing.setMaxLook(50);
+    probing.setRowCuts(3);
+    CglGomory gomory;
+    gomory.setLimit(300);
+    CglKnapsackCover knapsack;
+    CglClique clique;
+    clique.setStarCliqueReport(false);
+    clique.setRowCliqueReport(false);
+    CglMixedIntegerRounding2 mixedIntegerRounding;
+    CglFlowCover flowCover;
+    CglTwomir twomir;
+    model.addCutGenerator(&probing, -1, "Probing");
+    model.addCutGenerator(&gomory, -1, "Gomory");
+    model.addCutGenerator(&knapsack, -1, "Knapsack");
+    model.addCutGenerator(&clique, -1, "Clique");
+    model.addCutGenerator(&mixedIntegerRounding, -1, "MixedIntegerRounding2");
+    model.addCutGenerator(&flowCover, -1, "FlowCover");
+    model.addCutGenerator(&twomir, -1, "Twomir");
+
+    CbcRounding rounding(model);
+    CbcHeuristicLocal local(model);
+    CbcHeuristicFPump pump(model);
+    CbcHeuristicRINS rins(model);
+    CbcHeuristicDiveCoefficient diveCoefficient(model);
+    CbcHeuristicDiveFractional diveFractional(model);
+    model.addHeuristic(&rounding, "Rounding");
+    model.addHeuristic(&local, "LocalSearch");
+    model.addHeuristic(&pump, "FeasibilityPump");
+    model.addHeuristic(&rins, "RINS");
+    model.addHeuristic(&diveCoefficient, "DiveCoefficient");
+    model.addHeuristic(&diveFractional, "DiveFractional");
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CbcModel;
+
+enum class ComponentAction
+{
+    Run,
+    Throttled, // a generator every throttle times as many nodes, a heuristic every throttle-th call
+    Disabled
+};
+
+const char* componentActionName(ComponentAction action);
+
+// What one cut generator or heuristic did during a solve.
+struct ComponentStats
+{
+    std::string name;
+    bool isHeuristic = false;
+    int calls = 0;           // generator entered, heuristic run
+    double seconds = 0.0;
+    std::int64_t cuts = 0;   // cuts generated
+    double boundGain = 0.0;  // LP bound movement of the cut rounds, shared by their cuts
+    int solutions = 0;       // incumbents found by the heuristic
+    ComponentAction action = ComponentAction::Run;
+    int throttle = 1;
+    bool preloaded = false;  // action taken from a stored profile
+};
+
+struct ProfilerPolicy
+{
+    bool adapt = true;             // throttle and disable while solving, else only measure
+    double minSeconds = 0.05;      // time a component must have used since its last decision
+    double minTimeShare = 0.05;    // and its share of the solve time so far
+    double checkInterval = 0.25;   // seconds between evaluations in the tree
+    int maxThrottle = 16;          // a component that stays unproductive past this is disabled
+    double gainTolerance = 1e-6;   // relative bound gain counted as none
+};
+
+struct ProfilerShared;
+
+/*
+  Measures every cut generator and heuristic of a CbcModel and throttles or
+  disables the ones that use time without paying for it:
+
+    CbcModel model(solver);
+    addStandardComponents(model);        // or your own generators and heuristics
+    ComponentProfiler profiler;
+    profiler.preload("./profiles", fingerprint);   // decisions of an earlier solve
+    profiler.attach(model);
+    model.branchAndBound();
+    profiler.finish(model);
+    profiler.store("./profiles", fingerprint);
+    profiler.print(std::cout);
+
+  Generators are timed by CBC itself (CbcCutGenerator::setTiming) and are
+  not wrapped, since CBC treats some of them (probing) by type. The LP bound
+  movement of each cut round is shared out among the generators by the cuts
+  each added to it. Heuristics are wrapped in a timing CbcHeuristic; CBC
+  also checks a few heuristics by type (the feasibility pump, diving), and
+  wrapped they run as plain heuristics. A wrapped heuristic keeps the
+  settings it had when attach() was called.
+
+  Every checkInterval seconds, and after the root cut loop, each component
+  that used at least minSeconds and minTimeShare of the solve since its last
+  decision is judged on what it did since then: a generator that moved the
+  bound by nothing, or a heuristic that found no incumbent, runs a quarter
+  as often (generators: howOften; heuristics: every throttle-th call), and
+  is disabled once its throttle passes maxThrottle. Productive components
+  are left alone.
+
+  Profiles are small text files, one per structural fingerprint
+  (fingerprint.h) in a directory. Preloading one applies its Throttled and
+  Disabled decisions before the solve starts, so the second solve of a
+  model does not pay for learning them again. Meant for serial solves; with
+  CBC threads the thread models adapt on their own copies of the generators.
+*/
+class ComponentProfiler
+{
+public:
+    explicit ComponentProfiler(ProfilerPolicy policy = {});
+    ~ComponentProfiler();
+    ComponentProfiler(const ComponentProfiler&) = delete;
+    ComponentProfiler& operator=(const ComponentProfiler&) = delete;
+
+    // After the generators and heuristics are added, before branchAndBound.
+    void attach(CbcModel& model);
+    // After branchAndBound: final generator totals.
+    void finish(CbcModel& model);
+
+    // Returns false if there is no profile for the fingerprint.
+    bool preload(const std::string& directory, std::uint64_t fingerprint);
+    bool store(const std::string& directory, std::uint64_t fingerprint) const;
+
+    std::vector<ComponentStats> stats() const;
+    int numDisabled() const;
+    int numThrottled() const;
+    void print(std::ostream& out) const;
+
+private:
+    std::shared_ptr<ProfilerShared> shared_;
+    std::vector<ComponentStats> preloaded_;
+};
+
+// The generators and heuristics CbcMain uses by default: probing, Gomory,
+// knapsack, clique, MIR, flow cover and two-step MIR cuts (CBC decides after
+// the root how often), rounding, local search, feasibility pump, RINS and
+// two dives.
+void addStandardComponents(CbcModel& model);
@@ -0,0 +1,137 @@
+#include "fingerprint.h"
+#include "parallel.h"
+#include "problem_instance.h"
+#include "problem_view.h"
+
+#include <cstring>
+#include <vector>
+
+// rows/columns per hashed block, fixed so the hash does not depend on the thread count
+static const int kBlockSize = 4096;
+
+static inline std::uint64_t mix(std::uint64_t h, std::uint64_t value)
+{
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    h = (h ^ value) * 0xc4ceb9fe1a85ec53ULL;
+    return h ^ (h >> 29);
+}
+
+static inline std::uint64_t bits(double value)
+{
+    if (value == 0.0)
+        value = 0.0; // -0.0
+    std::uint64_t word;
+    std::memcpy(&word, &value, sizeof(word));
+    return word;
+}
+
+static int numBlocks(int count)
+{
+    return (count + kBlockSize - 1) / kBlockSize;
+}
+
+// Hashes blocks in parallel, then folds the block hashes in order.
+template <typename Fn>
+static std::uint64_t hashBlocks(std::uint64_t seed, int count, int numThreads, Fn&& hashRange)
+{
+    std::vector<std::uint64_t> blockHash(numBlocks(count));
+    parallelFor(static_cast<int>(blockHash.size()), numThreads, [&](int block) {
+        int begin = block * kBlockSize;
+        int end = std::min(count, begin + kBlockSize);
+        blockHash[block] = hashRange(mix(seed, block), begin, end);
+    });
+    std::uint64_t h = mix(seed, count);
+    for (std::uint64_t value : blockHash)
+        h = mix(h, value);
+    return h;
+}
+
+template <typename Arrays>
+static std::uint64_t structuralHash(const Arrays& a, int numThreads)
+{
+    std::uint64_t h = mix(mix(mix(0x5f0c0e1d2b3a4958ULL, a.numCols), a.numRows), a.numNonZeros);
+    h = mix(h, static_cast<std::uint64_t>(a.objSense));
+
+    h = mix(h, hashBlocks(1, a.numCols, numThreads, [&](std::uint64_t b, int begin, int end) {
+        for (int j = begin; j < end; j++)
+            b = mix(mix(b, static_cast<unsigned char>(a.varType(j))), bits(a.objCoeffs[j]));
+        return b;
+    }));
+
+    h = mix(h, hashBlocks(2, a.numRows, numThreads, [&](std::uint64_t b, int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            int rowBegin = a.rowStart[i], rowEnd = a.rowStart[i + 1];
+            b = mix(mix(b, static_cast<unsigned char>(a.rowtypes[i])), rowEnd - rowBegin);
+            for (int p = rowBegin; p < rowEnd; p++)
+                b = mix(mix(b, a.colIdxs[p]), bits(a.colCoeffs[p]));
+        }
+        return b;
+    }));
+    return h;
+}
+
+template <typename Arrays>
+static std::uint64_t dataHash(const Arrays& a, int numThreads)
+{
+    std::uint64_t h = mix(mix(0x3c6ef372fe94f82bULL, a.numCols), a.numRows);
+    h = mix(h, bits(a.objOffset));
+    h = mix(h, hashBlocks(3, a.numCols, numThreads, [&](std::uint64_t b, int begin, int end) {
+        for (int j = begin; j < end; j++)
+            b = mix(mix(b, bits(a.lb[j])), bits(a.ub[j]));
+        return b;
+    }));
+    h = mix(h, hashBlocks(4, a.numRows, numThreads, [&](std::uint64_t b, int begin, int end) {
+        for (int i = begin; i < end; i++)
+            b = mix(mix(b, bits(a.rhs[i])), bits(a.rhsrange[i]));
+        return b;
+    }));
+    return h;
+}
+
+// Gives ProblemInstance the varType(j) accessor ProblemView already has.
+struct InstanceArrays
+{
+    const ProblemInstance& data;
+    int numCols, numRows, numNonZeros, objSense;
+    double objOffset;
+    const double* lb;
+    const double* ub;
+    const double* objCoeffs;
+    const char* rowtypes;
+    const double* rhs;
+    const double* rhsrange;
+    const int* rowStart;
+    const int* colIdxs;
+    const double* colCoeffs;
+
+    explicit InstanceArrays(const ProblemInstance& d)
+        : data(d), numCols(d.numCols), numRows(d.numRows), numNonZeros(d.numNonZeros), objSense(d.objSense),
+          objOffset(d.objOffset), lb(d.lb.data()), ub(d.ub.data()), objCoeffs(d.objCoeffs.data()),
+          rowtypes(d.rowtypes.data()), rhs(d.rhs.data()), rhsrange(d.rhsrange.data()), rowStart(d.rowStart.data()),
+          colIdxs(d.colIdxs.data()), colCoeffs(d.colCoeffs.data())
+    {
+    }
+
+    char varType(int j) const { return data.varTypes[j]; }
+};
+
+std::uint64_t structuralFingerprint(const ProblemInstance& data, int numThreads)
+{
+    return structuralHash(InstanceArrays(data), numThreads);
+}
+
+std::uint64_t structuralFingerprint(const ProblemView& view, int numThreads)
+{
+    return structuralHash(view, numThreads);
+}
+
+std::uint64_t dataFingerprint(const ProblemInstance& data, int numThreads)
+{
+    return dataHash(InstanceArrays(data), numThreads);
+}
+
+std::uint64_t dataFingerprint(const ProblemView& view, int numThreads)
+{
+    return dataHash(view, numThreads);
+}
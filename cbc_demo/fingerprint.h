@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+struct ProblemInstance;
+struct ProblemView;
+
+/*
+  64-bit hashes of a model, computed over fixed-size row and column blocks on
+  numThreads threads (<= 0 uses every core); the result does not depend on the
+  thread count.
+
+  structuralFingerprint covers what a warm start depends on: dimensions,
+  objective sense and coefficients, variable types, row senses and the sparsity
+  pattern and values of the matrix. Models that differ only in rhs, ranges or
+  bounds share it. dataFingerprint covers exactly those remaining numbers
+  (rhs, ranges, bounds, objective offset), so the pair identifies the model.
+  -0.0 hashes like 0.0; names are not hashed.
+*/
+std::uint64_t structuralFingerprint(const ProblemInstance& data, int numThreads = 0);
+std::uint64_t structuralFingerprint(const ProblemView& view, int numThreads = 0);
+
+std::uint64_t dataFingerprint(const ProblemInstance& data, int numThreads = 0);
+std::uint64_t dataFingerprint(const ProblemView& view, int numThreads = 0);
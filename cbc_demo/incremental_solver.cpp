@@ -0,0 +1,136 @@
+#include "incremental_solver.h"
+#include "mip_start.h"
+#include "model_delta.h"
+#include "problem_instance.h"
+#include "util.h"
+
+#include "CbcModel.hpp"
+#include "CoinFinite.hpp"
+#include "OsiClpSolverInterface.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+IncrementalSolver::IncrementalSolver(const OsiSolverInterface& solver)
+    : solver_(std::make_unique<OsiClpSolverInterface>())
+{
+    solver_->loadProblem(*solver.getMatrixByCol(), solver.getColLower(), solver.getColUpper(),
+        solver.getObjCoefficients(), solver.getRowLower(), solver.getRowUpper());
+    solver_->setObjSense(solver.getObjSense());
+    double offset = 0.0; // Osi keeps the objective constant negated, copied as is
+    solver.getDblParam(OsiObjOffset, offset);
+    solver_->setDblParam(OsiObjOffset, offset);
+    for (int j = 0; j < solver.getNumCols(); j++)
+        if (solver.isInteger(j))
+            solver_->setInteger(j);
+    solver_->messageHandler()->setLogLevel(0);
+}
+
+IncrementalSolver::IncrementalSolver(const ProblemInstance& data)
+    : solver_(std::make_unique<OsiClpSolverInterface>())
+{
+    loadProblemData(data, *solver_, false);
+    solver_->messageHandler()->setLogLevel(0);
+}
+
+IncrementalSolver::~IncrementalSolver() = default;
+
+const OsiSolverInterface& IncrementalSolver::solver() const
+{
+    return *solver_;
+}
+
+int IncrementalSolver::apply(const ModelDelta& delta)
+{
+    auto start = std::chrono::steady_clock::now();
+    int numColsBefore = solver_->getNumCols();
+    int errors = delta.apply(*solver_);
+    if (errors > 0)
+        return errors;
+
+    if (!incumbent_.empty()) {
+        // keep the values of the surviving columns, added ones start at the bound nearest 0
+        std::vector<int> map = delta.columnMap(numColsBefore);
+        std::vector<double> moved(solver_->getNumCols());
+        const double* lower = solver_->getColLower();
+        const double* upper = solver_->getColUpper();
+        for (int j = 0; j < static_cast<int>(map.size()); j++) {
+            if (map[j] < 0)
+                continue;
+            moved[map[j]] = j < numColsBefore ? incumbent_[j] : std::min(std::max(0.0, lower[map[j]]), upper[map[j]]);
+        }
+        incumbent_.swap(moved);
+    }
+    applySeconds_ += secondsSince(start);
+    return 0;
+}
+
+BatchResult IncrementalSolver::solve(double timeLimit, int threads, bool keepSolution)
+{
+    BatchResult result;
+    ResolveInfo info;
+    info.applySeconds = applySeconds_;
+    applySeconds_ = 0.0;
+    info.warmBasis = solved_;
+
+    auto start = std::chrono::steady_clock::now();
+    if (solved_)
+        solver_->resolve();
+    else
+        solver_->initialSolve();
+    solved_ = true;
+    info.lpSeconds = secondsSince(start);
+    info.lpIterations = solver_->getIterationCount();
+    if (solver_->isProvenPrimalInfeasible() || solver_->isProvenDualInfeasible()) {
+        result.status = solver_->isProvenPrimalInfeasible() ? BatchStatus::Infeasible : BatchStatus::Stopped;
+        result.message = solver_->isProvenPrimalInfeasible() ? "" : "relaxation unbounded";
+        result.solveSeconds = info.lpSeconds;
+        info_ = info;
+        return result;
+    }
+
+    double remaining = timeLimit - info.lpSeconds;
+    if (timeLimit > 0.0 && remaining <= 0.0) {
+        result.status = BatchStatus::Stopped;
+        result.message = "time limit reached in the root LP";
+        result.solveSeconds = info.lpSeconds;
+        info_ = info;
+        return result;
+    }
+
+    CbcModel model(*solver_);
+    model.setLogLevel(0);
+    model.setUseElapsedTime(true);
+    if (timeLimit > 0.0)
+        model.setMaximumSeconds(remaining);
+    // CBC runs serial code for 0 threads, 1 would still start the thread machinery
+    model.setNumberThreads(threads > 1 ? threads : 0);
+
+    int numCols = solver_->getNumCols();
+    if (static_cast<int>(incumbent_.size()) == numCols) {
+        // check=true drops the solution if the changes made it infeasible
+        model.setBestSolution(incumbent_.data(), numCols, COIN_DBL_MAX, true);
+        info.incumbentKept = model.bestSolution() != nullptr;
+        if (!info.incumbentKept) {
+            MipStart integers;
+            for (int j = 0; j < numCols; j++)
+                if (solver_->isInteger(j))
+                    integers.emplace_back(j, incumbent_[j]);
+            std::vector<double> repaired;
+            if (completeMipStart(*solver_, integers, repaired, 0)) {
+                model.setBestSolution(repaired.data(), numCols, COIN_DBL_MAX, true);
+                info.incumbentRepaired = model.bestSolution() != nullptr;
+            }
+        }
+    }
+
+    model.branchAndBound();
+    result.solveSeconds = secondsSince(start);
+    collectBatchResult(model, false, true, result);
+    if (result.hasSolution)
+        incumbent_ = result.solution;
+    if (!keepSolution)
+        result.solution.clear();
+    info_ = info;
+    return result;
+}
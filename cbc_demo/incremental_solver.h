@@ -0,0 +1,72 @@
+#pragma once
+
+#include "batch_solver.h"
+
+#include <memory>
+#include <vector>
+
+class ModelDelta;
+class OsiClpSolverInterface;
+class OsiSolverInterface;
+struct ProblemInstance;
+
+// How the last solve of an IncrementalSolver started.
+struct ResolveInfo
+{
+    double applySeconds = 0.0;      // the delta applied since the solve before
+    double lpSeconds = 0.0;         // root LP on the live solver
+    int lpIterations = 0;
+    bool warmBasis = false;         // the LP started from the basis of the solve before
+    bool incumbentKept = false;     // the previous incumbent was still feasible
+    bool incumbentRepaired = false; // it was not, an LP with its integers fixed completed it
+};
+
+/*
+  Solves a model that changes a little between solves, as in a rolling
+  horizon, without copying the solver and building a fresh CbcModel from
+  scratch each time (main.cpp: solver2 = solver1). One live
+  OsiClpSolverInterface keeps the model; ModelDelta batches are applied to
+  it in place and its root LP is re-solved from its own basis, so a few
+  changed bounds cost a few dual simplex iterations. The previous incumbent,
+  mapped through added and deleted columns, becomes the first incumbent of
+  the search; if the changes made it infeasible, its integer values are
+  completed by an LP (completeMipStart) instead.
+
+    IncrementalSolver solver(data);
+    BatchResult first = solver.solve(60.0);
+    for (each period) {
+        ModelDelta delta;
+        delta.setColUpper(j, 0.0);
+        ...
+        solver.apply(delta);
+        BatchResult result = solver.solve(60.0);
+    }
+
+  CbcModel branches on a copy of its solver and cannot be reused for a
+  second branchAndBound, so every solve still clones the live solver once,
+  after the root LP, with the optimal basis in it.
+*/
+class IncrementalSolver
+{
+public:
+    explicit IncrementalSolver(const OsiSolverInterface& solver);
+    explicit IncrementalSolver(const ProblemInstance& data);
+    ~IncrementalSolver();
+
+    // Returns the errors of ModelDelta::apply; on errors nothing changes.
+    int apply(const ModelDelta& delta);
+
+    // threads: CBC threads, 0 or 1 for the serial code
+    BatchResult solve(double timeLimit = 0.0, int threads = 0, bool keepSolution = true);
+
+    const OsiSolverInterface& solver() const;
+    const std::vector<double>& incumbent() const { return incumbent_; }
+    const ResolveInfo& lastResolve() const { return info_; }
+
+private:
+    std::unique_ptr<OsiClpSolverInterface> solver_;
+    bool solved_ = false;
+    double applySeconds_ = 0.0; // since the last solve
+    std::vector<double> incumbent_; // empty without one
+    ResolveInfo info_;
+};
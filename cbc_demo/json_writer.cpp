@@ -0,0 +1,30 @@
+#include "json_writer.h"
+
+#include <cmath>
+#include <cstdio>
+#include <ostream>
+
+void writeJsonString(std::ostream& out, const std::string& value)
+{
+    out << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+            out << ' ';
+        else
+            out << c;
+    }
+    out << '"';
+}
+
+void writeJsonNumber(std::ostream& out, double value, const char* format)
+{
+    if (std::isfinite(value) && std::fabs(value) < 1e50) {
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), format, value);
+        out << buffer;
+    } else {
+        out << "null";
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <iosfwd>
+#include <string>
+
+// The pieces the JSON reports (batch_solver.h, racing_solver.h) are written from.
+
+// A quoted string; quotes and backslashes escaped, control characters as spaces.
+void writeJsonString(std::ostream& out, const std::string& value);
+
+// value in printf format, or null: JSON has no infinity, and CBC reports
+// missing bounds as +-1e50 or more.
+void writeJsonNumber(std::ostream& out, double value, const char* format = "%.17g");
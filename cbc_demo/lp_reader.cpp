@@ -0,0 +1,433 @@
+#include "model_reader.h"
+#include "problem_instance.h"
+
+#include "CoinFinite.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <iostream>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+/*
+  CPLEX LP format, the subset written by CoinLpIO and the commercial solvers:
+  objective, constraints, bounds, generals and binaries. LP is row oriented,
+  so the CSR arrays are filled while the constraints are read.
+*/
+
+enum LpTokenKind { kTokName, kTokNumber, kTokPlus, kTokMinus, kTokLe, kTokGe, kTokEq, kTokColon, kTokEnd };
+
+struct LpToken
+{
+    LpTokenKind kind;
+    std::string_view text;
+    double value;
+    bool lineStart;
+};
+
+static bool isNameChar(char c)
+{
+    return !std::isspace(static_cast<unsigned char>(c)) && c != '+' && c != '-' && c != '<' && c != '>'
+        && c != '=' && c != ':' && c != '\\';
+}
+
+static std::vector<LpToken> tokenizeLp(std::string_view text, int& errors)
+{
+    std::vector<LpToken> tokens;
+    tokens.reserve(text.size() / 4);
+    std::size_t i = 0, n = text.size();
+    bool lineStart = true;
+    while (i < n) {
+        char c = text[i];
+        if (c == '\n') {
+            lineStart = true;
+            i++;
+            continue;
+        }
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            i++;
+            continue;
+        }
+        if (c == '\\') {
+            while (i < n && text[i] != '\n')
+                i++;
+            continue;
+        }
+
+        LpToken token{kTokName, std::string_view(), 0.0, lineStart};
+        std::size_t start = i;
+        lineStart = false;
+        if (c == '+') {
+            token.kind = kTokPlus;
+            i++;
+        } else if (c == '-') {
+            token.kind = kTokMinus;
+            i++;
+        } else if (c == ':') {
+            token.kind = kTokColon;
+            i++;
+        } else if (c == '<' || c == '>' || c == '=') {
+            i++;
+            char next = i < n ? text[i] : '\0';
+            if (c == '<')
+                token.kind = kTokLe;
+            else if (c == '>')
+                token.kind = kTokGe;
+            else
+                token.kind = next == '<' ? kTokLe : next == '>' ? kTokGe : kTokEq;
+            if (next == '=' || (c == '=' && (next == '<' || next == '>')))
+                i++;
+        } else if (std::isdigit(static_cast<unsigned char>(c))
+            || (c == '.' && i + 1 < n && std::isdigit(static_cast<unsigned char>(text[i + 1])))) {
+            token.kind = kTokNumber;
+            auto result = std::from_chars(text.data() + i, text.data() + n, token.value);
+            if (result.ec != std::errc()) {
+                errors++;
+                i++;
+            } else {
+                i = result.ptr - text.data();
+            }
+        } else {
+            while (i < n && isNameChar(text[i]))
+                i++;
+        }
+        token.text = text.substr(start, i - start);
+        tokens.push_back(token);
+    }
+    tokens.push_back({kTokEnd, std::string_view(), 0.0, true});
+    return tokens;
+}
+
+static bool equalsNoCase(std::string_view a, const char* b)
+{
+    std::size_t i = 0;
+    for (; i < a.size() && b[i]; i++)
+        if (std::tolower(static_cast<unsigned char>(a[i])) != b[i])
+            return false;
+    return i == a.size() && b[i] == '\0';
+}
+
+static bool isInfinityName(std::string_view name)
+{
+    return equalsNoCase(name, "inf") || equalsNoCase(name, "infinity");
+}
+
+enum LpSection { kLpNone, kLpMin, kLpMax, kLpSubjectTo, kLpBounds, kLpGenerals, kLpBinaries, kLpSkip, kLpStop };
+
+// Section keyword starting at tokens[pos] (must begin a line); sets the number of tokens it spans.
+static LpSection sectionAt(const std::vector<LpToken>& tokens, std::size_t pos, int& width)
+{
+    const LpToken& token = tokens[pos];
+    width = 1;
+    if (token.kind != kTokName || !token.lineStart)
+        return kLpNone;
+    std::string_view t = token.text;
+    if (equalsNoCase(t, "minimize") || equalsNoCase(t, "minimise") || equalsNoCase(t, "minimum") || equalsNoCase(t, "min"))
+        return kLpMin;
+    if (equalsNoCase(t, "maximize") || equalsNoCase(t, "maximise") || equalsNoCase(t, "maximum") || equalsNoCase(t, "max"))
+        return kLpMax;
+    if (equalsNoCase(t, "st") || equalsNoCase(t, "s.t.") || equalsNoCase(t, "st."))
+        return kLpSubjectTo;
+    if ((equalsNoCase(t, "subject") || equalsNoCase(t, "such")) && tokens[pos + 1].kind == kTokName
+        && (equalsNoCase(tokens[pos + 1].text, "to") || equalsNoCase(tokens[pos + 1].text, "that"))) {
+        width = 2;
+        return kLpSubjectTo;
+    }
+    if (equalsNoCase(t, "bounds") || equalsNoCase(t, "bound"))
+        return kLpBounds;
+    if (equalsNoCase(t, "generals") || equalsNoCase(t, "general") || equalsNoCase(t, "gen")
+        || equalsNoCase(t, "integers") || equalsNoCase(t, "integer"))
+        return kLpGenerals;
+    if (equalsNoCase(t, "binaries") || equalsNoCase(t, "binary") || equalsNoCase(t, "bin"))
+        return kLpBinaries;
+    if (equalsNoCase(t, "semi-continuous") || equalsNoCase(t, "semis") || equalsNoCase(t, "semi")
+        || equalsNoCase(t, "sos"))
+        return kLpSkip;
+    if (equalsNoCase(t, "end"))
+        return kLpStop;
+    return kLpNone;
+}
+
+namespace {
+
+struct LpParser
+{
+    const std::vector<LpToken>& tokens;
+    ProblemInstance& data;
+    std::size_t pos = 0;
+    int errors = 0;
+
+    // a node per column, bumped from one arena and freed with the parser
+    std::pmr::monotonic_buffer_resource scratch;
+    std::pmr::unordered_map<std::string_view, int> colIndex;
+    std::vector<std::string_view> colNames;
+    std::vector<std::pair<int, double>> rowTerms;
+
+    LpParser(const std::vector<LpToken>& t, ProblemInstance& d)
+        : tokens(t), data(d), scratch(d.resource()), colIndex(&scratch)
+    {
+    }
+
+    bool atSection() const
+    {
+        int width;
+        return tokens[pos].kind == kTokEnd || sectionAt(tokens, pos, width) != kLpNone;
+    }
+
+    int column(std::string_view name)
+    {
+        auto it = colIndex.emplace(name, static_cast<int>(colNames.size()));
+        if (it.second) {
+            colNames.push_back(name);
+            data.objCoeffs.push_back(0.0);
+            data.lb.push_back(0.0);
+            data.ub.push_back(COIN_DBL_MAX);
+            data.varTypes.push_back('C');
+        }
+        return it.first->second;
+    }
+
+    void error(const char* what)
+    {
+        const LpToken& token = tokens[pos];
+        std::cout << "LP " << what << " near '" << token.text << "'" << std::endl;
+        errors++;
+    }
+
+    // optional sign followed by a number or inf
+    bool signedNumber(double& value)
+    {
+        double sign = 1.0;
+        while (tokens[pos].kind == kTokPlus || tokens[pos].kind == kTokMinus)
+            sign = tokens[pos++].kind == kTokMinus ? -sign : sign;
+        const LpToken& token = tokens[pos];
+        if (token.kind == kTokNumber) {
+            value = sign * token.value;
+        } else if (token.kind == kTokName && isInfinityName(token.text)) {
+            value = sign * COIN_DBL_MAX;
+        } else {
+            return false;
+        }
+        pos++;
+        return true;
+    }
+
+    // linear terms up to a sense or the next section; constants are summed up
+    void expression(double& constant)
+    {
+        rowTerms.clear();
+        constant = 0.0;
+        while (!atSection()) {
+            LpTokenKind kind = tokens[pos].kind;
+            if (kind == kTokLe || kind == kTokGe || kind == kTokEq)
+                return;
+            double sign = 1.0;
+            while (tokens[pos].kind == kTokPlus || tokens[pos].kind == kTokMinus)
+                sign = tokens[pos++].kind == kTokMinus ? -sign : sign;
+            double coeff = 1.0;
+            bool hasNumber = false;
+            if (tokens[pos].kind == kTokNumber) {
+                coeff = tokens[pos++].value;
+                hasNumber = true;
+            }
+            if (tokens[pos].kind == kTokName && !atSection()) {
+                rowTerms.emplace_back(column(tokens[pos++].text), sign * coeff);
+            } else if (hasNumber) {
+                constant += sign * coeff;
+            } else {
+                error("expected a term");
+                pos++;
+            }
+        }
+    }
+
+    bool rowName(std::string_view& name)
+    {
+        if (tokens[pos].kind == kTokName && tokens[pos + 1].kind == kTokColon) {
+            name = tokens[pos].text;
+            pos += 2;
+            return true;
+        }
+        return false;
+    }
+
+    void objective()
+    {
+        std::string_view name;
+        rowName(name);
+        double constant;
+        expression(constant);
+        for (const auto& term : rowTerms)
+            data.objCoeffs[term.first] += term.second;
+        data.objOffset += constant;
+    }
+
+    void constraint(std::vector<double>& rowLower, std::vector<double>& rowUpper)
+    {
+        std::string_view name;
+        bool named = rowName(name);
+        double constant;
+        expression(constant);
+        LpTokenKind sense = tokens[pos].kind;
+        double rhs;
+        if ((sense != kTokLe && sense != kTokGe && sense != kTokEq) || (pos++, !signedNumber(rhs))) {
+            error("bad constraint");
+            while (!atSection() && !(tokens[pos].kind == kTokName && tokens[pos + 1].kind == kTokColon))
+                pos++;
+            return;
+        }
+        rhs -= constant;
+
+        // one entry per column, sorted like a solver's row-major copy
+        std::sort(rowTerms.begin(), rowTerms.end());
+        for (std::size_t k = 0; k < rowTerms.size(); k++) {
+            if (k > 0 && rowTerms[k].first == rowTerms[k - 1].first) {
+                data.colCoeffs.back() += rowTerms[k].second;
+                continue;
+            }
+            data.colIdxs.push_back(rowTerms[k].first);
+            data.colCoeffs.push_back(rowTerms[k].second);
+        }
+        data.rowStart.push_back(static_cast<int>(data.colIdxs.size()));
+
+        rowLower.push_back(sense == kTokLe ? -COIN_DBL_MAX : rhs);
+        rowUpper.push_back(sense == kTokGe ? COIN_DBL_MAX : rhs);
+        if (named) {
+            data.rowName.push_back(name);
+        } else {
+            char buffer[16];
+            std::snprintf(buffer, sizeof(buffer), "R%07d", static_cast<int>(data.rowName.size()));
+            data.rowName.push_back(buffer);
+        }
+    }
+
+    void applyBound(int col, LpTokenKind sense, double value, bool valueOnLeft)
+    {
+        if (sense == kTokEq) {
+            data.lb[col] = data.ub[col] = value;
+        } else if ((sense == kTokLe) != valueOnLeft) {
+            data.ub[col] = value;
+        } else {
+            data.lb[col] = value;
+        }
+    }
+
+    void bound()
+    {
+        double value;
+        std::size_t start = pos;
+        if (signedNumber(value)) {
+            // value <= x [<= value]
+            LpTokenKind sense = tokens[pos].kind;
+            if ((sense == kTokLe || sense == kTokGe || sense == kTokEq) && tokens[pos + 1].kind == kTokName) {
+                pos++;
+                int col = column(tokens[pos++].text);
+                applyBound(col, sense, value, true);
+                sense = tokens[pos].kind;
+                if (sense == kTokLe || sense == kTokGe || sense == kTokEq) {
+                    pos++;
+                    if (signedNumber(value))
+                        applyBound(col, sense, value, false);
+                    else
+                        error("bad bound");
+                }
+                return;
+            }
+        } else if (tokens[pos].kind == kTokName) {
+            int col = column(tokens[pos++].text);
+            if (tokens[pos].kind == kTokName && equalsNoCase(tokens[pos].text, "free") && !atSection()) {
+                pos++;
+                data.lb[col] = -COIN_DBL_MAX;
+                data.ub[col] = COIN_DBL_MAX;
+                return;
+            }
+            LpTokenKind sense = tokens[pos].kind;
+            if (sense == kTokLe || sense == kTokGe || sense == kTokEq) {
+                pos++;
+                if (signedNumber(value)) {
+                    applyBound(col, sense, value, false);
+                    return;
+                }
+            }
+        }
+        pos = std::max(pos, start + 1);
+        error("bad bound");
+    }
+};
+
+} // namespace
+
+int readLpText(std::string_view text, ProblemInstance& data)
+{
+    int tokenErrors = 0;
+    std::vector<LpToken> tokens = tokenizeLp(text, tokenErrors);
+
+    data = ProblemInstance();
+    data.objSense = 1;
+    data.objOffset = 0.0;
+    data.rowStart.push_back(0);
+
+    LpParser parser(tokens, data);
+    parser.errors = tokenErrors;
+    std::vector<double> rowLower, rowUpper;
+    LpSection section = kLpNone;
+    while (tokens[parser.pos].kind != kTokEnd) {
+        int width;
+        LpSection next = sectionAt(tokens, parser.pos, width);
+        if (next != kLpNone) {
+            if (next == kLpStop)
+                break;
+            section = next;
+            parser.pos += width;
+            if (section == kLpMax)
+                data.objSense = -1;
+            if (section == kLpMin || section == kLpMax)
+                parser.objective();
+            continue;
+        }
+
+        switch (section) {
+        case kLpSubjectTo:
+            parser.constraint(rowLower, rowUpper);
+            break;
+        case kLpBounds:
+            parser.bound();
+            break;
+        case kLpGenerals:
+        case kLpBinaries:
+            if (tokens[parser.pos].kind == kTokName) {
+                int col = parser.column(tokens[parser.pos].text);
+                data.varTypes[col] = 'I';
+                if (section == kLpBinaries) {
+                    data.lb[col] = 0.0;
+                    data.ub[col] = 1.0;
+                }
+            } else {
+                parser.error("expected a variable name");
+            }
+            parser.pos++;
+            break;
+        case kLpSkip:
+            parser.pos++;
+            break;
+        default:
+            parser.error("unexpected text");
+            parser.pos++;
+            break;
+        }
+    }
+
+    data.numCols = static_cast<int>(parser.colNames.size());
+    data.numRows = static_cast<int>(rowLower.size());
+    data.numNonZeros = static_cast<int>(data.colIdxs.size());
+    data.rowtypes.resize(data.numRows);
+    data.rhs.resize(data.numRows);
+    data.rhsrange.resize(data.numRows);
+    for (int i = 0; i < data.numRows; i++)
+        rowBoundsToSense(rowLower[i], rowUpper[i], data.rowtypes[i], data.rhs[i], data.rhsrange[i]);
+    data.colName.assign(parser.colNames.begin(), parser.colNames.end());
+    return parser.errors;
+}
@@ -4,114 +4,9 @@
 #include "OsiClpSolverInterface.hpp"
 #include <fstream>
 
-struct ProblemInstance
-{
-    int numCols;
-    std::vector<char> varTypes;
-    std::vector<double> lb;
-    std::vector<double> ub;
-    std::vector<double> objCoeffs;
-    
-    int numRows;
-    int numNonZeros;
-    int objSense;
-    std::vector<char> rowtypes;
-    std::vector<double> rhs;
-    std::vector<double> rhsrange;
-    std::vector<int> rowStart;
-    std::vector<int> colIdxs;
-    std::vector<double> colCoeffs;
-    std::vector<std::string> colName;
-    std::vector<std::string> rowName;
-};
-
-
-ProblemInstance getProblemData(CbcModel& model)
-{
-    ProblemInstance data;
-    data.numRows = model.solver()->getNumRows();
-    data.numCols = model.solver()->getNumCols();
-    data.numNonZeros = model.solver()->getNumElements(); // get the number of nonzeros elements 
-    data.objSense = model.getObjSense(); // get the objective sense (1 for min (default), -1 for max,)
-    
-    /* col types:
-       - 0 - continuous
-       - 1 - binary
-       - 2 - general integer
-       - 3 - if supported - semi-continuous
-       - 4 - if supported - semi-continuous integer
-    */
-    data.varTypes = std::vector<char>(data.numCols);
-    for (int i = 0; i < data.numCols; i++) 
-    {
-      if (model.solver()->isContinuous(i)) {
-            data.varTypes[i] = 'C';
-        } else if (model.solver()->isInteger(i)) {
-            data.varTypes[i] = 'I';
-        } else {
-            std::cout << "Var " << i << " is neither continuous nor integer." << std::endl;
-        }
-        // model.solver()->isBinary(i)
-        // model.solver()->isIntegerNonBinary(i)
-    }
-    
-    const double *lb = model.solver()->getColLower();
-    const double *ub = model.solver()->getColUpper();
-
-    data.lb = std::vector<double>(data.numCols);
-    data.ub = std::vector<double>(data.numCols);
-
-    for(int i = 0; i < data.numCols; i++) {
-        data.lb[i] = lb[i];
-        data.ub[i] = ub[i];
-    }
-    
-    const double* objCoeffs = model.solver()->getObjCoefficients();
-    data.objCoeffs = std::vector<double>(data.numCols);
-    for(int i = 0; i < data.numCols; i++) data.objCoeffs[i] = objCoeffs[i];
-
-    const char* rowtypes = model.solver()->getRowSense();
-    data.rowtypes = std::vector<char>(data.numRows);
-    for(int i = 0; i < data.numRows; i++) data.rowtypes[i] = rowtypes[i];
-
-    /** Get pointer to array[getNumRows()] of row constraint senses.
-        <li>'L': <= constraint
-        <li>'E': =  constraint
-        <li>'G': >= constraint
-        <li>'R': ranged constraint
-        <li>'N': free constraint
-    */
-
-    const double* rhs = model.solver()->getRightHandSide();
-    data.rhs = std::vector<double>(data.numRows);
-    for(int i = 0; i < data.numRows; i++) data.rhs[i] = rhs[i];
-    
-    // get CSR matrix 
-    const CoinPackedMatrix * matrixByRow = model.solver()->getMatrixByRow();
-    const double *colCoeffs = matrixByRow->getElements();
-    const int *colIdxs = matrixByRow->getIndices();
-    const int *rowStart = matrixByRow->getVectorStarts();
-    
-    // data.colCoeffs[data.rowStart[i]:data.rowStart[i+1]] means the nonzero elements of row i
-    // data.colIdxs[data.rowStart[i]:data.rowStart[i+1]] means the column index of the nonzero elements of row i
-    data.colCoeffs = std::vector<double>(data.numNonZeros); // coefficient of each nonzero element
-    data.rowStart = std::vector<int>(data.numRows + 1); // start index of each row
-    data.colIdxs = std::vector<int>(data.numNonZeros); // column index of each nonzero element
-
-    for (int i = 0; i < data.numNonZeros; i++) {
-        data.colCoeffs[i] = colCoeffs[i];
-        data.colIdxs[i] = colIdxs[i];
-    }
-    for (int i = 0; i < data.numNonZeros + 1; i++) data.rowStart[i] = rowStart[i];
-    
-    for (int i = 0; i < data.numCols; i++)
-       data.colName.push_back(model.solver()->getColName(i));
-    
-    for (int i = 0; i < data.numRows; i++)
-       data.rowName.push_back(model.solver()->getRowName(i));
-
-    return data;
-}
+#include "mip_start.h"
+#include "problem_instance.h"
+#include "problem_view.h"
 
 
 int main(int argc, const char *argv[]) {
@@ -179,7 +74,9 @@ int main(int argc, const char *argv[]) {
   
   CbcModel model(solver1);
 
-  ProblemInstance data = getProblemData(model);
+  // zero-copy view over the solver arrays, use getProblemData(model) for an owning copy.
+  // CbcModel works on its own clone, so solver1 stays untouched and the view stays valid
+  ProblemView data = getProblemView(solver1);
   // data.printStat();
 
   // Set the number of threads to use in parallel
@@ -188,11 +85,13 @@ int main(int argc, const char *argv[]) {
   model.setLogLevel(1); // log level range from 0-3
   model.setMaximumSeconds(60.0); // set time limit
   
-  // set initial solution
-  std::vector<std::pair< std::string, double > > initSol;
-  for (int i = 0; i < numVar; i++)
-      initSol.push_back(std::make_pair(data.colName[i], 0.0)); 
-  model.setMIPStart(initSol);
+  // set initial solution by column index (mip_start.h); model.setMIPStart takes
+  // (name, value) pairs and is only read by the cbc driver, not by branchAndBound
+  // columns left out are completed by an LP (and a short search if needed)
+  MipStart initSol;
+  // x3 = 1 on purpose: the all-zero start used before violates 0.5*x1 + x2 + 21.8*x3 >= 22
+  initSol.emplace_back(3, 1.0); // x3 = 1
+  applyMipStart(model, initSol);
   
   // start branch and bound tree search
   model.branchAndBound();
@@ -223,7 +122,7 @@ int main(int argc, const char *argv[]) {
       const double *solution = model.bestSolution();
       for (int i = 0; i < numVar; i++) {
           double value = solution[i];
-          std::cout << data.colName[i] << ":" << value << ", ";
+          std::cout << data.colName(i) << ":" << value << ", ";
       }
       std::cout << std::endl;
       std::cout << "Obj value: " << model.getObjValue() << std::endl; // get objecitve value
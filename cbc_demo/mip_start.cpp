@@ -0,0 +1,183 @@
+#include "mip_start.h"
+#include "model_reader.h"
+#include "name_table.h"
+
+#include "CbcModel.hpp"
+#include "CoinFinite.hpp"
+#include "OsiSolverInterface.hpp"
+
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string_view>
+
+static const double kIntegerTolerance = 1e-6;
+
+bool completeMipStart(const OsiSolverInterface& solver, const MipStart& start, std::vector<double>& solution,
+    int maxNodes)
+{
+    int numCols = solver.getNumCols();
+    std::unique_ptr<OsiSolverInterface> fixed(solver.clone());
+    fixed->messageHandler()->setLogLevel(0);
+    fixed->setHintParam(OsiDoReducePrint, true, OsiHintTry);
+    for (const auto& entry : start) {
+        int col = entry.first;
+        if (col < 0 || col >= numCols) {
+            std::cout << "MIP start: column " << col << " out of range" << std::endl;
+            return false;
+        }
+        if (solver.isInteger(col)) {
+            double value = std::floor(entry.second + 0.5);
+            fixed->setColBounds(col, value, value);
+        }
+    }
+
+    fixed->initialSolve();
+    if (!fixed->isProvenOptimal()) {
+        std::cout << "MIP start: no feasible completion" << std::endl;
+        return false;
+    }
+    solution.assign(fixed->getColSolution(), fixed->getColSolution() + numCols);
+    bool integral = true;
+    for (int j = 0; j < numCols && integral; j++)
+        integral = !solver.isInteger(j) || std::fabs(solution[j] - std::floor(solution[j] + 0.5)) <= kIntegerTolerance;
+
+    if (!integral) {
+        // the start leaves integers free, finish them on the restricted model
+        CbcModel completion(*fixed);
+        completion.setLogLevel(0);
+        completion.setMaximumNodes(maxNodes);
+        completion.branchAndBound();
+        if (!completion.bestSolution()) {
+            std::cout << "MIP start: no integer completion within " << maxNodes << " nodes" << std::endl;
+            return false;
+        }
+        solution.assign(completion.bestSolution(), completion.bestSolution() + numCols);
+    }
+    return true;
+}
+
+bool applyMipStart(CbcModel& model, const MipStart& start, int maxNodes)
+{
+    std::vector<double> solution;
+    if (!completeMipStart(*model.solver(), start, solution, maxNodes))
+        return false;
+
+    // check=true re-solves with the integers fixed and drops the solution if it is infeasible
+    model.setBestSolution(solution.data(), static_cast<int>(solution.size()), COIN_DBL_MAX, true);
+    if (!model.bestSolution()) {
+        std::cout << "MIP start: completed solution rejected" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int resolveMipStart(const NameTable& colNames, const std::vector<std::pair<std::string, double>>& named,
+    MipStart& start)
+{
+    start.clear();
+    start.reserve(named.size());
+    int unknown = 0;
+    for (const auto& entry : named) {
+        int col = colNames.find(entry.first);
+        if (col < 0) {
+            unknown++;
+            continue;
+        }
+        start.emplace_back(col, entry.second);
+    }
+    return unknown;
+}
+
+bool writeSolution(const std::string& path, const NameTable& colNames, const double* x, int numCols,
+    double objValue, const double* objCoeffs)
+{
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        std::cout << "Cannot open " << path << std::endl;
+        return false;
+    }
+    std::fprintf(file, "Solution - objective value %.15g\n", objValue);
+    std::string fallback;
+    for (int j = 0; j < numCols; j++) {
+        if (x[j] == 0.0)
+            continue;
+        std::string_view name;
+        if (j < colNames.size()) {
+            name = colNames[j];
+        } else {
+            fallback = "C" + std::to_string(j);
+            name = fallback;
+        }
+        std::fprintf(file, "%7d %-19.*s %-19.15g %.15g\n", j, static_cast<int>(name.size()), name.data(), x[j],
+            objCoeffs ? objCoeffs[j] : 0.0);
+    }
+    bool ok = std::fclose(file) == 0;
+    if (!ok)
+        std::cout << "Write " << path << " failed" << std::endl;
+    return ok;
+}
+
+static bool isNumber(std::string_view token, double& value)
+{
+    const char* last = token.data() + token.size();
+    auto result = std::from_chars(token.data(), last, value);
+    return result.ec == std::errc() && result.ptr == last;
+}
+
+bool readMipStart(const std::string& path, const NameTable& colNames, MipStart& start)
+{
+    std::string text;
+    if (!readTextFile(path, text))
+        return false;
+
+    start.clear();
+    int unknown = 0;
+    std::vector<std::string_view> tokens;
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        std::size_t eol = text.find('\n', pos);
+        if (eol == std::string::npos)
+            eol = text.size();
+        std::string_view line(text.data() + pos, eol - pos);
+        pos = eol + 1;
+
+        tokens.clear();
+        std::size_t i = 0;
+        while (i < line.size()) {
+            while (i < line.size() && std::isspace(static_cast<unsigned char>(line[i])))
+                i++;
+            std::size_t begin = i;
+            while (i < line.size() && !std::isspace(static_cast<unsigned char>(line[i])))
+                i++;
+            if (i > begin)
+                tokens.push_back(line.substr(begin, i - begin));
+        }
+        // the driver marks infeasible values with "**"
+        std::size_t first = !tokens.empty() && tokens[0] == "**" ? 1 : 0;
+        std::size_t count = tokens.size() - first;
+
+        double index = -1.0, value = 0.0;
+        std::string_view name;
+        if (count >= 3 && isNumber(tokens[first], index) && isNumber(tokens[first + 2], value)) {
+            name = tokens[first + 1];
+        } else if (count == 2 && isNumber(tokens[first + 1], value)) {
+            name = tokens[first];
+        } else {
+            continue; // status line or comment
+        }
+
+        int col = colNames.empty() ? static_cast<int>(index) : colNames.find(name);
+        if (col < 0) {
+            unknown++;
+            continue;
+        }
+        start.emplace_back(col, value);
+    }
+    if (unknown > 0)
+        std::cout << path << ": " << unknown << " unknown columns skipped" << std::endl;
+    return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+class CbcModel;
+class NameTable;
+class OsiSolverInterface;
+
+// A partial solution by column index, e.g. from a heuristic or an earlier solve.
+using MipStart = std::vector<std::pair<int, double>>;
+
+/*
+  Index-based replacement for CbcModel::setMIPStart, which takes (name,
+  value) pairs and leaves them to the CbcMain driver (plain branchAndBound
+  ignores them). The listed integer columns are fixed at their rounded
+  values and an LP over the remaining columns completes the solution, as the
+  driver does; if that LP leaves integers fractional, a short branch and
+  bound (maxNodes) on the fixed model finishes it. The completed solution
+  becomes the incumbent through setBestSolution, which checks it again.
+
+    MipStart start;
+    for (int j : chosen)
+        start.emplace_back(j, 1.0);
+    applyMipStart(model, start);
+    model.branchAndBound();
+
+  Returns false, with a message, if the start has unknown columns or cannot
+  be completed to a feasible solution.
+*/
+bool applyMipStart(CbcModel& model, const MipStart& start, int maxNodes = 1000);
+
+// The completion behind applyMipStart without touching a model: solution
+// gets every column of the solver.
+bool completeMipStart(const OsiSolverInterface& solver, const MipStart& start, std::vector<double>& solution,
+    int maxNodes = 1000);
+
+// Resolves (name, value) pairs through the name index. Unknown names are
+// skipped and counted; the return value is their number.
+int resolveMipStart(const NameTable& colNames, const std::vector<std::pair<std::string, double>>& named,
+    MipStart& start);
+
+/*
+  Solution files in the layout the cbc driver writes, one nonzero per line:
+
+    Optimal - objective value 508.3
+          0 x1                  1                   0
+
+  i.e. index, name, value and (optionally) the objective coefficient.
+  readMipStart also takes plain "name value" lines and resolves the names
+  with colNames.find, so reading a start costs one hash lookup per line.
+*/
+bool writeSolution(const std::string& path, const NameTable& colNames, const double* x, int numCols,
+    double objValue, const double* objCoeffs = nullptr);
+bool readMipStart(const std::string& path, const NameTable& colNames, MipStart& start);
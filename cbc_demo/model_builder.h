@@ -0,0 +1,456 @@
+#pragma once
+
+#include "problem_instance.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+#include <iostream>
+#include <memory_resource>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class LinExpr;
+
+/*
+  Expression templates behind the LinExpr syntax of ModelBuilder. 2 * x + 3 * y
+  is a small tree of value types, Sum<Scaled<Var>, Scaled<Var>>, and nothing is
+  allocated until ModelBuilder::addConstr walks it with terms(), writing every
+  (column, coefficient) pair straight into the CSR buffers. A LinExpr inside
+  a tree is held by reference, so keep trees in the statement that builds
+  them (auto e = x + y; is fine, auto e = makeExpr() + x; dangles).
+*/
+namespace linexpr {
+
+template <typename E>
+struct Expr
+{
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+template <typename E>
+using Stored = std::conditional_t<std::is_same_v<E, LinExpr>, const LinExpr&, E>;
+
+struct Constant : Expr<Constant>
+{
+    double value;
+
+    explicit Constant(double v) : value(v) {}
+    template <typename F>
+    void terms(F&&) const {}
+    double constant() const { return value; }
+};
+
+template <typename A, typename B>
+struct Sum : Expr<Sum<A, B>>
+{
+    Stored<A> a;
+    Stored<B> b;
+
+    Sum(const A& x, const B& y) : a(x), b(y) {}
+    template <typename F>
+    void terms(F&& f) const
+    {
+        a.terms(f);
+        b.terms(f);
+    }
+    double constant() const { return a.constant() + b.constant(); }
+};
+
+template <typename A>
+struct Scaled : Expr<Scaled<A>>
+{
+    Stored<A> a;
+    double k;
+
+    Scaled(const A& x, double factor) : a(x), k(factor) {}
+    template <typename F>
+    void terms(F&& f) const
+    {
+        a.terms([&](int col, double coef) { f(col, k * coef); });
+    }
+    double constant() const { return k * a.constant(); }
+};
+
+// expr <= rhs, expr >= rhs or expr == rhs, for ModelBuilder::addConstr
+template <typename E>
+struct TempConstr
+{
+    Stored<E> expr;
+    char sense; // 'L', 'G' or 'E'
+    double rhs;
+};
+
+} // namespace linexpr
+
+// Column handle of a ModelBuilder.
+struct Var : linexpr::Expr<Var>
+{
+    int index = -1;
+
+    Var() = default;
+    explicit Var(int j) : index(j) {}
+    template <typename F>
+    void terms(F&& f) const { f(index, 1.0); }
+    double constant() const { return 0.0; }
+};
+
+/*
+  Materialized expression for sums built in loops, like GRBLinExpr:
+
+    LinExpr cost;
+    cost.reserve(n);
+    for (int j = 0; j < n; j++)
+        cost += c[j] * x[j];
+    builder.setObjective(cost);
+
+  Terms are appended as they come; repeated columns are merged when the
+  expression is added to a builder.
+*/
+class LinExpr : public linexpr::Expr<LinExpr>
+{
+public:
+    LinExpr() = default;
+    LinExpr(double constant) : constant_(constant) {}
+    LinExpr(Var x) { add(x.index, 1.0); }
+    template <typename E>
+    LinExpr(const linexpr::Expr<E>& e) { *this += e; }
+
+    void reserve(std::size_t terms)
+    {
+        cols_.reserve(terms);
+        coefs_.reserve(terms);
+    }
+    void add(int col, double coef)
+    {
+        cols_.push_back(col);
+        coefs_.push_back(coef);
+    }
+    // n terms at once, as GRBLinExpr::addTerms
+    void addTerms(const double* coefs, const Var* vars, int n)
+    {
+        for (int k = 0; k < n; k++)
+            add(vars[k].index, coefs[k]);
+    }
+    template <typename E>
+    LinExpr& operator+=(const linexpr::Expr<E>& e)
+    {
+        e.self().terms([this](int col, double coef) { add(col, coef); });
+        constant_ += e.self().constant();
+        return *this;
+    }
+    template <typename E>
+    LinExpr& operator-=(const linexpr::Expr<E>& e)
+    {
+        e.self().terms([this](int col, double coef) { add(col, -coef); });
+        constant_ -= e.self().constant();
+        return *this;
+    }
+    LinExpr& operator+=(double value)
+    {
+        constant_ += value;
+        return *this;
+    }
+    LinExpr& operator-=(double value)
+    {
+        constant_ -= value;
+        return *this;
+    }
+    void clear()
+    {
+        cols_.clear();
+        coefs_.clear();
+        constant_ = 0.0;
+    }
+
+    std::size_t size() const { return cols_.size(); }
+    template <typename F>
+    void terms(F&& f) const
+    {
+        for (std::size_t k = 0; k < cols_.size(); k++)
+            f(cols_[k], coefs_[k]);
+    }
+    double constant() const { return constant_; }
+
+private:
+    std::vector<int> cols_;
+    std::vector<double> coefs_;
+    double constant_ = 0.0;
+};
+
+namespace linexpr {
+
+template <typename A, typename B>
+Sum<A, B> operator+(const Expr<A>& a, const Expr<B>& b) { return Sum<A, B>(a.self(), b.self()); }
+template <typename A>
+Sum<A, Constant> operator+(const Expr<A>& a, double b) { return Sum<A, Constant>(a.self(), Constant(b)); }
+template <typename A>
+Sum<A, Constant> operator+(double a, const Expr<A>& b) { return Sum<A, Constant>(b.self(), Constant(a)); }
+
+template <typename A, typename B>
+Sum<A, Scaled<B>> operator-(const Expr<A>& a, const Expr<B>& b)
+{
+    return Sum<A, Scaled<B>>(a.self(), Scaled<B>(b.self(), -1.0));
+}
+template <typename A>
+Sum<A, Constant> operator-(const Expr<A>& a, double b) { return Sum<A, Constant>(a.self(), Constant(-b)); }
+template <typename A>
+Sum<Scaled<A>, Constant> operator-(double a, const Expr<A>& b)
+{
+    return Sum<Scaled<A>, Constant>(Scaled<A>(b.self(), -1.0), Constant(a));
+}
+template <typename A>
+Scaled<A> operator-(const Expr<A>& a) { return Scaled<A>(a.self(), -1.0); }
+
+template <typename A>
+Scaled<A> operator*(double k, const Expr<A>& a) { return Scaled<A>(a.self(), k); }
+template <typename A>
+Scaled<A> operator*(const Expr<A>& a, double k) { return Scaled<A>(a.self(), k); }
+template <typename A>
+Scaled<A> operator/(const Expr<A>& a, double k) { return Scaled<A>(a.self(), 1.0 / k); }
+
+template <typename A>
+TempConstr<A> operator<=(const Expr<A>& a, double rhs) { return {a.self(), 'L', rhs}; }
+template <typename A>
+TempConstr<A> operator>=(const Expr<A>& a, double rhs) { return {a.self(), 'G', rhs}; }
+template <typename A>
+TempConstr<A> operator==(const Expr<A>& a, double rhs) { return {a.self(), 'E', rhs}; }
+template <typename A>
+TempConstr<A> operator<=(double lhs, const Expr<A>& a) { return {a.self(), 'G', lhs}; }
+template <typename A>
+TempConstr<A> operator>=(double lhs, const Expr<A>& a) { return {a.self(), 'L', lhs}; }
+
+// a <= b becomes a - b <= 0
+template <typename A, typename B>
+TempConstr<Sum<A, Scaled<B>>> operator<=(const Expr<A>& a, const Expr<B>& b) { return {a - b, 'L', 0.0}; }
+template <typename A, typename B>
+TempConstr<Sum<A, Scaled<B>>> operator>=(const Expr<A>& a, const Expr<B>& b) { return {a - b, 'G', 0.0}; }
+template <typename A, typename B>
+TempConstr<Sum<A, Scaled<B>>> operator==(const Expr<A>& a, const Expr<B>& b) { return {a - b, 'E', 0.0}; }
+
+} // namespace linexpr
+
+/*
+  Builds a model with Gurobi-like syntax straight into the CSR arrays of a
+  ProblemInstance and hands it to the solver in one loadProblem call, plus
+  one setInteger call for all integers, instead of an addCol, setColUpper,
+  setColLower, setInteger and setColName per variable and a
+  CoinPackedVector and addRow per constraint as in main.cpp.
+
+    ModelBuilder builder;
+    std::vector<Var> x;
+    for (int j = 0; j < 5; j++)
+        x.push_back(builder.addVar(0.0, 1.0, 1.0, 'I', "x" + std::to_string(j)));
+    builder.addConstr(11 * x[0] + 20 * x[1] + 3 * x[2] <= 12);
+    builder.addConstr(0.5 * x[1] + x[2] + 21.8 * x[3] >= 22);
+    builder.addRange(x[0] + x[4], 1.0, 2.0);
+    builder.setObjective(x[0] + x[1] + x[2] + x[3] + x[4], 1);
+
+    OsiClpSolverInterface solver;
+    builder.load(solver);
+
+  Repeated columns in one constraint are merged and zero coefficients
+  dropped. Names are optional; once any column (row) has one, the others
+  get CoinMpsIO-style defaults (C0000000, R0000000). Variable types are
+  'C', 'I' or 'B' (an integer in [0, 1]). Infinite bounds are
+  +-ModelBuilder::kInfinity.
+*/
+class ModelBuilder
+{
+public:
+    static constexpr double kInfinity = DBL_MAX; // COIN_DBL_MAX
+
+    explicit ModelBuilder(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : data_(resource), position_(resource)
+    {
+        data_.numCols = data_.numRows = data_.numNonZeros = 0;
+        data_.objSense = 1;
+        data_.rowStart.push_back(0);
+    }
+
+    void reserve(int numCols, int numRows, int numNonZeros)
+    {
+        data_.varTypes.reserve(numCols);
+        data_.lb.reserve(numCols);
+        data_.ub.reserve(numCols);
+        data_.objCoeffs.reserve(numCols);
+        position_.reserve(numCols);
+        data_.rowtypes.reserve(numRows);
+        data_.rhs.reserve(numRows);
+        data_.rhsrange.reserve(numRows);
+        data_.rowStart.reserve(numRows + 1);
+        data_.colIdxs.reserve(numNonZeros);
+        data_.colCoeffs.reserve(numNonZeros);
+    }
+
+    Var addVar(double lb, double ub, double obj, char type, std::string_view name = {})
+    {
+        if (type == 'B') {
+            type = 'I';
+            lb = std::max(lb, 0.0);
+            ub = std::min(ub, 1.0);
+        }
+        int j = data_.numCols++;
+        data_.varTypes.push_back(type == 'I' ? 'I' : 'C');
+        data_.lb.push_back(lb);
+        data_.ub.push_back(ub);
+        data_.objCoeffs.push_back(obj);
+        position_.push_back(-1);
+        addName(data_.colName, 'C', j, name);
+        return Var(j);
+    }
+
+    // count columns with the same bounds, objective and type; returns the first
+    Var addVars(int count, double lb, double ub, double obj, char type)
+    {
+        Var first(data_.numCols);
+        for (int k = 0; k < count; k++)
+            addVar(lb, ub, obj, type);
+        return first;
+    }
+
+    Var var(int j) const { return Var(j); }
+    int numVars() const { return data_.numCols; }
+    int numConstrs() const { return data_.numRows; }
+
+    void setBounds(Var x, double lb, double ub)
+    {
+        data_.lb[x.index] = lb;
+        data_.ub[x.index] = ub;
+    }
+
+    // Returns the row index, -1 (nothing added) if the expression uses a column of another builder.
+    template <typename E>
+    int addConstr(const linexpr::TempConstr<E>& constr, std::string_view name = {})
+    {
+        const double lower = constr.sense == 'L' ? -kInfinity : constr.rhs;
+        const double upper = constr.sense == 'G' ? kInfinity : constr.rhs;
+        return addRow(constr.expr, lower, upper, name);
+    }
+
+    // lower <= expr <= upper, either side may be infinite
+    template <typename E>
+    int addRange(const linexpr::Expr<E>& expr, double lower, double upper, std::string_view name = {})
+    {
+        return addRow(expr.self(), lower, upper, name);
+    }
+
+    // sense 1 to minimize, -1 to maximize; replaces the objective
+    template <typename E>
+    bool setObjective(const linexpr::Expr<E>& expr, int sense = 1)
+    {
+        std::pmr::vector<double> obj(data_.numCols, 0.0, data_.resource());
+        bool ok = true;
+        expr.self().terms([&](int col, double coef) {
+            if (col >= 0 && col < data_.numCols)
+                obj[col] += coef;
+            else
+                ok = false;
+        });
+        if (!ok) {
+            std::cout << "Objective uses a column that is not in the model" << std::endl;
+            return false;
+        }
+        data_.objCoeffs.swap(obj);
+        data_.objOffset = expr.self().constant();
+        data_.objSense = sense;
+        return true;
+    }
+
+    const ProblemInstance& data() const { return data_; }
+    // Hands the model over; the builder is left empty.
+    ProblemInstance release()
+    {
+        ProblemInstance data = std::move(data_);
+        *this = ModelBuilder(data.resource());
+        return data;
+    }
+
+    // One loadProblem and one setInteger call, see loadProblemData.
+    void load(OsiSolverInterface& solver, bool loadNames = true) const { loadProblemData(data_, solver, loadNames); }
+
+private:
+    template <typename E>
+    int addRow(const E& expr, double lower, double upper, std::string_view name)
+    {
+        const int start = data_.numNonZeros;
+        bool ok = true;
+        // position_[j] is where column j was last written; at or past start it is in this row
+        expr.terms([&](int col, double coef) {
+            if (col < 0 || col >= data_.numCols) {
+                ok = false;
+                return;
+            }
+            int& at = position_[col];
+            if (at >= start) {
+                data_.colCoeffs[at] += coef;
+            } else {
+                at = static_cast<int>(data_.colIdxs.size());
+                data_.colIdxs.push_back(col);
+                data_.colCoeffs.push_back(coef);
+            }
+        });
+        if (!ok) {
+            std::cout << "Constraint uses a column that is not in the model" << std::endl;
+            for (int p = start; p < static_cast<int>(data_.colIdxs.size()); p++)
+                position_[data_.colIdxs[p]] = -1;
+            data_.colIdxs.resize(start);
+            data_.colCoeffs.resize(start);
+            return -1;
+        }
+        // drop terms that cancelled; position_ follows, so the next row cannot see a dropped slot as live
+        int end = start;
+        for (int p = start; p < static_cast<int>(data_.colIdxs.size()); p++) {
+            const int col = data_.colIdxs[p];
+            if (data_.colCoeffs[p] != 0.0) {
+                position_[col] = end;
+                data_.colIdxs[end] = col;
+                data_.colCoeffs[end++] = data_.colCoeffs[p];
+            } else {
+                position_[col] = -1;
+            }
+        }
+        data_.colIdxs.resize(end);
+        data_.colCoeffs.resize(end);
+
+        // the constant moves to the bounds
+        double constant = expr.constant();
+        if (lower > -kInfinity)
+            lower -= constant;
+        if (upper < kInfinity)
+            upper -= constant;
+        char sense;
+        double rhs, range;
+        rowBoundsToSense(lower, upper, sense, rhs, range);
+        data_.rowtypes.push_back(sense);
+        data_.rhs.push_back(rhs);
+        data_.rhsrange.push_back(range);
+        data_.rowStart.push_back(end);
+        data_.numNonZeros = end;
+        int i = data_.numRows++;
+        addName(data_.rowName, 'R', i, name);
+        return i;
+    }
+
+    // keeps names either empty or complete
+    static void addName(NameTable& names, char prefix, int index, std::string_view name)
+    {
+        if (name.empty() && names.empty())
+            return;
+        char fallback[16];
+        for (int k = names.size(); k < index; k++) {
+            std::snprintf(fallback, sizeof(fallback), "%c%07d", prefix, k);
+            names.push_back(fallback);
+        }
+        if (name.empty()) {
+            std::snprintf(fallback, sizeof(fallback), "%c%07d", prefix, index);
+            name = fallback;
+        }
+        names.push_back(name);
+    }
+
+    ProblemInstance data_;
+    std::pmr::vector<int> position_;
+};
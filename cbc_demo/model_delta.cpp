@@ -0,0 +1,220 @@
+#include "model_delta.h"
+#include "problem_instance.h"
+
+#include "OsiSolverInterface.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+
+static const double kKeep = std::numeric_limits<double>::quiet_NaN();
+
+void ModelDelta::setColBounds(int col, double lower, double upper)
+{
+    colBoundIdxs_.push_back(col);
+    colBounds_.push_back(lower);
+    colBounds_.push_back(upper);
+}
+
+void ModelDelta::setColLower(int col, double lower)
+{
+    setColBounds(col, lower, kKeep);
+}
+
+void ModelDelta::setColUpper(int col, double upper)
+{
+    setColBounds(col, kKeep, upper);
+}
+
+void ModelDelta::setObjCoeff(int col, double value)
+{
+    objIdxs_.push_back(col);
+    objCoeffs_.push_back(value);
+}
+
+void ModelDelta::setRowBounds(int row, double lower, double upper)
+{
+    rowBoundIdxs_.push_back(row);
+    rowBounds_.push_back(lower);
+    rowBounds_.push_back(upper);
+}
+
+void ModelDelta::setRhs(int row, double rhs)
+{
+    rhsIdxs_.push_back(row);
+    rhsValues_.push_back(rhs);
+}
+
+int ModelDelta::addCol(int numNonZeros, const int* rows, const double* coeffs, double lower, double upper,
+    double obj, bool isInteger)
+{
+    int k = numAddedCols();
+    addedColRows_.insert(addedColRows_.end(), rows, rows + numNonZeros);
+    addedColCoeffs_.insert(addedColCoeffs_.end(), coeffs, coeffs + numNonZeros);
+    addedColStart_.push_back(static_cast<int>(addedColRows_.size()));
+    addedColLower_.push_back(lower);
+    addedColUpper_.push_back(upper);
+    addedColObj_.push_back(obj);
+    if (isInteger)
+        addedIntegers_.push_back(k);
+    return k;
+}
+
+int ModelDelta::addRow(int numNonZeros, const int* cols, const double* coeffs, double lower, double upper)
+{
+    int k = numAddedRows();
+    addedRowCols_.insert(addedRowCols_.end(), cols, cols + numNonZeros);
+    addedRowCoeffs_.insert(addedRowCoeffs_.end(), coeffs, coeffs + numNonZeros);
+    addedRowStart_.push_back(static_cast<int>(addedRowCols_.size()));
+    addedRowLower_.push_back(lower);
+    addedRowUpper_.push_back(upper);
+    return k;
+}
+
+void ModelDelta::deleteCol(int col)
+{
+    deletedCols_.push_back(col);
+}
+
+void ModelDelta::deleteRow(int row)
+{
+    deletedRows_.push_back(row);
+}
+
+int ModelDelta::numChanges() const
+{
+    return static_cast<int>(colBoundIdxs_.size() + objIdxs_.size() + rowBoundIdxs_.size() + rhsIdxs_.size() +
+        deletedCols_.size() + deletedRows_.size()) + numAddedCols() + numAddedRows();
+}
+
+bool ModelDelta::empty() const
+{
+    return numChanges() == 0;
+}
+
+void ModelDelta::clear()
+{
+    *this = ModelDelta();
+}
+
+static int checkRange(const std::vector<int>& indices, int limit, const char* what)
+{
+    int errors = 0;
+    for (int index : indices) {
+        if (index < 0 || index >= limit) {
+            std::cout << "ModelDelta: " << what << " " << index << " out of range" << std::endl;
+            errors++;
+        }
+    }
+    return errors;
+}
+
+// Replaces the kept (NaN) bounds of each pair with the bound the entry
+// before it in the batch set, or else the solver's.
+static void fillKeptBounds(const std::vector<int>& indices, std::vector<double>& bounds, const double* lower,
+    const double* upper)
+{
+    std::unordered_map<int, std::size_t> last;
+    for (std::size_t k = 0; k < indices.size(); k++) {
+        auto it = last.find(indices[k]);
+        double previousLower = it != last.end() ? bounds[2 * it->second] : lower[indices[k]];
+        double previousUpper = it != last.end() ? bounds[2 * it->second + 1] : upper[indices[k]];
+        if (std::isnan(bounds[2 * k]))
+            bounds[2 * k] = previousLower;
+        if (std::isnan(bounds[2 * k + 1]))
+            bounds[2 * k + 1] = previousUpper;
+        last[indices[k]] = k;
+    }
+}
+
+static std::vector<int> sortedUnique(std::vector<int> indices)
+{
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    return indices;
+}
+
+int ModelDelta::apply(OsiSolverInterface& solver) const
+{
+    int numCols = solver.getNumCols();
+    int numRows = solver.getNumRows();
+    int totalCols = numCols + numAddedCols();
+    int totalRows = numRows + numAddedRows();
+    int errors = checkRange(colBoundIdxs_, numCols, "column") + checkRange(objIdxs_, numCols, "column") +
+        checkRange(rowBoundIdxs_, numRows, "row") + checkRange(rhsIdxs_, numRows, "row") +
+        checkRange(addedColRows_, numRows, "row") + checkRange(addedRowCols_, totalCols, "column") +
+        checkRange(deletedCols_, totalCols, "column") + checkRange(deletedRows_, totalRows, "row");
+    if (errors > 0)
+        return errors;
+
+    if (!colBoundIdxs_.empty()) {
+        std::vector<double> bounds(colBounds_);
+        fillKeptBounds(colBoundIdxs_, bounds, solver.getColLower(), solver.getColUpper());
+        solver.setColSetBounds(colBoundIdxs_.data(), colBoundIdxs_.data() + colBoundIdxs_.size(), bounds.data());
+    }
+    if (!objIdxs_.empty())
+        solver.setObjCoeffSet(objIdxs_.data(), objIdxs_.data() + objIdxs_.size(), objCoeffs_.data());
+    if (!rowBoundIdxs_.empty())
+        solver.setRowSetBounds(rowBoundIdxs_.data(), rowBoundIdxs_.data() + rowBoundIdxs_.size(), rowBounds_.data());
+
+    if (!rhsIdxs_.empty()) {
+        // the bounds each rhs moves are those after the rhs changes before it
+        std::vector<double> bounds(2 * rhsIdxs_.size());
+        std::unordered_map<int, std::size_t> last;
+        const double* rowLower = solver.getRowLower();
+        const double* rowUpper = solver.getRowUpper();
+        for (std::size_t k = 0; k < rhsIdxs_.size(); k++) {
+            int row = rhsIdxs_[k];
+            auto it = last.find(row);
+            double lower = it != last.end() ? bounds[2 * it->second] : rowLower[row];
+            double upper = it != last.end() ? bounds[2 * it->second + 1] : rowUpper[row];
+            char sense;
+            double rhs, range;
+            rowBoundsToSense(lower, upper, sense, rhs, range);
+            if (sense != 'N')
+                senseToRowBounds(sense, rhsValues_[k], range, lower, upper);
+            bounds[2 * k] = lower;
+            bounds[2 * k + 1] = upper;
+            last[row] = k;
+        }
+        solver.setRowSetBounds(rhsIdxs_.data(), rhsIdxs_.data() + rhsIdxs_.size(), bounds.data());
+    }
+
+    if (numAddedCols() > 0) {
+        solver.addCols(numAddedCols(), addedColStart_.data(), addedColRows_.data(), addedColCoeffs_.data(),
+            addedColLower_.data(), addedColUpper_.data(), addedColObj_.data());
+        if (!addedIntegers_.empty()) {
+            std::vector<int> integers(addedIntegers_);
+            for (int& col : integers)
+                col += numCols;
+            solver.setInteger(integers.data(), static_cast<int>(integers.size()));
+        }
+    }
+    if (numAddedRows() > 0)
+        solver.addRows(numAddedRows(), addedRowStart_.data(), addedRowCols_.data(), addedRowCoeffs_.data(),
+            addedRowLower_.data(), addedRowUpper_.data());
+
+    if (!deletedRows_.empty()) {
+        std::vector<int> rows = sortedUnique(deletedRows_);
+        solver.deleteRows(static_cast<int>(rows.size()), rows.data());
+    }
+    if (!deletedCols_.empty()) {
+        std::vector<int> cols = sortedUnique(deletedCols_);
+        solver.deleteCols(static_cast<int>(cols.size()), cols.data());
+    }
+    return 0;
+}
+
+std::vector<int> ModelDelta::columnMap(int numColsBefore) const
+{
+    std::vector<int> map(numColsBefore + numAddedCols(), 0);
+    for (int col : deletedCols_)
+        if (col >= 0 && col < static_cast<int>(map.size()))
+            map[col] = -1;
+    int next = 0;
+    for (int& position : map)
+        position = position < 0 ? -1 : next++;
+    return map;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+
+class OsiSolverInterface;
+
+/*
+  A batch of changes to a model, recorded first and applied to a live solver
+  in one go: one setColSetBounds, setRowSetBounds and setObjCoeffSet call
+  each, one addCols and addRows call and one deleteRows and deleteCols call,
+  instead of a call (and a solver notification) per change.
+
+    ModelDelta delta;
+    delta.setColUpper(j, 0.0);
+    delta.setRhs(i, demand[i]);
+    delta.setObjCoeff(k, cost[k]);
+    delta.apply(solver);
+
+  Indices refer to the model before the delta. Added columns get the
+  indices numCols, numCols + 1, ... in the order of addCol, and added rows
+  may use them. The changes are applied in the order bounds and objective,
+  row bounds, rhs, added columns, added rows, deletions, so setRhs works on
+  the row bounds that setRowBounds left; deletions renumber what is left
+  (columnMap). Several changes to one entry: the last one wins.
+*/
+class ModelDelta
+{
+public:
+    void setColBounds(int col, double lower, double upper);
+    void setColLower(int col, double lower);
+    void setColUpper(int col, double upper);
+    void setObjCoeff(int col, double value);
+
+    void setRowBounds(int row, double lower, double upper);
+    // Moves the bound the row's sense uses: the upper one of an L row, the
+    // lower one of a G row, both of an E row, and both of a ranged row so
+    // that its range stays. Free rows are left alone.
+    void setRhs(int row, double rhs);
+
+    // Return k for the k-th added column (row); it becomes column numCols + k
+    // (row numRows + k) of the solver.
+    int addCol(int numNonZeros, const int* rows, const double* coeffs, double lower, double upper, double obj,
+        bool isInteger = false);
+    int addRow(int numNonZeros, const int* cols, const double* coeffs, double lower, double upper);
+
+    // Added columns and rows can be deleted again by their new index.
+    void deleteCol(int col);
+    void deleteRow(int row);
+
+    bool empty() const;
+    int numChanges() const;
+    int numAddedCols() const { return static_cast<int>(addedColStart_.size()) - 1; }
+    int numAddedRows() const { return static_cast<int>(addedRowStart_.size()) - 1; }
+    void clear();
+
+    // Checks every index against the solver first and applies nothing if one
+    // is out of range. Returns the number of errors, each one printed.
+    int apply(OsiSolverInterface& solver) const;
+
+    // Where each column of the model before the delta (then each added
+    // column) ends up after apply, -1 for deleted columns.
+    std::vector<int> columnMap(int numColsBefore) const;
+
+private:
+    // Bounds are stored as (lower, upper) pairs, the layout of the Set calls;
+    // NaN keeps the bound the solver has.
+    std::vector<int> colBoundIdxs_;
+    std::vector<double> colBounds_;
+    std::vector<int> objIdxs_;
+    std::vector<double> objCoeffs_;
+    std::vector<int> rowBoundIdxs_;
+    std::vector<double> rowBounds_;
+    std::vector<int> rhsIdxs_;
+    std::vector<double> rhsValues_;
+
+    std::vector<int> addedColStart_ = {0};  // CSC of the added columns
+    std::vector<int> addedColRows_;
+    std::vector<double> addedColCoeffs_;
+    std::vector<double> addedColLower_;
+    std::vector<double> addedColUpper_;
+    std::vector<double> addedColObj_;
+    std::vector<int> addedIntegers_;        // offsets into the added columns
+    std::vector<int> addedRowStart_ = {0};  // CSR of the added rows
+    std::vector<int> addedRowCols_;
+    std::vector<double> addedRowCoeffs_;
+    std::vector<double> addedRowLower_;
+    std::vector<double> addedRowUpper_;
+
+    std::vector<int> deletedCols_;
+    std::vector<int> deletedRows_;
+};
@@ -0,0 +1,162 @@
+#include "model_extractor.h"
+#include "name_table.h"
+#include "problem_instance.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+int OsiModelExtractor::numCols()
+{
+    return view_.numCols;
+}
+
+int OsiModelExtractor::numRows()
+{
+    return view_.numRows;
+}
+
+std::int64_t OsiModelExtractor::numNonZeros()
+{
+    return view_.numNonZeros;
+}
+
+bool OsiModelExtractor::getObjectiveSense(int& sense, double& offset)
+{
+    sense = view_.objSense;
+    offset = view_.objOffset;
+    return true;
+}
+
+bool OsiModelExtractor::getColumns(char* types, double* lower, double* upper, double* objective)
+{
+    for (int j = 0; j < view_.numCols; j++)
+        types[j] = view_.varType(j);
+    std::copy(view_.lb.begin(), view_.lb.end(), lower);
+    std::copy(view_.ub.begin(), view_.ub.end(), upper);
+    std::copy(view_.objCoeffs.begin(), view_.objCoeffs.end(), objective);
+    return true;
+}
+
+bool OsiModelExtractor::getRowBounds(char* sense, double* rhs, double* range)
+{
+    std::copy(view_.rowtypes.begin(), view_.rowtypes.end(), sense);
+    std::copy(view_.rhs.begin(), view_.rhs.end(), rhs);
+    std::copy(view_.rhsrange.begin(), view_.rhsrange.end(), range);
+    return true;
+}
+
+bool OsiModelExtractor::getRows(int first, int last, std::int64_t* rowStart, int* colIdxs, double* values,
+    std::int64_t capacity)
+{
+    rowStart[0] = 0;
+    if (first >= last)
+        return true;
+    const int begin = view_.rowStart[first];
+    const int end = view_.rowStart[last];
+    if (end - begin > capacity)
+        return false;
+    std::copy(view_.colIdxs.data() + begin, view_.colIdxs.data() + end, colIdxs);
+    std::copy(view_.colCoeffs.data() + begin, view_.colCoeffs.data() + end, values);
+    for (int i = first + 1; i <= last; i++)
+        rowStart[i - first] = view_.rowStart[i] - begin;
+    return true;
+}
+
+bool OsiModelExtractor::getColNames(NameTable& names)
+{
+    for (int j = 0; j < view_.numCols; j++)
+        names.push_back(view_.colName(j));
+    return true;
+}
+
+bool OsiModelExtractor::getRowNames(NameTable& names)
+{
+    for (int i = 0; i < view_.numRows; i++)
+        names.push_back(view_.rowName(i));
+    return true;
+}
+
+template <typename Offset>
+static bool extract(ModelExtractor& source, BasicProblemInstance<Offset>& data, bool extractNames)
+{
+    const char* backend = source.backendName();
+    data.numCols = source.numCols();
+    data.numRows = source.numRows();
+    const std::int64_t capacity = source.numNonZeros();
+    if (data.numCols < 0 || data.numRows < 0 || capacity < 0) {
+        std::cout << backend << ": cannot read the model size" << std::endl;
+        return false;
+    }
+    if (capacity > std::numeric_limits<Offset>::max()) {
+        std::cout << backend << ": " << capacity << " nonzeros do not fit, use a ProblemInstance64" << std::endl;
+        return false;
+    }
+    if (!source.getObjectiveSense(data.objSense, data.objOffset)) {
+        std::cout << backend << ": cannot read the objective sense" << std::endl;
+        return false;
+    }
+
+    data.varTypes.resize(data.numCols);
+    data.lb.resize(data.numCols);
+    data.ub.resize(data.numCols);
+    data.objCoeffs.resize(data.numCols);
+    if (!source.getColumns(data.varTypes.data(), data.lb.data(), data.ub.data(), data.objCoeffs.data())) {
+        std::cout << backend << ": cannot read the columns" << std::endl;
+        return false;
+    }
+
+    data.rowtypes.resize(data.numRows);
+    data.rhs.resize(data.numRows);
+    data.rhsrange.resize(data.numRows);
+    if (!source.getRowBounds(data.rowtypes.data(), data.rhs.data(), data.rhsrange.data())) {
+        std::cout << backend << ": cannot read the rows" << std::endl;
+        return false;
+    }
+
+    // the backend writes 64-bit row starts; ProblemInstance's are narrowed after
+    data.rowStart.resize(data.numRows + 1);
+    data.colIdxs.resize(capacity);
+    data.colCoeffs.resize(capacity);
+    std::vector<std::int64_t> narrowStarts;
+    std::int64_t* rowStart = nullptr;
+    if constexpr (std::is_same<Offset, std::int64_t>::value) {
+        rowStart = data.rowStart.data();
+    } else {
+        narrowStarts.resize(data.numRows + 1);
+        rowStart = narrowStarts.data();
+    }
+    if (!source.getRows(0, data.numRows, rowStart, data.colIdxs.data(), data.colCoeffs.data(), capacity)) {
+        std::cout << backend << ": cannot read the matrix" << std::endl;
+        return false;
+    }
+    if constexpr (!std::is_same<Offset, std::int64_t>::value)
+        std::copy(narrowStarts.begin(), narrowStarts.end(), data.rowStart.begin());
+    // a backend may count explicit zeros it does not return
+    data.numNonZeros = static_cast<Offset>(rowStart[data.numRows]);
+    data.colIdxs.resize(data.numNonZeros);
+    data.colCoeffs.resize(data.numNonZeros);
+    data.invalidateColumns();
+
+    data.colName.clear();
+    data.rowName.clear();
+    if (extractNames) {
+        if (!source.getColNames(data.colName) || data.colName.size() != data.numCols)
+            data.colName.clear();
+        if (!source.getRowNames(data.rowName) || data.rowName.size() != data.numRows)
+            data.rowName.clear();
+    }
+    return true;
+}
+
+bool extractProblemData(ModelExtractor& source, ProblemInstance& data, bool extractNames)
+{
+    return extract(source, data, extractNames);
+}
+
+bool extractProblemData(ModelExtractor& source, ProblemInstance64& data, bool extractNames)
+{
+    return extract(source, data, extractNames);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "problem_view.h"
+
+#include <cstdint>
+
+class NameTable;
+class OsiSolverInterface;
+struct ProblemInstance;
+struct ProblemInstance64;
+
+/*
+  What extractProblemData needs from a solver backend: a handful of bulk
+  reads that each return a whole array, rows in CSR with one call for a
+  range of rows. Extraction then costs a fixed number of calls into the
+  backend and time proportional to rows + columns + nonzeros, whatever the
+  backend, instead of one call per coefficient.
+
+    OsiModelExtractor source(solver);        // CBC, Clp: over getProblemView
+    ProblemInstance data;
+    if (!extractProblemData(source, data))
+        return 1;
+
+  Backends: OsiModelExtractor below, CplexExtractor (CPXXgetrows,
+  cplex_demo/cplex_extractor.h), GurobiExtractor (GRBModel::getRow,
+  gurobi_demo/gurobi_extractor.h) and ScriptedExtractor, which replays a
+  recorded model from memory for tests and benchmarks
+  (scripted_extractor.h).
+
+  Conventions are ProblemInstance's: types 'C' or 'I', infinite bounds
+  +-COIN_DBL_MAX, rows in Osi sense/rhs/range form (rowBoundsToSense).
+*/
+class ModelExtractor
+{
+public:
+    virtual ~ModelExtractor() = default;
+
+    virtual const char* backendName() const = 0;
+    virtual int numCols() = 0;
+    virtual int numRows() = 0;
+    virtual std::int64_t numNonZeros() = 0;
+    // sense 1 minimize, -1 maximize; offset is the constant term of the objective
+    virtual bool getObjectiveSense(int& sense, double& offset) = 0;
+
+    // Arrays of numCols().
+    virtual bool getColumns(char* types, double* lower, double* upper, double* objective) = 0;
+    // Arrays of numRows().
+    virtual bool getRowBounds(char* sense, double* rhs, double* range) = 0;
+    // Rows [first, last): rowStart gets last - first + 1 offsets from 0,
+    // colIdxs and values have room for capacity nonzeros.
+    virtual bool getRows(int first, int last, std::int64_t* rowStart, int* colIdxs, double* values,
+        std::int64_t capacity) = 0;
+    // Appends one name per column (row); false if the model has none.
+    virtual bool getColNames(NameTable&) { return false; }
+    virtual bool getRowNames(NameTable&) { return false; }
+};
+
+// Any OsiSolverInterface, read through a ProblemView (problem_view.h) taken
+// when the extractor is made, so the solver must not change before extracting.
+class OsiModelExtractor : public ModelExtractor
+{
+public:
+    explicit OsiModelExtractor(const OsiSolverInterface& solver) : view_(getProblemView(solver)) {}
+
+    const char* backendName() const override { return "osi"; }
+    int numCols() override;
+    int numRows() override;
+    std::int64_t numNonZeros() override;
+    bool getObjectiveSense(int& sense, double& offset) override;
+    bool getColumns(char* types, double* lower, double* upper, double* objective) override;
+    bool getRowBounds(char* sense, double* rhs, double* range) override;
+    bool getRows(int first, int last, std::int64_t* rowStart, int* colIdxs, double* values,
+        std::int64_t capacity) override;
+    bool getColNames(NameTable& names) override;
+    bool getRowNames(NameTable& names) override;
+
+private:
+    ProblemView view_;
+};
+
+// Fills data from source: one call per array, the rows in one getRows call,
+// the names only if asked for and present. Returns false, printing which
+// read failed, if the backend reports an error or a model that does not fit.
+bool extractProblemData(ModelExtractor& source, ProblemInstance& data, bool extractNames = true);
+bool extractProblemData(ModelExtractor& source, ProblemInstance64& data, bool extractNames = true);
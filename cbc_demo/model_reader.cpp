@@ -0,0 +1,47 @@
+#include "model_reader.h"
+#include "problem_instance.h"
+#include "util.h"
+
+#include <zlib.h>
+
+#include <iostream>
+
+bool readTextFile(const std::string& path, std::string& text)
+{
+    // gzread passes plain files through unchanged
+    gzFile file = gzopen(path.c_str(), "rb");
+    if (!file) {
+        std::cout << "Cannot open " << path << std::endl;
+        return false;
+    }
+    gzbuffer(file, 1 << 20);
+
+    text.clear();
+    const std::size_t block = 1 << 22;
+    for (;;) {
+        std::size_t used = text.size();
+        text.resize(used + block);
+        int got = gzread(file, &text[used], static_cast<unsigned>(block));
+        if (got < 0) {
+            std::cout << "Read " << path << " failed" << std::endl;
+            gzclose(file);
+            text.clear();
+            return false;
+        }
+        text.resize(used + got);
+        if (static_cast<std::size_t>(got) < block)
+            break;
+    }
+    gzclose(file);
+    return true;
+}
+
+int readModelFile(const std::string& path, ProblemInstance& data, int numThreads)
+{
+    std::string text;
+    if (!readTextFile(path, text))
+        return 1;
+    if (endsWith(path, ".lp") || endsWith(path, ".lp.gz"))
+        return readLpText(text, data);
+    return readMpsText(text, data, numThreads);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+struct ProblemInstance;
+
+/*
+  Native readers for .mps, .mps.gz and .lp files that fill a row-major
+  ProblemInstance directly, without going through a solver and its
+  column-major storage.
+
+  The MPS reader splits the COLUMNS, RHS, RANGES and BOUNDS sections into
+  line-aligned chunks that are tokenized on numThreads threads
+  (numThreads <= 0 uses every core). Semantics follow CoinMpsIO: integer
+  markers (integers default to binary bounds), the first RHS/RANGES/BOUNDS set
+  only, ranges on E rows by sign, N rows after the objective dropped, explicit
+  zeros dropped, an RHS on the objective row as a negated objective constant.
+  SOS, quadratic and conic sections are skipped. MPS files are read in free
+  format, i.e. names must not contain blanks.
+
+  All functions return the number of errors (0 on success) and print each
+  error, like OsiSolverInterface::readMps.
+*/
+
+// Picks the reader from the file name: *.lp / *.lp.gz, anything else is MPS.
+int readModelFile(const std::string& path, ProblemInstance& data, int numThreads = 0);
+
+int readMpsText(std::string_view text, ProblemInstance& data, int numThreads = 0);
+int readLpText(std::string_view text, ProblemInstance& data);
+
+// Reads a whole file into memory, inflating it if it is gzip compressed.
+bool readTextFile(const std::string& path, std::string& text);
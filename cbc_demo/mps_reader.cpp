@@ -0,0 +1,577 @@
+#include "model_reader.h"
+#include "parallel.h"
+#include "problem_instance.h"
+
+#include "CoinFinite.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+// sections smaller than this are parsed in one chunk
+static const std::size_t kMinChunkBytes = 1 << 16;
+
+static const int kObjectiveRow = -1;
+static const int kUnknownRow = -2;
+static const int kFreeRow = -3; // N rows after the objective, dropped like CoinMpsIO does
+
+struct TextRange
+{
+    const char* begin = nullptr;
+    const char* end = nullptr;
+};
+
+// Next line of [pos, end) without the line break, false at the end of the text.
+static bool nextLine(const char*& pos, const char* end, std::string_view& line)
+{
+    if (pos >= end)
+        return false;
+    const char* eol = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+    if (!eol)
+        eol = end;
+    const char* lineEnd = eol;
+    if (lineEnd > pos && lineEnd[-1] == '\r')
+        lineEnd--;
+    line = std::string_view(pos, lineEnd - pos);
+    pos = eol < end ? eol + 1 : end;
+    return true;
+}
+
+// Splits on blanks; stores up to maxTokens tokens but returns the full count.
+static int splitTokens(std::string_view line, std::string_view* tokens, int maxTokens)
+{
+    int count = 0;
+    std::size_t i = 0, n = line.size();
+    while (i < n) {
+        while (i < n && (line[i] == ' ' || line[i] == '\t'))
+            i++;
+        if (i >= n)
+            break;
+        std::size_t start = i;
+        while (i < n && line[i] != ' ' && line[i] != '\t')
+            i++;
+        if (count < maxTokens)
+            tokens[count] = line.substr(start, i - start);
+        count++;
+    }
+    return count;
+}
+
+static bool isBlankOrComment(std::string_view line)
+{
+    for (char c : line) {
+        if (c == '*')
+            return true;
+        if (c != ' ' && c != '\t')
+            return false;
+    }
+    return true;
+}
+
+static bool parseNumber(std::string_view token, double& value)
+{
+    const char* first = token.data();
+    const char* last = first + token.size();
+    if (first != last && *first == '+')
+        first++;
+    auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && result.ptr == last;
+}
+
+// CoinMpsIO treats anything beyond 1e30 as infinite
+static double clampInfinity(double value)
+{
+    if (value >= 1.0e30)
+        return COIN_DBL_MAX;
+    if (value <= -1.0e30)
+        return -COIN_DBL_MAX;
+    return value;
+}
+
+// Splits a section body into about numChunks line-aligned pieces.
+static std::vector<TextRange> splitChunks(TextRange range, int numThreads)
+{
+    std::size_t bytes = range.end - range.begin;
+    std::size_t numChunks = std::max<std::size_t>(1, std::min<std::size_t>(4 * numThreads, bytes / kMinChunkBytes));
+    std::vector<TextRange> chunks;
+    const char* start = range.begin;
+    for (std::size_t c = 1; c <= numChunks && start < range.end; c++) {
+        const char* stop = range.end;
+        if (c < numChunks) {
+            stop = std::max(start, range.begin + bytes * c / numChunks);
+            const char* eol = static_cast<const char*>(std::memchr(stop, '\n', range.end - stop));
+            stop = eol ? eol + 1 : range.end;
+        }
+        chunks.push_back({start, stop});
+        start = stop;
+    }
+    return chunks;
+}
+
+struct MpsEntry
+{
+    int col; // chunk-local column
+    int row;
+    double value;
+};
+
+struct ColumnChunk
+{
+    std::vector<std::string_view> colNames;
+    // integer marker state when the column starts: -1 unknown yet (inherit from previous chunk), 0 or 1
+    std::vector<signed char> marker;
+    std::vector<MpsEntry> entries;
+    signed char endMarker = -1;
+    std::vector<int> globalCol;
+    std::vector<int> rowCount;
+    int errors = 0;
+};
+
+// RHS / RANGES / BOUNDS line
+struct MpsRecord
+{
+    std::string_view set;
+    int type; // bound type for BOUNDS
+    int index; // row, or column for BOUNDS
+    double value;
+};
+
+struct RecordChunk
+{
+    std::vector<MpsRecord> records;
+    int errors = 0;
+};
+
+enum BoundType { kUp, kLo, kFx, kFr, kMi, kPl, kBv, kLi, kUi, kSc, kBadBound };
+
+static int boundType(std::string_view token)
+{
+    static const char* names[] = {"UP", "LO", "FX", "FR", "MI", "PL", "BV", "LI", "UI", "SC"};
+    for (int t = 0; t < kBadBound; t++)
+        if (token == names[t])
+            return t;
+    return kBadBound;
+}
+
+static bool boundNeedsValue(int type)
+{
+    return type != kFr && type != kMi && type != kPl && type != kBv;
+}
+
+int readMpsText(std::string_view text, ProblemInstance& data, int numThreads)
+{
+    if (numThreads <= 0)
+        numThreads = defaultThreadCount();
+
+    // the name maps allocate a node per row and column, from here they cost a
+    // pointer bump each and go all at once
+    std::pmr::monotonic_buffer_resource scratch(data.resource());
+
+    int errors = 0;
+    TextRange rowsRange, columnsRange, rhsRange, rangesRange, boundsRange;
+    std::string_view objSenseToken;
+
+    // locate the sections; headers are the lines that don't start with a blank
+    {
+        TextRange* current = nullptr;
+        bool inObjSense = false;
+        const char* pos = text.data();
+        const char* end = pos + text.size();
+        std::string_view line;
+        const char* lineStart = pos;
+        while (nextLine(pos, end, line)) {
+            if (!line.empty() && line[0] != ' ' && line[0] != '\t' && line[0] != '*') {
+                if (current)
+                    current->end = lineStart;
+                current = nullptr;
+                inObjSense = false;
+
+                std::string_view tokens[2];
+                int count = splitTokens(line, tokens, 2);
+                std::string_view key = tokens[0];
+                if (key == "ROWS") current = &rowsRange;
+                else if (key == "COLUMNS") current = &columnsRange;
+                else if (key == "RHS") current = &rhsRange;
+                else if (key == "RANGES") current = &rangesRange;
+                else if (key == "BOUNDS") current = &boundsRange;
+                else if (key == "OBJSENSE" || key == "OBJSENS") {
+                    inObjSense = true;
+                    if (count > 1)
+                        objSenseToken = tokens[1];
+                } else if (key == "ENDATA") {
+                    break;
+                } else if (key != "NAME" && key != "OBJNAME") {
+                    // SOS, quadratic and conic sections, which readMps drops as well
+                    std::cout << "MPS section " << key << " is ignored" << std::endl;
+                }
+                if (current)
+                    current->begin = pos;
+            } else if (inObjSense && !isBlankOrComment(line)) {
+                std::string_view tokens[1];
+                splitTokens(line, tokens, 1);
+                objSenseToken = tokens[0];
+            }
+            lineStart = pos;
+        }
+        if (current)
+            current->end = lineStart;
+    }
+    if (!rowsRange.begin || !columnsRange.begin) {
+        std::cout << "MPS text has no ROWS or COLUMNS section" << std::endl;
+        return errors + 1;
+    }
+
+    // ROWS, sequential: the row index map is shared read-only by the parallel passes
+    std::string_view objName;
+    std::vector<char> rowKind;
+    std::vector<std::string_view> rowNames;
+    std::pmr::unordered_map<std::string_view, int> rowIndex(&scratch);
+    {
+        const char* pos = rowsRange.begin;
+        std::string_view line;
+        while (nextLine(pos, rowsRange.end, line)) {
+            if (isBlankOrComment(line))
+                continue;
+            std::string_view tokens[2];
+            if (splitTokens(line, tokens, 2) != 2 || tokens[0].size() != 1) {
+                std::cout << "Bad ROWS line: " << line << std::endl;
+                errors++;
+                continue;
+            }
+            char kind = tokens[0][0];
+            if (kind == 'N') {
+                if (objName.empty())
+                    objName = tokens[1];
+                else
+                    rowIndex.emplace(tokens[1], kFreeRow);
+                continue;
+            }
+            if (kind != 'N' && kind != 'L' && kind != 'G' && kind != 'E') {
+                std::cout << "Bad row type: " << line << std::endl;
+                errors++;
+                continue;
+            }
+            if (!rowIndex.emplace(tokens[1], static_cast<int>(rowNames.size())).second) {
+                std::cout << "Duplicate row " << tokens[1] << std::endl;
+                errors++;
+                continue;
+            }
+            rowKind.push_back(kind);
+            rowNames.push_back(tokens[1]);
+        }
+    }
+    const int numRows = static_cast<int>(rowNames.size());
+    auto findRow = [&](std::string_view name) {
+        if (name == objName)
+            return kObjectiveRow;
+        auto it = rowIndex.find(name);
+        return it == rowIndex.end() ? kUnknownRow : it->second;
+    };
+
+    // COLUMNS, tokenized in parallel; every chunk numbers its columns locally
+    std::vector<TextRange> columnRanges = splitChunks(columnsRange, numThreads);
+    std::vector<ColumnChunk> columnChunks(columnRanges.size());
+    parallelFor(static_cast<int>(columnRanges.size()), numThreads, [&](int c) {
+        ColumnChunk& chunk = columnChunks[c];
+        chunk.entries.reserve((columnRanges[c].end - columnRanges[c].begin) / 32);
+        signed char state = -1;
+        const char* pos = columnRanges[c].begin;
+        std::string_view line;
+        std::string_view tokens[5];
+        while (nextLine(pos, columnRanges[c].end, line)) {
+            if (isBlankOrComment(line))
+                continue;
+            int count = splitTokens(line, tokens, 5);
+            if (count >= 3 && tokens[1] == "'MARKER'") {
+                if (tokens[2] == "'INTORG'")
+                    state = 1;
+                else if (tokens[2] == "'INTEND'")
+                    state = 0;
+                chunk.endMarker = state;
+                continue;
+            }
+            if (count != 3 && count != 5) {
+                std::cout << "Bad COLUMNS line: " << line << std::endl;
+                chunk.errors++;
+                continue;
+            }
+            if (chunk.colNames.empty() || chunk.colNames.back() != tokens[0]) {
+                chunk.colNames.push_back(tokens[0]);
+                chunk.marker.push_back(state);
+            }
+            int col = static_cast<int>(chunk.colNames.size()) - 1;
+            for (int k = 1; k < count; k += 2) {
+                int row = findRow(tokens[k]);
+                double value;
+                if (row == kUnknownRow || !parseNumber(tokens[k + 1], value)) {
+                    std::cout << "Bad COLUMNS entry: " << line << std::endl;
+                    chunk.errors++;
+                    continue;
+                }
+                // explicit zeros are not stored, same as CoinMpsIO
+                if (row != kFreeRow && value != 0.0)
+                    chunk.entries.push_back({col, row, value});
+            }
+        }
+    });
+
+    // stitch the chunks: a column may straddle two chunks, markers carry over
+    std::vector<std::string_view> colNames;
+    std::vector<char> colInteger;
+    {
+        signed char state = 0;
+        for (ColumnChunk& chunk : columnChunks) {
+            errors += chunk.errors;
+            chunk.globalCol.resize(chunk.colNames.size());
+            for (std::size_t j = 0; j < chunk.colNames.size(); j++) {
+                if (j == 0 && !colNames.empty() && colNames.back() == chunk.colNames[0]) {
+                    chunk.globalCol[0] = static_cast<int>(colNames.size()) - 1;
+                    continue;
+                }
+                chunk.globalCol[j] = static_cast<int>(colNames.size());
+                colNames.push_back(chunk.colNames[j]);
+                colInteger.push_back(chunk.marker[j] < 0 ? state : chunk.marker[j]);
+            }
+            if (chunk.endMarker >= 0)
+                state = chunk.endMarker;
+        }
+    }
+    const int numCols = static_cast<int>(colNames.size());
+
+    std::pmr::unordered_map<std::string_view, int> colIndex(&scratch);
+    colIndex.reserve(numCols);
+    for (int j = 0; j < numCols; j++) {
+        if (!colIndex.emplace(colNames[j], j).second) {
+            std::cout << "Column " << colNames[j] << " is not contiguous in COLUMNS" << std::endl;
+            errors++;
+        }
+    }
+
+    // CSR straight from the column-ordered entries: per-chunk row counts, then a scatter
+    data.numRows = numRows;
+    data.numCols = numCols;
+    data.objCoeffs.assign(numCols, 0.0);
+    parallelFor(static_cast<int>(columnChunks.size()), numThreads, [&](int c) {
+        ColumnChunk& chunk = columnChunks[c];
+        chunk.rowCount.assign(numRows, 0);
+        for (const MpsEntry& entry : chunk.entries) {
+            if (entry.row >= 0)
+                chunk.rowCount[entry.row]++;
+            else
+                data.objCoeffs[chunk.globalCol[entry.col]] = entry.value;
+        }
+    });
+
+    // rowCount of each chunk becomes its write cursor per row
+    data.rowStart.assign(numRows + 1, 0);
+    for (int i = 0; i < numRows; i++) {
+        int offset = data.rowStart[i];
+        for (ColumnChunk& chunk : columnChunks) {
+            int count = chunk.rowCount[i];
+            chunk.rowCount[i] = offset;
+            offset += count;
+        }
+        data.rowStart[i + 1] = offset;
+    }
+    data.numNonZeros = data.rowStart[numRows];
+    data.colIdxs.resize(data.numNonZeros);
+    data.colCoeffs.resize(data.numNonZeros);
+    parallelFor(static_cast<int>(columnChunks.size()), numThreads, [&](int c) {
+        ColumnChunk& chunk = columnChunks[c];
+        for (const MpsEntry& entry : chunk.entries) {
+            if (entry.row < 0)
+                continue;
+            int pos = chunk.rowCount[entry.row]++;
+            data.colIdxs[pos] = chunk.globalCol[entry.col];
+            data.colCoeffs[pos] = entry.value;
+        }
+        std::vector<MpsEntry>().swap(chunk.entries);
+    });
+
+    // RHS / RANGES / BOUNDS: tokenize in parallel, apply in file order
+    auto parseRecords = [&](TextRange range, bool bounds) {
+        std::vector<TextRange> ranges = splitChunks(range, numThreads);
+        std::vector<RecordChunk> chunks(ranges.size());
+        parallelFor(static_cast<int>(ranges.size()), numThreads, [&](int c) {
+            RecordChunk& chunk = chunks[c];
+            const char* pos = ranges[c].begin;
+            std::string_view line;
+            std::string_view tokens[6];
+            while (nextLine(pos, ranges[c].end, line)) {
+                if (isBlankOrComment(line))
+                    continue;
+                int count = splitTokens(line, tokens, 6);
+                if (bounds) {
+                    // type [set] column [value]
+                    int type = count > 0 ? boundType(tokens[0]) : kBadBound;
+                    bool hasSet = false, hasValue = false;
+                    if (type != kBadBound) {
+                        if (boundNeedsValue(type)) {
+                            hasValue = true;
+                            hasSet = count == 4;
+                        } else if (count == 3) {
+                            hasSet = colIndex.count(tokens[2]) > 0;
+                            hasValue = !hasSet;
+                        } else {
+                            hasSet = hasValue = count == 4;
+                        }
+                    }
+                    int expected = 2 + hasSet + hasValue;
+                    MpsRecord record{hasSet ? tokens[1] : std::string_view(), type, -1, 0.0};
+                    if (type != kBadBound && count == expected) {
+                        auto it = colIndex.find(tokens[1 + hasSet]);
+                        if (it != colIndex.end())
+                            record.index = it->second;
+                    }
+                    if (record.index < 0 || (hasValue && !parseNumber(tokens[expected - 1], record.value))) {
+                        std::cout << "Bad BOUNDS line: " << line << std::endl;
+                        chunk.errors++;
+                        continue;
+                    }
+                    chunk.records.push_back(record);
+                } else {
+                    // [set] row value [row value]
+                    if (count < 2 || count > 5) {
+                        std::cout << "Bad RHS/RANGES line: " << line << std::endl;
+                        chunk.errors++;
+                        continue;
+                    }
+                    int first = count % 2;
+                    std::string_view set = first ? tokens[0] : std::string_view();
+                    for (int k = first; k + 1 < count; k += 2) {
+                        MpsRecord record{set, 0, findRow(tokens[k]), 0.0};
+                        if (record.index == kUnknownRow || !parseNumber(tokens[k + 1], record.value)) {
+                            std::cout << "Bad RHS/RANGES entry: " << line << std::endl;
+                            chunk.errors++;
+                            continue;
+                        }
+                        chunk.records.push_back(record);
+                    }
+                }
+            }
+        });
+        std::vector<MpsRecord> records;
+        for (RecordChunk& chunk : chunks) {
+            errors += chunk.errors;
+            records.insert(records.end(), chunk.records.begin(), chunk.records.end());
+        }
+        return records;
+    };
+
+    // only the first named set of each section is used, as in CoinMpsIO
+    auto inFirstSet = [](std::string_view& firstSet, bool& seen, const MpsRecord& record) {
+        if (!seen) {
+            firstSet = record.set;
+            seen = true;
+        }
+        return record.set == firstSet;
+    };
+
+    std::vector<double> rowRhs(numRows, 0.0);
+    data.objOffset = 0.0;
+    if (rhsRange.begin) {
+        std::string_view firstSet;
+        bool seen = false;
+        for (const MpsRecord& record : parseRecords(rhsRange, false)) {
+            if (!inFirstSet(firstSet, seen, record))
+                continue;
+            if (record.index == kObjectiveRow)
+                data.objOffset = -record.value;
+            else if (record.index >= 0)
+                rowRhs[record.index] = clampInfinity(record.value);
+        }
+    }
+
+    std::vector<double> rowLower(numRows), rowUpper(numRows);
+    for (int i = 0; i < numRows; i++) {
+        double rhs = rowRhs[i];
+        switch (rowKind[i]) {
+        case 'L': rowLower[i] = -COIN_DBL_MAX; rowUpper[i] = rhs; break;
+        case 'G': rowLower[i] = rhs; rowUpper[i] = COIN_DBL_MAX; break;
+        case 'E': rowLower[i] = rowUpper[i] = rhs; break;
+        default: rowLower[i] = -COIN_DBL_MAX; rowUpper[i] = COIN_DBL_MAX; break;
+        }
+    }
+
+    if (rangesRange.begin) {
+        std::string_view firstSet;
+        bool seen = false;
+        for (const MpsRecord& record : parseRecords(rangesRange, false)) {
+            if (!inFirstSet(firstSet, seen, record) || record.index < 0)
+                continue;
+            int i = record.index;
+            double range = record.value;
+            switch (rowKind[i]) {
+            case 'L': rowLower[i] = rowRhs[i] - std::fabs(range); break;
+            case 'G': rowUpper[i] = rowRhs[i] + std::fabs(range); break;
+            case 'E':
+                if (range > 0.0)
+                    rowUpper[i] = rowRhs[i] + range;
+                else
+                    rowLower[i] = rowRhs[i] + range;
+                break;
+            default: break;
+            }
+        }
+    }
+
+    data.rowtypes.resize(numRows);
+    data.rhs.resize(numRows);
+    data.rhsrange.resize(numRows);
+    for (int i = 0; i < numRows; i++)
+        rowBoundsToSense(rowLower[i], rowUpper[i], data.rowtypes[i], data.rhs[i], data.rhsrange[i]);
+
+    // columns inside integer markers default to binary, as in CoinMpsIO
+    data.lb.assign(numCols, 0.0);
+    data.ub.resize(numCols);
+    for (int j = 0; j < numCols; j++)
+        data.ub[j] = colInteger[j] ? 1.0 : COIN_DBL_MAX;
+    if (boundsRange.begin) {
+        std::string_view firstSet;
+        bool seen = false;
+        bool warnedSemi = false;
+        for (const MpsRecord& record : parseRecords(boundsRange, true)) {
+            if (!inFirstSet(firstSet, seen, record))
+                continue;
+            int j = record.index;
+            double value = clampInfinity(record.value);
+            switch (record.type) {
+            case kUp:
+                data.ub[j] = value;
+                if (value < 0.0 && data.lb[j] == 0.0)
+                    data.lb[j] = -COIN_DBL_MAX;
+                break;
+            case kLo: data.lb[j] = value; break;
+            case kFx: data.lb[j] = data.ub[j] = value; break;
+            case kFr: data.lb[j] = -COIN_DBL_MAX; data.ub[j] = COIN_DBL_MAX; break;
+            case kMi: data.lb[j] = -COIN_DBL_MAX; break;
+            case kPl: data.ub[j] = COIN_DBL_MAX; break;
+            case kBv: data.lb[j] = 0.0; data.ub[j] = 1.0; colInteger[j] = 1; break;
+            case kLi: data.lb[j] = value; colInteger[j] = 1; break;
+            case kUi: data.ub[j] = value; colInteger[j] = 1; break;
+            case kSc:
+                if (!warnedSemi)
+                    std::cout << "Semi-continuous bounds are read as plain upper bounds" << std::endl;
+                warnedSemi = true;
+                data.ub[j] = value;
+                break;
+            }
+        }
+    }
+
+    data.varTypes.resize(numCols);
+    for (int j = 0; j < numCols; j++)
+        data.varTypes[j] = colInteger[j] ? 'I' : 'C';
+
+    data.objSense = 1;
+    if (objSenseToken == "MAX" || objSenseToken == "MAXIMIZE")
+        data.objSense = -1;
+
+    data.colName.assign(colNames.begin(), colNames.end());
+    data.rowName.assign(rowNames.begin(), rowNames.end());
+    return errors;
+}
@@ -0,0 +1,150 @@
+#include "name_table.h"
+
+#include <utility>
+
+// FNV-1a; a word-at-a-time hash with the murmur3 finalizer measured slower
+// on the miplib3 and synthetic names of bench_names
+std::uint64_t hashName(std::string_view name)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+NameTable::NameTable(std::pmr::memory_resource* resource)
+    : chars_(resource), offsets_(1, 0, resource), slots_(resource)
+{
+}
+
+NameTable::NameTable(const NameTable& other)
+    : chars_(other.chars_), offsets_(other.offsets_)
+{
+}
+
+// the index is not copied, the copy builds its own on its first lookup
+NameTable& NameTable::operator=(const NameTable& other)
+{
+    if (this != &other) {
+        chars_ = other.chars_;
+        offsets_ = other.offsets_;
+        slots_.clear();
+        indexed_.store(false, std::memory_order_release);
+    }
+    return *this;
+}
+
+// moves the resource along with the arrays
+NameTable::NameTable(NameTable&& other) noexcept
+    : chars_(std::move(other.chars_)), offsets_(std::move(other.offsets_)), slots_(std::move(other.slots_)),
+      indexed_(other.indexed_.load(std::memory_order_acquire))
+{
+    other.clear();
+}
+
+NameTable& NameTable::operator=(NameTable&& other) noexcept
+{
+    if (this != &other) {
+        chars_ = std::move(other.chars_);
+        offsets_ = std::move(other.offsets_);
+        slots_ = std::move(other.slots_);
+        indexed_.store(other.indexed_.load(std::memory_order_acquire), std::memory_order_release);
+        other.clear();
+    }
+    return *this;
+}
+
+void NameTable::push_back(std::string_view name)
+{
+    // hashed before the append, name may point into the arena
+    bool indexed = indexed_.load(std::memory_order_relaxed);
+    std::uint64_t hash = indexed ? hashName(name) : 0;
+    chars_.append(name.data(), name.size());
+    offsets_.push_back(chars_.size());
+    if (indexed)
+        insert(size() - 1, hash);
+}
+
+void NameTable::reserve(int count, std::size_t chars)
+{
+    offsets_.reserve(static_cast<std::size_t>(count) + 1);
+    chars_.reserve(chars);
+}
+
+void NameTable::clear()
+{
+    chars_.clear();
+    offsets_.assign(1, 0);
+    slots_.clear();
+    indexed_.store(false, std::memory_order_release);
+}
+
+void NameTable::insert(int index, std::uint64_t hash) const
+{
+    if (2 * (static_cast<std::size_t>(index) + 1) > slots_.size()) {
+        // grow and re-insert everything before index, keeping the first of duplicates
+        std::size_t capacity = 16;
+        while (capacity < 2 * (static_cast<std::size_t>(index) + 1))
+            capacity *= 2;
+        slots_.assign(capacity, Slot{0, -1});
+        for (int i = 0; i < index; i++)
+            insert(i, hashName((*this)[i]));
+    }
+    std::size_t mask = slots_.size() - 1;
+    std::uint32_t tag = static_cast<std::uint32_t>(hash >> 32);
+    for (std::size_t s = hash & mask;; s = (s + 1) & mask) {
+        Slot& slot = slots_[s];
+        if (slot.index < 0) {
+            slot = Slot{tag, index};
+            return;
+        }
+        if (slot.hash == tag && (*this)[slot.index] == (*this)[index])
+            return; // duplicate, find() keeps returning the first one
+    }
+}
+
+void NameTable::buildIndex() const
+{
+    std::lock_guard<std::mutex> lock(indexMutex_);
+    if (indexed_.load(std::memory_order_relaxed))
+        return;
+    std::size_t capacity = 16;
+    while (capacity < 2 * static_cast<std::size_t>(size()))
+        capacity *= 2;
+    slots_.assign(capacity, Slot{0, -1});
+    for (int i = 0; i < size(); i++)
+        insert(i, hashName((*this)[i]));
+    indexed_.store(true, std::memory_order_release);
+}
+
+int NameTable::find(std::string_view name) const
+{
+    if (!indexed_.load(std::memory_order_acquire))
+        buildIndex();
+    std::uint64_t hash = hashName(name);
+    std::size_t mask = slots_.size() - 1;
+    std::uint32_t tag = static_cast<std::uint32_t>(hash >> 32);
+    for (std::size_t s = hash & mask;; s = (s + 1) & mask) {
+        const Slot& slot = slots_[s];
+        if (slot.index < 0)
+            return -1;
+        if (slot.hash == tag && (*this)[slot.index] == name)
+            return slot.index;
+    }
+}
+
+std::size_t NameTable::memoryBytes() const
+{
+    return chars_.capacity() + offsets_.capacity() * sizeof(std::uint64_t) + slots_.capacity() * sizeof(Slot);
+}
+
+std::vector<std::string> NameTable::toStrings() const
+{
+    std::vector<std::string> names;
+    names.reserve(size());
+    for (int i = 0; i < size(); i++)
+        names.emplace_back((*this)[i]);
+    return names;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+  Column or row names stored back to back in one character arena, with an
+  offset per name, instead of one std::string each. find() maps a name back
+  to its index through an open-addressing hash table (linear probing, load
+  factor at most 1/2) that is built on the first lookup and then kept up to
+  date by push_back, so models that never look a name up do not pay for it.
+
+  Indexing mirrors std::vector<std::string>, but operator[] returns a
+  string_view into the arena that is invalidated by the next push_back.
+
+    NameTable names;
+    names.push_back("x1");
+    names.push_back("x2");
+    int col = names.find("x2");          // 1, -1 if there is no such name
+    std::string_view name = names[col];  // "x2"
+
+  Duplicate names are kept; find() returns the first of them. Lookups are
+  safe from several threads, modifications are not.
+*/
+class NameTable
+{
+public:
+    NameTable() = default;
+    explicit NameTable(std::pmr::memory_resource* resource); // for the arena, the offsets and the index
+    NameTable(const NameTable& other);
+    NameTable& operator=(const NameTable& other);
+    NameTable(NameTable&& other) noexcept;
+    NameTable& operator=(NameTable&& other) noexcept;
+
+    int size() const { return static_cast<int>(offsets_.size()) - 1; }
+    bool empty() const { return size() == 0; }
+    std::string_view operator[](int i) const
+    {
+        return std::string_view(chars_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]);
+    }
+
+    void push_back(std::string_view name);
+    template <typename It>
+    void assign(It first, It last)
+    {
+        clear();
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+    void reserve(int count, std::size_t chars = 0);
+    void clear();
+
+    int find(std::string_view name) const;
+
+    // Bytes held by the arena, the offsets and the index (if built).
+    std::size_t memoryBytes() const;
+    // Copies for APIs that want strings, e.g. OsiSolverInterface::setColNames.
+    std::vector<std::string> toStrings() const;
+
+private:
+    struct Slot
+    {
+        std::uint32_t hash;
+        std::int32_t index; // -1 for an empty slot
+    };
+
+    void buildIndex() const;
+    void insert(int index, std::uint64_t hash) const;
+
+    std::pmr::string chars_;
+    std::pmr::vector<std::uint64_t> offsets_ = {0}; // size() + 1 entries
+
+    mutable std::pmr::vector<Slot> slots_; // power of two, empty until the first find()
+    mutable std::atomic<bool> indexed_{false};
+    mutable std::mutex indexMutex_;
+};
+
+// FNV-1a over the bytes of the name, the hash behind NameTable::find.
+std::uint64_t hashName(std::string_view name);
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Number of worker threads to use when the caller passes numThreads <= 0.
+inline int defaultThreadCount()
+{
+    unsigned int cores = std::thread::hardware_concurrency();
+    return cores == 0 ? 1 : static_cast<int>(cores);
+}
+
+/*
+  Runs fn(chunk) for every chunk in [0, numChunks) on up to numThreads threads
+  (numThreads <= 0 uses every core). Chunks are handed out dynamically, so
+  uneven chunks balance themselves. The calling thread takes part in the work.
+*/
+template <typename Fn>
+void parallelFor(int numChunks, int numThreads, Fn&& fn)
+{
+    if (numThreads <= 0)
+        numThreads = defaultThreadCount();
+    numThreads = std::min(numThreads, numChunks);
+    if (numThreads <= 1) {
+        for (int chunk = 0; chunk < numChunks; chunk++)
+            fn(chunk);
+        return;
+    }
+
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (int chunk = next++; chunk < numChunks; chunk = next++)
+            fn(chunk);
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (int t = 1; t < numThreads; t++)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread& thread : threads)
+        thread.join();
+}
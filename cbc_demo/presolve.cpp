@@ -0,0 +1,672 @@
+#include "presolve.h"
+#include "parallel.h"
+#include "problem_instance.h"
+#include "util.h"
+
+#include "CoinFinite.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+static const int kChunkSize = 2048;
+static const double kInfinity = 1e30;      // bounds beyond this are infinite
+static const double kFeasibilityTolerance = 1e-9;
+static const double kIntegerTolerance = 1e-6;
+
+static bool isInfinite(double value)
+{
+    return std::fabs(value) >= kInfinity;
+}
+
+static int numChunks(int count)
+{
+    return (count + kChunkSize - 1) / kChunkSize;
+}
+
+// Activity bounds of a row over the active columns.
+struct RowScan
+{
+    int count = 0;
+    int single = -1;   // the column of a singleton row
+    double singleCoeff = 0.0;
+    double minActivity = 0.0; // finite part
+    double maxActivity = 0.0;
+    int minInfinite = 0;      // columns with an infinite contribution
+    int maxInfinite = 0;
+};
+
+// Decisions of the column scan, applied afterwards in column order.
+struct ColumnScan
+{
+    double lb;
+    double ub;
+    int dualFix = 0; // 1 to the lower bound, 2 to the upper bound
+};
+
+class Presolver
+{
+public:
+    Presolver(const ProblemInstance& data, PresolveMap& map, PresolveStats& stats, const PresolveOptions& options)
+        : data_(data), map_(map), stats_(stats), options_(options)
+    {
+    }
+
+    PresolveStatus run(ProblemInstance& reduced);
+
+private:
+    bool scanRows();
+    bool scanColumns();
+    bool removeDuplicateRows();
+    void removeDuplicateColumns();
+    void fixColumn(int col, double value);
+    void build(ProblemInstance& reduced) const;
+    bool infeasible(const std::string& message)
+    {
+        map_.message = message;
+        return false;
+    }
+    std::string rowLabel(int row) const
+    {
+        return data_.rowName.empty() ? "row " + std::to_string(row) : "row " + std::string(data_.rowName[row]);
+    }
+
+    const ProblemInstance& data_;
+    PresolveMap& map_;
+    PresolveStats& stats_;
+    PresolveOptions options_;
+    bool changed_ = false;
+
+    std::vector<double> lb_, ub_;
+    std::vector<double> rowLower_, rowUpper_; // after the fixed columns moved to the right hand side
+    std::vector<char> colActive_, rowActive_;
+    double offset_ = 0.0;
+
+    // column-major copy of the original matrix, rows ascending within a column
+    std::shared_ptr<const ColumnMajor> columns_;
+
+    std::vector<RowScan> rowScan_;
+    std::vector<double> scanLb_, scanUb_; // the bounds rowScan_ was computed with
+};
+
+void Presolver::fixColumn(int col, double value)
+{
+    colActive_[col] = 0;
+    map_.colRemoved[col] = 1;
+    map_.fixedValue[col] = value;
+    lb_[col] = ub_[col] = value;
+    offset_ += data_.objCoeffs[col] * value;
+    for (int p = columns_->colStart[col]; p < columns_->colStart[col + 1]; p++) {
+        int row = columns_->rowIdxs[p];
+        double shift = columns_->rowCoeffs[p] * value;
+        if (!isInfinite(rowLower_[row]))
+            rowLower_[row] -= shift;
+        if (!isInfinite(rowUpper_[row]))
+            rowUpper_[row] -= shift;
+    }
+    changed_ = true;
+}
+
+// Empty, singleton and redundant rows; false if a row cannot be satisfied.
+bool Presolver::scanRows()
+{
+    scanLb_ = lb_;
+    scanUb_ = ub_;
+    parallelFor(numChunks(data_.numRows), options_.numThreads, [&](int chunk) {
+        int end = std::min(data_.numRows, (chunk + 1) * kChunkSize);
+        for (int i = chunk * kChunkSize; i < end; i++) {
+            if (!rowActive_[i])
+                continue;
+            RowScan scan;
+            for (int k = data_.rowStart[i]; k < data_.rowStart[i + 1]; k++) {
+                int j = data_.colIdxs[k];
+                if (!colActive_[j])
+                    continue;
+                double a = data_.colCoeffs[k];
+                scan.count++;
+                scan.single = j;
+                scan.singleCoeff = a;
+                double low = a > 0.0 ? scanLb_[j] : scanUb_[j];
+                double high = a > 0.0 ? scanUb_[j] : scanLb_[j];
+                if (isInfinite(low))
+                    scan.minInfinite++;
+                else
+                    scan.minActivity += a * low;
+                if (isInfinite(high))
+                    scan.maxInfinite++;
+                else
+                    scan.maxActivity += a * high;
+            }
+            rowScan_[i] = scan;
+        }
+    });
+
+    for (int i = 0; i < data_.numRows; i++) {
+        if (!rowActive_[i])
+            continue;
+        const RowScan& scan = rowScan_[i];
+        double lower = rowLower_[i], upper = rowUpper_[i];
+        double lowerTolerance = kFeasibilityTolerance * std::max(1.0, std::fabs(lower));
+        double upperTolerance = kFeasibilityTolerance * std::max(1.0, std::fabs(upper));
+
+        if (scan.count == 0) {
+            if ((!isInfinite(lower) && lower > lowerTolerance) || (!isInfinite(upper) && upper < -upperTolerance))
+                return infeasible(rowLabel(i) + " is empty but needs a nonzero activity");
+            rowActive_[i] = 0;
+            stats_.emptyRows++;
+            changed_ = true;
+            continue;
+        }
+
+        if (scan.count == 1) {
+            int j = scan.single;
+            double a = scan.singleCoeff;
+            double low = isInfinite(a > 0.0 ? lower : upper) ? -COIN_DBL_MAX : (a > 0.0 ? lower : upper) / a;
+            double high = isInfinite(a > 0.0 ? upper : lower) ? COIN_DBL_MAX : (a > 0.0 ? upper : lower) / a;
+            if (data_.varTypes[j] != 'C') {
+                if (!isInfinite(low))
+                    low = std::ceil(low - kIntegerTolerance);
+                if (!isInfinite(high))
+                    high = std::floor(high + kIntegerTolerance);
+            }
+            lb_[j] = std::max(lb_[j], low);
+            ub_[j] = std::min(ub_[j], high);
+            if (lb_[j] > ub_[j] + kFeasibilityTolerance * std::max(1.0, std::fabs(lb_[j])))
+                return infeasible(rowLabel(i) + " contradicts the bounds of its only column");
+            ub_[j] = std::max(ub_[j], lb_[j]);
+            rowActive_[i] = 0;
+            stats_.singletonRows++;
+            changed_ = true;
+            continue;
+        }
+
+        if (scan.minInfinite == 0 && !isInfinite(upper) && scan.minActivity > upper + 1e-6 * std::max(1.0, std::fabs(upper)))
+            return infeasible(rowLabel(i) + " cannot reach its upper bound");
+        if (scan.maxInfinite == 0 && !isInfinite(lower) && scan.maxActivity < lower - 1e-6 * std::max(1.0, std::fabs(lower)))
+            return infeasible(rowLabel(i) + " cannot reach its lower bound");
+        bool lowerHolds = isInfinite(lower) || (scan.minInfinite == 0 && scan.minActivity >= lower - lowerTolerance);
+        bool upperHolds = isInfinite(upper) || (scan.maxInfinite == 0 && scan.maxActivity <= upper + upperTolerance);
+        if (lowerHolds && upperHolds) {
+            rowActive_[i] = 0;
+            stats_.redundantRows++;
+            changed_ = true;
+        }
+    }
+    return true;
+}
+
+// Implied integer bounds, dual fixing and fixed columns.
+bool Presolver::scanColumns()
+{
+    std::vector<ColumnScan> columns(data_.numCols);
+    std::vector<int> tightened(numChunks(data_.numCols), 0);
+    parallelFor(numChunks(data_.numCols), options_.numThreads, [&](int chunk) {
+        int end = std::min(data_.numCols, (chunk + 1) * kChunkSize);
+        for (int j = chunk * kChunkSize; j < end; j++) {
+            if (!colActive_[j])
+                continue;
+            ColumnScan& column = columns[j];
+            column.lb = lb_[j];
+            column.ub = ub_[j];
+            bool integer = data_.varTypes[j] != 'C';
+            int upLocks = 0, downLocks = 0;
+            for (int p = columns_->colStart[j]; p < columns_->colStart[j + 1]; p++) {
+                int i = columns_->rowIdxs[p];
+                if (!rowActive_[i])
+                    continue;
+                double a = columns_->rowCoeffs[p];
+                bool hasLower = !isInfinite(rowLower_[i]), hasUpper = !isInfinite(rowUpper_[i]);
+                if (a > 0.0) {
+                    upLocks += hasUpper;
+                    downLocks += hasLower;
+                } else {
+                    upLocks += hasLower;
+                    downLocks += hasUpper;
+                }
+                if (!integer)
+                    continue;
+                // the rest of the row at its extreme, with the bounds of the row scan
+                const RowScan& scan = rowScan_[i];
+                if (hasUpper && scan.minInfinite == 0) {
+                    double slack = rowUpper_[i] - scan.minActivity;
+                    if (a > 0.0)
+                        column.ub = std::min(column.ub, std::floor(scanLb_[j] + slack / a + kIntegerTolerance));
+                    else
+                        column.lb = std::max(column.lb, std::ceil(scanUb_[j] + slack / a - kIntegerTolerance));
+                }
+                if (hasLower && scan.maxInfinite == 0) {
+                    double slack = rowLower_[i] - scan.maxActivity;
+                    if (a > 0.0)
+                        column.lb = std::max(column.lb, std::ceil(scanUb_[j] + slack / a - kIntegerTolerance));
+                    else
+                        column.ub = std::min(column.ub, std::floor(scanLb_[j] + slack / a + kIntegerTolerance));
+                }
+            }
+            tightened[chunk] += (column.lb > lb_[j]) + (column.ub < ub_[j]);
+            double cost = data_.objCoeffs[j] * data_.objSense;
+            if (options_.dualFixing && cost >= 0.0 && downLocks == 0 && !isInfinite(column.lb))
+                column.dualFix = 1;
+            else if (options_.dualFixing && cost <= 0.0 && upLocks == 0 && !isInfinite(column.ub))
+                column.dualFix = 2;
+        }
+    });
+
+    for (int count : tightened)
+        stats_.tightenedBounds += count;
+    for (int j = 0; j < data_.numCols; j++) {
+        if (!colActive_[j])
+            continue;
+        const ColumnScan& column = columns[j];
+        if (column.lb > lb_[j] || column.ub < ub_[j])
+            changed_ = true;
+        lb_[j] = column.lb;
+        ub_[j] = column.ub;
+        if (lb_[j] > ub_[j] + kFeasibilityTolerance * std::max(1.0, std::fabs(lb_[j]))) {
+            std::string name = data_.colName.empty() ? std::to_string(j) : std::string(data_.colName[j]);
+            return infeasible("the bounds of column " + name + " cross");
+        }
+        if (column.dualFix != 0) {
+            fixColumn(j, column.dualFix == 1 ? lb_[j] : ub_[j]);
+            stats_.dualFixedColumns++;
+        } else if (ub_[j] - lb_[j] <= kFeasibilityTolerance * std::max(1.0, std::fabs(lb_[j]))) {
+            fixColumn(j, data_.varTypes[j] != 'C' ? std::round(lb_[j]) : lb_[j]);
+            stats_.fixedColumns++;
+        }
+    }
+    return true;
+}
+
+// Hash of (index, value) pairs, values scaled by the first one so parallel rows collide.
+static std::uint64_t hashEntries(const std::vector<std::pair<int, double>>& entries, double scale)
+{
+    std::uint64_t hash = 1469598103934665603ull;
+    for (const auto& entry : entries) {
+        // round to 10 significant digits, equal values must hash equally
+        double value = entry.second * scale;
+        long long quantized = std::llround(value * 1e9);
+        hash = (hash ^ static_cast<std::uint64_t>(entry.first)) * 1099511628211ull;
+        hash = (hash ^ static_cast<std::uint64_t>(quantized)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+static bool nearlyEqual(double a, double b)
+{
+    return std::fabs(a - b) <= 1e-12 * std::max(1.0, std::max(std::fabs(a), std::fabs(b)));
+}
+
+bool Presolver::removeDuplicateRows()
+{
+    // active entries of every row, sorted by column, and a hash of the row scaled by its first entry
+    std::vector<std::vector<std::pair<int, double>>> rows(data_.numRows);
+    std::vector<std::pair<std::uint64_t, int>> hashes(data_.numRows, {0, -1});
+    parallelFor(numChunks(data_.numRows), options_.numThreads, [&](int chunk) {
+        int end = std::min(data_.numRows, (chunk + 1) * kChunkSize);
+        for (int i = chunk * kChunkSize; i < end; i++) {
+            if (!rowActive_[i])
+                continue;
+            auto& entries = rows[i];
+            for (int k = data_.rowStart[i]; k < data_.rowStart[i + 1]; k++)
+                if (colActive_[data_.colIdxs[k]])
+                    entries.emplace_back(data_.colIdxs[k], data_.colCoeffs[k]);
+            if (entries.size() < 2)
+                continue;
+            std::sort(entries.begin(), entries.end());
+            hashes[i] = {hashEntries(entries, 1.0 / entries[0].second), i};
+        }
+    });
+
+    hashes.erase(std::remove_if(hashes.begin(), hashes.end(), [](const auto& h) { return h.second < 0; }),
+        hashes.end());
+    std::sort(hashes.begin(), hashes.end());
+    for (std::size_t start = 0; start < hashes.size();) {
+        std::size_t end = start + 1;
+        while (end < hashes.size() && hashes[end].first == hashes[start].first)
+            end++;
+        for (std::size_t a = start; a < end; a++) {
+            int keep = hashes[a].second;
+            if (!rowActive_[keep])
+                continue;
+            for (std::size_t b = a + 1; b < end; b++) {
+                int other = hashes[b].second;
+                if (!rowActive_[other] || rows[keep].size() != rows[other].size())
+                    continue;
+                const auto& x = rows[keep];
+                const auto& y = rows[other];
+                double ratio = y[0].second / x[0].second; // row other = ratio * row keep
+                bool same = true;
+                for (std::size_t k = 0; k < x.size() && same; k++)
+                    same = x[k].first == y[k].first && nearlyEqual(x[k].second * ratio, y[k].second);
+                if (!same)
+                    continue;
+
+                double lower = rowLower_[other], upper = rowUpper_[other];
+                double low = ratio > 0.0 ? lower : upper, high = ratio > 0.0 ? upper : lower;
+                low = isInfinite(low) ? -COIN_DBL_MAX : low / ratio;
+                high = isInfinite(high) ? COIN_DBL_MAX : high / ratio;
+                rowLower_[keep] = std::max(rowLower_[keep], low);
+                rowUpper_[keep] = std::min(rowUpper_[keep], high);
+                if (rowLower_[keep] > rowUpper_[keep] + kFeasibilityTolerance * std::max(1.0, std::fabs(rowLower_[keep])))
+                    return infeasible(rowLabel(keep) + " and its duplicate " + rowLabel(other) + " contradict");
+                rowUpper_[keep] = std::max(rowUpper_[keep], rowLower_[keep]);
+                rowActive_[other] = 0;
+                stats_.duplicateRows++;
+                changed_ = true;
+            }
+        }
+        start = end;
+    }
+    return true;
+}
+
+void Presolver::removeDuplicateColumns()
+{
+    std::vector<std::vector<std::pair<int, double>>> columns(data_.numCols);
+    std::vector<std::pair<std::uint64_t, int>> hashes(data_.numCols, {0, -1});
+    parallelFor(numChunks(data_.numCols), options_.numThreads, [&](int chunk) {
+        int end = std::min(data_.numCols, (chunk + 1) * kChunkSize);
+        for (int j = chunk * kChunkSize; j < end; j++) {
+            // the split in postsolve needs finite lower bounds
+            if (!colActive_[j] || isInfinite(lb_[j]))
+                continue;
+            auto& entries = columns[j];
+            for (int p = columns_->colStart[j]; p < columns_->colStart[j + 1]; p++)
+                if (rowActive_[columns_->rowIdxs[p]])
+                    entries.emplace_back(columns_->rowIdxs[p], columns_->rowCoeffs[p]);
+            if (entries.empty())
+                continue;
+            entries.emplace_back(-1, data_.objCoeffs[j]);
+            entries.emplace_back(-2, data_.varTypes[j] == 'C' ? 0.0 : 1.0);
+            hashes[j] = {hashEntries(entries, 1.0), j};
+        }
+    });
+
+    hashes.erase(std::remove_if(hashes.begin(), hashes.end(), [](const auto& h) { return h.second < 0; }),
+        hashes.end());
+    std::sort(hashes.begin(), hashes.end());
+    for (std::size_t start = 0; start < hashes.size();) {
+        std::size_t end = start + 1;
+        while (end < hashes.size() && hashes[end].first == hashes[start].first)
+            end++;
+        for (std::size_t a = start; a < end; a++) {
+            int keep = hashes[a].second;
+            if (!colActive_[keep])
+                continue;
+            for (std::size_t b = a + 1; b < end; b++) {
+                int other = hashes[b].second;
+                if (!colActive_[other] || columns[keep] != columns[other])
+                    continue;
+                // x_keep + x_other becomes the kept column
+                map_.merges.push_back({keep, other, ub_[keep], lb_[other]});
+                lb_[keep] += lb_[other];
+                ub_[keep] = isInfinite(ub_[keep]) || isInfinite(ub_[other]) ? COIN_DBL_MAX : ub_[keep] + ub_[other];
+                colActive_[other] = 0;
+                map_.colRemoved[other] = 2;
+                stats_.mergedColumns++;
+                changed_ = true;
+            }
+        }
+        start = end;
+    }
+}
+
+void Presolver::build(ProblemInstance& reduced) const
+{
+    map_.colOrigin.clear();
+    map_.rowOrigin.clear();
+    std::vector<int> newIndex(data_.numCols, -1);
+    for (int j = 0; j < data_.numCols; j++) {
+        if (!colActive_[j])
+            continue;
+        newIndex[j] = static_cast<int>(map_.colOrigin.size());
+        map_.colOrigin.push_back(j);
+    }
+    for (int i = 0; i < data_.numRows; i++)
+        if (rowActive_[i])
+            map_.rowOrigin.push_back(i);
+
+    reduced = ProblemInstance();
+    reduced.numCols = static_cast<int>(map_.colOrigin.size());
+    reduced.numRows = static_cast<int>(map_.rowOrigin.size());
+    reduced.objSense = data_.objSense;
+    reduced.objOffset = data_.objOffset + offset_;
+    for (int j : map_.colOrigin) {
+        reduced.varTypes.push_back(data_.varTypes[j]);
+        reduced.lb.push_back(lb_[j]);
+        reduced.ub.push_back(ub_[j]);
+        reduced.objCoeffs.push_back(data_.objCoeffs[j]);
+        if (!data_.colName.empty())
+            reduced.colName.push_back(data_.colName[j]);
+    }
+    reduced.rowStart.push_back(0);
+    for (int i : map_.rowOrigin) {
+        char sense;
+        double rhs, range;
+        rowBoundsToSense(isInfinite(rowLower_[i]) ? -COIN_DBL_MAX : rowLower_[i],
+            isInfinite(rowUpper_[i]) ? COIN_DBL_MAX : rowUpper_[i], sense, rhs, range);
+        reduced.rowtypes.push_back(sense);
+        reduced.rhs.push_back(rhs);
+        reduced.rhsrange.push_back(range);
+        if (!data_.rowName.empty())
+            reduced.rowName.push_back(data_.rowName[i]);
+        for (int k = data_.rowStart[i]; k < data_.rowStart[i + 1]; k++) {
+            int j = newIndex[data_.colIdxs[k]];
+            if (j < 0)
+                continue;
+            reduced.colIdxs.push_back(j);
+            reduced.colCoeffs.push_back(data_.colCoeffs[k]);
+        }
+        reduced.rowStart.push_back(static_cast<int>(reduced.colIdxs.size()));
+    }
+    reduced.numNonZeros = static_cast<int>(reduced.colIdxs.size());
+}
+
+PresolveStatus Presolver::run(ProblemInstance& reduced)
+{
+    auto start = std::chrono::steady_clock::now();
+    map_ = PresolveMap();
+    map_.numCols = data_.numCols;
+    map_.numRows = data_.numRows;
+    map_.colRemoved.assign(data_.numCols, 0);
+    map_.fixedValue.assign(data_.numCols, 0.0);
+    map_.colName = data_.colName;
+    map_.rowName = data_.rowName;
+    stats_ = PresolveStats();
+
+    lb_.assign(data_.lb.begin(), data_.lb.end());
+    ub_.assign(data_.ub.begin(), data_.ub.end());
+    // integral bounds for the integer columns, merged columns rely on it
+    for (int j = 0; j < data_.numCols; j++) {
+        if (data_.varTypes[j] == 'C')
+            continue;
+        if (!isInfinite(lb_[j]))
+            lb_[j] = std::ceil(lb_[j] - kIntegerTolerance);
+        if (!isInfinite(ub_[j]))
+            ub_[j] = std::floor(ub_[j] + kIntegerTolerance);
+    }
+    rowLower_.resize(data_.numRows);
+    rowUpper_.resize(data_.numRows);
+    for (int i = 0; i < data_.numRows; i++)
+        senseToRowBounds(data_.rowtypes[i], data_.rhs[i], data_.rhsrange[i], rowLower_[i], rowUpper_[i]);
+    colActive_.assign(data_.numCols, 1);
+    rowActive_.assign(data_.numRows, 1);
+    rowScan_.resize(data_.numRows);
+    columns_ = data_.columns(options_.numThreads);
+
+    bool feasible = true;
+    while (feasible && stats_.rounds < options_.maxRounds) {
+        changed_ = false;
+        stats_.rounds++;
+        auto phase = std::chrono::steady_clock::now();
+        feasible = scanRows();
+        stats_.rowSeconds += secondsSince(phase);
+        if (!feasible)
+            break;
+
+        phase = std::chrono::steady_clock::now();
+        feasible = scanColumns();
+        stats_.columnSeconds += secondsSince(phase);
+        if (!feasible)
+            break;
+
+        if (options_.duplicates) {
+            phase = std::chrono::steady_clock::now();
+            feasible = removeDuplicateRows();
+            if (feasible)
+                removeDuplicateColumns();
+            stats_.duplicateSeconds += secondsSince(phase);
+        }
+        if (!changed_)
+            break;
+    }
+
+    if (feasible)
+        build(reduced);
+    else
+        reduced = ProblemInstance();
+    stats_.seconds = secondsSince(start);
+    return feasible ? PresolveStatus::Reduced : PresolveStatus::Infeasible;
+}
+
+PresolveStatus presolve(const ProblemInstance& data, ProblemInstance& reduced, PresolveMap& map,
+    PresolveStats& stats, const PresolveOptions& options)
+{
+    Presolver presolver(data, map, stats, options);
+    return presolver.run(reduced);
+}
+
+void PresolveMap::postsolve(const double* reduced, double* full) const
+{
+    for (int j = 0; j < numCols; j++)
+        full[j] = fixedValue[j];
+    for (std::size_t k = 0; k < colOrigin.size(); k++)
+        full[colOrigin[k]] = reduced[k];
+    // x_kept takes what it can up to its bound, the rest goes back to x_removed
+    for (auto merge = merges.rbegin(); merge != merges.rend(); ++merge) {
+        double sum = full[merge->kept];
+        full[merge->kept] = std::min(merge->keptUb, sum - merge->removedLb);
+        full[merge->removed] = sum - full[merge->kept];
+    }
+}
+
+std::vector<double> PresolveMap::postsolve(const std::vector<double>& reduced) const
+{
+    std::vector<double> full(numCols);
+    postsolve(reduced.data(), full.data());
+    return full;
+}
+
+static const char kMapMagic[8] = {'C', 'B', 'C', 'P', 'M', 'A', 'P', '\0'};
+static const std::uint32_t kMapVersion = 1;
+
+struct PresolveMapHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::int32_t numCols;
+    std::int32_t numRows;
+    std::int32_t reducedCols;
+    std::int32_t reducedRows;
+    std::int32_t numMerges;
+    std::int32_t numColNames;
+    std::int32_t numRowNames;
+};
+
+template <typename T>
+static bool writeArray(std::FILE* file, const T* data, std::size_t count)
+{
+    return count == 0 || std::fwrite(data, sizeof(T), count, file) == count;
+}
+
+template <typename T>
+static bool readArray(std::FILE* file, std::vector<T>& data, std::size_t count)
+{
+    data.resize(count);
+    return count == 0 || std::fread(data.data(), sizeof(T), count, file) == count;
+}
+
+static bool writeNames(std::FILE* file, const NameTable& names)
+{
+    for (int i = 0; i < names.size(); i++) {
+        std::string_view name = names[i];
+        std::uint32_t length = static_cast<std::uint32_t>(name.size());
+        if (!writeArray(file, &length, 1) || !writeArray(file, name.data(), name.size()))
+            return false;
+    }
+    return true;
+}
+
+static bool readNames(std::FILE* file, NameTable& names, std::size_t count)
+{
+    names.clear();
+    names.reserve(static_cast<int>(count));
+    std::string name;
+    for (std::size_t i = 0; i < count; i++) {
+        std::uint32_t length;
+        if (std::fread(&length, sizeof(length), 1, file) != 1 || length > (1u << 20))
+            return false;
+        name.resize(length);
+        if (length > 0 && std::fread(&name[0], 1, length, file) != length)
+            return false;
+        names.push_back(name);
+    }
+    return true;
+}
+
+bool writePresolveMap(const PresolveMap& map, const std::string& path)
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cout << "cannot write presolve map " << path << std::endl;
+        return false;
+    }
+    PresolveMapHeader header;
+    std::memcpy(header.magic, kMapMagic, sizeof(kMapMagic));
+    header.version = kMapVersion;
+    header.numCols = map.numCols;
+    header.numRows = map.numRows;
+    header.reducedCols = static_cast<std::int32_t>(map.colOrigin.size());
+    header.reducedRows = static_cast<std::int32_t>(map.rowOrigin.size());
+    header.numMerges = static_cast<std::int32_t>(map.merges.size());
+    header.numColNames = static_cast<std::int32_t>(map.colName.size());
+    header.numRowNames = static_cast<std::int32_t>(map.rowName.size());
+    bool ok = writeArray(file, &header, 1) && writeArray(file, map.colOrigin.data(), map.colOrigin.size())
+        && writeArray(file, map.rowOrigin.data(), map.rowOrigin.size())
+        && writeArray(file, map.colRemoved.data(), map.colRemoved.size())
+        && writeArray(file, map.fixedValue.data(), map.fixedValue.size())
+        && writeArray(file, map.merges.data(), map.merges.size()) && writeNames(file, map.colName)
+        && writeNames(file, map.rowName);
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok)
+        std::cout << "cannot write presolve map " << path << std::endl;
+    return ok;
+}
+
+bool readPresolveMap(const std::string& path, PresolveMap& map)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cout << "cannot open presolve map " << path << std::endl;
+        return false;
+    }
+    PresolveMapHeader header;
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1
+        && std::memcmp(header.magic, kMapMagic, sizeof(kMapMagic)) == 0 && header.version == kMapVersion;
+    if (ok) {
+        map = PresolveMap();
+        map.numCols = header.numCols;
+        map.numRows = header.numRows;
+        ok = readArray(file, map.colOrigin, header.reducedCols) && readArray(file, map.rowOrigin, header.reducedRows)
+            && readArray(file, map.colRemoved, header.numCols) && readArray(file, map.fixedValue, header.numCols)
+            && readArray(file, map.merges, header.numMerges) && readNames(file, map.colName, header.numColNames)
+            && readNames(file, map.rowName, header.numRowNames);
+    }
+    std::fclose(file);
+    if (!ok)
+        std::cout << path << " is not a presolve map of version " << kMapVersion << std::endl;
+    return ok;
+}
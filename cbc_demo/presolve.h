@@ -0,0 +1,94 @@
+#pragma once
+
+#include "name_table.h"
+
+#include <string>
+#include <vector>
+
+struct ProblemInstance;
+
+struct PresolveOptions
+{
+    int numThreads = 0;     // <= 0 uses every core
+    int maxRounds = 10;     // stops earlier once a round changes nothing
+    bool duplicates = true; // duplicate rows and columns, the most expensive rules
+    bool dualFixing = true; // fix columns that no row keeps from their cheaper bound
+};
+
+// What each rule removed, summed over the rounds.
+struct PresolveStats
+{
+    int fixedColumns = 0;      // lb == ub, also after tightening
+    int dualFixedColumns = 0;  // dominated: moved to the bound the objective prefers
+    int mergedColumns = 0;     // duplicate columns folded into one
+    int emptyRows = 0;
+    int singletonRows = 0;     // turned into column bounds
+    int redundantRows = 0;     // activity bounds imply the row, free rows included
+    int duplicateRows = 0;
+    int tightenedBounds = 0;   // integer column bounds implied by the rows
+    int rounds = 0;
+    double rowSeconds = 0.0;       // row scans, singleton and empty rows
+    double columnSeconds = 0.0;    // bound tightening, fixing
+    double duplicateSeconds = 0.0;
+    double seconds = 0.0;
+};
+
+enum class PresolveStatus
+{
+    Reduced,   // possibly by nothing
+    Infeasible // see PresolveMap::message
+};
+
+/*
+  Maps solutions of the reduced model back to the original one. Columns are
+  kept, fixed at a value, or merged into a duplicate column; merges are
+  undone in reverse order. The original names are kept for the caller.
+*/
+struct PresolveMap
+{
+    struct Merge
+    {
+        int kept;          // original index of the column that stays
+        int removed;
+        double keptUb;     // bounds at the time of the merge
+        double removedLb;
+    };
+
+    int numCols = 0; // original sizes
+    int numRows = 0;
+    std::vector<int> colOrigin;      // reduced column -> original column
+    std::vector<int> rowOrigin;      // reduced row -> original row
+    std::vector<char> colRemoved;    // original column: 0 kept, 1 fixed, 2 merged
+    std::vector<double> fixedValue;  // original column, for fixed columns
+    std::vector<Merge> merges;       // in the order they were made
+    NameTable colName;               // original names, empty if the model had none
+    NameTable rowName;
+    std::string message;
+
+    // full receives numCols values.
+    void postsolve(const double* reduced, double* full) const;
+    std::vector<double> postsolve(const std::vector<double>& reduced) const;
+};
+
+/*
+  Presolve on the CSR of a ProblemInstance, before any solver sees the
+  model. Every round scans the rows (activity bounds, empty, singleton and
+  redundant rows), then the columns (implied integer bounds, dual fixing,
+  fixed columns), then looks for duplicate rows and columns by hash. The
+  scans run on row and column chunks in parallel; each thread only writes
+  the entries of its own chunk, and the changes are applied afterwards in
+  index order, so the result does not depend on the thread count.
+
+  All reductions keep an optimal solution of the original model, and
+  PresolveMap::postsolve rebuilds it from one of the reduced model. Only the
+  primal solution is restored, duals and bases are not. A singleton row
+  becomes a bound on its column, continuous or not; the activity-implied
+  bounds are applied to integer columns only, rounded to whole values.
+*/
+PresolveStatus presolve(const ProblemInstance& data, ProblemInstance& reduced, PresolveMap& map,
+    PresolveStats& stats, const PresolveOptions& options = PresolveOptions());
+
+// The map in a small binary file, to keep it next to a cached reduced model
+// (writeSnapshot). Both return false, with a message, on I/O or format errors.
+bool writePresolveMap(const PresolveMap& map, const std::string& path);
+bool readPresolveMap(const std::string& path, PresolveMap& map);
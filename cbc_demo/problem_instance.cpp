@@ -0,0 +1,320 @@
+#include "problem_instance.h"
+#include "parallel.h"
+#include "problem_view.h"
+
+#include "CbcModel.hpp"
+#include "CoinPackedMatrix.hpp"
+#include "CoinFinite.hpp"
+#include "OsiSolverInterface.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+
+void rowBoundsToSense(double lower, double upper, char& sense, double& rhs, double& range)
+{
+    range = 0.0;
+    if (lower > -COIN_DBL_MAX) {
+        if (upper < COIN_DBL_MAX) {
+            rhs = upper;
+            if (upper == lower) {
+                sense = 'E';
+            } else {
+                sense = 'R';
+                range = upper - lower;
+            }
+        } else {
+            sense = 'G';
+            rhs = lower;
+        }
+    } else {
+        if (upper < COIN_DBL_MAX) {
+            sense = 'L';
+            rhs = upper;
+        } else {
+            sense = 'N';
+            rhs = 0.0;
+        }
+    }
+}
+
+void senseToRowBounds(char sense, double rhs, double range, double& lower, double& upper)
+{
+    switch (sense) {
+    case 'E': lower = upper = rhs; break;
+    case 'L': lower = -COIN_DBL_MAX; upper = rhs; break;
+    case 'G': lower = rhs; upper = COIN_DBL_MAX; break;
+    case 'R': lower = rhs - range; upper = rhs; break;
+    default: lower = -COIN_DBL_MAX; upper = COIN_DBL_MAX; break;
+    }
+}
+
+template <typename Offset>
+BasicProblemInstance<Offset>::BasicProblemInstance(std::pmr::memory_resource* resource)
+    : varTypes(resource), lb(resource), ub(resource), objCoeffs(resource), rowtypes(resource), rhs(resource),
+      rhsrange(resource), rowStart(resource), colIdxs(resource), colCoeffs(resource), colName(resource),
+      rowName(resource)
+{
+}
+
+ProblemInstance getProblemData(const OsiSolverInterface& solver, std::pmr::memory_resource* resource)
+{
+    return toProblemInstance(getProblemView(solver), resource);
+}
+
+ProblemInstance getProblemData(CbcModel& model)
+{
+    return getProblemData(*model.solver());
+}
+
+ProblemInstance64 getProblemData64(const OsiSolverInterface& solver, std::pmr::memory_resource* resource)
+{
+    return toProblemInstance64(getProblemView(solver), resource);
+}
+
+// Everything but the row starts, which the caller converts.
+template <typename To, typename From>
+static void copyAllButRowStart(const From& from, To& to)
+{
+    to.numCols = from.numCols;
+    to.numRows = from.numRows;
+    to.objSense = from.objSense;
+    to.objOffset = from.objOffset;
+    to.varTypes.assign(from.varTypes.begin(), from.varTypes.end());
+    to.lb.assign(from.lb.begin(), from.lb.end());
+    to.ub.assign(from.ub.begin(), from.ub.end());
+    to.objCoeffs.assign(from.objCoeffs.begin(), from.objCoeffs.end());
+    to.rowtypes.assign(from.rowtypes.begin(), from.rowtypes.end());
+    to.rhs.assign(from.rhs.begin(), from.rhs.end());
+    to.rhsrange.assign(from.rhsrange.begin(), from.rhsrange.end());
+    to.colIdxs.assign(from.colIdxs.begin(), from.colIdxs.end());
+    to.colCoeffs.assign(from.colCoeffs.begin(), from.colCoeffs.end());
+    to.colName = from.colName;
+    to.rowName = from.rowName;
+}
+
+ProblemInstance64 widenProblemInstance(const ProblemInstance& data, std::pmr::memory_resource* resource)
+{
+    ProblemInstance64 wide(resource);
+    copyAllButRowStart(data, wide);
+    wide.numNonZeros = data.numNonZeros;
+    wide.rowStart.assign(data.rowStart.begin(), data.rowStart.end());
+    return wide;
+}
+
+static bool fitsInt(const ProblemInstance64& wide, const char* target)
+{
+    if (wide.numNonZeros <= std::numeric_limits<int>::max())
+        return true;
+    std::cout << "The model has " << wide.numNonZeros << " nonzeros, more than " << target << " holds ("
+              << std::numeric_limits<int>::max() << ")" << std::endl;
+    return false;
+}
+
+bool narrowProblemInstance(const ProblemInstance64& wide, ProblemInstance& narrow)
+{
+    if (!fitsInt(wide, "ProblemInstance"))
+        return false;
+    copyAllButRowStart(wide, narrow);
+    narrow.numNonZeros = static_cast<int>(wide.numNonZeros);
+    narrow.rowStart.assign(wide.rowStart.begin(), wide.rowStart.end()); // every start <= numNonZeros
+    return true;
+}
+
+// Loads the matrix given as CoinBigIndex row starts, then the rest of data.
+template <typename Offset>
+static void loadWithRowStarts(const BasicProblemInstance<Offset>& data, const CoinBigIndex* rowStart,
+    OsiSolverInterface& solver, bool loadNames)
+{
+    // row ordered, the solver converts to its own storage
+    CoinPackedMatrix matrix(false, data.numCols, data.numRows, static_cast<CoinBigIndex>(data.numNonZeros),
+        data.colCoeffs.data(), data.colIdxs.data(), rowStart, nullptr);
+    solver.loadProblem(matrix, data.lb.data(), data.ub.data(), data.objCoeffs.data(),
+        data.rowtypes.data(), data.rhs.data(), data.rhsrange.data());
+    solver.setObjSense(data.objSense);
+    solver.setDblParam(OsiObjOffset, -data.objOffset);
+
+    // temporaries come from the instance's resource as well
+    std::pmr::vector<int> integers(data.resource());
+    for (int i = 0; i < data.numCols; i++)
+        if (data.varTypes[i] == 'I')
+            integers.push_back(i);
+    solver.setInteger(integers.data(), static_cast<int>(integers.size()));
+
+    if (loadNames && !data.colName.empty()) {
+        // Osi keeps its own strings, the arena is copied out once
+        OsiSolverInterface::OsiNameVec colNames = data.colName.toStrings();
+        OsiSolverInterface::OsiNameVec rowNames = data.rowName.toStrings();
+        solver.setColNames(colNames, 0, data.numCols, 0);
+        solver.setRowNames(rowNames, 0, data.numRows, 0);
+    }
+}
+
+void loadProblemData(const ProblemInstance& data, OsiSolverInterface& solver, bool loadNames)
+{
+    static_assert(std::is_same_v<CoinBigIndex, int>, "ProblemInstance::rowStart is handed to CBC as is");
+    loadWithRowStarts(data, data.rowStart.data(), solver, loadNames);
+}
+
+bool loadProblemData(const ProblemInstance64& data, OsiSolverInterface& solver, bool loadNames)
+{
+    if (data.numNonZeros > std::numeric_limits<CoinBigIndex>::max()) {
+        std::cout << "The model has " << data.numNonZeros << " nonzeros, CBC takes at most "
+                  << std::numeric_limits<CoinBigIndex>::max() << std::endl;
+        return false;
+    }
+    std::pmr::vector<CoinBigIndex> rowStart(data.rowStart.begin(), data.rowStart.end(), data.resource());
+    loadWithRowStarts(data, rowStart.data(), solver, loadNames);
+    return true;
+}
+
+// Each row chunk of the transpose keeps counts for every column, so chunks
+// below this many nonzeros cost more than they save.
+static const int kMinTransposeChunk = 1 << 15;
+
+template <typename Offset>
+void transposeToColumns(const BasicProblemInstance<Offset>& data, BasicColumnMajor<Offset>& columns, int numThreads)
+{
+    const int numCols = data.numCols;
+    const int numRows = data.numRows;
+    const Offset numNonZeros = data.numNonZeros;
+    const Offset* rowStart = data.rowStart.data();
+    const int* colIdxs = data.colIdxs.data();
+    const double* colCoeffs = data.colCoeffs.data();
+
+    columns.colStart.assign(numCols + 1, 0);
+    columns.rowIdxs.resize(numNonZeros);
+    columns.rowCoeffs.resize(numNonZeros);
+    Offset* colStart = columns.colStart.data();
+    int* rowIdxs = columns.rowIdxs.data();
+    double* rowCoeffs = columns.rowCoeffs.data();
+
+    if (numThreads <= 0)
+        numThreads = defaultThreadCount();
+    // the per-chunk counts together stay below the size of the matrix
+    Offset chunks = std::min<Offset>(numThreads, numNonZeros / kMinTransposeChunk);
+    int numChunks = static_cast<int>(std::max<Offset>(1, std::min<Offset>(chunks, numNonZeros / std::max(numCols, 1))));
+
+    if (numChunks == 1) {
+        for (Offset k = 0; k < numNonZeros; k++)
+            colStart[colIdxs[k] + 1]++;
+        for (int j = 0; j < numCols; j++)
+            colStart[j + 1] += colStart[j];
+        std::vector<Offset> next(colStart, colStart + numCols);
+        for (int i = 0; i < numRows; i++) {
+            for (Offset k = rowStart[i]; k < rowStart[i + 1]; k++) {
+                Offset p = next[colIdxs[k]]++;
+                rowIdxs[p] = i;
+                rowCoeffs[p] = colCoeffs[k];
+            }
+        }
+        return;
+    }
+
+    // row chunks of about equal nonzeros
+    std::vector<int> chunkRow(numChunks + 1, numRows);
+    chunkRow[0] = 0;
+    for (int c = 1; c < numChunks; c++) {
+        Offset target = static_cast<Offset>(static_cast<long long>(numNonZeros) * c / numChunks);
+        chunkRow[c] = static_cast<int>(std::lower_bound(rowStart, rowStart + numRows, target) - rowStart);
+    }
+
+    // 1. column counts per row chunk
+    std::vector<Offset> counts(static_cast<std::size_t>(numChunks) * numCols, 0);
+    parallelFor(numChunks, numThreads, [&](int c) {
+        Offset* count = counts.data() + static_cast<std::size_t>(c) * numCols;
+        for (Offset k = rowStart[chunkRow[c]]; k < rowStart[chunkRow[c + 1]]; k++)
+            count[colIdxs[k]]++;
+    });
+
+    // 2. the counts become the first position of every (chunk, column) pair:
+    //    column ranges sum their counts, one serial prefix over the ranges,
+    //    then every range hands out its positions column by column
+    int rangeSize = (numCols + numChunks - 1) / numChunks;
+    std::vector<Offset> rangeBase(numChunks + 1, 0);
+    parallelFor(numChunks, numThreads, [&](int r) {
+        Offset total = 0;
+        for (int j = r * rangeSize; j < std::min(numCols, (r + 1) * rangeSize); j++)
+            for (int c = 0; c < numChunks; c++)
+                total += counts[static_cast<std::size_t>(c) * numCols + j];
+        rangeBase[r + 1] = total;
+    });
+    for (int r = 0; r < numChunks; r++)
+        rangeBase[r + 1] += rangeBase[r];
+    parallelFor(numChunks, numThreads, [&](int r) {
+        Offset pos = rangeBase[r];
+        for (int j = r * rangeSize; j < std::min(numCols, (r + 1) * rangeSize); j++) {
+            colStart[j] = pos;
+            for (int c = 0; c < numChunks; c++) {
+                Offset& count = counts[static_cast<std::size_t>(c) * numCols + j];
+                Offset n = count;
+                count = pos;
+                pos += n;
+            }
+        }
+    });
+    colStart[numCols] = numNonZeros;
+
+    // 3. scatter; earlier chunks own earlier positions, so rows stay ascending
+    parallelFor(numChunks, numThreads, [&](int c) {
+        Offset* next = counts.data() + static_cast<std::size_t>(c) * numCols;
+        for (int i = chunkRow[c]; i < chunkRow[c + 1]; i++) {
+            for (Offset k = rowStart[i]; k < rowStart[i + 1]; k++) {
+                Offset p = next[colIdxs[k]]++;
+                rowIdxs[p] = i;
+                rowCoeffs[p] = colCoeffs[k];
+            }
+        }
+    });
+}
+
+template <typename Offset>
+bool ColumnCache<Offset>::Shape::operator==(const Shape& other) const
+{
+    return rowStart == other.rowStart && colIdxs == other.colIdxs && colCoeffs == other.colCoeffs
+        && numRows == other.numRows && numCols == other.numCols && numNonZeros == other.numNonZeros;
+}
+
+template <typename Offset>
+typename ColumnCache<Offset>::Shape ColumnCache<Offset>::shapeOf(const BasicProblemInstance<Offset>& data)
+{
+    Shape shape;
+    shape.rowStart = data.rowStart.data();
+    shape.colIdxs = data.colIdxs.data();
+    shape.colCoeffs = data.colCoeffs.data();
+    shape.numRows = data.numRows;
+    shape.numCols = data.numCols;
+    shape.numNonZeros = data.numNonZeros;
+    return shape;
+}
+
+template <typename Offset>
+std::shared_ptr<const BasicColumnMajor<Offset>> ColumnCache<Offset>::get(const BasicProblemInstance<Offset>& data,
+    int numThreads)
+{
+    // concurrent first callers wait for one transpose instead of each building their own
+    std::lock_guard<std::mutex> lock(mutex_);
+    Shape shape = shapeOf(data);
+    if (!columns_ || !(shape == shape_)) {
+        auto columns = std::make_shared<BasicColumnMajor<Offset>>();
+        transposeToColumns(data, *columns, numThreads);
+        columns_ = std::move(columns);
+        shape_ = shape;
+    }
+    return columns_;
+}
+
+template <typename Offset>
+void ColumnCache<Offset>::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    columns_.reset();
+}
+
+template struct BasicProblemInstance<int>;
+template struct BasicProblemInstance<std::int64_t>;
+template class ColumnCache<int>;
+template class ColumnCache<std::int64_t>;
+template void transposeToColumns(const BasicProblemInstance<int>&, BasicColumnMajor<int>&, int);
+template void transposeToColumns(const BasicProblemInstance<std::int64_t>&, BasicColumnMajor<std::int64_t>&, int);
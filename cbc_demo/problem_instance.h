@@ -0,0 +1,180 @@
+#pragma once
+
+#include "name_table.h"
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class CbcModel;
+class OsiSolverInterface;
+template <typename Offset>
+struct BasicProblemInstance;
+
+// Column-major (CSC) copy of the CSR: rowIdxs/rowCoeffs[colStart[j]:colStart[j+1]]
+// are the nonzeros of column j, rows ascending. Offset as in BasicProblemInstance.
+template <typename Offset>
+struct BasicColumnMajor
+{
+    std::vector<Offset> colStart; // numCols + 1 entries
+    std::vector<int> rowIdxs;
+    std::vector<double> rowCoeffs;
+};
+
+using ColumnMajor = BasicColumnMajor<int>;
+using ColumnMajor64 = BasicColumnMajor<std::int64_t>;
+
+/*
+  Cache behind ProblemInstance::columns(). It remembers the shape of the CSR
+  it was built from (sizes and array addresses), so appending rows or
+  reallocating the matrix arrays drops it on the next access. Copies start
+  empty: a copied instance has its own arrays and builds its own transpose.
+*/
+template <typename Offset>
+class ColumnCache
+{
+public:
+    ColumnCache() = default;
+    ColumnCache(const ColumnCache&) {}
+    ColumnCache& operator=(const ColumnCache&)
+    {
+        reset();
+        return *this;
+    }
+
+    std::shared_ptr<const BasicColumnMajor<Offset>> get(const BasicProblemInstance<Offset>& data, int numThreads);
+    void reset();
+
+private:
+    struct Shape
+    {
+        const void* rowStart = nullptr;
+        const void* colIdxs = nullptr;
+        const void* colCoeffs = nullptr;
+        int numRows = -1;
+        int numCols = -1;
+        std::int64_t numNonZeros = -1;
+
+        bool operator==(const Shape& other) const;
+    };
+    static Shape shapeOf(const BasicProblemInstance<Offset>& data);
+
+    std::mutex mutex_;
+    std::shared_ptr<const BasicColumnMajor<Offset>> columns_;
+    Shape shape_;
+};
+
+/*
+  Every array, the names included, allocates from one memory resource: the
+  default heap, or e.g. a std::pmr::monotonic_buffer_resource, which turns
+  the thousands of vector growths of reading and extracting a model into
+  pointer bumps in a few large blocks and frees them all at once.
+
+    std::pmr::monotonic_buffer_resource arena(1 << 20);
+    ProblemInstance data(&arena);
+    readModelFile(path, data);
+
+  The resource must outlive the instance. Copies allocate from the default
+  resource, moves keep the resource of the source.
+
+  Offset is the type of the nonzero positions, rowStart and numNonZeros, as
+  CPXNNZ in the CPXX API of CPLEX; column and row indices stay int.
+  ProblemInstance (int) is the compact default and what CBC takes, its
+  CoinBigIndex is int. ProblemInstance64 holds models beyond 2^31 - 1
+  nonzeros, e.g. generated ones, for extraction, snapshots and evaluation;
+  loadProblemData and narrowProblemInstance check that it fits before
+  handing it to CBC.
+*/
+template <typename Offset>
+struct BasicProblemInstance
+{
+    BasicProblemInstance() = default;
+    explicit BasicProblemInstance(std::pmr::memory_resource* resource);
+
+    int numCols;
+    std::pmr::vector<char> varTypes;
+    std::pmr::vector<double> lb;
+    std::pmr::vector<double> ub;
+    std::pmr::vector<double> objCoeffs;
+
+    int numRows;
+    Offset numNonZeros;
+    int objSense;
+    double objOffset = 0.0; // constant term of the objective
+    std::pmr::vector<char> rowtypes;
+    std::pmr::vector<double> rhs;
+    std::pmr::vector<double> rhsrange;
+    std::pmr::vector<Offset> rowStart;
+    std::pmr::vector<int> colIdxs;
+    std::pmr::vector<double> colCoeffs;
+    NameTable colName; // empty if the model has no names
+    NameTable rowName;
+
+    std::pmr::memory_resource* resource() const { return lb.get_allocator().resource(); }
+
+    /*
+      Column-major copy of the matrix, built on first call by a parallel
+      counting-sort transpose (numThreads <= 0 uses every core) and cached
+      until the CSR changes shape. Changing rowStart/colIdxs/colCoeffs in
+      place keeps the shape, so call invalidateColumns() after such edits.
+      Safe to call from several threads; the returned copy stays valid after
+      an invalidation.
+
+        std::shared_ptr<const ColumnMajor> cols = data.columns();
+        for (int p = cols->colStart[j]; p < cols->colStart[j + 1]; p++)
+            reducedCost -= duals[cols->rowIdxs[p]] * cols->rowCoeffs[p];
+    */
+    std::shared_ptr<const BasicColumnMajor<Offset>> columns(int numThreads = 0) const
+    {
+        return columnCache_.get(*this, numThreads);
+    }
+    void invalidateColumns() const { columnCache_.reset(); }
+
+    mutable ColumnCache<Offset> columnCache_;
+};
+
+// Structs rather than aliases, so headers can forward declare them.
+struct ProblemInstance : BasicProblemInstance<int>
+{
+    using BasicProblemInstance<int>::BasicProblemInstance;
+};
+
+struct ProblemInstance64 : BasicProblemInstance<std::int64_t>
+{
+    using BasicProblemInstance<std::int64_t>::BasicProblemInstance;
+};
+
+// The transpose behind ProblemInstance::columns(), uncached. The result does
+// not depend on numThreads.
+template <typename Offset>
+void transposeToColumns(const BasicProblemInstance<Offset>& data, BasicColumnMajor<Offset>& columns,
+    int numThreads = 0);
+
+// Osi convention: free rows are 'N', ranged rows keep rhs = upper, range = upper - lower.
+// Infinite bounds are +-COIN_DBL_MAX.
+void rowBoundsToSense(double lower, double upper, char& sense, double& rhs, double& range);
+void senseToRowBounds(char sense, double rhs, double range, double& lower, double& upper);
+
+// Deep copy of the model data held by the solver. Prefer getProblemView
+// (problem_view.h) when the solver outlives the consumer of the data.
+ProblemInstance getProblemData(const OsiSolverInterface& solver,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+ProblemInstance getProblemData(CbcModel& model);
+ProblemInstance64 getProblemData64(const OsiSolverInterface& solver,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+// Same model at the other width. Narrowing returns false (and prints why) if
+// the nonzeros do not fit in an int, leaving narrow untouched.
+ProblemInstance64 widenProblemInstance(const ProblemInstance& data,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+bool narrowProblemInstance(const ProblemInstance64& wide, ProblemInstance& narrow);
+
+// Loads the instance into the solver in one loadProblem call, then marks the
+// integers in one batch; names are copied only if asked for.
+void loadProblemData(const ProblemInstance& data, OsiSolverInterface& solver, bool loadNames = true);
+// Narrows the row starts on the way; returns false (and loads nothing) if
+// the model has more nonzeros than CoinBigIndex holds.
+bool loadProblemData(const ProblemInstance64& data, OsiSolverInterface& solver, bool loadNames = true);
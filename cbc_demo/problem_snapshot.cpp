@@ -0,0 +1,317 @@
+#include "problem_snapshot.h"
+#include "problem_instance.h"
+
+#include "OsiSolverInterface.hpp"
+
+#include <zlib.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+static std::uint64_t alignUp(std::uint64_t value)
+{
+    return (value + kSnapshotAlignment - 1) / kSnapshotAlignment * kSnapshotAlignment;
+}
+
+static std::uint32_t crc32Update(std::uint32_t crc, const void* data, std::uint64_t bytes)
+{
+    const Bytef* ptr = static_cast<const Bytef*>(data);
+    while (bytes > 0) {
+        uInt chunk = bytes > (1u << 30) ? (1u << 30) : static_cast<uInt>(bytes);
+        crc = static_cast<std::uint32_t>(::crc32(crc, ptr, chunk));
+        ptr += chunk;
+        bytes -= chunk;
+    }
+    return crc;
+}
+
+template <typename Offset>
+static bool writeSnapshotOf(const BasicProblemInstance<Offset>& data, const std::string& path)
+{
+    std::shared_ptr<const BasicColumnMajor<Offset>> columns = data.columns();
+    const std::vector<Offset>& colStart = columns->colStart;
+    const std::vector<int>& rowIdxs = columns->rowIdxs;
+    const std::vector<double>& rowCoeffs = columns->rowCoeffs;
+
+    std::vector<std::uint64_t> colNameOffsets(data.numCols), rowNameOffsets(data.numRows);
+    std::string names;
+    for (int i = 0; i < data.numCols; i++) {
+        colNameOffsets[i] = names.size();
+        if (i < static_cast<int>(data.colName.size()))
+            names += data.colName[i];
+        names.push_back('\0');
+    }
+    for (int i = 0; i < data.numRows; i++) {
+        rowNameOffsets[i] = names.size();
+        if (i < static_cast<int>(data.rowName.size()))
+            names += data.rowName[i];
+        names.push_back('\0');
+    }
+
+    // rhsrange is optional in ProblemInstance, the loader always expects one entry per row
+    std::vector<double> rhsrange(data.rhsrange.begin(), data.rhsrange.end());
+    rhsrange.resize(data.numRows, 0.0);
+
+    struct Payload { const void* ptr; std::uint64_t bytes; };
+    Payload payload[kNumSnapshotSections];
+    payload[kSectionVarTypes] = {data.varTypes.data(), data.varTypes.size() * sizeof(char)};
+    payload[kSectionLb] = {data.lb.data(), data.lb.size() * sizeof(double)};
+    payload[kSectionUb] = {data.ub.data(), data.ub.size() * sizeof(double)};
+    payload[kSectionObjCoeffs] = {data.objCoeffs.data(), data.objCoeffs.size() * sizeof(double)};
+    payload[kSectionRowTypes] = {data.rowtypes.data(), data.rowtypes.size() * sizeof(char)};
+    payload[kSectionRhs] = {data.rhs.data(), data.rhs.size() * sizeof(double)};
+    payload[kSectionRhsRange] = {rhsrange.data(), rhsrange.size() * sizeof(double)};
+    payload[kSectionRowStart] = {data.rowStart.data(), data.rowStart.size() * sizeof(Offset)};
+    payload[kSectionColIdxs] = {data.colIdxs.data(), data.colIdxs.size() * sizeof(int)};
+    payload[kSectionColCoeffs] = {data.colCoeffs.data(), data.colCoeffs.size() * sizeof(double)};
+    payload[kSectionColStart] = {colStart.data(), colStart.size() * sizeof(Offset)};
+    payload[kSectionRowIdxs] = {rowIdxs.data(), rowIdxs.size() * sizeof(int)};
+    payload[kSectionRowCoeffs] = {rowCoeffs.data(), rowCoeffs.size() * sizeof(double)};
+    payload[kSectionColNameOffsets] = {colNameOffsets.data(), colNameOffsets.size() * sizeof(std::uint64_t)};
+    payload[kSectionRowNameOffsets] = {rowNameOffsets.data(), rowNameOffsets.size() * sizeof(std::uint64_t)};
+    payload[kSectionNames] = {names.data(), names.size()};
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+    header.version = kSnapshotVersion;
+    header.headerBytes = sizeof(SnapshotHeader);
+    header.numCols = data.numCols;
+    header.numRows = data.numRows;
+    header.numNonZeros = data.numNonZeros;
+    header.objSense = data.objSense;
+    header.objOffset = data.objOffset;
+    header.offsetBytes = sizeof(Offset);
+
+    std::uint64_t offset = alignUp(sizeof(SnapshotHeader));
+    std::uint32_t crc = crc32Update(0, nullptr, 0);
+    for (int s = 0; s < kNumSnapshotSections; s++) {
+        header.sections[s].offset = offset;
+        header.sections[s].bytes = payload[s].bytes;
+        crc = crc32Update(crc, payload[s].ptr, payload[s].bytes);
+        offset = alignUp(offset + payload[s].bytes);
+    }
+    header.checksum = crc;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cout << "Cannot open snapshot " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    const std::vector<char> padding(kSnapshotAlignment, 0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::uint64_t written = sizeof(header);
+    for (int s = 0; s < kNumSnapshotSections; s++) {
+        out.write(padding.data(), header.sections[s].offset - written);
+        out.write(static_cast<const char*>(payload[s].ptr), payload[s].bytes);
+        written = header.sections[s].offset + payload[s].bytes;
+    }
+    // keep the file a whole number of pages so the last section maps cleanly
+    out.write(padding.data(), alignUp(written) - written);
+
+    if (!out) {
+        std::cout << "Write snapshot " << path << " failed" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool writeSnapshot(const ProblemInstance& data, const std::string& path)
+{
+    return writeSnapshotOf(data, path);
+}
+
+bool writeSnapshot(const ProblemInstance64& data, const std::string& path)
+{
+    return writeSnapshotOf(data, path);
+}
+
+ProblemSnapshot::~ProblemSnapshot()
+{
+    close();
+}
+
+void ProblemSnapshot::close()
+{
+    if (base_)
+        munmap(base_, mappedBytes_);
+    base_ = nullptr;
+    mappedBytes_ = 0;
+    names_ = nullptr;
+
+    numCols = numRows = 0;
+    numNonZeros = 0;
+    offsetBytes = 4;
+    objSense = 1;
+    objOffset = 0.0;
+    varTypes = {};
+    lb = ub = objCoeffs = {};
+    rowtypes = {};
+    rhs = rhsrange = {};
+    rowStart = colIdxs = colStart = rowIdxs = {};
+    rowStart64 = colStart64 = {};
+    colCoeffs = rowCoeffs = {};
+    colNameOffsets = rowNameOffsets = {};
+}
+
+template <typename T>
+static Span<T> sectionSpan(const char* base, const SnapshotSection& section)
+{
+    return makeSpan(reinterpret_cast<const T*>(base + section.offset), section.bytes / sizeof(T));
+}
+
+bool ProblemSnapshot::open(const std::string& path, bool verifyChecksum)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cout << "Cannot open snapshot " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::uint64_t>(st.st_size) < sizeof(SnapshotHeader)) {
+        std::cout << "Snapshot " << path << " is truncated" << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* base = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        std::cout << "Cannot map snapshot " << path << std::endl;
+        return false;
+    }
+    base_ = base;
+    mappedBytes_ = st.st_size;
+
+    const char* bytes = static_cast<const char*>(base);
+    const SnapshotHeader& header = *reinterpret_cast<const SnapshotHeader*>(bytes);
+    // version 2 headers end before offsetBytes
+    const std::uint64_t version2Bytes = offsetof(SnapshotHeader, offsetBytes);
+    bool version2 = header.version == 2 && header.headerBytes == version2Bytes;
+    bool version3 = header.version == kSnapshotVersion && header.headerBytes == sizeof(SnapshotHeader)
+        && (header.offsetBytes == 4 || header.offsetBytes == 8);
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(header.magic)) != 0 || !(version2 || version3)) {
+        std::cout << "Snapshot " << path << " has an unsupported format or version" << std::endl;
+        close();
+        return false;
+    }
+
+    const std::uint64_t cols = header.numCols, rows = header.numRows, nnz = header.numNonZeros;
+    const std::uint64_t width = version2 ? 4 : header.offsetBytes;
+    const std::uint64_t expected[kNumSnapshotSections] = {
+        cols, cols * 8, cols * 8, cols * 8,
+        rows, rows * 8, rows * 8,
+        (rows + 1) * width, nnz * 4, nnz * 8,
+        (cols + 1) * width, nnz * 4, nnz * 8,
+        cols * 8, rows * 8, 0};
+
+    std::uint32_t crc = crc32Update(0, nullptr, 0);
+    for (int s = 0; s < kNumSnapshotSections; s++) {
+        const SnapshotSection& section = header.sections[s];
+        bool sizeOk = s == kSectionNames || section.bytes == expected[s];
+        if (!sizeOk || section.offset % kSnapshotAlignment != 0 || section.offset + section.bytes > mappedBytes_) {
+            std::cout << "Snapshot " << path << " has a corrupt section table" << std::endl;
+            close();
+            return false;
+        }
+        if (verifyChecksum)
+            crc = crc32Update(crc, bytes + section.offset, section.bytes);
+    }
+    if (verifyChecksum && crc != header.checksum) {
+        std::cout << "Snapshot " << path << " checksum mismatch" << std::endl;
+        close();
+        return false;
+    }
+
+    numCols = static_cast<int>(header.numCols);
+    numRows = static_cast<int>(header.numRows);
+    numNonZeros = header.numNonZeros;
+    offsetBytes = static_cast<int>(width);
+    objSense = header.objSense;
+    objOffset = header.objOffset;
+
+    varTypes = sectionSpan<char>(bytes, header.sections[kSectionVarTypes]);
+    lb = sectionSpan<double>(bytes, header.sections[kSectionLb]);
+    ub = sectionSpan<double>(bytes, header.sections[kSectionUb]);
+    objCoeffs = sectionSpan<double>(bytes, header.sections[kSectionObjCoeffs]);
+    rowtypes = sectionSpan<char>(bytes, header.sections[kSectionRowTypes]);
+    rhs = sectionSpan<double>(bytes, header.sections[kSectionRhs]);
+    rhsrange = sectionSpan<double>(bytes, header.sections[kSectionRhsRange]);
+    if (offsetBytes == 8)
+        rowStart64 = sectionSpan<std::int64_t>(bytes, header.sections[kSectionRowStart]);
+    else
+        rowStart = sectionSpan<int>(bytes, header.sections[kSectionRowStart]);
+    colIdxs = sectionSpan<int>(bytes, header.sections[kSectionColIdxs]);
+    colCoeffs = sectionSpan<double>(bytes, header.sections[kSectionColCoeffs]);
+    if (offsetBytes == 8)
+        colStart64 = sectionSpan<std::int64_t>(bytes, header.sections[kSectionColStart]);
+    else
+        colStart = sectionSpan<int>(bytes, header.sections[kSectionColStart]);
+    rowIdxs = sectionSpan<int>(bytes, header.sections[kSectionRowIdxs]);
+    rowCoeffs = sectionSpan<double>(bytes, header.sections[kSectionRowCoeffs]);
+    colNameOffsets = sectionSpan<std::uint64_t>(bytes, header.sections[kSectionColNameOffsets]);
+    rowNameOffsets = sectionSpan<std::uint64_t>(bytes, header.sections[kSectionRowNameOffsets]);
+    names_ = bytes + header.sections[kSectionNames].offset;
+
+    // every name starts inside the names section, which ends with a NUL
+    const std::uint64_t namesBytes = header.sections[kSectionNames].bytes;
+    bool namesOk = numCols + numRows == 0 || (namesBytes > 0 && names_[namesBytes - 1] == '\0');
+    for (std::uint64_t offset : colNameOffsets)
+        namesOk = namesOk && offset < namesBytes;
+    for (std::uint64_t offset : rowNameOffsets)
+        namesOk = namesOk && offset < namesBytes;
+    if (!namesOk) {
+        std::cout << "Snapshot " << path << " has a corrupt section table" << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool ProblemSnapshot::loadInto(OsiSolverInterface& solver, bool loadNames) const
+{
+    // the only copy: 64-bit column starts narrowed for CBC
+    std::vector<CoinBigIndex> narrowStart;
+    const CoinBigIndex* start = colStart.data();
+    if (offsetBytes == 8) {
+        if (numNonZeros > std::numeric_limits<CoinBigIndex>::max()) {
+            std::cout << "The snapshot has " << numNonZeros << " nonzeros, CBC takes at most "
+                      << std::numeric_limits<CoinBigIndex>::max() << std::endl;
+            return false;
+        }
+        narrowStart.assign(colStart64.begin(), colStart64.end());
+        start = narrowStart.data();
+    }
+    solver.loadProblem(numCols, numRows, start, rowIdxs.data(), rowCoeffs.data(),
+        lb.data(), ub.data(), objCoeffs.data(), rowtypes.data(), rhs.data(), rhsrange.data());
+    solver.setObjSense(objSense);
+    solver.setDblParam(OsiObjOffset, -objOffset);
+
+    std::vector<int> integers;
+    for (int i = 0; i < numCols; i++)
+        if (varTypes[i] == 'I')
+            integers.push_back(i);
+    solver.setInteger(integers.data(), static_cast<int>(integers.size()));
+
+    if (loadNames) {
+        OsiSolverInterface::OsiNameVec colNames(numCols), rowNames(numRows);
+        for (int i = 0; i < numCols; i++)
+            colNames[i] = colName(i);
+        for (int i = 0; i < numRows; i++)
+            rowNames[i] = rowName(i);
+        solver.setColNames(colNames, 0, numCols, 0);
+        solver.setRowNames(rowNames, 0, numRows, 0);
+    }
+    return true;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "problem_view.h"
+
+#include <cstdint>
+#include <string>
+
+struct ProblemInstance;
+struct ProblemInstance64;
+class OsiSolverInterface;
+
+/*
+  Binary snapshot of a ProblemInstance, written once and mmap'ed on later runs.
+
+  Layout (little endian, version kSnapshotVersion):
+    - SnapshotHeader at offset 0
+    - one section per SnapshotSectionId, each starting on a page boundary
+
+  Next to the CSR arrays the snapshot keeps a column-major copy of the matrix,
+  because that is what OsiSolverInterface::loadProblem takes: loading hands the
+  mapped arrays to the solver as they are, without any intermediate buffer.
+
+  Names of columns and rows share one blob of '\0' terminated strings;
+  colNameOffsets[i] / rowNameOffsets[i] point at the start of each name.
+
+  rowStart and colStart are offsetBytes wide: 4 for a ProblemInstance, 8 for
+  a ProblemInstance64. Version 2 files, written before the field existed,
+  have 4 and are still read.
+*/
+
+constexpr char kSnapshotMagic[8] = {'C', 'B', 'C', 'S', 'N', 'A', 'P', '\0'};
+constexpr std::uint32_t kSnapshotVersion = 3;
+constexpr std::uint64_t kSnapshotAlignment = 4096;
+
+enum SnapshotSectionId
+{
+    kSectionVarTypes,
+    kSectionLb,
+    kSectionUb,
+    kSectionObjCoeffs,
+    kSectionRowTypes,
+    kSectionRhs,
+    kSectionRhsRange,
+    kSectionRowStart,
+    kSectionColIdxs,
+    kSectionColCoeffs,
+    kSectionColStart,
+    kSectionRowIdxs,
+    kSectionRowCoeffs,
+    kSectionColNameOffsets,
+    kSectionRowNameOffsets,
+    kSectionNames,
+    kNumSnapshotSections
+};
+
+struct SnapshotSection
+{
+    std::uint64_t offset;
+    std::uint64_t bytes;
+};
+
+struct SnapshotHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t headerBytes;
+    std::int64_t numCols;
+    std::int64_t numRows;
+    std::int64_t numNonZeros;
+    std::int32_t objSense;
+    std::uint32_t checksum; // crc32 over all sections, in section order
+    double objOffset;
+    SnapshotSection sections[kNumSnapshotSections];
+    std::uint32_t offsetBytes; // since version 3
+    std::uint32_t reserved;
+};
+
+// Returns false (and prints the reason) if the file can't be written.
+bool writeSnapshot(const ProblemInstance& data, const std::string& path);
+bool writeSnapshot(const ProblemInstance64& data, const std::string& path);
+
+/*
+  Read-only mapping of a snapshot file. The spans point into the mapping and
+  stay valid until close() or destruction.
+*/
+class ProblemSnapshot
+{
+public:
+    ProblemSnapshot() = default;
+    ~ProblemSnapshot();
+    ProblemSnapshot(const ProblemSnapshot&) = delete;
+    ProblemSnapshot& operator=(const ProblemSnapshot&) = delete;
+
+    // Maps the file; verifyChecksum touches every page, skip it for lazy loading.
+    // Section sizes and name offsets are checked either way.
+    bool open(const std::string& path, bool verifyChecksum = true);
+    void close();
+    bool isOpen() const { return base_ != nullptr; }
+
+    // Feeds the mapped arrays to solver.loadProblem, then marks integers and
+    // optionally copies the names (Osi keeps names in std::strings). 64-bit
+    // column starts are narrowed to CoinBigIndex on the way; returns false,
+    // loading nothing, if they do not fit.
+    bool loadInto(OsiSolverInterface& solver, bool loadNames = true) const;
+
+    const char* colName(int i) const { return names_ + colNameOffsets[i]; }
+    const char* rowName(int i) const { return names_ + rowNameOffsets[i]; }
+
+    int numCols = 0;
+    int numRows = 0;
+    std::int64_t numNonZeros = 0;
+    int offsetBytes = 4; // which of rowStart/colStart and rowStart64/colStart64 is set
+    int objSense = 1;
+    double objOffset = 0.0;
+
+    Span<char> varTypes;
+    Span<double> lb;
+    Span<double> ub;
+    Span<double> objCoeffs;
+
+    Span<char> rowtypes;
+    Span<double> rhs;
+    Span<double> rhsrange;
+
+    // CSR
+    Span<int> rowStart;
+    Span<std::int64_t> rowStart64;
+    Span<int> colIdxs;
+    Span<double> colCoeffs;
+
+    // CSC, what loadProblem consumes
+    Span<int> colStart;
+    Span<std::int64_t> colStart64;
+    Span<int> rowIdxs;
+    Span<double> rowCoeffs;
+
+    Span<std::uint64_t> colNameOffsets;
+    Span<std::uint64_t> rowNameOffsets;
+
+private:
+    void* base_ = nullptr;
+    std::size_t mappedBytes_ = 0;
+    const char* names_ = nullptr;
+};
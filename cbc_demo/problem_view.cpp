@@ -0,0 +1,107 @@
+#include "problem_view.h"
+#include "problem_instance.h"
+
+#include "CbcModel.hpp"
+#include "CoinPackedMatrix.hpp"
+#include "OsiSolverInterface.hpp"
+
+ProblemView getProblemView(const OsiSolverInterface& solver)
+{
+    ProblemView view;
+    view.solver = &solver;
+    view.numRows = solver.getNumRows();
+    view.numCols = solver.getNumCols();
+    view.numNonZeros = solver.getNumElements();
+    view.objSense = static_cast<int>(solver.getObjSense());
+    // Osi reports objective = c'x - OsiObjOffset
+    double offset = 0.0;
+    solver.getDblParam(OsiObjOffset, offset);
+    view.objOffset = -offset;
+
+    const std::size_t numCols = view.numCols;
+    const std::size_t numRows = view.numRows;
+    view.colType = makeSpan(solver.getColType(), numCols);
+    view.lb = makeSpan(solver.getColLower(), numCols);
+    view.ub = makeSpan(solver.getColUpper(), numCols);
+    view.objCoeffs = makeSpan(solver.getObjCoefficients(), numCols);
+
+    view.rowtypes = makeSpan(solver.getRowSense(), numRows);
+    view.rhs = makeSpan(solver.getRightHandSide(), numRows);
+    view.rhsrange = makeSpan(solver.getRowRange(), numRows);
+
+    // the row copy is built on demand by the solver and cached until the model changes
+    const CoinPackedMatrix* matrixByRow = solver.getMatrixByRow();
+    if (matrixByRow->hasGaps()) {
+        auto compact = std::make_shared<CoinPackedMatrix>(*matrixByRow);
+        compact->removeGaps();
+        view.compactRows = compact;
+        matrixByRow = compact.get();
+    }
+
+    view.rowStart = makeSpan(matrixByRow->getVectorStarts(), numRows + 1);
+    view.colIdxs = makeSpan(matrixByRow->getIndices(), static_cast<std::size_t>(view.numNonZeros));
+    view.colCoeffs = makeSpan(matrixByRow->getElements(), static_cast<std::size_t>(view.numNonZeros));
+    return view;
+}
+
+ProblemView getProblemView(CbcModel& model)
+{
+    return getProblemView(*model.solver());
+}
+
+std::string ProblemView::colName(int i) const
+{
+    return solver->getColName(i);
+}
+
+std::string ProblemView::rowName(int i) const
+{
+    return solver->getRowName(i);
+}
+
+template <typename Instance>
+static Instance copyView(const ProblemView& view, std::pmr::memory_resource* resource)
+{
+    Instance data(resource);
+    data.numCols = view.numCols;
+    data.numRows = view.numRows;
+    data.numNonZeros = view.numNonZeros;
+    data.objSense = view.objSense;
+    data.objOffset = view.objOffset;
+
+    data.varTypes.resize(view.numCols);
+    for (int i = 0; i < view.numCols; i++)
+        data.varTypes[i] = view.varType(i);
+
+    data.lb.assign(view.lb.begin(), view.lb.end());
+    data.ub.assign(view.ub.begin(), view.ub.end());
+    data.objCoeffs.assign(view.objCoeffs.begin(), view.objCoeffs.end());
+
+    data.rowtypes.assign(view.rowtypes.begin(), view.rowtypes.end());
+    data.rhs.assign(view.rhs.begin(), view.rhs.end());
+    data.rhsrange.assign(view.rhsrange.begin(), view.rhsrange.end());
+
+    data.rowStart.assign(view.rowStart.begin(), view.rowStart.end());
+    data.colIdxs.assign(view.colIdxs.begin(), view.colIdxs.end());
+    data.colCoeffs.assign(view.colCoeffs.begin(), view.colCoeffs.end());
+
+    data.colName.reserve(view.numCols);
+    for (int i = 0; i < view.numCols; i++)
+        data.colName.push_back(view.colName(i));
+
+    data.rowName.reserve(view.numRows);
+    for (int i = 0; i < view.numRows; i++)
+        data.rowName.push_back(view.rowName(i));
+
+    return data;
+}
+
+ProblemInstance toProblemInstance(const ProblemView& view, std::pmr::memory_resource* resource)
+{
+    return copyView<ProblemInstance>(view, resource);
+}
+
+ProblemInstance64 toProblemInstance64(const ProblemView& view, std::pmr::memory_resource* resource)
+{
+    return copyView<ProblemInstance64>(view, resource);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+struct ProblemInstance;
+struct ProblemInstance64;
+class CbcModel;
+class CoinPackedMatrix;
+class OsiSolverInterface;
+
+// Non-owning (pointer, size) pair, a minimal stand-in for std::span.
+template <typename T>
+struct Span
+{
+    const T* ptr = nullptr;
+    std::size_t len = 0;
+
+    const T* data() const { return ptr; }
+    std::size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+    const T& operator[](std::size_t i) const { return ptr[i]; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + len; }
+};
+
+template <typename T>
+Span<T> makeSpan(const T* ptr, std::size_t len)
+{
+    return Span<T>{ptr, len};
+}
+
+/*
+  Zero-copy view of the model held by an OsiSolverInterface. Every array
+  points straight into the solver (or its cached row-major matrix), so the
+  view is only valid while the solver is alive and unmodified; re-take it
+  after adding/deleting rows or columns, or after branchAndBound.
+
+  Names are not copied: colName(i)/rowName(i) ask the solver on demand.
+  The one exception is a row copy with gaps between the rows, which is not a
+  CSR array; the view then holds a compacted copy of the matrix.
+*/
+struct ProblemView
+{
+    const OsiSolverInterface* solver = nullptr;
+
+    int numCols = 0;
+    int numRows = 0;
+    int numNonZeros = 0;
+    int objSense = 1;
+    double objOffset = 0.0; // constant term of the objective
+
+    /* col types (OsiSolverInterface::getColType):
+       - 0 - continuous
+       - 1 - binary
+       - 2 - general integer
+       - 3 - if supported - semi-continuous
+       - 4 - if supported - semi-continuous integer
+    */
+    Span<char> colType;
+    Span<double> lb;
+    Span<double> ub;
+    Span<double> objCoeffs;
+
+    // row senses: 'L' <=, 'E' =, 'G' >=, 'R' ranged, 'N' free
+    Span<char> rowtypes;
+    Span<double> rhs;
+    Span<double> rhsrange;
+
+    // CSR: colIdxs/colCoeffs[rowStart[i]:rowStart[i+1]] are the nonzeros of row i
+    Span<int> rowStart;
+    Span<int> colIdxs;
+    Span<double> colCoeffs;
+    std::shared_ptr<const CoinPackedMatrix> compactRows; // only if the solver's row copy has gaps
+
+    // 'C' or 'I', same convention as ProblemInstance::varTypes
+    char varType(int i) const { return (colType[i] == 0 || colType[i] == 3) ? 'C' : 'I'; }
+
+    std::string colName(int i) const;
+    std::string rowName(int i) const;
+};
+
+ProblemView getProblemView(const OsiSolverInterface& solver);
+ProblemView getProblemView(CbcModel& model);
+
+// Explicit deep copy, including all names.
+ProblemInstance toProblemInstance(const ProblemView& view,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+ProblemInstance64 toProblemInstance64(const ProblemView& view,
+    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
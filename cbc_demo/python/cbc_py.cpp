@@ -0,0 +1,538 @@
+// Python module cbc_py: reads a model with the native readers (model_reader.h)
+// and hands its ProblemInstance arrays to Python through the buffer protocol,
+// without copying. See Readme.md "17 Python Access".
+//
+//   import cbc_py, numpy as np
+//   model = cbc_py.Model("air04.mps.gz")
+//   row_start, col_idx, col_val = model.csr()   # memoryviews into the model
+//   val = np.asarray(col_val)                   # still no copy
+//   result = model.solve(starts=np.zeros((8, model.num_cols)), time_limit=60)
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "batch_evaluator.h"
+#include "batch_solver.h"
+#include "mip_start.h"
+#include "model_reader.h"
+#include "problem_instance.h"
+#include "util.h"
+
+#include "CbcModel.hpp"
+#include "CoinFinite.hpp"
+#include "OsiClpSolverInterface.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+static const double kFeasibilityTolerance = 1e-6;
+
+/*
+  Read-only 1-D view of one C++ array. owner is the Python object that owns the
+  array (a Model) and keep holds arrays that live outside it (the cached CSC,
+  solve results), so a view, and every memoryview or NumPy array made from
+  it, keeps its storage alive.
+*/
+struct ArrayObject
+{
+    PyObject_HEAD
+    PyObject* owner;
+    std::shared_ptr<const void> keep;
+    const void* data;
+    const char* format;
+    Py_ssize_t itemSize;
+    Py_ssize_t shape;
+    Py_ssize_t stride;
+};
+
+struct ModelObject
+{
+    PyObject_HEAD
+    ProblemInstance* data;
+    BatchEvaluator* evaluator; // built on the first evaluate or solve with starts
+};
+
+// Heap types made from the specs in PyInit_cbc_py.
+static PyTypeObject* ArrayType = nullptr;
+static PyTypeObject* ModelType = nullptr;
+
+static void arrayDealloc(PyObject* self)
+{
+    ArrayObject* array = reinterpret_cast<ArrayObject*>(self);
+    PyTypeObject* type = Py_TYPE(self);
+    Py_XDECREF(array->owner);
+    array->keep.~shared_ptr();
+    type->tp_free(self);
+    Py_DECREF(type); // instances of heap types hold their type
+}
+
+static int arrayGetBuffer(PyObject* self, Py_buffer* view, int flags)
+{
+    ArrayObject* array = reinterpret_cast<ArrayObject*>(self);
+    if (flags & PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "model arrays are read-only");
+        view->obj = nullptr;
+        return -1;
+    }
+    static const double empty = 0.0; // vector::data() may be null for no elements
+    view->buf = const_cast<void*>(array->data ? array->data : &empty);
+    view->obj = Py_NewRef(self);
+    view->len = array->itemSize * array->shape;
+    view->readonly = 1;
+    view->itemsize = array->itemSize;
+    view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(array->format) : nullptr;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) ? &array->shape : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) ? &array->stride : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+// A memoryview over count items of data; the view holds owner and keep.
+template <typename T>
+static PyObject* makeView(PyObject* owner, std::shared_ptr<const void> keep, const T* data, std::size_t count)
+{
+    ArrayObject* array = PyObject_New(ArrayObject, ArrayType);
+    if (!array)
+        return nullptr;
+    new (&array->keep) std::shared_ptr<const void>(std::move(keep));
+    array->owner = Py_XNewRef(owner);
+    array->data = data;
+    array->format = std::is_same<T, double>::value ? "d" : std::is_same<T, int>::value ? "i" : "c";
+    array->itemSize = sizeof(T);
+    array->shape = static_cast<Py_ssize_t>(count);
+    array->stride = sizeof(T);
+    PyObject* view = PyMemoryView_FromObject(reinterpret_cast<PyObject*>(array));
+    Py_DECREF(array);
+    return view;
+}
+
+template <typename T, typename Allocator>
+static PyObject* viewOf(PyObject* model, const std::vector<T, Allocator>& values)
+{
+    return makeView(model, nullptr, values.data(), values.size());
+}
+
+// Copies the result vector into shared storage and views it.
+static PyObject* viewOfCopy(std::vector<double> values)
+{
+    auto storage = std::make_shared<std::vector<double>>(std::move(values));
+    return makeView<double>(nullptr, storage, storage->data(), storage->size());
+}
+
+static ProblemInstance& instanceOf(PyObject* self)
+{
+    return *reinterpret_cast<ModelObject*>(self)->data;
+}
+
+static PyObject* modelNew(PyTypeObject* type, PyObject* args, PyObject* kwargs)
+{
+    static const char* keywords[] = {"path", "threads", nullptr};
+    const char* path = nullptr;
+    int threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|i", const_cast<char**>(keywords), &path, &threads))
+        return nullptr;
+
+    auto data = std::make_unique<ProblemInstance>();
+    std::string file = path;
+    int errors;
+    Py_BEGIN_ALLOW_THREADS
+    errors = readModelFile(file, *data, threads);
+    Py_END_ALLOW_THREADS
+    if (errors != 0) {
+        PyErr_Format(PyExc_ValueError, "%d errors reading %s", errors, path);
+        return nullptr;
+    }
+
+    ModelObject* self = reinterpret_cast<ModelObject*>(type->tp_alloc(type, 0));
+    if (!self)
+        return nullptr;
+    self->data = data.release();
+    self->evaluator = nullptr;
+    return reinterpret_cast<PyObject*>(self);
+}
+
+static void modelDealloc(PyObject* self)
+{
+    ModelObject* model = reinterpret_cast<ModelObject*>(self);
+    PyTypeObject* type = Py_TYPE(self);
+    delete model->evaluator;
+    delete model->data;
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static const BatchEvaluator& evaluatorOf(PyObject* self)
+{
+    ModelObject* model = reinterpret_cast<ModelObject*>(self);
+    if (!model->evaluator)
+        model->evaluator = new BatchEvaluator(*model->data);
+    return *model->evaluator;
+}
+
+static bool isDoubleFormat(const char* format)
+{
+    if (!format)
+        return false; // plain bytes
+    if (*format == '@' || *format == '=' || *format == '<')
+        format++;
+    return std::strcmp(format, "d") == 0;
+}
+
+/*
+  Reads a 2-D (starts x columns) buffer of doubles, any strides, into a
+  column-blocked SolutionBatch. A 1-D buffer is one start. NaN marks a
+  column the start leaves free; those starts are returned in partial.
+*/
+static bool readStarts(PyObject* object, int numCols, SolutionBatch& batch, std::vector<int>& partial)
+{
+    Py_buffer view;
+    if (PyObject_GetBuffer(object, &view, PyBUF_STRIDES | PyBUF_FORMAT) != 0)
+        return false;
+    std::unique_ptr<Py_buffer, void (*)(Py_buffer*)> release(&view, PyBuffer_Release);
+    if (!isDoubleFormat(view.format) || (view.ndim != 1 && view.ndim != 2)) {
+        PyErr_SetString(PyExc_TypeError, "starts must be a 1-D or 2-D buffer of float64");
+        return false;
+    }
+    Py_ssize_t numStarts = view.ndim == 2 ? view.shape[0] : 1;
+    Py_ssize_t length = view.shape[view.ndim - 1];
+    if (length != numCols) {
+        PyErr_Format(PyExc_ValueError, "starts have %zd columns, the model %d", length, numCols);
+        return false;
+    }
+    Py_ssize_t rowStride = view.ndim == 2 ? view.strides[0] : 0;
+    Py_ssize_t colStride = view.strides[view.ndim - 1];
+
+    batch = SolutionBatch(numCols, static_cast<int>(numStarts));
+    partial.clear();
+    const char* base = static_cast<const char*>(view.buf);
+    for (Py_ssize_t b = 0; b < numStarts; b++) {
+        bool complete = true;
+        for (int j = 0; j < numCols; j++) {
+            double value;
+            std::memcpy(&value, base + b * rowStride + j * colStride, sizeof(double));
+            complete = complete && !std::isnan(value);
+            batch.at(j, static_cast<int>(b)) = value;
+        }
+        if (!complete)
+            partial.push_back(static_cast<int>(b));
+    }
+    return true;
+}
+
+static PyObject* modelCsr(PyObject* self, PyObject*)
+{
+    const ProblemInstance& data = instanceOf(self);
+    PyObject* rowStart = viewOf(self, data.rowStart);
+    PyObject* colIdxs = viewOf(self, data.colIdxs);
+    PyObject* colCoeffs = viewOf(self, data.colCoeffs);
+    if (!rowStart || !colIdxs || !colCoeffs) {
+        Py_XDECREF(rowStart);
+        Py_XDECREF(colIdxs);
+        Py_XDECREF(colCoeffs);
+        return nullptr;
+    }
+    return Py_BuildValue("(NNN)", rowStart, colIdxs, colCoeffs);
+}
+
+static PyObject* modelCsc(PyObject* self, PyObject* args, PyObject* kwargs)
+{
+    static const char* keywords[] = {"threads", nullptr};
+    int threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|i", const_cast<char**>(keywords), &threads))
+        return nullptr;
+    const ProblemInstance& data = instanceOf(self);
+    std::shared_ptr<const ColumnMajor> columns;
+    Py_BEGIN_ALLOW_THREADS
+    columns = data.columns(threads);
+    Py_END_ALLOW_THREADS
+    PyObject* colStart = makeView(self, columns, columns->colStart.data(), columns->colStart.size());
+    PyObject* rowIdxs = makeView(self, columns, columns->rowIdxs.data(), columns->rowIdxs.size());
+    PyObject* rowCoeffs = makeView(self, columns, columns->rowCoeffs.data(), columns->rowCoeffs.size());
+    if (!colStart || !rowIdxs || !rowCoeffs) {
+        Py_XDECREF(colStart);
+        Py_XDECREF(rowIdxs);
+        Py_XDECREF(rowCoeffs);
+        return nullptr;
+    }
+    return Py_BuildValue("(NNN)", colStart, rowIdxs, rowCoeffs);
+}
+
+static PyObject* nameAt(const NameTable& names, Py_ssize_t index)
+{
+    if (index < 0 || index >= names.size()) {
+        PyErr_SetString(PyExc_IndexError, "index out of range");
+        return nullptr;
+    }
+    std::string_view name = names[static_cast<int>(index)];
+    return PyUnicode_FromStringAndSize(name.data(), static_cast<Py_ssize_t>(name.size()));
+}
+
+static PyObject* modelColName(PyObject* self, PyObject* arg)
+{
+    Py_ssize_t index = PyLong_AsSsize_t(arg);
+    if (index == -1 && PyErr_Occurred())
+        return nullptr;
+    return nameAt(instanceOf(self).colName, index);
+}
+
+static PyObject* modelRowName(PyObject* self, PyObject* arg)
+{
+    Py_ssize_t index = PyLong_AsSsize_t(arg);
+    if (index == -1 && PyErr_Occurred())
+        return nullptr;
+    return nameAt(instanceOf(self).rowName, index);
+}
+
+static PyObject* findName(const NameTable& names, PyObject* arg)
+{
+    Py_ssize_t length;
+    const char* name = PyUnicode_AsUTF8AndSize(arg, &length);
+    if (!name)
+        return nullptr;
+    return PyLong_FromLong(names.find(std::string_view(name, static_cast<std::size_t>(length))));
+}
+
+static PyObject* modelColIndex(PyObject* self, PyObject* arg)
+{
+    return findName(instanceOf(self).colName, arg);
+}
+
+static PyObject* modelRowIndex(PyObject* self, PyObject* arg)
+{
+    return findName(instanceOf(self).rowName, arg);
+}
+
+static PyObject* modelEvaluate(PyObject* self, PyObject* args, PyObject* kwargs)
+{
+    static const char* keywords[] = {"starts", "threads", nullptr};
+    PyObject* starts = nullptr;
+    int threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|i", const_cast<char**>(keywords), &starts, &threads))
+        return nullptr;
+    const ProblemInstance& data = instanceOf(self);
+    SolutionBatch batch;
+    std::vector<int> partial;
+    if (!readStarts(starts, data.numCols, batch, partial))
+        return nullptr;
+    if (!partial.empty()) {
+        PyErr_SetString(PyExc_ValueError, "evaluate needs complete starts, without NaN");
+        return nullptr;
+    }
+
+    const BatchEvaluator& evaluator = evaluatorOf(self);
+    BatchEvaluation evaluation;
+    Py_BEGIN_ALLOW_THREADS
+    evaluator.evaluate(batch, evaluation, threads);
+    Py_END_ALLOW_THREADS
+    std::vector<double> violation(batch.batchSize);
+    for (int b = 0; b < batch.batchSize; b++)
+        violation[b] = evaluation.maxViolation(b);
+    return Py_BuildValue("(NN)", viewOfCopy(std::move(evaluation.objective)), viewOfCopy(std::move(violation)));
+}
+
+/*
+  Picks the incumbent for a solve from the starts: the best complete start
+  that the evaluator finds feasible, and each partial start completed by
+  completeMipStart, all compared by objective. Runs without the GIL.
+*/
+static bool bestStart(const ProblemInstance& data, const BatchEvaluator& evaluator, const SolutionBatch& batch,
+    const std::vector<int>& partial, const OsiSolverInterface& solver, int threads, std::vector<double>& best)
+{
+    double bestObjective = 0.0;
+    bool found = false;
+    auto offer = [&](const double* x) {
+        double objective = 0.0;
+        for (int j = 0; j < data.numCols; j++)
+            objective += data.objCoeffs[j] * x[j];
+        objective *= data.objSense;
+        if (!found || objective < bestObjective) {
+            best.assign(x, x + data.numCols);
+            bestObjective = objective;
+            found = true;
+        }
+    };
+
+    BatchEvaluation evaluation;
+    evaluator.evaluate(batch, evaluation, threads);
+    std::vector<double> x(data.numCols);
+    std::size_t next = 0;
+    for (int b = 0; b < batch.batchSize; b++) {
+        if (next < partial.size() && partial[next] == b) {
+            next++;
+            continue;
+        }
+        if (evaluation.maxViolation(b) <= kFeasibilityTolerance) {
+            batch.getSolution(b, x.data());
+            offer(x.data());
+        }
+    }
+    for (int b : partial) {
+        MipStart start;
+        for (int j = 0; j < data.numCols; j++)
+            if (!std::isnan(batch.at(j, b)))
+                start.emplace_back(j, batch.at(j, b));
+        std::vector<double> solution;
+        if (completeMipStart(solver, start, solution))
+            offer(solution.data());
+    }
+    return found;
+}
+
+static PyObject* resultDict(const BatchResult& result, bool startUsed)
+{
+    PyObject* solution = Py_NewRef(Py_None);
+    if (result.hasSolution && !result.solution.empty()) {
+        Py_DECREF(solution);
+        solution = viewOfCopy(result.solution);
+        if (!solution)
+            return nullptr;
+    }
+    return Py_BuildValue("{s:s,s:s,s:O,s:d,s:d,s:d,s:i,s:i,s:d,s:O,s:N}", "status",
+        batchStatusName(result.status), "message", result.message.c_str(), "has_solution",
+        result.hasSolution ? Py_True : Py_False, "objective", result.objValue, "bound", result.bestBound, "gap",
+        result.gap, "nodes", result.nodes, "iterations", result.iterations, "seconds", result.solveSeconds,
+        "start_used", startUsed ? Py_True : Py_False, "solution", solution);
+}
+
+static PyObject* modelSolve(PyObject* self, PyObject* args, PyObject* kwargs)
+{
+    static const char* keywords[] = {"starts", "time_limit", "threads", nullptr};
+    PyObject* starts = Py_None;
+    double timeLimit = 0.0;
+    int threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|Odi", const_cast<char**>(keywords), &starts, &timeLimit,
+            &threads))
+        return nullptr;
+    const ProblemInstance& data = instanceOf(self);
+    SolutionBatch batch;
+    std::vector<int> partial;
+    if (starts != Py_None && !readStarts(starts, data.numCols, batch, partial))
+        return nullptr;
+    const BatchEvaluator* evaluator = starts != Py_None ? &evaluatorOf(self) : nullptr;
+
+    BatchResult result;
+    bool startUsed = false;
+    Py_BEGIN_ALLOW_THREADS
+    OsiClpSolverInterface solver;
+    solver.messageHandler()->setLogLevel(0);
+    loadProblemData(data, solver, false);
+    std::vector<double> best;
+    if (evaluator)
+        startUsed = bestStart(data, *evaluator, batch, partial, solver, threads, best);
+
+    CbcModel model(solver);
+    model.setLogLevel(0);
+    model.setUseElapsedTime(true);
+    if (timeLimit > 0.0)
+        model.setMaximumSeconds(timeLimit);
+    model.setNumberThreads(threads > 1 ? threads : 0);
+    if (startUsed)
+        model.setBestSolution(best.data(), data.numCols, COIN_DBL_MAX, true);
+    startUsed = startUsed && model.bestSolution();
+    auto start = std::chrono::steady_clock::now();
+    model.branchAndBound();
+    result.solveSeconds = secondsSince(start);
+    collectBatchResult(model, false, true, result);
+    Py_END_ALLOW_THREADS
+    return resultDict(result, startUsed);
+}
+
+static PyObject* modelLb(PyObject* self, void*) { return viewOf(self, instanceOf(self).lb); }
+static PyObject* modelUb(PyObject* self, void*) { return viewOf(self, instanceOf(self).ub); }
+static PyObject* modelObj(PyObject* self, void*) { return viewOf(self, instanceOf(self).objCoeffs); }
+static PyObject* modelVarTypes(PyObject* self, void*) { return viewOf(self, instanceOf(self).varTypes); }
+static PyObject* modelSense(PyObject* self, void*) { return viewOf(self, instanceOf(self).rowtypes); }
+static PyObject* modelRhs(PyObject* self, void*) { return viewOf(self, instanceOf(self).rhs); }
+static PyObject* modelRhsRange(PyObject* self, void*) { return viewOf(self, instanceOf(self).rhsrange); }
+static PyObject* modelRowStart(PyObject* self, void*) { return viewOf(self, instanceOf(self).rowStart); }
+static PyObject* modelColIdxs(PyObject* self, void*) { return viewOf(self, instanceOf(self).colIdxs); }
+static PyObject* modelColCoeffs(PyObject* self, void*) { return viewOf(self, instanceOf(self).colCoeffs); }
+static PyObject* modelNumCols(PyObject* self, void*) { return PyLong_FromLong(instanceOf(self).numCols); }
+static PyObject* modelNumRows(PyObject* self, void*) { return PyLong_FromLong(instanceOf(self).numRows); }
+static PyObject* modelNumNonZeros(PyObject* self, void*) { return PyLong_FromLong(instanceOf(self).numNonZeros); }
+static PyObject* modelObjSense(PyObject* self, void*) { return PyLong_FromLong(instanceOf(self).objSense); }
+static PyObject* modelObjOffset(PyObject* self, void*) { return PyFloat_FromDouble(instanceOf(self).objOffset); }
+
+static PyGetSetDef modelGetSet[] = {
+    {"num_cols", modelNumCols, nullptr, nullptr, nullptr},
+    {"num_rows", modelNumRows, nullptr, nullptr, nullptr},
+    {"num_nonzeros", modelNumNonZeros, nullptr, nullptr, nullptr},
+    {"obj_sense", modelObjSense, nullptr, "1 minimize, -1 maximize", nullptr},
+    {"obj_offset", modelObjOffset, nullptr, nullptr, nullptr},
+    {"lb", modelLb, nullptr, "column lower bounds, float64", nullptr},
+    {"ub", modelUb, nullptr, "column upper bounds, float64", nullptr},
+    {"obj", modelObj, nullptr, "objective coefficients, float64", nullptr},
+    {"var_types", modelVarTypes, nullptr, "b'C' or b'I' per column", nullptr},
+    {"sense", modelSense, nullptr, "b'L', b'E', b'G', b'R' or b'N' per row", nullptr},
+    {"rhs", modelRhs, nullptr, "float64; the upper end of ranged rows", nullptr},
+    {"rhs_range", modelRhsRange, nullptr, "float64, upper - lower of ranged rows", nullptr},
+    {"row_start", modelRowStart, nullptr, "CSR row pointers, int32, num_rows + 1", nullptr},
+    {"col_idx", modelColIdxs, nullptr, "CSR column indices, int32", nullptr},
+    {"col_val", modelColCoeffs, nullptr, "CSR coefficients, float64", nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}};
+
+static PyMethodDef modelMethods[] = {
+    {"csr", modelCsr, METH_NOARGS, "csr() -> (row_start, col_idx, col_val), as get_csr_matrix returns them"},
+    {"csc", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(modelCsc)), METH_VARARGS | METH_KEYWORDS,
+        "csc(threads=0) -> (col_start, row_idx, row_val), transposed once and cached"},
+    {"col_name", modelColName, METH_O, "col_name(j) -> str"},
+    {"row_name", modelRowName, METH_O, "row_name(i) -> str"},
+    {"col_index", modelColIndex, METH_O, "col_index(name) -> int, -1 if unknown"},
+    {"row_index", modelRowIndex, METH_O, "row_index(name) -> int, -1 if unknown"},
+    {"evaluate", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(modelEvaluate)),
+        METH_VARARGS | METH_KEYWORDS,
+        "evaluate(starts, threads=0) -> (objective, max_violation), one entry per row of the 2-D starts"},
+    {"solve", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(modelSolve)),
+        METH_VARARGS | METH_KEYWORDS,
+        "solve(starts=None, time_limit=0, threads=0) -> dict; the best feasible row of starts (NaN: free "
+        "column, completed by an LP) becomes the first incumbent"},
+    {nullptr, nullptr, 0, nullptr}};
+
+static PyModuleDef cbcModule = {PyModuleDef_HEAD_INIT, "cbc_py",
+    "Zero-copy access to models read by the cbc_demo readers, and CBC solves with batches of MIP starts.", -1,
+    nullptr, nullptr, nullptr, nullptr, nullptr};
+
+static PyType_Slot arraySlots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(arrayDealloc)},
+    {Py_bf_getbuffer, reinterpret_cast<void*>(arrayGetBuffer)},
+    {Py_tp_doc, const_cast<char*>("Read-only buffer over an array of a Model")},
+    {0, nullptr}};
+
+// only made by makeView
+static PyType_Spec arraySpec = {"cbc_py.Array", sizeof(ArrayObject), 0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_DISALLOW_INSTANTIATION, arraySlots};
+
+static PyType_Slot modelSlots[] = {
+    {Py_tp_dealloc, reinterpret_cast<void*>(modelDealloc)},
+    {Py_tp_new, reinterpret_cast<void*>(modelNew)},
+    {Py_tp_methods, modelMethods},
+    {Py_tp_getset, modelGetSet},
+    {Py_tp_doc, const_cast<char*>("Model(path, threads=0): an .mps[.gz] or .lp[.gz] model read into memory")},
+    {0, nullptr}};
+
+static PyType_Spec modelSpec = {"cbc_py.Model", sizeof(ModelObject), 0, Py_TPFLAGS_DEFAULT, modelSlots};
+
+PyMODINIT_FUNC PyInit_cbc_py(void)
+{
+    ArrayType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&arraySpec));
+    ModelType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&modelSpec));
+    if (!ArrayType || !ModelType)
+        return nullptr;
+    PyObject* module = PyModule_Create(&cbcModule);
+    if (!module)
+        return nullptr;
+    if (PyModule_AddObjectRef(module, "Model", reinterpret_cast<PyObject*>(ModelType)) < 0) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
@@ -0,0 +1,319 @@
+#include "racing_solver.h"
+#include "json_writer.h"
+#include "util.h"
+
+#include "CbcEventHandler.hpp"
+#include "CbcHeuristic.hpp"
+#include "CbcHeuristicFPump.hpp"
+#include "CbcHeuristicLocal.hpp"
+#include "CbcHeuristicRINS.hpp"
+#include "CbcModel.hpp"
+#include "CglClique.hpp"
+#include "CglFlowCover.hpp"
+#include "CglGomory.hpp"
+#include "CglKnapsackCover.hpp"
+#include "CglMixedIntegerRounding2.hpp"
+#include "CglProbing.hpp"
+#include "CglTwomir.hpp"
+#include "OsiSolverInterface.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+std::vector<RaceConfig> defaultRaceConfigs(int count)
+{
+    static const RaceConfig base[] = {
+        // name, seed, cuts, heuristics, strong branching, trust
+        {"default", -1, 1, true, 5, 10},
+        {"aggressive cuts", 1, 2, true, 5, 10},
+        {"no cuts", 2, 0, true, 5, 10},
+        {"strong branching", 3, 1, true, 20, 20},
+        {"no heuristics", 4, 1, false, 5, 10},
+        {"pseudo costs", 5, 1, true, 0, 0},
+    };
+    const int numBase = static_cast<int>(sizeof(base) / sizeof(base[0]));
+
+    std::vector<RaceConfig> configs;
+    for (int k = 0; k < count; k++) {
+        RaceConfig config = base[k % numBase];
+        if (k >= numBase) {
+            config.randomSeed = 100 * (k / numBase) + k % numBase;
+            config.name += " seed " + std::to_string(config.randomSeed);
+        }
+        configs.push_back(config);
+    }
+    return configs;
+}
+
+// The best solution any racer has found, in CBC's minimization sense.
+struct SharedIncumbent
+{
+    std::mutex mutex;
+    std::atomic<double> objective{COIN_DBL_MAX};
+    std::vector<double> solution;
+    int source = -1;
+    std::atomic<bool> finished{false}; // a racer proved its result
+};
+
+/*
+  Publishes the racer's incumbents and imports better ones from the others.
+  Imports happen at node events only, where the search is between nodes and
+  CbcModel::setBestSolution can replace the incumbent safely.
+*/
+class RaceEventHandler : public CbcEventHandler
+{
+public:
+    RaceEventHandler(CbcModel* model, SharedIncumbent* shared, int racer, RacerResult* result)
+        : CbcEventHandler(model), shared_(shared), racer_(racer), result_(result)
+    {
+    }
+
+    CbcAction event(CbcEvent whichEvent) override
+    {
+        publish();
+        if (whichEvent == endSearch)
+            return noAction;
+        if (shared_->finished.load(std::memory_order_relaxed))
+            return stop;
+        if (whichEvent == node)
+            import();
+        return noAction;
+    }
+
+    CbcEventHandler* clone() const override { return new RaceEventHandler(*this); }
+
+private:
+    void publish()
+    {
+        double objective = model_->getMinimizationObjValue();
+        if (objective >= published_ || !model_->bestSolution())
+            return;
+        published_ = objective;
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        if (objective < shared_->objective.load(std::memory_order_relaxed)) {
+            shared_->solution.assign(model_->bestSolution(), model_->bestSolution() + model_->getNumCols());
+            shared_->source = racer_;
+            shared_->objective.store(objective, std::memory_order_release);
+            result_->solutionsFound++;
+        }
+    }
+
+    void import()
+    {
+        double best = shared_->objective.load(std::memory_order_acquire);
+        if (best >= published_ - 1e-9 * std::max(1.0, std::fabs(best)))
+            return;
+        {
+            std::lock_guard<std::mutex> lock(shared_->mutex);
+            best = shared_->objective.load(std::memory_order_relaxed);
+            incoming_ = shared_->solution;
+        }
+        published_ = best;
+        model_->setBestSolution(incoming_.data(), static_cast<int>(incoming_.size()), best, false);
+        double cutoff = best - model_->getCutoffIncrement();
+        if (cutoff < model_->getCutoff())
+            model_->setCutoff(cutoff);
+        result_->solutionsImported++;
+    }
+
+    SharedIncumbent* shared_;
+    int racer_;
+    RacerResult* result_;
+    double published_ = COIN_DBL_MAX;
+    std::vector<double> incoming_;
+};
+
+void configureRacer(CbcModel& model, const RaceConfig& config, double timeLimit)
+{
+    model.setLogLevel(0);
+    model.solver()->messageHandler()->setLogLevel(0);
+    model.setUseElapsedTime(true);
+    if (timeLimit > 0.0)
+        model.setMaximumSeconds(timeLimit);
+    if (config.randomSeed >= 0)
+        model.setRandomSeed(config.randomSeed);
+    model.setNumberStrong(config.strongBranching);
+    model.setNumberBeforeTrust(config.numberBeforeTrust);
+
+    if (config.cuts > 0) {
+        // every node for the aggressive level, otherwise CBC decides from the root's success
+        int howOften = config.cuts > 1 ? 1 : -1;
+        CglProbing probing;
+        probing.setUsingObjective(true);
+        probing.setMaxPass(3);
+        probing.setMaxProbe(100);
+        probing.setMaxLook(50);
+        probing.setRowCuts(3);
+        CglGomory gomory;
+        gomory.setLimit(300);
+        CglKnapsackCover knapsack;
+        CglClique clique;
+        clique.setStarCliqueReport(false);
+        clique.setRowCliqueReport(false);
+        CglMixedIntegerRounding2 mixedIntegerRounding;
+        CglFlowCover flowCover;
+        CglTwomir twomir;
+
+        model.addCutGenerator(&probing, howOften, "Probing");
+        model.addCutGenerator(&gomory, howOften, "Gomory");
+        model.addCutGenerator(&knapsack, howOften, "Knapsack");
+        model.addCutGenerator(&clique, howOften, "Clique");
+        model.addCutGenerator(&mixedIntegerRounding, howOften, "MixedIntegerRounding2");
+        model.addCutGenerator(&flowCover, howOften, "FlowCover");
+        model.addCutGenerator(&twomir, howOften, "Twomir");
+        if (config.cuts > 1) {
+            model.setMaximumCutPassesAtRoot(50);
+            model.setMaximumCutPasses(5);
+        }
+    }
+
+    if (config.heuristics) {
+        CbcRounding rounding(model);
+        CbcHeuristicLocal local(model);
+        CbcHeuristicFPump pump(model);
+        CbcHeuristicRINS rins(model);
+        model.addHeuristic(&rounding, "Rounding");
+        model.addHeuristic(&local, "LocalSearch");
+        model.addHeuristic(&pump, "FeasibilityPump");
+        model.addHeuristic(&rins, "RINS");
+    }
+}
+
+RaceResult raceSolve(const OsiSolverInterface& solver, const std::vector<RaceConfig>& configs, double timeLimit)
+{
+    RaceResult race;
+    if (configs.empty())
+        return race;
+    const int numRacers = static_cast<int>(configs.size());
+    const double sense = solver.getObjSense();
+    race.racers.resize(numRacers);
+
+    // models are set up here, so the threads share nothing but the incumbent
+    SharedIncumbent shared;
+    std::vector<std::unique_ptr<CbcModel>> models;
+    for (int k = 0; k < numRacers; k++) {
+        race.racers[k].config = configs[k].name;
+        models.emplace_back(new CbcModel(solver));
+        configureRacer(*models[k], configs[k], timeLimit);
+        RaceEventHandler handler(models[k].get(), &shared, k, &race.racers[k]);
+        models[k]->passInEventHandler(&handler);
+    }
+
+    std::mutex finishMutex;
+    int firstProven = -1;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int k = 0; k < numRacers; k++) {
+        threads.emplace_back([&, k]() {
+            CbcModel& model = *models[k];
+            model.branchAndBound();
+            RacerResult& racer = race.racers[k];
+            racer.seconds = secondsSince(start);
+            racer.nodes = model.getNodeCount();
+            racer.hasSolution = model.bestSolution() != nullptr;
+            racer.objValue = racer.hasSolution ? model.getObjValue() : 0.0;
+            racer.bestBound = model.getBestPossibleObjValue();
+
+            bool proven = model.isProvenOptimal() || model.isProvenInfeasible();
+            if (model.isProvenOptimal())
+                racer.status = BatchStatus::Optimal;
+            else if (model.isProvenInfeasible())
+                racer.status = BatchStatus::Infeasible;
+            else if (model.status() == 5)
+                racer.status = BatchStatus::Cancelled;
+            else if (model.status() == 2)
+                racer.status = BatchStatus::Failed;
+            else
+                racer.status = BatchStatus::Stopped;
+
+            if (proven) {
+                std::lock_guard<std::mutex> lock(finishMutex);
+                if (firstProven < 0)
+                    firstProven = k;
+                shared.finished = true;
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    race.seconds = secondsSince(start);
+
+    race.incumbentFrom = shared.source;
+    race.hasSolution = !shared.solution.empty();
+    if (race.hasSolution) {
+        race.objValue = shared.objective.load() * sense;
+        race.solution = shared.solution;
+    }
+
+    if (firstProven >= 0) {
+        race.winner = firstProven;
+        race.status = race.racers[firstProven].status;
+        race.bestBound = race.hasSolution ? race.objValue : race.racers[firstProven].bestBound;
+    } else {
+        // no proof: the tightest bound wins, every racer's bound is valid for the model
+        race.status = BatchStatus::Stopped;
+        for (int k = 0; k < numRacers; k++) {
+            const RacerResult& racer = race.racers[k];
+            if (racer.status == BatchStatus::Failed)
+                continue;
+            if (race.winner < 0 || racer.bestBound * sense > race.racers[race.winner].bestBound * sense)
+                race.winner = k;
+        }
+        if (race.winner < 0)
+            return race;
+        race.bestBound = race.racers[race.winner].bestBound;
+    }
+    race.winnerConfig = configs[race.winner].name;
+    if (race.hasSolution)
+        race.gap = std::fabs(race.objValue - race.bestBound) / std::max(1e-10, std::fabs(race.objValue));
+    return race;
+}
+
+void writeRaceReportJson(const RaceResult& result, std::ostream& out)
+{
+    out << "{\n  \"status\": \"" << batchStatusName(result.status) << "\", \"winner\": ";
+    writeJsonString(out, result.winnerConfig);
+    out << ", \"incumbent_from\": ";
+    if (result.incumbentFrom >= 0)
+        writeJsonString(out, result.racers[result.incumbentFrom].config);
+    else
+        out << "null";
+    out << ", \"objective\": ";
+    if (result.hasSolution)
+        writeJsonNumber(out, result.objValue);
+    else
+        out << "null";
+    out << ", \"bound\": ";
+    writeJsonNumber(out, result.bestBound);
+    out << ", \"gap\": ";
+    if (result.hasSolution)
+        writeJsonNumber(out, result.gap);
+    else
+        out << "null";
+    out << ", \"seconds\": ";
+    writeJsonNumber(out, result.seconds, "%.6f");
+    out << ",\n  \"racers\": [";
+    for (std::size_t k = 0; k < result.racers.size(); k++) {
+        const RacerResult& r = result.racers[k];
+        out << (k == 0 ? "\n" : ",\n") << "    {\"config\": ";
+        writeJsonString(out, r.config);
+        out << ", \"status\": \"" << batchStatusName(r.status) << "\", \"objective\": ";
+        if (r.hasSolution)
+            writeJsonNumber(out, r.objValue);
+        else
+            out << "null";
+        out << ", \"bound\": ";
+        writeJsonNumber(out, r.bestBound);
+        out << ", \"nodes\": " << r.nodes << ", \"found\": " << r.solutionsFound
+            << ", \"imported\": " << r.solutionsImported << ", \"seconds\": ";
+        writeJsonNumber(out, r.seconds, "%.6f");
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "batch_solver.h"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class CbcModel;
+class OsiSolverInterface;
+
+// One racer's CBC settings.
+struct RaceConfig
+{
+    std::string name;
+    int randomSeed = -1;       // < 0 keeps CBC's seed
+    int cuts = 1;              // 0 none, 1 the usual generators at the root and every few nodes, 2 every node and more root passes
+    bool heuristics = true;    // rounding, local search, feasibility pump, RINS
+    int strongBranching = 5;   // candidates for strong branching
+    int numberBeforeTrust = 10; // strong branches before pseudo costs are trusted
+};
+
+// The first count of a fixed set of diverse configurations; past that set the
+// list repeats with other random seeds.
+std::vector<RaceConfig> defaultRaceConfigs(int count);
+
+// Quiet logs, the time limit, branching, and the generators and heuristics config asks for.
+// cbc_bench and bench_subtrees set their models up with it too.
+void configureRacer(CbcModel& model, const RaceConfig& config, double timeLimit);
+
+struct RacerResult
+{
+    std::string config;
+    BatchStatus status = BatchStatus::Failed; // Cancelled: another racer finished first
+    bool hasSolution = false;
+    double objValue = 0.0;
+    double bestBound = 0.0;
+    int nodes = 0;
+    int solutionsFound = 0;    // incumbents this racer published to the others
+    int solutionsImported = 0; // incumbents it took from the others
+    double seconds = 0.0;
+};
+
+struct RaceResult
+{
+    BatchStatus status = BatchStatus::Failed;
+    int winner = -1;        // racer that proved the result, or the one with the best bound at the time limit
+    std::string winnerConfig;
+    int incumbentFrom = -1; // racer that found the best solution
+    bool hasSolution = false;
+    double objValue = 0.0;
+    double bestBound = 0.0; // best over all racers
+    double gap = 0.0;
+    double seconds = 0.0;
+    std::vector<double> solution;
+    std::vector<RacerResult> racers;
+};
+
+/*
+  Races one model with several CBC configurations, each on its own thread
+  with its own copy of the solver. A CbcEventHandler in every racer publishes
+  its new incumbents to a shared slot and, at the next node of every other
+  racer, installs them there as best solution and cutoff. The first racer
+  that proves optimality (or infeasibility) stops the others; otherwise all
+  of them run to the wall clock timeLimit.
+
+    RaceResult race = raceSolve(solver, defaultRaceConfigs(4), 60.0);
+    std::cout << race.winnerConfig << std::endl;
+*/
+RaceResult raceSolve(const OsiSolverInterface& solver, const std::vector<RaceConfig>& configs, double timeLimit = 0.0);
+
+void writeRaceReportJson(const RaceResult& result, std::ostream& out);
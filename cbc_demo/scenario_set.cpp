@@ -0,0 +1,776 @@
+#include "scenario_set.h"
+#include "model_reader.h"
+#include "parallel.h"
+#include "util.h"
+
+#include "CbcModel.hpp"
+#include "CoinFinite.hpp"
+#include "CoinWarmStart.hpp"
+#include "OsiClpSolverInterface.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+
+int Scenario::numChanges() const
+{
+    return static_cast<int>(rhsRows.size() + coeffRows.size() + objCols.size() + boundCols.size());
+}
+
+double ScenarioSet::totalProbability() const
+{
+    double total = 0.0;
+    for (const Scenario& scenario : scenarios)
+        total += scenario.probability;
+    return total;
+}
+
+// Kinds in the order the entries of a Scenario are emitted.
+enum ChangeKind
+{
+    kRhs,
+    kCoeff,
+    kObj,
+    kLower,
+    kUpper,
+    kObjConstant
+};
+
+enum Modifier
+{
+    kReplace,
+    kAdd,
+    kMultiply
+};
+
+// One entry of the stochastic file, with the value as written.
+struct Change
+{
+    int kind;
+    int row;
+    int col;
+    double value;
+};
+
+using ChangeKey = std::tuple<int, int, int>; // kind, row, col
+
+// A scenario of a SCENARIOS section before it is resolved against its parent.
+struct ScenarioNode
+{
+    std::string name;
+    int parent;
+    int period;
+    double probability;
+    std::vector<Change> changes;
+};
+
+// One outcome of an INDEP element or a BLOCKS block.
+struct Realization
+{
+    double probability;
+    std::vector<Change> changes;
+};
+
+struct RandomBlock
+{
+    std::string name;
+    int period;
+    std::vector<Realization> realizations;
+};
+
+static double clampInfinity(double value)
+{
+    if (value >= 1.0e30)
+        return COIN_DBL_MAX;
+    if (value <= -1.0e30)
+        return -COIN_DBL_MAX;
+    return value;
+}
+
+static std::string upper(std::string value)
+{
+    std::transform(value.begin(), value.end(), value.begin(), ::toupper);
+    return value;
+}
+
+static bool parseNumber(const std::string& token, double& value)
+{
+    char* end = nullptr;
+    value = std::strtod(token.c_str(), &end);
+    return end != token.c_str() && *end == '\0';
+}
+
+// Calls fn(tokens, lineNumber, isHeader) for every line that is not blank or
+// a comment; a header starts in the first column.
+template <typename Fn>
+static void forEachLine(const std::string& text, Fn&& fn)
+{
+    std::istringstream in(text);
+    std::string line;
+    std::vector<std::string> tokens;
+    for (int number = 1; std::getline(in, line); number++) {
+        if (line.empty() || line[0] == '*')
+            continue;
+        tokens.clear();
+        std::istringstream words(line);
+        for (std::string token; words >> token;)
+            tokens.push_back(token);
+        if (tokens.empty())
+            continue;
+        bool isHeader = line[0] != ' ' && line[0] != '\t';
+        if (!fn(tokens, number, isHeader))
+            break;
+    }
+}
+
+// Name of the first N row, which the MPS reader does not keep.
+static std::string objectiveRowName(const std::string& coreText)
+{
+    std::string name;
+    bool inRows = false;
+    forEachLine(coreText, [&](const std::vector<std::string>& tokens, int, bool isHeader) {
+        if (isHeader) {
+            if (inRows)
+                return false;
+            inRows = upper(tokens[0]) == "ROWS";
+            return true;
+        }
+        if (inRows && tokens.size() >= 2 && upper(tokens[0]) == "N") {
+            name = tokens[1];
+            return false;
+        }
+        return true;
+    });
+    return name;
+}
+
+static std::string findSmpsFile(const std::string& base, std::initializer_list<const char*> extensions)
+{
+    for (const char* extension : extensions) {
+        for (const char* compressed : {"", ".gz"}) {
+            std::string path = base + extension + compressed;
+            if (std::filesystem::exists(path))
+                return path;
+        }
+    }
+    return "";
+}
+
+static std::string smpsBaseName(std::string path)
+{
+    auto strip = [&](const std::string& suffix) {
+        if (path.size() > suffix.size() && endsWith(path, suffix)) {
+            path.resize(path.size() - suffix.size());
+            return true;
+        }
+        return false;
+    };
+    strip(".gz");
+    for (const char* extension : {".cor", ".core", ".tim", ".time", ".sto", ".stoch"})
+        if (strip(extension))
+            break;
+    return path;
+}
+
+static int periodIndex(const ScenarioSet& set, const std::string& name)
+{
+    auto it = std::find(set.periods.begin(), set.periods.end(), name);
+    return it == set.periods.end() ? -1 : static_cast<int>(it - set.periods.begin());
+}
+
+static int readTimeFile(const std::string& path, const std::string& text, const std::string& objName,
+    ScenarioSet& set)
+{
+    const ProblemInstance& core = set.core;
+    int errors = 0;
+    auto error = [&](int line, const std::string& message) {
+        std::cout << path << ":" << line << ": " << message << std::endl;
+        errors++;
+    };
+
+    // implicit: first column and row of each period; explicit: period per entry
+    std::string section;
+    bool isExplicit = false;
+    std::vector<int> firstCol, firstRow;
+    set.rowPeriod.assign(core.numRows, 0);
+    set.colPeriod.assign(core.numCols, 0);
+    forEachLine(text, [&](const std::vector<std::string>& tokens, int line, bool isHeader) {
+        if (isHeader) {
+            section = upper(tokens[0]);
+            if (section == "PERIODS")
+                isExplicit = tokens.size() > 1 && upper(tokens[1]) == "EXPLICIT";
+            return section != "ENDATA";
+        }
+        if (section == "PERIODS" && !isExplicit) {
+            if (tokens.size() < 3) {
+                error(line, "expected column, row and period");
+                return true;
+            }
+            // a period may start at the objective row, which is not a row of the core
+            int col = core.colName.find(tokens[0]);
+            int row = tokens[1] == objName ? 0 : core.rowName.find(tokens[1]);
+            if (col < 0 || row < 0) {
+                error(line, "unknown " + std::string(col < 0 ? "column " + tokens[0] : "row " + tokens[1]));
+                return true;
+            }
+            set.periods.push_back(tokens[2]);
+            firstCol.push_back(col);
+            firstRow.push_back(row);
+        } else if (section == "PERIODS") {
+            set.periods.push_back(tokens[0]);
+        } else if ((section == "ROWS" || section == "COLUMNS") && tokens.size() >= 2) {
+            bool isRow = section == "ROWS";
+            int index = isRow ? core.rowName.find(tokens[0]) : core.colName.find(tokens[0]);
+            int period = periodIndex(set, tokens[1]);
+            if (period < 0) {
+                // the explicit format may also list periods only here
+                set.periods.push_back(tokens[1]);
+                period = static_cast<int>(set.periods.size()) - 1;
+            }
+            if (index >= 0)
+                (isRow ? set.rowPeriod : set.colPeriod)[index] = period;
+            else if (!isRow || tokens[0] != objName)
+                error(line, "unknown " + std::string(isRow ? "row " : "column ") + tokens[0]);
+        }
+        return true;
+    });
+
+    if (!isExplicit) {
+        for (std::size_t p = 1; p < firstCol.size(); p++) {
+            if (firstCol[p] < firstCol[p - 1] || firstRow[p] < firstRow[p - 1])
+                error(0, "period " + set.periods[p] + " starts before the period before it");
+        }
+        for (std::size_t p = 0; p < firstCol.size(); p++) {
+            std::fill(set.colPeriod.begin() + firstCol[p], set.colPeriod.end(), static_cast<int>(p));
+            std::fill(set.rowPeriod.begin() + firstRow[p], set.rowPeriod.end(), static_cast<int>(p));
+        }
+    }
+    if (set.periods.empty())
+        error(0, "no periods");
+    return errors;
+}
+
+static double coreCoefficient(const ProblemInstance& core, int row, int col)
+{
+    for (int k = core.rowStart[row]; k < core.rowStart[row + 1]; k++)
+        if (core.colIdxs[k] == col)
+            return core.colCoeffs[k];
+    return 0.0;
+}
+
+static double coreValue(const ProblemInstance& core, int kind, int row, int col)
+{
+    switch (kind) {
+    case kRhs: return core.rhs[row];
+    case kCoeff: return coreCoefficient(core, row, col);
+    case kObj: return core.objCoeffs[col];
+    case kLower: return core.lb[col];
+    case kUpper: return core.ub[col];
+    default: return core.objOffset;
+    }
+}
+
+// The value that replaces the core's; an RHS on the objective row is the
+// negated constant, as in the MPS reader.
+static double resolveValue(const ProblemInstance& core, const Change& change, int modifier)
+{
+    double value = change.kind == kObjConstant && modifier != kMultiply ? -change.value : change.value;
+    double base = coreValue(core, change.kind, change.row, change.col);
+    if (modifier == kAdd)
+        return base + value;
+    if (modifier == kMultiply)
+        return base * value;
+    return change.kind == kLower || change.kind == kUpper ? clampInfinity(value) : value;
+}
+
+static int keyPeriod(const ScenarioSet& set, const ChangeKey& key)
+{
+    auto [kind, row, col] = key;
+    switch (kind) {
+    case kRhs: return set.rowPeriod[row];
+    case kCoeff: return std::max(set.rowPeriod[row], set.colPeriod[col]);
+    case kObjConstant: return 0;
+    default: return set.colPeriod[col];
+    }
+}
+
+static void emitScenario(const ProblemInstance& core, const std::map<ChangeKey, double>& values, Scenario& scenario)
+{
+    scenario.objOffset = core.objOffset;
+    std::map<int, std::pair<double, double>> bounds;
+    for (const auto& [key, value] : values) {
+        auto [kind, row, col] = key;
+        switch (kind) {
+        case kRhs:
+            scenario.rhsRows.push_back(row);
+            scenario.rhs.push_back(value);
+            break;
+        case kCoeff:
+            scenario.coeffRows.push_back(row);
+            scenario.coeffCols.push_back(col);
+            scenario.coeffs.push_back(value);
+            break;
+        case kObj:
+            scenario.objCols.push_back(col);
+            scenario.objCoeffs.push_back(value);
+            break;
+        case kLower:
+        case kUpper: {
+            auto inserted = bounds.emplace(col, std::make_pair(core.lb[col], core.ub[col]));
+            (kind == kLower ? inserted.first->second.first : inserted.first->second.second) = value;
+            break;
+        }
+        default:
+            scenario.objOffset = value;
+            break;
+        }
+    }
+    for (const auto& [col, bound] : bounds) {
+        scenario.boundCols.push_back(col);
+        scenario.lower.push_back(bound.first);
+        scenario.upper.push_back(bound.second);
+    }
+}
+
+// Parses "column row value [row value]", "rhs-set row value [row value]" or
+// "UP|LO|FX|MI|PL bound-set column [value]" from tokens[0]; returns the
+// index of the first token not used, -1 on an error (message set).
+static int parseEntry(const std::vector<std::string>& tokens, bool allowSecondPair, const ProblemInstance& core,
+    const std::string& objName, std::vector<Change>& changes, std::string& message)
+{
+    std::string type = upper(tokens[0]);
+    if (type == "UP" || type == "LO" || type == "FX" || type == "MI" || type == "PL") {
+        bool needsValue = type != "MI" && type != "PL";
+        double value = type == "MI" ? -COIN_DBL_MAX : COIN_DBL_MAX;
+        if (tokens.size() < (needsValue ? 4u : 3u) || (needsValue && !parseNumber(tokens[3], value))) {
+            message = "expected bound type, bound set, column and value";
+            return -1;
+        }
+        int col = core.colName.find(tokens[2]);
+        if (col < 0) {
+            message = "unknown column " + tokens[2];
+            return -1;
+        }
+        if (type != "UP" && type != "PL")
+            changes.push_back(Change{kLower, -1, col, value});
+        if (type != "LO" && type != "MI")
+            changes.push_back(Change{kUpper, -1, col, value});
+        return needsValue ? 4 : 3;
+    }
+
+    if (tokens.size() < 3) {
+        message = "expected column or rhs set, row and value";
+        return -1;
+    }
+    int col = core.colName.find(tokens[0]);
+    std::size_t t = 1;
+    do {
+        double value;
+        if (!parseNumber(tokens[t + 1], value)) {
+            message = "bad value " + tokens[t + 1];
+            return -1;
+        }
+        if (tokens[t] == objName) {
+            changes.push_back(Change{col >= 0 ? kObj : kObjConstant, -1, col, value});
+        } else {
+            int row = core.rowName.find(tokens[t]);
+            if (row < 0) {
+                message = "unknown row " + tokens[t];
+                return -1;
+            }
+            changes.push_back(Change{col >= 0 ? kCoeff : kRhs, row, col, value});
+        }
+        t += 2;
+    } while (allowSecondPair && t + 1 < tokens.size());
+    return static_cast<int>(t);
+}
+
+static ChangeKey keyOf(const Change& change)
+{
+    return ChangeKey(change.kind, change.row, change.col);
+}
+
+static int readStochFile(const std::string& path, const std::string& text, const std::string& objName,
+    ScenarioSet& set, int numThreads, int maxScenarios)
+{
+    const ProblemInstance& core = set.core;
+    int errors = 0;
+    auto error = [&](int line, const std::string& message) {
+        std::cout << path << ":" << line << ": " << message << std::endl;
+        errors++;
+    };
+
+    std::string section;
+    int modifier = kReplace;
+    std::vector<ScenarioNode> nodes;
+    std::unordered_map<std::string, int> nodeIndex;
+    std::vector<RandomBlock> blocks;
+    std::map<std::string, int> blockIndex; // INDEP element ("column row") or BLOCKS block name
+    Realization* realization = nullptr;    // the BL being read
+    bool mixedModifiers = false;
+
+    forEachLine(text, [&](const std::vector<std::string>& tokens, int line, bool isHeader) {
+        if (isHeader) {
+            section = upper(tokens[0]);
+            if (section == "SCENARIOS" || section == "INDEP" || section == "BLOCKS") {
+                std::string distribution = tokens.size() > 1 ? upper(tokens[1]) : "DISCRETE";
+                if (distribution != "DISCRETE")
+                    error(line, "only DISCRETE distributions are supported, not " + distribution);
+                std::string mode = tokens.size() > 2 ? upper(tokens[2]) : "REPLACE";
+                int next = mode == "ADD" ? kAdd : mode == "MULTIPLY" ? kMultiply : kReplace;
+                mixedModifiers |= (!nodes.empty() || !blocks.empty()) && next != modifier;
+                modifier = next;
+            } else if (section != "NAME" && section != "ENDATA") {
+                error(line, "unsupported section " + section);
+            }
+            realization = nullptr;
+            return section != "ENDATA";
+        }
+
+        std::string message;
+        std::string first = upper(tokens[0]);
+        if (section == "SCENARIOS" && first == "SC") {
+            double probability;
+            if (tokens.size() < 5 || !parseNumber(tokens[3], probability)) {
+                error(line, "expected SC name parent probability period");
+                return true;
+            }
+            int parent = -1;
+            if (upper(tokens[2]) != "ROOT" && tokens[2] != "'ROOT'") {
+                auto it = nodeIndex.find(tokens[2]);
+                if (it == nodeIndex.end()) {
+                    error(line, "unknown parent scenario " + tokens[2]);
+                    return true;
+                }
+                parent = it->second;
+            }
+            int period = periodIndex(set, tokens[4]);
+            if (period < 0) {
+                error(line, "unknown period " + tokens[4]);
+                return true;
+            }
+            nodeIndex.emplace(tokens[1], static_cast<int>(nodes.size()));
+            nodes.push_back(ScenarioNode{tokens[1], parent, period, probability, {}});
+        } else if (section == "SCENARIOS") {
+            if (nodes.empty())
+                error(line, "entry before the first SC line");
+            else if (parseEntry(tokens, true, core, objName, nodes.back().changes, message) < 0)
+                error(line, message);
+        } else if (section == "BLOCKS" && first == "BL") {
+            double probability;
+            int period = tokens.size() >= 4 ? periodIndex(set, tokens[2]) : -1;
+            if (tokens.size() < 4 || !parseNumber(tokens[3], probability) || period < 0) {
+                error(line, "expected BL block period probability");
+                return true;
+            }
+            auto inserted = blockIndex.emplace(tokens[1], static_cast<int>(blocks.size()));
+            if (inserted.second)
+                blocks.push_back(RandomBlock{tokens[1], period, {}});
+            RandomBlock& block = blocks[inserted.first->second];
+            block.realizations.push_back(Realization{probability, {}});
+            realization = &block.realizations.back();
+        } else if (section == "BLOCKS") {
+            if (!realization)
+                error(line, "entry before the first BL line");
+            else if (parseEntry(tokens, true, core, objName, realization->changes, message) < 0)
+                error(line, message);
+        } else if (section == "INDEP") {
+            // an entry followed by its period and probability
+            std::vector<Change> changes;
+            int used = parseEntry(tokens, false, core, objName, changes, message);
+            double probability;
+            int period = used > 0 && used + 1 < static_cast<int>(tokens.size()) ? periodIndex(set, tokens[used]) : -1;
+            if (used < 0 || period < 0 || !parseNumber(tokens[used + 1], probability)) {
+                error(line, used < 0 ? message : "expected entry, period and probability");
+                return true;
+            }
+            std::string element = tokens[used - 3] + " " + tokens[used - 2];
+            if (first == "UP" || first == "LO" || first == "FX" || first == "MI" || first == "PL")
+                element = first + " " + tokens[2];
+            auto inserted = blockIndex.emplace(element, static_cast<int>(blocks.size()));
+            if (inserted.second)
+                blocks.push_back(RandomBlock{element, period, {}});
+            blocks[inserted.first->second].realizations.push_back(Realization{probability, changes});
+        }
+        return true;
+    });
+    if (mixedModifiers)
+        error(0, "sections with different modifiers");
+    if (!nodes.empty() && !blocks.empty())
+        error(0, "SCENARIOS together with INDEP or BLOCKS sections");
+    if (nodes.empty() && blocks.empty())
+        error(0, "no scenarios");
+    if (errors > 0)
+        return errors;
+
+    if (!nodes.empty()) {
+        // every scenario walks its own path from the root, so they resolve independently
+        set.scenarios.resize(nodes.size());
+        parallelFor(static_cast<int>(nodes.size()), numThreads, [&](int s) {
+            std::vector<int> path;
+            for (int n = s; n >= 0; n = nodes[n].parent)
+                path.push_back(n);
+            std::reverse(path.begin(), path.end());
+            std::map<ChangeKey, double> values;
+            for (std::size_t p = 0; p < path.size(); p++) {
+                const ScenarioNode& node = nodes[path[p]];
+                if (p > 0) {
+                    for (auto it = values.begin(); it != values.end();)
+                        it = keyPeriod(set, it->first) >= node.period ? values.erase(it) : std::next(it);
+                }
+                for (const Change& change : node.changes)
+                    values[keyOf(change)] = resolveValue(core, change, modifier);
+            }
+            Scenario& scenario = set.scenarios[s];
+            scenario.name = nodes[s].name;
+            scenario.parent = nodes[s].parent;
+            scenario.period = nodes[s].period;
+            scenario.probability = nodes[s].probability;
+            emitScenario(core, values, scenario);
+        });
+        return 0;
+    }
+
+    // INDEP and BLOCKS: one scenario per combination, block 0 varying slowest
+    double count = 1.0;
+    for (const RandomBlock& block : blocks)
+        count *= block.realizations.size();
+    if (count > maxScenarios) {
+        std::cout << path << ": " << count << " scenarios, more than the limit of " << maxScenarios << std::endl;
+        return 1;
+    }
+    set.scenarios.resize(static_cast<std::size_t>(count));
+    parallelFor(static_cast<int>(count), numThreads, [&](int s) {
+        Scenario& scenario = set.scenarios[s];
+        scenario.name = "S" + std::to_string(s + 1);
+        scenario.period = static_cast<int>(set.periods.size());
+        scenario.probability = 1.0;
+        std::map<ChangeKey, double> values;
+        int rest = s;
+        for (int b = static_cast<int>(blocks.size()) - 1; b >= 0; b--) {
+            int outcomes = static_cast<int>(blocks[b].realizations.size());
+            const Realization& chosen = blocks[b].realizations[rest % outcomes];
+            rest /= outcomes;
+            scenario.probability *= chosen.probability;
+            scenario.period = std::min(scenario.period, blocks[b].period);
+            for (const Change& change : chosen.changes)
+                values[keyOf(change)] = resolveValue(core, change, modifier);
+        }
+        emitScenario(core, values, scenario);
+    });
+    return 0;
+}
+
+int readSmps(const std::string& path, ScenarioSet& set, int numThreads, int maxScenarios)
+{
+    std::string base = smpsBaseName(path);
+    std::string corePath = findSmpsFile(base, {".cor", ".core", ".COR"});
+    std::string timePath = findSmpsFile(base, {".tim", ".time", ".TIM"});
+    std::string stochPath = findSmpsFile(base, {".sto", ".stoch", ".STO"});
+    if (corePath.empty() || timePath.empty() || stochPath.empty()) {
+        std::cout << "Cannot find the " << (corePath.empty() ? "core" : timePath.empty() ? "time" : "stochastic")
+                  << " file of " << base << std::endl;
+        return 1;
+    }
+
+    set = ScenarioSet();
+    std::string coreText, timeText, stochText;
+    if (!readTextFile(corePath, coreText) || !readTextFile(timePath, timeText) ||
+        !readTextFile(stochPath, stochText))
+        return 1;
+    int errors = readMpsText(coreText, set.core, numThreads);
+    if (errors > 0)
+        return errors;
+    std::string objName = objectiveRowName(coreText);
+    errors = readTimeFile(timePath, timeText, objName, set);
+    if (errors > 0)
+        return errors;
+    return readStochFile(stochPath, stochText, objName, set, numThreads, maxScenarios);
+}
+
+// Row bounds for new right hand sides, keeping each row's sense and range.
+static std::vector<double> rhsBounds(const ProblemInstance& core, const std::vector<int>& rows,
+    const std::vector<double>& rhs)
+{
+    std::vector<double> bounds(2 * rows.size());
+    for (std::size_t k = 0; k < rows.size(); k++)
+        senseToRowBounds(core.rowtypes[rows[k]], rhs[k], core.rhsrange[rows[k]], bounds[2 * k], bounds[2 * k + 1]);
+    return bounds;
+}
+
+static std::vector<double> interleave(const std::vector<double>& lower, const std::vector<double>& upper)
+{
+    std::vector<double> bounds(2 * lower.size());
+    for (std::size_t k = 0; k < lower.size(); k++) {
+        bounds[2 * k] = lower[k];
+        bounds[2 * k + 1] = upper[k];
+    }
+    return bounds;
+}
+
+void applyScenario(const ScenarioSet& set, int scenario, OsiClpSolverInterface& solver)
+{
+    const Scenario& s = set.scenarios[scenario];
+    if (!s.rhsRows.empty()) {
+        std::vector<double> bounds = rhsBounds(set.core, s.rhsRows, s.rhs);
+        solver.setRowSetBounds(s.rhsRows.data(), s.rhsRows.data() + s.rhsRows.size(), bounds.data());
+    }
+    for (std::size_t k = 0; k < s.coeffRows.size(); k++)
+        solver.modifyCoefficient(s.coeffRows[k], s.coeffCols[k], s.coeffs[k]);
+    if (!s.objCols.empty())
+        solver.setObjCoeffSet(s.objCols.data(), s.objCols.data() + s.objCols.size(), s.objCoeffs.data());
+    if (!s.boundCols.empty()) {
+        std::vector<double> bounds = interleave(s.lower, s.upper);
+        solver.setColSetBounds(s.boundCols.data(), s.boundCols.data() + s.boundCols.size(), bounds.data());
+    }
+    if (s.objOffset != set.core.objOffset)
+        solver.setDblParam(OsiObjOffset, -s.objOffset);
+}
+
+void restoreCore(const ScenarioSet& set, int scenario, OsiClpSolverInterface& solver)
+{
+    const ProblemInstance& core = set.core;
+    const Scenario& s = set.scenarios[scenario];
+    if (!s.rhsRows.empty()) {
+        std::vector<double> rhs(s.rhsRows.size());
+        for (std::size_t k = 0; k < rhs.size(); k++)
+            rhs[k] = core.rhs[s.rhsRows[k]];
+        std::vector<double> bounds = rhsBounds(core, s.rhsRows, rhs);
+        solver.setRowSetBounds(s.rhsRows.data(), s.rhsRows.data() + s.rhsRows.size(), bounds.data());
+    }
+    for (std::size_t k = 0; k < s.coeffRows.size(); k++)
+        solver.modifyCoefficient(s.coeffRows[k], s.coeffCols[k], coreCoefficient(core, s.coeffRows[k], s.coeffCols[k]));
+    if (!s.objCols.empty()) {
+        std::vector<double> obj(s.objCols.size());
+        for (std::size_t k = 0; k < obj.size(); k++)
+            obj[k] = core.objCoeffs[s.objCols[k]];
+        solver.setObjCoeffSet(s.objCols.data(), s.objCols.data() + s.objCols.size(), obj.data());
+    }
+    if (!s.boundCols.empty()) {
+        std::vector<double> bounds(2 * s.boundCols.size());
+        for (std::size_t k = 0; k < s.boundCols.size(); k++) {
+            bounds[2 * k] = core.lb[s.boundCols[k]];
+            bounds[2 * k + 1] = core.ub[s.boundCols[k]];
+        }
+        solver.setColSetBounds(s.boundCols.data(), s.boundCols.data() + s.boundCols.size(), bounds.data());
+    }
+    if (s.objOffset != core.objOffset)
+        solver.setDblParam(OsiObjOffset, -core.objOffset);
+}
+
+static void collectLpResult(const OsiClpSolverInterface& solver, bool keepSolution, BatchResult& result)
+{
+    result.iterations = solver.getIterationCount();
+    if (solver.isProvenOptimal()) {
+        result.status = BatchStatus::Optimal;
+        result.hasSolution = true;
+        result.objValue = result.bestBound = solver.getObjValue();
+        if (keepSolution)
+            result.solution.assign(solver.getColSolution(), solver.getColSolution() + solver.getNumCols());
+    } else if (solver.isProvenPrimalInfeasible()) {
+        result.status = BatchStatus::Infeasible;
+    } else {
+        result.status = BatchStatus::Stopped;
+        result.message = solver.isProvenDualInfeasible() ? "unbounded" : "LP stopped";
+    }
+}
+
+// Solves the scenario the solver holds: its LP, from the basis it has, and
+// the MIP on top of it if asked to.
+static void solveLoaded(OsiClpSolverInterface& solver, bool warm, bool integer, const ScenarioSolveOptions& options,
+    BatchResult& result)
+{
+    if (warm)
+        solver.resolve();
+    else
+        solver.initialSolve();
+    collectLpResult(solver, options.keepSolutions && !integer, result);
+    if (!integer || result.status != BatchStatus::Optimal)
+        return;
+
+    int lpIterations = result.iterations;
+    result.hasSolution = false;
+    result.solution.clear();
+    CbcModel model(solver);
+    model.setLogLevel(0);
+    model.setUseElapsedTime(true);
+    if (options.timeLimit > 0.0)
+        model.setMaximumSeconds(options.timeLimit);
+    model.setNumberThreads(0);
+    model.branchAndBound();
+    collectBatchResult(model, false, options.keepSolutions, result);
+    result.iterations += lpIterations;
+}
+
+ScenarioSolveResult solveScenarios(const ScenarioSet& set, const ScenarioSolveOptions& options)
+{
+    ScenarioSolveResult result;
+    int numScenarios = static_cast<int>(set.scenarios.size());
+    result.scenarios.resize(numScenarios);
+    for (int s = 0; s < numScenarios; s++) {
+        result.scenarios[s].jobId = s;
+        result.scenarios[s].name = set.scenarios[s].name;
+    }
+    if (numScenarios == 0)
+        return result;
+
+    OsiClpSolverInterface core;
+    loadProblemData(set.core, core, false);
+    core.messageHandler()->setLogLevel(0);
+    bool integer = !options.relax &&
+        std::any_of(set.core.varTypes.begin(), set.core.varTypes.end(), [](char type) { return type != 'C'; });
+    std::unique_ptr<CoinWarmStart> coreBasis;
+    if (options.warmStart) {
+        auto start = std::chrono::steady_clock::now();
+        core.initialSolve();
+        result.coreSeconds = secondsSince(start);
+        result.coreIterations = core.getIterationCount();
+        coreBasis.reset(core.getWarmStart());
+    }
+
+    // one solver per thread, copied up front; the shared core is not touched by the workers
+    int numThreads = std::min(options.numThreads <= 0 ? defaultThreadCount() : options.numThreads, numScenarios);
+    std::vector<std::unique_ptr<OsiClpSolverInterface>> workers;
+    for (int w = 0; w < numThreads; w++)
+        workers.push_back(std::make_unique<OsiClpSolverInterface>(core));
+
+    std::atomic<int> next(0);
+    auto start = std::chrono::steady_clock::now();
+    parallelFor(numThreads, numThreads, [&](int w) {
+        for (int s = next++; s < numScenarios; s = next++) {
+            BatchResult& scenario = result.scenarios[s];
+            auto solveStart = std::chrono::steady_clock::now();
+            if (options.warmStart) {
+                OsiClpSolverInterface& solver = *workers[w];
+                applyScenario(set, s, solver);
+                solver.setWarmStart(coreBasis.get());
+                solveLoaded(solver, true, integer, options, scenario);
+                restoreCore(set, s, solver);
+            } else {
+                OsiClpSolverInterface solver(*workers[w]);
+                applyScenario(set, s, solver);
+                solveLoaded(solver, false, integer, options, scenario);
+            }
+            scenario.solveSeconds = secondsSince(solveStart);
+        }
+    });
+    result.seconds = secondsSince(start);
+    result.scenariosPerSecond = numScenarios / std::max(1e-9, result.seconds);
+
+    for (int s = 0; s < numScenarios; s++) {
+        const BatchResult& scenario = result.scenarios[s];
+        if (scenario.status != BatchStatus::Optimal)
+            continue;
+        result.numOptimal++;
+        result.expectedObjective += set.scenarios[s].probability * scenario.objValue;
+        result.optimalProbability += set.scenarios[s].probability;
+    }
+    return result;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "batch_solver.h"
+#include "problem_instance.h"
+
+#include <string>
+#include <vector>
+
+class OsiClpSolverInterface;
+
+/*
+  One scenario of a stochastic program: the entries of the core model it
+  changes, with the values that replace the core's (ADD and MULTIPLY
+  modifiers already resolved, values inherited from the parent scenario
+  included), sorted by row and column. Everything else is the core's, so a
+  scenario of a large model costs a few dozen numbers, not a copy of it.
+*/
+struct Scenario
+{
+    std::string name;
+    int parent = -1;          // scenario it branches from, -1 for ROOT
+    int period = 0;           // first period in which it differs from the parent
+    double probability = 0.0; // of the whole path, as in the SCENARIOS section
+
+    std::vector<int> rhsRows;
+    std::vector<double> rhs;
+    std::vector<int> coeffRows;
+    std::vector<int> coeffCols;
+    std::vector<double> coeffs;
+    std::vector<int> objCols;
+    std::vector<double> objCoeffs;
+    std::vector<int> boundCols;
+    std::vector<double> lower;
+    std::vector<double> upper;
+    double objOffset = 0.0;   // the core's unless an RHS entry on the objective row changes it
+
+    int numChanges() const;
+};
+
+struct ScenarioSet
+{
+    ProblemInstance core;
+    std::vector<std::string> periods; // in time order
+    std::vector<int> rowPeriod;       // period of each core row
+    std::vector<int> colPeriod;       // period of each core column
+    std::vector<Scenario> scenarios;
+
+    double totalProbability() const;
+};
+
+/*
+  Reads an SMPS triplet: the core (.cor/.core, an MPS file), the time file
+  (.tim/.time) and the stochastic file (.sto/.stoch), each optionally
+  gzipped. path is the common base name or any one of the three files.
+
+    ScenarioSet set;
+    if (readSmps("Data/Sample/app0110", set) != 0)
+        return 1;
+    ScenarioSolveResult result = solveScenarios(set);
+
+  The time file may be implicit (PERIODS: first column and row of each
+  period, in core order) or explicit (ROWS and COLUMNS sections naming the
+  period of each entry). The stochastic file may hold SCENARIOS, INDEP or
+  BLOCKS sections with DISCRETE distributions and the REPLACE (default),
+  ADD or MULTIPLY modifier. Entries are "column row value" for a
+  coefficient (the objective row for a cost), "rhs-set row value" for a
+  right hand side and "UP|LO|FX bound-set column value" for a bound.
+
+  Scenarios of a SCENARIOS section keep the values of their parent in the
+  periods before their own period and override them with their entries.
+  INDEP and BLOCKS sections expand into the product of their
+  distributions, one scenario per combination; maxScenarios caps that
+  expansion. The core is read on numThreads threads (readMpsText) and the
+  scenarios are expanded on numThreads threads, one scenario at a time.
+
+  Returns the number of errors (0 on success), each one printed.
+*/
+int readSmps(const std::string& path, ScenarioSet& set, int numThreads = 0, int maxScenarios = 1000000);
+
+// Sets the values of one scenario on a solver that holds the core, and puts
+// the core's values back for the same entries afterwards, so that one
+// solver can go through many scenarios without reloading the core.
+void applyScenario(const ScenarioSet& set, int scenario, OsiClpSolverInterface& solver);
+void restoreCore(const ScenarioSet& set, int scenario, OsiClpSolverInterface& solver);
+
+struct ScenarioSolveOptions
+{
+    int numThreads = 0;         // scenarios solved at once, <= 0 for every core
+    bool warmStart = true;      // each LP starts from the optimal basis of the core
+    bool relax = false;         // solve the LP relaxation even if the core has integers
+    double timeLimit = 0.0;     // wall seconds per MIP, <= 0 for none
+    bool keepSolutions = false;
+};
+
+struct ScenarioSolveResult
+{
+    std::vector<BatchResult> scenarios; // jobId is the scenario index
+    int numOptimal = 0;
+    double expectedObjective = 0.0; // probability-weighted, over the optimal scenarios
+    double optimalProbability = 0.0; // the probability they cover
+    double coreSeconds = 0.0;       // the LP of the core, done once before the scenarios
+    int coreIterations = 0;
+    double seconds = 0.0;           // wall time of the scenarios
+    double scenariosPerSecond = 0.0;
+};
+
+/*
+  Solves every scenario of the set on numThreads threads. Each thread keeps
+  one OsiClpSolverInterface cloned from the solved core and walks through
+  the scenarios that it takes from a shared counter: apply the scenario,
+  reset the basis to the core's optimal one, re-solve with the dual simplex
+  (most scenarios change right hand sides, which keeps that basis dual
+  feasible), put the core back. A core with integers gets a CbcModel per
+  scenario on top of that LP, unless options.relax is set.
+
+  Without warmStart every scenario is solved from scratch on a fresh clone
+  of the unsolved core, the baseline the warm start is measured against.
+*/
+ScenarioSolveResult solveScenarios(const ScenarioSet& set, const ScenarioSolveOptions& options = {});
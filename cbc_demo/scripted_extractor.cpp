@@ -0,0 +1,177 @@
+#include "scripted_extractor.h"
+#include "name_table.h"
+#include "problem_snapshot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+ScriptedExtractor::ScriptedExtractor()
+{
+    recording_.numCols = recording_.numRows = 0;
+    recording_.numNonZeros = 0;
+    recording_.objSense = 1;
+    recording_.rowStart.assign(1, 0);
+}
+
+ScriptedExtractor::ScriptedExtractor(const ProblemInstance& recording)
+    : recording_(widenProblemInstance(recording))
+{
+}
+
+ScriptedExtractor::ScriptedExtractor(ProblemInstance64 recording)
+    : recording_(std::move(recording))
+{
+}
+
+bool ScriptedExtractor::open(const std::string& snapshotPath)
+{
+    ProblemSnapshot snapshot;
+    if (!snapshot.open(snapshotPath)) {
+        std::cout << "Cannot replay " << snapshotPath << std::endl;
+        return false;
+    }
+    ProblemInstance64 data;
+    data.numCols = snapshot.numCols;
+    data.numRows = snapshot.numRows;
+    data.numNonZeros = snapshot.numNonZeros;
+    data.objSense = snapshot.objSense;
+    data.objOffset = snapshot.objOffset;
+    data.varTypes.assign(snapshot.varTypes.begin(), snapshot.varTypes.end());
+    data.lb.assign(snapshot.lb.begin(), snapshot.lb.end());
+    data.ub.assign(snapshot.ub.begin(), snapshot.ub.end());
+    data.objCoeffs.assign(snapshot.objCoeffs.begin(), snapshot.objCoeffs.end());
+    data.rowtypes.assign(snapshot.rowtypes.begin(), snapshot.rowtypes.end());
+    data.rhs.assign(snapshot.rhs.begin(), snapshot.rhs.end());
+    data.rhsrange.assign(snapshot.rhsrange.begin(), snapshot.rhsrange.end());
+    if (snapshot.offsetBytes == 8)
+        data.rowStart.assign(snapshot.rowStart64.begin(), snapshot.rowStart64.end());
+    else
+        data.rowStart.assign(snapshot.rowStart.begin(), snapshot.rowStart.end());
+    data.colIdxs.assign(snapshot.colIdxs.begin(), snapshot.colIdxs.end());
+    data.colCoeffs.assign(snapshot.colCoeffs.begin(), snapshot.colCoeffs.end());
+
+    // snapshots store an empty name for each column of a model without names
+    bool colNames = false, rowNames = false;
+    for (int j = 0; j < data.numCols && !colNames; j++)
+        colNames = snapshot.colName(j)[0] != '\0';
+    for (int i = 0; i < data.numRows && !rowNames; i++)
+        rowNames = snapshot.rowName(i)[0] != '\0';
+    for (int j = 0; colNames && j < data.numCols; j++)
+        data.colName.push_back(snapshot.colName(j));
+    for (int i = 0; rowNames && i < data.numRows; i++)
+        data.rowName.push_back(snapshot.rowName(i));
+    recording_ = std::move(data);
+    return true;
+}
+
+bool ScriptedExtractor::call()
+{
+    if (callLatency_ > 0.0) {
+        // spin, sleeping is far coarser than an API call
+        auto until = std::chrono::steady_clock::now() + std::chrono::duration<double>(callLatency_);
+        while (std::chrono::steady_clock::now() < until) {
+        }
+    }
+    return numCalls_++ != failingCall_;
+}
+
+double ScriptedExtractor::coefficient(int row, int col)
+{
+    call();
+    const int* first = recording_.colIdxs.data() + recording_.rowStart[row];
+    const int* last = recording_.colIdxs.data() + recording_.rowStart[row + 1];
+    const int* found = std::find(first, last, col);
+    return found == last ? 0.0 : recording_.colCoeffs[found - recording_.colIdxs.data()];
+}
+
+int ScriptedExtractor::numCols()
+{
+    return call() ? recording_.numCols : -1;
+}
+
+int ScriptedExtractor::numRows()
+{
+    return call() ? recording_.numRows : -1;
+}
+
+std::int64_t ScriptedExtractor::numNonZeros()
+{
+    return call() ? recording_.numNonZeros : -1;
+}
+
+bool ScriptedExtractor::getObjectiveSense(int& sense, double& offset)
+{
+    sense = recording_.objSense;
+    offset = recording_.objOffset;
+    return call();
+}
+
+bool ScriptedExtractor::getColumns(char* types, double* lower, double* upper, double* objective)
+{
+    if (!call())
+        return false;
+    std::copy(recording_.varTypes.begin(), recording_.varTypes.end(), types);
+    std::copy(recording_.lb.begin(), recording_.lb.end(), lower);
+    std::copy(recording_.ub.begin(), recording_.ub.end(), upper);
+    std::copy(recording_.objCoeffs.begin(), recording_.objCoeffs.end(), objective);
+    return true;
+}
+
+bool ScriptedExtractor::getRowBounds(char* sense, double* rhs, double* range)
+{
+    if (!call())
+        return false;
+    std::copy(recording_.rowtypes.begin(), recording_.rowtypes.end(), sense);
+    std::copy(recording_.rhs.begin(), recording_.rhs.end(), rhs);
+    if (recording_.rhsrange.empty())
+        std::fill(range, range + recording_.numRows, 0.0);
+    else
+        std::copy(recording_.rhsrange.begin(), recording_.rhsrange.end(), range);
+    return true;
+}
+
+bool ScriptedExtractor::getRows(int first, int last, std::int64_t* rowStart, int* colIdxs, double* values,
+    std::int64_t capacity)
+{
+    const int step = rowsPerCall_ > 0 ? rowsPerCall_ : std::max(1, last - first);
+    const std::int64_t base = recording_.rowStart[first];
+    rowStart[0] = 0;
+    for (int i = first; i < last; i += step) {
+        if (!call())
+            return false;
+        int end = std::min(last, i + step);
+        std::int64_t from = recording_.rowStart[i], to = recording_.rowStart[end];
+        if (to - base > capacity)
+            return false;
+        std::copy(recording_.colIdxs.begin() + from, recording_.colIdxs.begin() + to, colIdxs + (from - base));
+        std::copy(recording_.colCoeffs.begin() + from, recording_.colCoeffs.begin() + to, values + (from - base));
+        for (int r = i; r < end; r++)
+            rowStart[r - first + 1] = recording_.rowStart[r + 1] - base;
+    }
+    return true;
+}
+
+bool ScriptedExtractor::getColNames(NameTable& names)
+{
+    if (!call() || recording_.colName.empty())
+        return false;
+    for (int j = 0; j < recording_.colName.size(); j++)
+        names.push_back(recording_.colName[j]);
+    return true;
+}
+
+bool ScriptedExtractor::getRowNames(NameTable& names)
+{
+    if (!call() || recording_.rowName.empty())
+        return false;
+    for (int i = 0; i < recording_.rowName.size(); i++)
+        names.push_back(recording_.rowName[i]);
+    return true;
+}
+
+bool recordModel(ModelExtractor& source, const std::string& snapshotPath)
+{
+    ProblemInstance64 data;
+    return extractProblemData(source, data) && writeSnapshot(data, snapshotPath);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "model_extractor.h"
+#include "problem_instance.h"
+
+#include <string>
+
+/*
+  A ModelExtractor that replays a recorded model from memory, so every
+  extraction path can be tested and benchmarked without a commercial
+  solver or its license. A recording is a ProblemInstance, given directly or
+  read from a snapshot file (problem_snapshot.h) that recordModel wrote from
+  any backend.
+
+  It can play the backend's costs too: every call counts as a call into the
+  backend and spends callLatency seconds, as an API round trip would; rows
+  come back rowsPerCall per backend call (1 is Gurobi's getRow, 0 all at
+  once like CPXXgetrows); coefficient() is the single coefficient probe the
+  old O(rows x cols) extraction loops over. setFailingCall makes one call
+  fail, for the error paths.
+
+    ScriptedExtractor source;
+    source.open("recorded.snap");
+    source.setRowsPerCall(1);
+    source.setCallLatency(2e-6);
+    ProblemInstance data;
+    extractProblemData(source, data);
+    std::cout << source.numCalls() << " calls" << std::endl;
+*/
+class ScriptedExtractor : public ModelExtractor
+{
+public:
+    ScriptedExtractor(); // an empty model until open()
+    explicit ScriptedExtractor(const ProblemInstance& recording);
+    explicit ScriptedExtractor(ProblemInstance64 recording);
+
+    // Replays a snapshot; false (printing why) if it can't be read.
+    bool open(const std::string& snapshotPath);
+    const ProblemInstance64& recording() const { return recording_; }
+
+    void setRowsPerCall(int rows) { rowsPerCall_ = rows; }
+    void setCallLatency(double seconds) { callLatency_ = seconds; }
+    void setFailingCall(long call) { failingCall_ = call; } // 0 based, < 0 none
+    long numCalls() const { return numCalls_; }
+    void resetCalls() { numCalls_ = 0; }
+
+    // The coefficient at (row, col), 0 if there is none; one backend call.
+    double coefficient(int row, int col);
+
+    const char* backendName() const override { return "scripted"; }
+    int numCols() override;
+    int numRows() override;
+    std::int64_t numNonZeros() override;
+    bool getObjectiveSense(int& sense, double& offset) override;
+    bool getColumns(char* types, double* lower, double* upper, double* objective) override;
+    bool getRowBounds(char* sense, double* rhs, double* range) override;
+    bool getRows(int first, int last, std::int64_t* rowStart, int* colIdxs, double* values,
+        std::int64_t capacity) override;
+    bool getColNames(NameTable& names) override;
+    bool getRowNames(NameTable& names) override;
+
+private:
+    // One call into the backend: counted, latency spent; false if it is the failing one.
+    bool call();
+
+    ProblemInstance64 recording_;
+    int rowsPerCall_ = 0;
+    double callLatency_ = 0.0;
+    long failingCall_ = -1;
+    long numCalls_ = 0;
+};
+
+// Extracts source and writes it as a snapshot for ScriptedExtractor::open.
+bool recordModel(ModelExtractor& source, const std::string& snapshotPath);
@@ -0,0 +1,428 @@
+#include "solve_telemetry.h"
+
+#include "CbcModel.hpp"
+#include "CbcCutGenerator.hpp"
+#include "CbcEventHandler.hpp"
+#include "CbcTree.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+struct TelemetryRing
+{
+    explicit TelemetryRing(std::size_t capacity, std::uint32_t index)
+        : slots(new TelemetryRecord[capacity]), mask(capacity - 1), thread(index)
+    {
+    }
+
+    std::unique_ptr<TelemetryRecord[]> slots;
+    std::uint64_t mask;
+    std::uint32_t thread;
+    std::atomic<std::uint64_t> dropped{0};
+    alignas(64) std::atomic<std::uint64_t> head{0}; // next slot to write, producer only
+    alignas(64) std::atomic<std::uint64_t> tail{0}; // next slot to read, flusher only
+};
+
+static std::atomic<std::uint64_t> nextTelemetryId(1);
+
+static std::int64_t steadyNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Collects records for one CbcModel; CBC clones it into every thread model.
+class TelemetryEventHandler : public CbcEventHandler
+{
+public:
+    TelemetryEventHandler(CbcModel* model, SolveTelemetry* telemetry) : CbcEventHandler(model), telemetry_(telemetry) {}
+
+    CbcAction event(CbcEvent whichEvent) override
+    {
+        if (telemetry_->enabled() && model_)
+            onEvent(whichEvent);
+        return noAction;
+    }
+
+    CbcAction event(CbcEvent whichEvent, void*) override
+    {
+        if (telemetry_->enabled() && model_)
+            onEvent(whichEvent);
+        return noAction;
+    }
+
+    CbcEventHandler* clone() const override { return new TelemetryEventHandler(*this); }
+
+    // Emits a CutGenerator record for every generator that ran since its last one.
+    void recordGenerators(std::uint64_t now)
+    {
+        int count = model_->numberCutGenerators();
+        generatorSeconds_.resize(count, 0.0);
+        generatorCuts_.resize(count, 0);
+        for (int i = 0; i < count; i++) {
+            const CbcCutGenerator* generator = model_->cutGenerator(i);
+            double seconds = generator->timeInCutGenerator();
+            int cuts = generator->numberCutsInTotal();
+            if (seconds <= generatorSeconds_[i] && cuts <= generatorCuts_[i])
+                continue;
+            TelemetryRecord r = makeRecord(TelemetryEvent::CutGenerator, now);
+            r.bound = seconds - generatorSeconds_[i];
+            r.nodes = cuts - generatorCuts_[i];
+            r.extra = i;
+            telemetry_->record(r);
+            generatorSeconds_[i] = seconds;
+            generatorCuts_[i] = cuts;
+        }
+    }
+
+    TelemetryRecord makeRecord(TelemetryEvent event, std::uint64_t now) const
+    {
+        TelemetryRecord r;
+        r.timeNs = now;
+        r.event = event;
+        r.thread = 0;
+        r.incumbent = model_->bestSolution() ? model_->getObjValue() : std::numeric_limits<double>::quiet_NaN();
+        r.bound = std::numeric_limits<double>::quiet_NaN();
+        r.nodes = model_->getNodeCount();
+        r.extra = 0;
+        return r;
+    }
+
+    void recordBound(TelemetryEvent event, std::uint64_t now)
+    {
+        TelemetryRecord r = makeRecord(event, now);
+        r.bound = model_->getBestPossibleObjValue();
+        telemetry_->record(r);
+        lastBoundNs_ = now;
+    }
+
+private:
+    void onEvent(CbcEvent whichEvent)
+    {
+        std::uint64_t now = telemetry_->nowNs();
+        switch (whichEvent) {
+        case node: {
+            TelemetryRecord r = makeRecord(TelemetryEvent::Node, now);
+            r.extra = model_->tree() ? model_->tree()->size() : 0;
+            telemetry_->record(r);
+            if (now - lastBoundNs_ >= telemetry_->boundIntervalNs())
+                recordBound(TelemetryEvent::Bound, now);
+            break;
+        }
+        case solution:
+            recordBound(TelemetryEvent::Solution, now);
+            break;
+        case heuristicSolution:
+            recordBound(TelemetryEvent::HeuristicSolution, now);
+            break;
+        case heuristicPass:
+            telemetry_->record(makeRecord(TelemetryEvent::HeuristicPass, now));
+            break;
+        case generatedCuts:
+            telemetry_->record(makeRecord(TelemetryEvent::CutRound, now));
+            recordGenerators(now);
+            break;
+        case afterRootCuts:
+            recordBound(TelemetryEvent::RootCuts, now);
+            recordGenerators(now);
+            break;
+        default:
+            break;
+        }
+    }
+
+    SolveTelemetry* telemetry_;
+    std::uint64_t lastBoundNs_ = 0;
+    std::vector<double> generatorSeconds_;
+    std::vector<int> generatorCuts_;
+};
+
+SolveTelemetry::SolveTelemetry(std::size_t ringCapacity, int flushIntervalMs, int boundIntervalMs)
+    : id_(nextTelemetryId++),
+      flushIntervalMs_(std::max(1, flushIntervalMs)),
+      boundIntervalNs_(static_cast<std::uint64_t>(std::max(0, boundIntervalMs)) * 1000000),
+      startNs_(steadyNs())
+{
+    ringCapacity_ = 64;
+    while (ringCapacity_ < ringCapacity)
+        ringCapacity_ <<= 1;
+    flusher_ = std::thread(&SolveTelemetry::flushLoop, this);
+}
+
+SolveTelemetry::~SolveTelemetry()
+{
+    {
+        std::lock_guard<std::mutex> lock(flushMutex_);
+        stopping_ = true;
+    }
+    flushWake_.notify_all();
+    if (flusher_.joinable())
+        flusher_.join();
+}
+
+std::uint64_t SolveTelemetry::nowNs() const
+{
+    return static_cast<std::uint64_t>(steadyNs() - startNs_);
+}
+
+TelemetryRing* SolveTelemetry::ringForThisThread()
+{
+    // a few recent (telemetry, ring) pairs, so a thread can alternate between live
+    // instances without the lock; a miss looks the thread up in ringByThread_
+    struct RingCache
+    {
+        std::uint64_t owner = 0;
+        TelemetryRing* ring = nullptr;
+    };
+    static thread_local RingCache cache[4];
+    static thread_local unsigned nextSlot = 0;
+    for (const RingCache& entry : cache)
+        if (entry.owner == id_)
+            return entry.ring;
+
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    TelemetryRing*& ring = ringByThread_[std::this_thread::get_id()];
+    if (!ring) {
+        rings_.push_back(std::make_unique<TelemetryRing>(ringCapacity_, static_cast<std::uint32_t>(rings_.size())));
+        ring = rings_.back().get();
+    }
+    RingCache& entry = cache[nextSlot++ % 4];
+    entry.owner = id_;
+    entry.ring = ring;
+    return ring;
+}
+
+void SolveTelemetry::record(const TelemetryRecord& record)
+{
+    TelemetryRing* ring = ringForThisThread();
+    std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) > ring->mask) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TelemetryRecord& slot = ring->slots[head & ring->mask];
+    slot = record;
+    slot.thread = ring->thread;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void SolveTelemetry::drain()
+{
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    for (auto& ring : rings_) {
+        std::uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        std::uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; tail++)
+            records_.push_back(ring->slots[tail & ring->mask]);
+        ring->tail.store(tail, std::memory_order_release);
+    }
+}
+
+void SolveTelemetry::flushLoop()
+{
+    std::unique_lock<std::mutex> lock(flushMutex_);
+    while (!stopping_) {
+        flushWake_.wait_for(lock, std::chrono::milliseconds(flushIntervalMs_));
+        drain();
+    }
+}
+
+std::uint64_t SolveTelemetry::droppedRecords() const
+{
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    std::uint64_t dropped = 0;
+    for (const auto& ring : rings_)
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+    return dropped;
+}
+
+void SolveTelemetry::attach(CbcModel& model)
+{
+    generatorNames.clear();
+    for (int i = 0; i < model.numberCutGenerators(); i++) {
+        CbcCutGenerator* generator = model.cutGenerator(i);
+        generator->setTiming(true);
+        const char* name = generator->cutGeneratorName();
+        generatorNames.push_back(name ? name : "generator " + std::to_string(i));
+    }
+    // moreSpecialOptions2 bit 32: clone the handler into each thread model instead of sharing it
+    model.setMoreSpecialOptions2(model.moreSpecialOptions2() | 32);
+
+    TelemetryEventHandler handler(&model, this);
+    model.passInEventHandler(&handler);
+    if (enabled())
+        record(handler.makeRecord(TelemetryEvent::Start, nowNs()));
+}
+
+void SolveTelemetry::finish(CbcModel& model)
+{
+    if (enabled()) {
+        std::uint64_t now = nowNs();
+        if (auto* handler = dynamic_cast<TelemetryEventHandler*>(model.getEventHandler())) {
+            handler->recordGenerators(now);
+            handler->recordBound(TelemetryEvent::End, now);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(flushMutex_);
+        stopping_ = true;
+    }
+    flushWake_.notify_all();
+    if (flusher_.joinable())
+        flusher_.join();
+    drain();
+    std::stable_sort(records_.begin(), records_.end(),
+        [](const TelemetryRecord& a, const TelemetryRecord& b) { return a.timeNs < b.timeNs; });
+}
+
+// JSON has no NaN or infinity, and CBC uses 1e50 for "no value"
+static bool printable(double value)
+{
+    return std::isfinite(value) && std::fabs(value) < 1e49;
+}
+
+bool SolveTelemetry::writeChromeTrace(const std::string& path) const
+{
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        std::cout << "Cannot write " << path << std::endl;
+        return false;
+    }
+
+    std::uint32_t numThreads = 0;
+    for (const TelemetryRecord& r : records_)
+        numThreads = std::max(numThreads, r.thread + 1);
+    std::fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    std::fprintf(file, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"cbc\"}}");
+    for (std::uint32_t t = 0; t < numThreads; t++)
+        std::fprintf(file, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, "
+            "\"args\": {\"name\": \"solver thread %u\"}}", t, t);
+
+    // node counters at most once per millisecond and thread, the trace viewer chokes on more
+    std::vector<double> lastNodeUs(numThreads, -1e300);
+    double startUs = 0.0;
+    for (const TelemetryRecord& r : records_) {
+        double us = r.timeNs / 1000.0;
+        const char* instant = nullptr;
+        switch (r.event) {
+        case TelemetryEvent::Start:
+            startUs = us;
+            break;
+        case TelemetryEvent::Node:
+            if (us - lastNodeUs[r.thread] >= 1000.0) {
+                lastNodeUs[r.thread] = us;
+                std::fprintf(file, ",\n{\"name\": \"tree\", \"ph\": \"C\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, "
+                    "\"args\": {\"nodes\": %lld, \"open\": %lld}}", r.thread, us,
+                    static_cast<long long>(r.nodes), static_cast<long long>(r.extra));
+            }
+            break;
+        case TelemetryEvent::CutGenerator: {
+            const char* name = r.extra < static_cast<std::int64_t>(generatorNames.size())
+                ? generatorNames[r.extra].c_str() : "cut generator";
+            double durationUs = std::max(0.0, r.bound * 1e6);
+            std::fprintf(file, ",\n{\"name\": \"%s\", \"cat\": \"cuts\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, "
+                "\"ts\": %.3f, \"dur\": %.3f, \"args\": {\"cuts\": %lld}}", name, r.thread,
+                std::max(0.0, us - durationUs), durationUs, static_cast<long long>(r.nodes));
+            break;
+        }
+        case TelemetryEvent::Solution: instant = "solution"; break;
+        case TelemetryEvent::HeuristicSolution: instant = "heuristic solution"; break;
+        case TelemetryEvent::HeuristicPass: instant = "heuristic pass"; break;
+        case TelemetryEvent::CutRound: instant = "cut round"; break;
+        case TelemetryEvent::RootCuts: instant = "root cuts done"; break;
+        case TelemetryEvent::End:
+            std::fprintf(file, ",\n{\"name\": \"branchAndBound\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, "
+                "\"ts\": %.3f, \"dur\": %.3f, \"args\": {\"nodes\": %lld}}", r.thread, startUs, us - startUs,
+                static_cast<long long>(r.nodes));
+            break;
+        case TelemetryEvent::Bound:
+            break;
+        }
+        if (instant) {
+            std::fprintf(file, ",\n{\"name\": \"%s\", \"ph\": \"i\", \"s\": \"t\", \"pid\": 1, \"tid\": %u, "
+                "\"ts\": %.3f, \"args\": {\"nodes\": %lld", instant, r.thread, us, static_cast<long long>(r.nodes));
+            if (printable(r.incumbent))
+                std::fprintf(file, ", \"incumbent\": %.17g", r.incumbent);
+            std::fprintf(file, "}}");
+        }
+        bool hasObjective = r.event == TelemetryEvent::Bound || r.event == TelemetryEvent::Solution
+            || r.event == TelemetryEvent::HeuristicSolution || r.event == TelemetryEvent::RootCuts
+            || r.event == TelemetryEvent::End;
+        if (hasObjective && (printable(r.incumbent) || printable(r.bound))) {
+            std::fprintf(file, ",\n{\"name\": \"objective\", \"ph\": \"C\", \"pid\": 1, \"ts\": %.3f, \"args\": {", us);
+            if (printable(r.incumbent))
+                std::fprintf(file, "\"incumbent\": %.17g%s", r.incumbent, printable(r.bound) ? ", " : "");
+            if (printable(r.bound))
+                std::fprintf(file, "\"bound\": %.17g", r.bound);
+            std::fprintf(file, "}}");
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+    if (std::fclose(file) != 0) {
+        std::cout << "Write " << path << " failed" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static const char kCurveMagic[8] = {'C', 'B', 'C', 'C', 'U', 'R', 'V', 'E'};
+static const std::uint32_t kCurveVersion = 1;
+
+struct CurveHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t count;
+};
+
+bool SolveTelemetry::writeCurveLog(const std::string& path) const
+{
+    std::vector<CurvePoint> points;
+    for (const TelemetryRecord& r : records_) {
+        bool onCurve = r.event == TelemetryEvent::Start || r.event == TelemetryEvent::Bound
+            || r.event == TelemetryEvent::Solution || r.event == TelemetryEvent::HeuristicSolution
+            || r.event == TelemetryEvent::RootCuts || r.event == TelemetryEvent::End;
+        if (onCurve)
+            points.push_back(CurvePoint{r.timeNs * 1e-9, r.incumbent, r.bound, r.nodes});
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cout << "Cannot write " << path << std::endl;
+        return false;
+    }
+    CurveHeader header;
+    std::memcpy(header.magic, kCurveMagic, sizeof(kCurveMagic));
+    header.version = kCurveVersion;
+    header.reserved = 0;
+    header.count = points.size();
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+        && (points.empty() || std::fwrite(points.data(), sizeof(CurvePoint), points.size(), file) == points.size());
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok)
+        std::cout << "Write " << path << " failed" << std::endl;
+    return ok;
+}
+
+bool readCurveLog(const std::string& path, std::vector<CurvePoint>& points)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    CurveHeader header;
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1
+        && std::memcmp(header.magic, kCurveMagic, sizeof(kCurveMagic)) == 0 && header.version == kCurveVersion;
+    if (ok) {
+        points.resize(header.count);
+        ok = header.count == 0 || std::fread(points.data(), sizeof(CurvePoint), points.size(), file) == points.size();
+    }
+    std::fclose(file);
+    return ok;
+}
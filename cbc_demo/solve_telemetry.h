@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class CbcModel;
+
+enum class TelemetryEvent : std::uint32_t
+{
+    Start,              // attach()
+    Node,               // a node finished: nodes, tree size
+    Solution,           // new incumbent from the tree search
+    HeuristicSolution,  // new incumbent from a heuristic
+    HeuristicPass,
+    CutRound,           // a round of cut generation finished
+    RootCuts,           // root cut loop done, branching starts
+    CutGenerator,       // time and cuts a generator added since its last record
+    Bound,              // sampled best possible objective
+    End
+};
+
+// Fixed 48-byte record; the meaning of the payload depends on the event.
+struct TelemetryRecord
+{
+    std::uint64_t timeNs;      // since SolveTelemetry was created
+    TelemetryEvent event;
+    std::uint32_t thread;      // ring index, one ring per solver thread
+    double incumbent;          // best objective so far, NaN if none
+    double bound;              // Bound/Solution/End: best possible objective; CutGenerator: seconds
+    std::int64_t nodes;        // nodes so far; CutGenerator: cuts added
+    std::int64_t extra;        // Node: tree size; CutGenerator: generator index
+};
+
+struct TelemetryRing;
+
+/*
+  Solve instrumentation on top of CbcEventHandler. Every solver thread
+  writes TelemetryRecords into its own single-producer ring buffer (no locks,
+  no allocation after the first record); a flusher thread drains the rings
+  every flushIntervalMs. A full ring drops records and counts them instead
+  of blocking the solver.
+
+    SolveTelemetry telemetry;
+    telemetry.attach(model);       // after the cut generators are added
+    model.branchAndBound();
+    telemetry.finish(model);
+    telemetry.writeChromeTrace("solve.json");  // chrome://tracing, Perfetto
+    telemetry.writeCurveLog("solve.curve");    // incumbent/bound over time
+
+  Cut generators are timed with CbcCutGenerator::setTiming and reported as
+  deltas at each cut round; they are not wrapped, since CBC treats some
+  generators (probing) specially by type. The best bound walks the whole
+  tree, so it is sampled at most every boundIntervalMs per thread and at
+  every new incumbent. With setEnabled(false) the handler stays attached
+  but returns after one relaxed load.
+*/
+class SolveTelemetry
+{
+public:
+    explicit SolveTelemetry(std::size_t ringCapacity = 1 << 16, int flushIntervalMs = 20, int boundIntervalMs = 10);
+    ~SolveTelemetry();
+    SolveTelemetry(const SolveTelemetry&) = delete;
+    SolveTelemetry& operator=(const SolveTelemetry&) = delete;
+
+    // Installs the event handler and turns on cut generator timing.
+    void attach(CbcModel& model);
+    // After branchAndBound: final generator totals and the End record, then
+    // stops the flusher and drains the rings into records().
+    void finish(CbcModel& model);
+
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Called from the solver threads.
+    void record(const TelemetryRecord& record);
+    std::uint64_t nowNs() const;
+    std::uint64_t boundIntervalNs() const { return boundIntervalNs_; }
+
+    // Valid after finish(), in time order.
+    const std::vector<TelemetryRecord>& records() const { return records_; }
+    std::uint64_t droppedRecords() const;
+
+    bool writeChromeTrace(const std::string& path) const;
+    // Header {"CBCCURVE", version, count} then count x {seconds, incumbent, bound, nodes}.
+    bool writeCurveLog(const std::string& path) const;
+
+    std::vector<std::string> generatorNames; // filled by attach()
+
+private:
+    TelemetryRing* ringForThisThread();
+    void drain();
+    void flushLoop();
+
+    std::uint64_t id_;
+    std::size_t ringCapacity_;
+    int flushIntervalMs_;
+    std::uint64_t boundIntervalNs_;
+    std::int64_t startNs_;
+    std::atomic<bool> enabled_{true};
+
+    mutable std::mutex ringsMutex_;
+    std::vector<std::unique_ptr<TelemetryRing>> rings_;
+    std::unordered_map<std::thread::id, TelemetryRing*> ringByThread_;
+    std::vector<TelemetryRecord> records_;
+
+    std::mutex flushMutex_;
+    std::condition_variable flushWake_;
+    bool stopping_ = false;
+    std::thread flusher_;
+};
+
+struct CurvePoint
+{
+    double seconds;
+    double incumbent;
+    double bound;
+    std::int64_t nodes;
+};
+
+// Reads a file written by writeCurveLog; false if it is missing or malformed.
+bool readCurveLog(const std::string& path, std::vector<CurvePoint>& points);
@@ -0,0 +1,735 @@
+#include "subtree_solver.h"
+
+#include "parallel.h"
+#include "util.h"
+
+#include "CbcEventHandler.hpp"
+#include "CbcModel.hpp"
+#include "OsiSolverInterface.hpp"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// Bound changes against the model, all the coordinator knows of a subtree.
+struct Subtree
+{
+    int id = -1;
+    double bound = -COIN_DBL_MAX; // LP bound, minimization sense
+    std::vector<int> columns;
+    std::vector<double> lower;
+    std::vector<double> upper;
+    int branchColumn = -1;        // most fractional integer of the subtree's LP, not sent
+    double branchValue = 0.0;
+};
+
+// Best solution so far, minimization sense.
+struct Incumbent
+{
+    double objective = COIN_DBL_MAX;
+    std::vector<double> solution;
+
+    bool improve(double value, const double* values, int count)
+    {
+        if (value >= objective)
+            return false;
+        objective = value;
+        solution.assign(values, values + count);
+        return true;
+    }
+};
+
+// Whether a bound leaves nothing to find against the incumbent objective.
+static bool closedBy(double bound, double objective)
+{
+    return objective < COIN_DBL_MAX && bound >= objective - 1e-9 * std::max(1.0, std::fabs(objective));
+}
+
+/*
+  Splits subtrees by LP branching on the most fractional integer, best bound
+  first. Used by the coordinator to ramp up and by a worker to give away
+  part of its subtree.
+*/
+class LpSplitter
+{
+public:
+    explicit LpSplitter(const OsiSolverInterface& solver)
+        : lp_(solver.clone())
+    {
+        lp_->messageHandler()->setLogLevel(0);
+        lower_.assign(lp_->getColLower(), lp_->getColLower() + lp_->getNumCols());
+        upper_.assign(lp_->getColUpper(), lp_->getColUpper() + lp_->getNumCols());
+    }
+
+    // Replaces subtrees by at least target open ones, if they can be split that far.
+    void split(std::vector<Subtree>& subtrees, std::size_t target, Incumbent& best)
+    {
+        std::vector<Subtree> open;
+        for (Subtree& subtree : subtrees)
+            if (solve(subtree, best))
+                open.push_back(std::move(subtree));
+
+        while (open.size() < target) {
+            int pick = -1;
+            for (std::size_t i = 0; i < open.size(); i++) {
+                if (open[i].branchColumn >= 0 && !closedBy(open[i].bound, best.objective)
+                    && (pick < 0 || open[i].bound < open[pick].bound))
+                    pick = static_cast<int>(i);
+            }
+            if (pick < 0)
+                break;
+            Subtree parent = std::move(open[pick]);
+            open.erase(open.begin() + pick);
+            int column = parent.branchColumn;
+            for (int way = 0; way < 2; way++) {
+                Subtree child = parent;
+                if (way == 0)
+                    tighten(child, column, -COIN_DBL_MAX, std::floor(parent.branchValue));
+                else
+                    tighten(child, column, std::ceil(parent.branchValue), COIN_DBL_MAX);
+                if (solve(child, best))
+                    open.push_back(std::move(child));
+            }
+        }
+
+        // the solutions found on the way may have closed some
+        open.erase(std::remove_if(open.begin(), open.end(),
+            [&](const Subtree& subtree) { return closedBy(subtree.bound, best.objective); }), open.end());
+        std::sort(open.begin(), open.end(), [](const Subtree& a, const Subtree& b) { return a.bound < b.bound; });
+        subtrees = std::move(open);
+    }
+
+    int numLps() const { return numLps_; }
+
+private:
+    // Tightens the column's bounds in the subtree.
+    void tighten(Subtree& subtree, int column, double lower, double upper)
+    {
+        auto found = std::find(subtree.columns.begin(), subtree.columns.end(), column);
+        std::size_t k = found - subtree.columns.begin();
+        if (found == subtree.columns.end()) {
+            subtree.columns.push_back(column);
+            subtree.lower.push_back(lower_[column]);
+            subtree.upper.push_back(upper_[column]);
+        }
+        subtree.lower[k] = std::max(subtree.lower[k], lower);
+        subtree.upper[k] = std::min(subtree.upper[k], upper);
+    }
+
+    // Solves the subtree's LP; false if it is closed, by infeasibility, the
+    // incumbent or an integral solution (which goes to best).
+    bool solve(Subtree& subtree, Incumbent& best)
+    {
+        for (std::size_t k = 0; k < subtree.columns.size(); k++)
+            lp_->setColBounds(subtree.columns[k], subtree.lower[k], subtree.upper[k]);
+        if (numLps_++ == 0)
+            lp_->initialSolve();
+        else
+            lp_->resolve();
+
+        bool open = true;
+        subtree.branchColumn = -1;
+        if (lp_->isProvenOptimal()) {
+            double objective = lp_->getObjValue() * lp_->getObjSense();
+            subtree.bound = std::max(subtree.bound, objective);
+            if (closedBy(objective, best.objective)) {
+                open = false;
+            } else {
+                const double* x = lp_->getColSolution();
+                double mostFractional = 1e-6;
+                for (int j = 0; j < lp_->getNumCols(); j++) {
+                    double fraction = std::fabs(x[j] - std::floor(x[j] + 0.5));
+                    if (lp_->isInteger(j) && fraction > mostFractional) {
+                        mostFractional = fraction;
+                        subtree.branchColumn = j;
+                        subtree.branchValue = x[j];
+                    }
+                }
+                if (subtree.branchColumn < 0) {
+                    best.improve(objective, x, lp_->getNumCols());
+                    open = false;
+                }
+            }
+        } else if (lp_->isProvenPrimalInfeasible() || lp_->isDualObjectiveLimitReached()) {
+            open = false;
+        }
+        // otherwise (iteration limit, numerical trouble) a worker's CbcModel gets it unsplit
+
+        for (int column : subtree.columns)
+            lp_->setColBounds(column, lower_[column], upper_[column]);
+        return open;
+    }
+
+    std::unique_ptr<OsiSolverInterface> lp_;
+    std::vector<double> lower_;
+    std::vector<double> upper_;
+    int numLps_ = 0;
+};
+
+// Coordinator and worker talk in messages: type, payload size, payload.
+enum class MessageType : std::uint32_t
+{
+    Solve = 1,  // coordinator: cutoff, subtree
+    Cutoff,     // coordinator: objective of the best incumbent
+    Steal,      // coordinator: split the current subtree for an idle worker
+    Stop,       // coordinator: time limit while solving, exit while idle
+    Incumbent,  // worker: objective, solution
+    Done,       // worker: subtree id, status, nodes, seconds
+    Returned    // worker: the part it keeps, the parts it gives back
+};
+
+static bool sendAll(int fd, const char* data, std::size_t size)
+{
+    while (size > 0) {
+        ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL); // a dead peer is an error, not SIGPIPE
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            return false;
+        data += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+static bool receiveAll(int fd, char* data, std::size_t size)
+{
+    while (size > 0) {
+        ssize_t received = ::recv(fd, data, size, 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            return false;
+        data += received;
+        size -= received;
+    }
+    return true;
+}
+
+static bool sendMessage(int fd, MessageType type, const std::string& payload = std::string())
+{
+    std::uint32_t header[2] = {static_cast<std::uint32_t>(type), static_cast<std::uint32_t>(payload.size())};
+    std::string message(reinterpret_cast<const char*>(header), sizeof(header));
+    message += payload;
+    return sendAll(fd, message.data(), message.size());
+}
+
+static bool receiveMessage(int fd, MessageType& type, std::string& payload)
+{
+    std::uint32_t header[2];
+    if (!receiveAll(fd, reinterpret_cast<char*>(header), sizeof(header)) || header[1] > (1u << 30))
+        return false;
+    type = static_cast<MessageType>(header[0]);
+    payload.resize(header[1]);
+    return receiveAll(fd, &payload[0], payload.size());
+}
+
+template <typename T>
+static void put(std::string& out, T value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static void putArray(std::string& out, const std::vector<T>& values)
+{
+    put(out, static_cast<std::int32_t>(values.size()));
+    out.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+// Reads a payload front to back; ok turns false on the first short read.
+struct PayloadReader
+{
+    const std::string& data;
+    std::size_t position = 0;
+    bool ok = true;
+
+    template <typename T>
+    T get()
+    {
+        T value{};
+        if (!ok || data.size() - position < sizeof(T)) {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, data.data() + position, sizeof(T));
+        position += sizeof(T);
+        return value;
+    }
+
+    template <typename T>
+    void getArray(std::vector<T>& values)
+    {
+        std::int32_t count = get<std::int32_t>();
+        if (!ok || count < 0 || static_cast<std::size_t>(count) > (data.size() - position) / sizeof(T)) {
+            ok = false;
+            return;
+        }
+        values.resize(count);
+        std::memcpy(values.data(), data.data() + position, count * sizeof(T));
+        position += count * sizeof(T);
+    }
+};
+
+static void putSubtree(std::string& out, const Subtree& subtree)
+{
+    put(out, static_cast<std::int32_t>(subtree.id));
+    put(out, subtree.bound);
+    putArray(out, subtree.columns);
+    putArray(out, subtree.lower);
+    putArray(out, subtree.upper);
+}
+
+static Subtree getSubtree(PayloadReader& in)
+{
+    Subtree subtree;
+    subtree.id = in.get<std::int32_t>();
+    subtree.bound = in.get<double>();
+    in.getArray(subtree.columns);
+    in.getArray(subtree.lower);
+    in.getArray(subtree.upper);
+    if (subtree.lower.size() != subtree.columns.size() || subtree.upper.size() != subtree.columns.size())
+        in.ok = false;
+    return subtree;
+}
+
+// A worker's side of the connection, shared by its event handler.
+struct WorkerSession
+{
+    int fd = -1;
+    double cutoff = COIN_DBL_MAX; // best objective known, minimization sense
+    bool steal = false;
+    bool stop = false;
+};
+
+static void publishIncumbent(CbcModel& model, WorkerSession& session)
+{
+    double objective = model.getMinimizationObjValue();
+    if (!model.bestSolution() || objective >= session.cutoff)
+        return;
+    session.cutoff = objective;
+    std::string payload;
+    put(payload, objective);
+    putArray(payload, std::vector<double>(model.bestSolution(), model.bestSolution() + model.getNumCols()));
+    sendMessage(session.fd, MessageType::Incumbent, payload);
+}
+
+/*
+  Sends the worker's incumbents as they come and, between nodes, takes in
+  the coordinator's cutoffs, steal and stop requests.
+*/
+class WorkerEventHandler : public CbcEventHandler
+{
+public:
+    WorkerEventHandler(CbcModel* model, WorkerSession* session)
+        : CbcEventHandler(model), session_(session)
+    {
+    }
+
+    CbcAction event(CbcEvent whichEvent) override
+    {
+        publishIncumbent(*model_, *session_);
+        if (whichEvent == node)
+            receive();
+        if (whichEvent == endSearch)
+            return noAction;
+        return session_->steal || session_->stop ? stop : noAction;
+    }
+
+    CbcEventHandler* clone() const override { return new WorkerEventHandler(*this); }
+
+private:
+    void receive()
+    {
+        pollfd request = {session_->fd, POLLIN, 0};
+        MessageType type;
+        std::string payload;
+        while (::poll(&request, 1, 0) > 0) {
+            if (!receiveMessage(session_->fd, type, payload)) {
+                session_->stop = true; // coordinator gone
+                return;
+            }
+            PayloadReader in{payload};
+            if (type == MessageType::Cutoff) {
+                double objective = in.get<double>();
+                if (in.ok && objective < session_->cutoff) {
+                    session_->cutoff = objective;
+                    double cutoff = objective - model_->getCutoffIncrement();
+                    if (cutoff < model_->getCutoff())
+                        model_->setCutoff(cutoff);
+                }
+            } else if (type == MessageType::Steal) {
+                session_->steal = true;
+            } else if (type == MessageType::Stop) {
+                session_->stop = true;
+            }
+        }
+    }
+
+    WorkerSession* session_;
+};
+
+// Solves one subtree with its own CbcModel: Optimal when the subtree is closed,
+// Stopped or Cancelled on the coordinator's stop or steal, Failed when CBC
+// stopped on its own (a limit in config, or the search abandoned).
+static BatchStatus solveSubtree(const OsiSolverInterface& solver, const Subtree& subtree,
+    const SubtreeSolveOptions& options, WorkerSession& session, long& nodes)
+{
+    std::unique_ptr<OsiSolverInterface> lp(solver.clone());
+    for (std::size_t k = 0; k < subtree.columns.size(); k++)
+        lp->setColBounds(subtree.columns[k], subtree.lower[k], subtree.upper[k]);
+    CbcModel model(*lp);
+    configureRacer(model, options.config, 0.0);
+    if (session.cutoff < COIN_DBL_MAX)
+        model.setCutoff(session.cutoff);
+    WorkerEventHandler handler(&model, &session);
+    model.passInEventHandler(&handler);
+    model.branchAndBound();
+    nodes += model.getNodeCount();
+    publishIncumbent(model, session);
+    if (model.isProvenOptimal() || model.isProvenInfeasible())
+        return BatchStatus::Optimal;
+    if (session.stop)
+        return BatchStatus::Stopped;
+    return session.steal ? BatchStatus::Cancelled : BatchStatus::Failed;
+}
+
+// The forked worker: solves subtrees until the coordinator says stop or goes away.
+static void runWorker(int fd, const OsiSolverInterface& solver, const SubtreeSolveOptions& options)
+{
+    LpSplitter splitter(solver);
+    WorkerSession session;
+    session.fd = fd;
+    MessageType type;
+    std::string payload;
+    while (receiveMessage(fd, type, payload) && type != MessageType::Stop) {
+        PayloadReader in{payload};
+        if (type == MessageType::Cutoff)
+            session.cutoff = std::min(session.cutoff, in.get<double>());
+        if (type != MessageType::Solve)
+            continue; // a cutoff, or a steal that came after the subtree was done
+        session.cutoff = std::min(session.cutoff, in.get<double>());
+        Subtree subtree = getSubtree(in);
+        if (!in.ok)
+            return;
+
+        auto start = std::chrono::steady_clock::now();
+        session.steal = session.stop = false;
+        long nodes = 0;
+        BatchStatus status = solveSubtree(solver, subtree, options, session, nodes);
+        while (status == BatchStatus::Cancelled && session.steal) {
+            session.steal = false;
+            int id = subtree.id;
+            Incumbent best;
+            best.objective = session.cutoff;
+            std::vector<Subtree> parts(1, subtree);
+            splitter.split(parts, 2, best);
+            if (!best.solution.empty()) {
+                std::string found;
+                put(found, best.objective);
+                putArray(found, best.solution);
+                sendMessage(fd, MessageType::Incumbent, found);
+                session.cutoff = best.objective;
+            }
+            if (parts.empty()) {
+                status = BatchStatus::Optimal;
+                break;
+            }
+            subtree = std::move(parts[0]);
+            subtree.id = id;
+            std::string returned;
+            putSubtree(returned, subtree);
+            put(returned, static_cast<std::int32_t>(parts.size() - 1));
+            for (std::size_t p = 1; p < parts.size(); p++)
+                putSubtree(returned, parts[p]);
+            sendMessage(fd, MessageType::Returned, returned);
+            status = solveSubtree(solver, subtree, options, session, nodes);
+        }
+
+        std::string done;
+        put(done, static_cast<std::int32_t>(subtree.id));
+        put(done, static_cast<std::int32_t>(status));
+        put(done, static_cast<std::int64_t>(nodes));
+        put(done, secondsSince(start));
+        if (!sendMessage(fd, MessageType::Done, done))
+            return;
+    }
+}
+
+// The coordinator's view of one worker process.
+struct WorkerSlot
+{
+    int fd = -1;
+    bool alive = true;
+    bool busy = false;
+    bool stealing = false;
+    Subtree subtree;
+    std::chrono::steady_clock::time_point since;
+};
+
+// Every subtree closed: the incumbent is optimal, or there is none. Otherwise
+// the status stays as the caller set it and the open subtrees give the bound.
+static void finishResult(SubtreeSolveResult& result, const Incumbent& best, double sense,
+    const std::vector<Subtree>& open, std::chrono::steady_clock::time_point start)
+{
+    result.hasSolution = !best.solution.empty();
+    if (result.hasSolution) {
+        result.objValue = best.objective * sense;
+        result.solution = best.solution;
+    }
+    if (open.empty())
+        result.status = result.hasSolution ? BatchStatus::Optimal : BatchStatus::Infeasible;
+    double bound = best.objective;
+    for (const Subtree& subtree : open)
+        bound = std::min(bound, subtree.bound);
+    if (bound < COIN_DBL_MAX)
+        result.bestBound = bound * sense;
+    result.seconds = secondsSince(start);
+}
+
+SubtreeSolveResult solveSubtrees(const OsiSolverInterface& solver, const SubtreeSolveOptions& options)
+{
+    SubtreeSolveResult result;
+    auto start = std::chrono::steady_clock::now();
+    const double sense = solver.getObjSense();
+    const int numWorkers = options.numWorkers > 0 ? options.numWorkers : defaultThreadCount();
+    Incumbent best;
+    std::vector<Subtree> queue;
+    std::vector<Subtree> failed; // stopped by CBC itself, never handed out again
+
+    // ramp-up: CBC's root for an incumbent, then LP branching into subtrees
+    if (options.rootHeuristics) {
+        CbcModel root(solver);
+        configureRacer(root, options.config, options.timeLimit);
+        root.setMaximumNodes(0);
+        root.branchAndBound();
+        result.nodes += root.getNodeCount();
+        if (root.bestSolution())
+            best.improve(root.getMinimizationObjValue(), root.bestSolution(), root.getNumCols());
+        if (root.isProvenOptimal() || root.isProvenInfeasible()) {
+            result.rampUpSeconds = secondsSince(start);
+            finishResult(result, best, sense, queue, start);
+            return result;
+        }
+    }
+    LpSplitter splitter(solver);
+    queue.resize(1);
+    splitter.split(queue, static_cast<std::size_t>(numWorkers) * std::max(1, options.subtreesPerWorker), best);
+    result.rampUpLps = splitter.numLps();
+    result.rampUpSubtrees = static_cast<int>(queue.size());
+    result.rampUpSeconds = secondsSince(start);
+    int nextId = 0;
+    for (Subtree& subtree : queue)
+        subtree.id = nextId++;
+    if (queue.empty()) {
+        finishResult(result, best, sense, queue, start);
+        return result;
+    }
+
+    // fork the workers; each inherits the model and needs only bound changes
+    std::cout.flush();
+    std::fflush(nullptr);
+    std::vector<WorkerSlot> workers;
+    for (int w = 0; w < std::min(numWorkers, static_cast<int>(queue.size())); w++) {
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+            std::cout << "socketpair failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            ::close(fds[0]);
+            for (const WorkerSlot& other : workers)
+                ::close(other.fd);
+            runWorker(fds[1], solver, options);
+            ::_exit(0);
+        }
+        ::close(fds[1]);
+        if (pid < 0) {
+            std::cout << "fork failed: " << std::strerror(errno) << std::endl;
+            ::close(fds[0]);
+            break;
+        }
+        WorkerSlot slot;
+        slot.fd = fds[0];
+        workers.push_back(slot);
+        SubtreeWorkerResult report;
+        report.pid = pid;
+        result.workers.push_back(report);
+    }
+    if (workers.empty()) {
+        finishResult(result, best, sense, queue, start);
+        return result;
+    }
+
+    bool stopping = false;
+    std::vector<pollfd> requests;
+    std::vector<int> polled;
+    MessageType type;
+    std::string payload;
+    while (true) {
+        // hand out the lowest bounds first, drop what the incumbent closed
+        for (std::size_t w = 0; w < workers.size() && !stopping; w++) {
+            WorkerSlot& worker = workers[w];
+            while (worker.alive && !worker.busy && !queue.empty()) {
+                auto lowest = std::min_element(queue.begin(), queue.end(),
+                    [](const Subtree& a, const Subtree& b) { return a.bound < b.bound; });
+                Subtree subtree = std::move(*lowest);
+                queue.erase(lowest);
+                if (closedBy(subtree.bound, best.objective))
+                    continue;
+                std::string solve;
+                put(solve, best.objective);
+                putSubtree(solve, subtree);
+                worker.subtree = std::move(subtree);
+                worker.busy = true;
+                worker.since = std::chrono::steady_clock::now();
+                if (!sendMessage(worker.fd, MessageType::Solve, solve))
+                    break; // the poll below finds it dead
+            }
+        }
+
+        int numAlive = 0, numBusy = 0, numIdle = 0;
+        bool stealPending = false;
+        for (const WorkerSlot& worker : workers) {
+            numAlive += worker.alive;
+            numBusy += worker.alive && worker.busy;
+            numIdle += worker.alive && !worker.busy;
+            stealPending = stealPending || worker.stealing;
+        }
+        if (numAlive == 0) {
+            result.status = BatchStatus::Failed;
+            break;
+        }
+        if (numBusy == 0 && (queue.empty() || stopping))
+            break;
+
+        if (!stopping && options.timeLimit > 0.0 && secondsSince(start) >= options.timeLimit) {
+            stopping = true;
+            result.status = BatchStatus::Stopped;
+            for (WorkerSlot& worker : workers)
+                if (worker.alive && worker.busy)
+                    sendMessage(worker.fd, MessageType::Stop);
+        }
+
+        // an idle worker and nothing queued: split the longest running subtree
+        if (!stopping && queue.empty() && numIdle > 0 && !stealPending) {
+            int victim = -1;
+            double longest = options.stealAfter;
+            for (std::size_t w = 0; w < workers.size(); w++) {
+                double running = secondsSince(workers[w].since);
+                if (workers[w].alive && workers[w].busy && running >= longest) {
+                    longest = running;
+                    victim = static_cast<int>(w);
+                }
+            }
+            if (victim >= 0 && sendMessage(workers[victim].fd, MessageType::Steal)) {
+                workers[victim].stealing = true;
+                result.steals++;
+            }
+        }
+
+        requests.clear();
+        polled.clear();
+        for (std::size_t w = 0; w < workers.size(); w++) {
+            if (workers[w].alive) {
+                requests.push_back({workers[w].fd, POLLIN, 0});
+                polled.push_back(static_cast<int>(w));
+            }
+        }
+        if (::poll(requests.data(), requests.size(), 50) <= 0)
+            continue;
+
+        for (std::size_t r = 0; r < requests.size(); r++) {
+            if (requests[r].revents == 0)
+                continue;
+            int w = polled[r];
+            WorkerSlot& worker = workers[w];
+            SubtreeWorkerResult& report = result.workers[w];
+            if (!receiveMessage(worker.fd, type, payload)) {
+                // died: its subtree goes back to the queue
+                worker.alive = false;
+                report.status = BatchStatus::Failed;
+                ::close(worker.fd);
+                if (worker.busy)
+                    queue.push_back(std::move(worker.subtree));
+                worker.busy = worker.stealing = false;
+                continue;
+            }
+            PayloadReader in{payload};
+            if (type == MessageType::Incumbent) {
+                double objective = in.get<double>();
+                std::vector<double> solution;
+                in.getArray(solution);
+                if (in.ok && best.improve(objective, solution.data(), static_cast<int>(solution.size()))) {
+                    report.solutionsFound++;
+                    std::string cutoff;
+                    put(cutoff, objective);
+                    for (std::size_t other = 0; other < workers.size(); other++) {
+                        if (other != static_cast<std::size_t>(w) && workers[other].alive && workers[other].busy) {
+                            sendMessage(workers[other].fd, MessageType::Cutoff, cutoff);
+                            result.cutoffBroadcasts++;
+                        }
+                    }
+                }
+            } else if (type == MessageType::Done) {
+                in.get<std::int32_t>();
+                BatchStatus status = static_cast<BatchStatus>(in.get<std::int32_t>());
+                long nodes = static_cast<long>(in.get<std::int64_t>());
+                double seconds = in.get<double>();
+                report.nodes += nodes;
+                report.busySeconds += seconds;
+                result.nodes += nodes;
+                if (status == BatchStatus::Optimal) {
+                    report.subtrees++;
+                    result.subtreesSolved++;
+                } else if (status == BatchStatus::Stopped) {
+                    queue.push_back(std::move(worker.subtree)); // left open by the time limit
+                } else {
+                    report.status = BatchStatus::Failed;
+                    result.subtreesFailed++;
+                    failed.push_back(std::move(worker.subtree));
+                }
+                worker.busy = worker.stealing = false;
+            } else if (type == MessageType::Returned) {
+                Subtree kept = getSubtree(in);
+                std::int32_t count = in.get<std::int32_t>();
+                for (std::int32_t p = 0; p < count && in.ok; p++) {
+                    Subtree part = getSubtree(in);
+                    part.id = nextId++;
+                    queue.push_back(std::move(part));
+                    report.given++;
+                }
+                if (in.ok)
+                    worker.subtree = std::move(kept);
+                worker.stealing = false;
+                worker.since = std::chrono::steady_clock::now();
+            }
+        }
+    }
+
+    for (WorkerSlot& worker : workers) {
+        if (worker.alive) {
+            sendMessage(worker.fd, MessageType::Stop);
+            ::close(worker.fd);
+        }
+    }
+    for (const SubtreeWorkerResult& report : result.workers)
+        ::waitpid(report.pid, nullptr, 0);
+    queue.insert(queue.end(), failed.begin(), failed.end());
+    finishResult(result, best, sense, queue, start);
+    return result;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "batch_solver.h"
+#include "racing_solver.h"
+
+#include <vector>
+
+class OsiSolverInterface;
+
+struct SubtreeSolveOptions
+{
+    int numWorkers = 0;          // worker processes, <= 0 one per core
+    int subtreesPerWorker = 4;   // open subtrees the ramp-up aims for, per worker
+    double timeLimit = 0.0;      // wall clock for the whole solve, 0 none
+    double stealAfter = 0.5;     // seconds a worker must have spent on its subtree before it is split for an idle one
+    bool rootHeuristics = true;  // ramp-up starts with CBC's root node for an incumbent
+    RaceConfig config;           // CBC settings of the ramp-up and the workers
+};
+
+struct SubtreeWorkerResult
+{
+    int pid = 0;
+    BatchStatus status = BatchStatus::Optimal; // Failed: the process died, or CBC stopped one of its subtrees
+    int subtrees = 0;            // subtrees solved to the end
+    int given = 0;               // subtrees split off for idle workers
+    long nodes = 0;
+    int solutionsFound = 0;      // incumbents it reported that improved the best
+    double busySeconds = 0.0;
+};
+
+struct SubtreeSolveResult
+{
+    BatchStatus status = BatchStatus::Failed;
+    bool hasSolution = false;
+    double objValue = 0.0;
+    double bestBound = 0.0;      // lowest LP bound of the subtrees left open at a limit
+    std::vector<double> solution;
+    int rampUpLps = 0;           // subtree LPs solved to split the root
+    int rampUpSubtrees = 0;      // open subtrees the ramp-up produced
+    int subtreesSolved = 0;
+    int subtreesFailed = 0;      // stopped by CBC's own limits and given up, still open
+    int steals = 0;              // splits of a busy worker's subtree for idle ones
+    int cutoffBroadcasts = 0;
+    long nodes = 0;              // CBC nodes of the root and of every worker
+    double rampUpSeconds = 0.0;
+    double seconds = 0.0;
+    std::vector<SubtreeWorkerResult> workers;
+};
+
+/*
+  Solves a MIP with forked worker processes instead of CBC threads, so the
+  workers share no tree and no locks. The coordinator ramps up: CBC's root
+  node for a first incumbent, then best-first LP branching on the most
+  fractional integer until there are numWorkers * subtreesPerWorker open
+  subtrees, each described only by its bound changes. Workers are forked
+  after the model is set up, talk to the coordinator over a Unix socketpair
+  each, and solve one subtree at a time with their own CbcModel:
+
+    SubtreeSolveOptions options;
+    options.numWorkers = 16;
+    SubtreeSolveResult result = solveSubtrees(solver, options);
+    std::cout << batchStatusName(result.status) << " " << result.objValue << std::endl;
+
+  A worker sends every new incumbent at once; the coordinator keeps the best
+  and broadcasts it as cutoff, which the other workers install at their next
+  node. The queue hands out the subtree with the lowest bound first and
+  drops those the incumbent has closed. Once the queue is empty, an idle
+  worker gets work from the busy worker that has been on its subtree
+  longest: that worker stops its CbcModel, splits the subtree by LP
+  branching, keeps one part and gives the others back. What it had searched
+  in the subtree is searched again. A worker that dies has its subtree
+  queued again. A subtree CBC stops for its own reasons (an iteration or
+  solution limit in config) is given up rather than handed out again; it
+  stays open in bestBound and the result is not Optimal.
+
+  Linux only (fork, socketpair, poll). The caller must not have other
+  threads running inside CBC while this forks.
+*/
+SubtreeSolveResult solveSubtrees(const OsiSolverInterface& solver, const SubtreeSolveOptions& options = {});
@@ -0,0 +1,108 @@
+#include "thread_pool.h"
+#include "parallel.h"
+
+// worker index of the calling thread within currentPool, -1 elsewhere
+static thread_local const WorkStealingPool* currentPool = nullptr;
+static thread_local int currentWorker = -1;
+
+WorkStealingPool::WorkStealingPool(int numThreads)
+{
+    if (numThreads <= 0)
+        numThreads = defaultThreadCount();
+    queues_.reserve(numThreads);
+    for (int i = 0; i < numThreads; i++)
+        queues_.push_back(std::make_unique<TaskQueue>());
+    threads_.reserve(numThreads);
+    for (int i = 0; i < numThreads; i++)
+        threads_.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    for (std::thread& thread : threads_)
+        thread.join();
+}
+
+void WorkStealingPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        unfinished_++;
+    }
+
+    int target = currentPool == this ? currentWorker
+                                     : static_cast<int>(nextQueue_++ % queues_.size());
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+        queues_[target]->tasks.push_back(std::move(task));
+        queued_++;
+    }
+    // empty critical section so a worker can't miss the wakeup between its check and its wait
+    { std::lock_guard<std::mutex> lock(stateMutex_); }
+    workAvailable_.notify_one();
+}
+
+void WorkStealingPool::wait()
+{
+    std::unique_lock<std::mutex> lock(stateMutex_);
+    allDone_.wait(lock, [this]() { return unfinished_ == 0; });
+}
+
+bool WorkStealingPool::popTask(int self, std::function<void()>& task)
+{
+    {
+        TaskQueue& own = *queues_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            queued_--;
+            return true;
+        }
+    }
+
+    int numQueues = static_cast<int>(queues_.size());
+    for (int k = 1; k < numQueues; k++) {
+        TaskQueue& victim = *queues_[(self + k) % numQueues];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            queued_--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(int self)
+{
+    currentPool = this;
+    currentWorker = self;
+
+    std::function<void()> task;
+    for (;;) {
+        if (popTask(self, task)) {
+            running_++;
+            task();
+            task = nullptr;
+            running_--;
+
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            if (--unfinished_ == 0)
+                allDone_.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(stateMutex_);
+        workAvailable_.wait(lock, [this]() { return stopping_ || queued_.load() > 0; });
+        if (stopping_ && queued_.load() == 0)
+            return;
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+  Fixed set of worker threads with one task deque per worker. A worker runs
+  its own deque in submission order and, once it is empty, steals from the
+  back of another worker's deque, so long tasks (whole solves) don't leave
+  cores idle behind a busy worker. Tasks submitted from a worker go to that
+  worker's deque; other submissions are spread round-robin.
+
+  Use parallelFor (parallel.h) for short data-parallel loops; this pool is for
+  independent, uneven jobs that arrive over time.
+*/
+class WorkStealingPool
+{
+public:
+    explicit WorkStealingPool(int numThreads = 0); // <= 0 uses every core
+    ~WorkStealingPool(); // runs the remaining tasks, then joins
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Blocks until every submitted task has finished.
+    void wait();
+
+    int size() const { return static_cast<int>(threads_.size()); }
+    int queued() const { return queued_.load(); } // submitted, not started
+    int running() const { return running_.load(); }
+
+private:
+    struct TaskQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool popTask(int self, std::function<void()>& task);
+    void workerLoop(int self);
+
+    std::vector<std::unique_ptr<TaskQueue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<int> queued_{0};
+    std::atomic<int> running_{0};
+    std::atomic<unsigned> nextQueue_{0};
+
+    std::mutex stateMutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable allDone_;
+    int unfinished_ = 0;
+    bool stopping_ = false;
+};
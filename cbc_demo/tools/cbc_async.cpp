@@ -0,0 +1,117 @@
+// Solves models in the background with AsyncSolver (async_solver.h) while
+// the main thread prints the latest progress of every solve once a second,
+// the way a service would report on its running requests.
+//
+//   ./cbc_async [-w workers] [-t seconds] [-e extend] [-c cancel after] model files...
+//
+// -e pushes the deadline of every solve still running at half its time
+// limit out by that many seconds; -c cancels the last model after that many
+// seconds.
+
+#include "async_solver.h"
+#include "model_reader.h"
+#include "problem_instance.h"
+#include "util.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main(int argc, const char *argv[])
+{
+    int numWorkers = 0;
+    double timeLimit = 0.0, extend = 0.0, cancelAfter = -1.0;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-w" && hasValue)
+            numWorkers = std::atoi(argv[++i]);
+        else if (arg == "-t" && hasValue)
+            timeLimit = std::atof(argv[++i]);
+        else if (arg == "-e" && hasValue)
+            extend = std::atof(argv[++i]);
+        else if (arg == "-c" && hasValue)
+            cancelAfter = std::atof(argv[++i]);
+        else
+            paths.push_back(arg);
+    }
+    if (paths.empty()) {
+        std::cout << "Usage: cbc_async [-w workers] [-t seconds] [-e extend] [-c cancel after] model files..."
+                  << std::endl;
+        return 1;
+    }
+
+    AsyncSolver solver(numWorkers);
+    std::vector<SolveHandle> handles;
+    std::vector<std::string> names;
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& path : paths) {
+        auto data = std::make_shared<ProblemInstance>();
+        if (readModelFile(path, *data) != 0)
+            continue;
+        SolveOptions options;
+        options.name = std::filesystem::path(path).stem().string();
+        options.timeLimit = timeLimit;
+        options.keepSolution = false;
+        handles.push_back(solver.solveAsync(data, options));
+        names.push_back(options.name);
+    }
+
+    bool extended = false, cancelled = false;
+    double lastReport = -1.0;
+    for (;;) {
+        bool allDone = true;
+        for (const SolveHandle& handle : handles)
+            allDone = allDone && handle.ready();
+        double elapsed = secondsSince(start);
+        if (extend > 0.0 && !extended && timeLimit > 0.0 && elapsed >= timeLimit / 2) {
+            for (std::size_t k = 0; k < handles.size(); k++)
+                if (handles[k].extendDeadline(extend))
+                    std::printf("%8.1fs  extend %s by %g s\n", elapsed, names[k].c_str(), extend);
+            extended = true;
+        }
+        if (cancelAfter >= 0.0 && !cancelled && elapsed >= cancelAfter && !handles.empty()) {
+            if (handles.back().cancel())
+                std::printf("%8.1fs  cancel %s\n", elapsed, names.back().c_str());
+            cancelled = true;
+        }
+        if (allDone)
+            break;
+
+        if (elapsed - lastReport < 1.0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            continue;
+        }
+        lastReport = elapsed;
+        std::printf("%8.1fs  queued %d, running %d\n", elapsed, solver.queued(), solver.running());
+        for (std::size_t k = 0; k < handles.size(); k++) {
+            SolveProgress p = handles[k].progress();
+            if (handles[k].ready() || p.updates == 0)
+                continue;
+            char incumbent[32] = "-", gap[32] = "-";
+            if (p.hasIncumbent) {
+                std::snprintf(incumbent, sizeof(incumbent), "%.8g", p.incumbent);
+                std::snprintf(gap, sizeof(gap), "%.2f%%", p.gap * 100.0);
+            }
+            std::printf("          %-14s %7.1fs  bound %-14.8g incumbent %-14s gap %-8s nodes %d\n",
+                names[k].c_str(), p.seconds, p.bestBound, incumbent, gap, p.nodes);
+        }
+    }
+
+    std::printf("%-4s %-14s %-10s %-14s %16s %16s %10s %8s\n", "id", "model", "status", "message", "objective", "bound",
+        "nodes", "time(s)");
+    for (const SolveHandle& handle : handles) {
+        const BatchResult& r = handle.get();
+        std::printf("%-4d %-14s %-10s %-14s %16.8g %16.8g %10d %8.3f\n", r.jobId, r.name.c_str(),
+            batchStatusName(r.status), r.message.c_str(), r.hasSolution ? r.objValue : 0.0, r.bestBound, r.nodes,
+            r.solveSeconds);
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Solves a batch of models with BatchSolver (batch_solver.h) and writes a report.
+//
+//   ./cbc_batch [-j workers] [-c cores] [-t seconds] [--cancel-after seconds]
+//               [-o report.json|report.csv] model files...
+//
+// -t is the time limit of each job, --cancel-after cancels whatever is still
+// queued or running once that much wall time has passed.
+
+#include "batch_solver.h"
+#include "util.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main(int argc, const char *argv[])
+{
+    int numWorkers = 0, numCores = 0;
+    double timeLimit = 0.0, cancelAfter = 0.0;
+    std::string reportPath;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-j" && hasValue)
+            numWorkers = std::atoi(argv[++i]);
+        else if (arg == "-c" && hasValue)
+            numCores = std::atoi(argv[++i]);
+        else if (arg == "-t" && hasValue)
+            timeLimit = std::atof(argv[++i]);
+        else if (arg == "--cancel-after" && hasValue)
+            cancelAfter = std::atof(argv[++i]);
+        else if (arg == "-o" && hasValue)
+            reportPath = argv[++i];
+        else
+            files.push_back(arg);
+    }
+
+    if (files.empty()) {
+        std::cout << "Usage: cbc_batch [-j workers] [-c cores] [-t seconds] [--cancel-after seconds]"
+                     " [-o report.json|report.csv] model files..." << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    BatchSolver batch(numWorkers, numCores);
+    for (const std::string& file : files) {
+        BatchJob job;
+        job.path = file;
+        job.timeLimit = timeLimit;
+        batch.submit(job);
+    }
+
+    if (cancelAfter > 0.0) {
+        auto deadline = start + std::chrono::duration<double>(cancelAfter);
+        while (batch.queued() + batch.running() > 0 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        batch.cancelAll();
+    }
+    std::vector<BatchResult> results = batch.wait();
+    double wallSeconds = secondsSince(start);
+
+    std::printf("%-16s %-10s %16s %16s %10s %8s %8s %8s  %s\n", "model", "status", "objective", "bound",
+        "nodes", "threads", "load(s)", "solve(s)", "note");
+    int failures = 0;
+    for (const BatchResult& r : results) {
+        if (r.status == BatchStatus::Failed)
+            failures++;
+        std::printf("%-16s %-10s %16.8g %16.8g %10d %8d %8.3f %8.3f  %s\n", r.name.c_str(),
+            batchStatusName(r.status), r.hasSolution ? r.objValue : 0.0, r.bestBound, r.nodes, r.threads,
+            r.loadSeconds, r.solveSeconds, r.message.c_str());
+    }
+    std::printf("%zu jobs in %.3f s wall\n", results.size(), wallSeconds);
+
+    if (!reportPath.empty()) {
+        std::ofstream report(reportPath);
+        if (!report) {
+            std::cout << "Cannot write " << reportPath << std::endl;
+            return 1;
+        }
+        if (endsWith(reportPath, ".csv"))
+            writeBatchReportCsv(results, report);
+        else
+            writeBatchReportJson(results, report);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+// Finds the block structure of a model (block_structure.h), reports the
+// blocks and linking rows and solves the blocks in parallel.
+//
+//   ./cbc_blocks [-j threads] [-t seconds] [--hints file.dec|file.block]
+//                [--max-linking rows] [--no-solve] model file
+
+#include "block_structure.h"
+#include "model_reader.h"
+#include "problem_instance.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, const char *argv[])
+{
+    int numThreads = 0, maxLinking = -1;
+    double timeLimit = 0.0;
+    bool solve = true;
+    std::string hintsPath, path;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-j" && hasValue)
+            numThreads = std::atoi(argv[++i]);
+        else if (arg == "-t" && hasValue)
+            timeLimit = std::atof(argv[++i]);
+        else if (arg == "--hints" && hasValue)
+            hintsPath = argv[++i];
+        else if (arg == "--max-linking" && hasValue)
+            maxLinking = std::atoi(argv[++i]);
+        else if (arg == "--no-solve")
+            solve = false;
+        else
+            path = arg;
+    }
+
+    if (path.empty()) {
+        std::cout << "Usage: cbc_blocks [-j threads] [-t seconds] [--hints file.dec|file.block]"
+                     " [--max-linking rows] [--no-solve] model file" << std::endl;
+        return 1;
+    }
+
+    ProblemInstance data;
+    if (readModelFile(path, data) != 0)
+        return 1;
+    BlockStructure blocks;
+    if (hintsPath.empty())
+        blocks = detectBlocks(data, maxLinking);
+    else if (!readBlockHints(hintsPath, data, blocks))
+        return 1;
+
+    std::vector<int> rows(blocks.numBlocks, 0), cols(blocks.numBlocks, 0);
+    for (int b : blocks.rowBlock)
+        if (b >= 0)
+            rows[b]++;
+    for (int b : blocks.colBlock)
+        cols[b]++;
+    std::printf("%s: %d rows, %d columns, %d blocks, %zu linking rows%s\n", path.c_str(), data.numRows,
+        data.numCols, blocks.numBlocks, blocks.linkingRows.size(), hintsPath.empty() ? "" : " (from hints)");
+    for (int b = 0; b < std::min(blocks.numBlocks, 20); b++)
+        std::printf("  block %-4d %8d rows %8d columns\n", b, rows[b], cols[b]);
+    if (blocks.numBlocks > 20)
+        std::printf("  ...\n");
+    if (!blocks.linkingRows.empty()) {
+        std::printf("  linking rows:");
+        for (std::size_t k = 0; k < std::min<std::size_t>(blocks.linkingRows.size(), 20); k++) {
+            int row = blocks.linkingRows[k];
+            std::string name = data.rowName.empty() ? std::to_string(row) : std::string(data.rowName[row]);
+            std::printf(" %s", name.c_str());
+        }
+        std::printf("%s\n", blocks.linkingRows.size() > 20 ? " ..." : "");
+    }
+    if (!solve)
+        return 0;
+
+    BlockSolveResult result = solveBlocks(data, blocks, numThreads, timeLimit);
+    std::printf("%-10s %-10s %16s %16s %10s %8s\n", "block", "status", "objective", "bound", "nodes", "solve(s)");
+    for (const BatchResult& r : result.blocks)
+        std::printf("%-10d %-10s %16.8g %16.8g %10d %8.3f\n", r.jobId, batchStatusName(r.status),
+            r.hasSolution ? r.objValue : 0.0, r.bestBound, r.nodes, r.solveSeconds);
+    std::printf("%s%s, objective %.8g, bound %.8g (block relaxation %.8g), %.3f s  %s\n",
+        batchStatusName(result.status), result.solvedWhole ? " (whole model, linking rows violated)" : "",
+        result.hasSolution ? result.objValue : 0.0, result.bestBound, result.relaxationBound, result.seconds,
+        result.message.c_str());
+    return result.status == BatchStatus::Failed ? 1 : 0;
+}
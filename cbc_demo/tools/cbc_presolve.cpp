@@ -0,0 +1,159 @@
+// Runs the native presolve (presolve.h) on models and reports what each rule
+// removed. With --solve the original and the reduced model are solved with
+// CBC, and the postsolved solution is checked against the original model.
+//
+//   ./cbc_presolve [-j threads] [-t seconds] [--solve] [--no-duplicates]
+//                  [-o reduced.snap] [--map reduced.map] model files...
+//
+// -o and --map write the reduced model and its postsolve map of the last model,
+// nothing if that model could not be read or is infeasible.
+
+#include "CbcModel.hpp"
+#include "OsiClpSolverInterface.hpp"
+
+#include "batch_evaluator.h"
+#include "model_reader.h"
+#include "presolve.h"
+#include "problem_instance.h"
+#include "problem_snapshot.h"
+#include "util.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct SolveOutcome
+{
+    bool hasSolution = false;
+    bool optimal = false;
+    double objValue = 0.0;
+    double seconds = 0.0;
+    std::vector<double> solution;
+};
+
+static SolveOutcome solve(const ProblemInstance& data, double timeLimit)
+{
+    SolveOutcome outcome;
+    auto start = std::chrono::steady_clock::now();
+    OsiClpSolverInterface solver;
+    solver.messageHandler()->setLogLevel(0);
+    loadProblemData(data, solver, false);
+    CbcModel model(solver);
+    model.setLogLevel(0);
+    model.setUseElapsedTime(true);
+    if (timeLimit > 0.0)
+        model.setMaximumSeconds(timeLimit);
+    model.branchAndBound();
+    outcome.seconds = secondsSince(start);
+    outcome.optimal = model.isProvenOptimal();
+    outcome.hasSolution = model.bestSolution() != nullptr;
+    if (outcome.hasSolution) {
+        outcome.objValue = model.getObjValue();
+        outcome.solution.assign(model.bestSolution(), model.bestSolution() + data.numCols);
+    }
+    return outcome;
+}
+
+int main(int argc, const char *argv[])
+{
+    PresolveOptions options;
+    double timeLimit = 60.0;
+    bool solveModels = false;
+    std::string reducedPath, mapPath;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-j" && hasValue)
+            options.numThreads = std::atoi(argv[++i]);
+        else if (arg == "-t" && hasValue)
+            timeLimit = std::atof(argv[++i]);
+        else if (arg == "--solve")
+            solveModels = true;
+        else if (arg == "--no-duplicates")
+            options.duplicates = false;
+        else if (arg == "-o" && hasValue)
+            reducedPath = argv[++i];
+        else if (arg == "--map" && hasValue)
+            mapPath = argv[++i];
+        else
+            files.push_back(arg);
+    }
+
+    if (files.empty()) {
+        std::cout << "Usage: cbc_presolve [-j threads] [-t seconds] [--solve] [--no-duplicates]"
+                     " [-o reduced.snap] [--map reduced.map] model files..." << std::endl;
+        return 1;
+    }
+
+    std::printf("%-12s %13s %13s %15s %5s %5s %5s %5s %5s %5s %5s %5s %8s\n", "model", "rows", "cols", "nonzeros",
+        "fix", "dual", "merge", "empty", "singl", "redun", "dupl", "bound", "time(ms)");
+    int failures = 0;
+    ProblemInstance reduced;
+    PresolveMap map;
+    bool lastReduced = false; // the last model was read and presolved
+    for (const std::string& path : files) {
+        ProblemInstance data;
+        lastReduced = false;
+        if (readModelFile(path, data) != 0) {
+            failures++;
+            continue;
+        }
+        std::string name = std::filesystem::path(path).filename().string();
+        name = name.substr(0, name.find('.'));
+
+        PresolveStats stats;
+        if (presolve(data, reduced, map, stats, options) == PresolveStatus::Infeasible) {
+            std::printf("%-12s infeasible: %s\n", name.c_str(), map.message.c_str());
+            continue;
+        }
+        lastReduced = true;
+        char rows[32], cols[32], nonZeros[32];
+        std::snprintf(rows, sizeof(rows), "%d>%d", data.numRows, reduced.numRows);
+        std::snprintf(cols, sizeof(cols), "%d>%d", data.numCols, reduced.numCols);
+        std::snprintf(nonZeros, sizeof(nonZeros), "%d>%d", data.numNonZeros, reduced.numNonZeros);
+        std::printf("%-12s %13s %13s %15s %5d %5d %5d %5d %5d %5d %5d %5d %8.2f\n", name.c_str(), rows, cols,
+            nonZeros, stats.fixedColumns, stats.dualFixedColumns, stats.mergedColumns, stats.emptyRows,
+            stats.singletonRows, stats.redundantRows, stats.duplicateRows, stats.tightenedBounds,
+            stats.seconds * 1000.0);
+
+        if (!solveModels)
+            continue;
+        SolveOutcome original = solve(data, timeLimit);
+        SolveOutcome presolved = solve(reduced, timeLimit);
+        double violation = -1.0, objective = 0.0;
+        if (presolved.hasSolution) {
+            // the postsolved solution, checked against the original model
+            SolutionBatch batch(data.numCols, 1);
+            batch.setSolution(0, map.postsolve(presolved.solution).data());
+            BatchEvaluation evaluation;
+            BatchEvaluator(data).evaluate(batch, evaluation);
+            violation = evaluation.maxViolation(0);
+            objective = evaluation.objective[0];
+        }
+        bool agree = original.optimal && presolved.optimal
+            ? std::fabs(original.objValue - objective) <= 1e-6 * std::max(1.0, std::fabs(objective))
+            : true;
+        if (!agree || violation > 1e-6)
+            failures++;
+        std::printf("             original %s %.10g in %.3f s, presolved %s %.10g in %.3f s, "
+                    "postsolved violation %g%s\n", original.optimal ? "optimal" : "stopped", original.objValue,
+            original.seconds, presolved.optimal ? "optimal" : "stopped", objective, presolved.seconds, violation,
+            agree ? "" : "  OBJECTIVES DIFFER");
+    }
+
+    if (!lastReduced && (!reducedPath.empty() || !mapPath.empty())) {
+        std::cout << "the last model was not presolved, nothing written" << std::endl;
+    } else {
+        if (!reducedPath.empty() && !writeSnapshot(reduced, reducedPath))
+            failures++;
+        if (!mapPath.empty() && !writePresolveMap(map, mapPath))
+            failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
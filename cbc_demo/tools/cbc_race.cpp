@@ -0,0 +1,71 @@
+// Races CBC configurations on one model with raceSolve (racing_solver.h).
+//
+//   ./cbc_race [-n racers] [-t seconds] [-o report.json] model file
+//
+// Prints one line per racer and the winning configuration.
+
+#include "model_reader.h"
+#include "problem_instance.h"
+#include "racing_solver.h"
+
+#include "OsiClpSolverInterface.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, const char *argv[])
+{
+    int numRacers = 4;
+    double timeLimit = 0.0;
+    std::string reportPath, path;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-n" && hasValue)
+            numRacers = std::atoi(argv[++i]);
+        else if (arg == "-t" && hasValue)
+            timeLimit = std::atof(argv[++i]);
+        else if (arg == "-o" && hasValue)
+            reportPath = argv[++i];
+        else
+            path = arg;
+    }
+
+    if (path.empty() || numRacers < 1) {
+        std::cout << "Usage: cbc_race [-n racers] [-t seconds] [-o report.json] model file" << std::endl;
+        return 1;
+    }
+
+    ProblemInstance data;
+    if (readModelFile(path, data) != 0)
+        return 1;
+    OsiClpSolverInterface solver;
+    solver.messageHandler()->setLogLevel(0);
+    loadProblemData(data, solver, false);
+
+    RaceResult race = raceSolve(solver, defaultRaceConfigs(numRacers), timeLimit);
+
+    std::printf("%-20s %-10s %16s %16s %10s %6s %8s %8s\n", "config", "status", "objective", "bound", "nodes",
+        "found", "imported", "time(s)");
+    for (const RacerResult& r : race.racers)
+        std::printf("%-20s %-10s %16.8g %16.8g %10d %6d %8d %8.3f\n", r.config.c_str(), batchStatusName(r.status),
+            r.hasSolution ? r.objValue : 0.0, r.bestBound, r.nodes, r.solutionsFound, r.solutionsImported,
+            r.seconds);
+    std::printf("%s: %s, objective %.8g, bound %.8g, winner \"%s\", best solution from \"%s\", %.3f s\n",
+        path.c_str(), batchStatusName(race.status), race.hasSolution ? race.objValue : 0.0, race.bestBound,
+        race.winnerConfig.c_str(), race.incumbentFrom >= 0 ? race.racers[race.incumbentFrom].config.c_str() : "",
+        race.seconds);
+
+    if (!reportPath.empty()) {
+        std::ofstream report(reportPath);
+        if (!report) {
+            std::cout << "cannot write " << reportPath << std::endl;
+            return 1;
+        }
+        writeRaceReportJson(race, report);
+    }
+    return race.status == BatchStatus::Failed ? 1 : 0;
+}
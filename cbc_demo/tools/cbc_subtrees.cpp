@@ -0,0 +1,65 @@
+// Solves one model with forked worker processes over Unix sockets
+// (subtree_solver.h).
+//
+//   ./cbc_subtrees [-w workers] [-s subtrees per worker] [-t seconds] [--steal-after seconds] model file
+//
+// Prints one line per worker and the result.
+
+#include "model_reader.h"
+#include "problem_instance.h"
+#include "subtree_solver.h"
+
+#include "OsiClpSolverInterface.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+int main(int argc, const char *argv[])
+{
+    SubtreeSolveOptions options;
+    std::string path;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-w" && hasValue)
+            options.numWorkers = std::atoi(argv[++i]);
+        else if (arg == "-s" && hasValue)
+            options.subtreesPerWorker = std::atoi(argv[++i]);
+        else if (arg == "-t" && hasValue)
+            options.timeLimit = std::atof(argv[++i]);
+        else if (arg == "--steal-after" && hasValue)
+            options.stealAfter = std::atof(argv[++i]);
+        else
+            path = arg;
+    }
+
+    if (path.empty()) {
+        std::cout << "Usage: cbc_subtrees [-w workers] [-s subtrees per worker] [-t seconds]"
+                     " [--steal-after seconds] model file" << std::endl;
+        return 1;
+    }
+
+    ProblemInstance data;
+    if (readModelFile(path, data) != 0)
+        return 1;
+    OsiClpSolverInterface solver;
+    solver.messageHandler()->setLogLevel(0);
+    loadProblemData(data, solver, false);
+
+    SubtreeSolveResult result = solveSubtrees(solver, options);
+
+    std::printf("%8s %-10s %9s %6s %10s %6s %8s\n", "pid", "status", "subtrees", "given", "nodes", "found",
+        "busy(s)");
+    for (const SubtreeWorkerResult& w : result.workers)
+        std::printf("%8d %-10s %9d %6d %10ld %6d %8.3f\n", w.pid, batchStatusName(w.status), w.subtrees, w.given,
+            w.nodes, w.solutionsFound, w.busySeconds);
+    std::printf("ramp-up: %d LPs, %d subtrees, %.3f s\n", result.rampUpLps, result.rampUpSubtrees,
+        result.rampUpSeconds);
+    std::printf("%s: %s, objective %.8g, bound %.8g, %ld nodes, %d subtrees, %d given up, %d steals, "
+                "%d cutoffs sent, %.3f s\n", path.c_str(), batchStatusName(result.status),
+        result.hasSolution ? result.objValue : 0.0, result.bestBound, result.nodes, result.subtreesSolved,
+        result.subtreesFailed, result.steals, result.cutoffBroadcasts, result.seconds);
+    return result.status == BatchStatus::Failed ? 1 : 0;
+}
@@ -0,0 +1,68 @@
+// Converts .mps / .mps.gz models into binary snapshots (problem_snapshot.h).
+//
+//   ./mps2snapshot model.mps.gz [more models...] [-o output_dir] [--index64]
+//
+// Each model.mps(.gz) is written as model.snap, next to the input unless -o is given.
+// --index64 writes 64-bit row and column starts (ProblemInstance64).
+
+#include "OsiClpSolverInterface.hpp"
+
+#include "problem_instance.h"
+#include "problem_snapshot.h"
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static std::string snapshotPath(const std::string& input, const std::string& outputDir)
+{
+    std::filesystem::path path(input);
+    std::filesystem::path stem = path.filename();
+    while (stem.has_extension() && (stem.extension() == ".gz" || stem.extension() == ".mps"))
+        stem = stem.stem();
+    std::filesystem::path dir = outputDir.empty() ? path.parent_path() : std::filesystem::path(outputDir);
+    return (dir / stem).string() + ".snap";
+}
+
+int main(int argc, const char *argv[])
+{
+    std::vector<std::string> inputs;
+    std::string outputDir;
+    bool index64 = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc)
+            outputDir = argv[++i];
+        else if (arg == "--index64")
+            index64 = true;
+        else
+            inputs.push_back(arg);
+    }
+
+    if (inputs.empty()) {
+        std::cout << "Usage: mps2snapshot model.mps[.gz] [more models...] [-o output_dir] [--index64]" << std::endl;
+        return 1;
+    }
+
+    int failures = 0;
+    for (const std::string& input : inputs) {
+        OsiClpSolverInterface solver;
+        solver.messageHandler()->setLogLevel(0);
+        if (solver.readMps(input.c_str(), "") != 0) {
+            std::cout << "Read " << input << " failed" << std::endl;
+            failures++;
+            continue;
+        }
+
+        ProblemInstance data = getProblemData(solver);
+        std::string output = snapshotPath(input, outputDir);
+        if (!(index64 ? writeSnapshot(widenProblemInstance(data), output) : writeSnapshot(data, output))) {
+            failures++;
+            continue;
+        }
+        std::cout << input << " -> " << output << " (" << data.numRows << " rows, "
+                  << data.numCols << " cols, " << data.numNonZeros << " nonzeros)" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
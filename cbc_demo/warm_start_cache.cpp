@@ -0,0 +1,365 @@
+#include "warm_start_cache.h"
+#include "fingerprint.h"
+#include "problem_instance.h"
+#include "util.h"
+
+#include "CbcEventHandler.hpp"
+#include "CbcModel.hpp"
+#include "CglStored.hpp"
+#include "CoinFinite.hpp"
+#include "CoinPackedMatrix.hpp"
+#include "CoinWarmStartBasis.hpp"
+#include "OsiSolverInterface.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+static const char kEntryMagic[8] = {'C', 'B', 'C', 'W', 'A', 'R', 'M', '\0'};
+static const std::uint32_t kEntryVersion = 1;
+
+struct WarmStartFileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::int32_t numCols;
+    std::int32_t numRows;
+    std::int32_t hasSolution;
+    std::uint64_t fingerprint;
+    std::uint64_t dataFingerprint;
+    double coldSeconds;
+    double objValue;
+    std::int32_t basisStructurals; // 0 without a basis
+    std::int32_t basisArtificials;
+    std::int64_t numCuts;
+    std::int64_t cutNonZeros;
+};
+
+// Root cuts as rows: cutLb <= sum cutVal[p] * x[cutIdx[p]] <= cutUb, p in [cutStart[k], cutStart[k+1])
+struct WarmStartEntry
+{
+    WarmStartFileHeader header;
+    std::vector<double> solution;
+    std::unique_ptr<CoinWarmStartBasis> basis;
+    std::vector<double> cutLb;
+    std::vector<double> cutUb;
+    std::vector<std::int64_t> cutStart{0};
+    std::vector<int> cutIdx;
+    std::vector<double> cutVal;
+};
+
+struct WarmStartPending
+{
+    std::uint64_t fingerprint = 0;
+    std::uint64_t dataFingerprint = 0;
+    bool hit = false;
+    double coldSeconds = 0.0;
+    std::chrono::steady_clock::time_point start;
+    WarmStartEntry root; // basis and tight cuts after the root cut loop
+    bool rootCaptured = false;
+};
+
+// Packed 2-bit statuses, 4 bytes per 16 variables as CoinWarmStartBasis stores them.
+static std::size_t statusBytes(int count)
+{
+    return 4 * ((static_cast<std::size_t>(count) + 15) >> 4);
+}
+
+template <typename T>
+static bool writeArray(std::FILE* file, const T* data, std::size_t count)
+{
+    return count == 0 || std::fwrite(data, sizeof(T), count, file) == count;
+}
+
+template <typename T>
+static bool readArray(std::FILE* file, std::vector<T>& data, std::size_t count)
+{
+    data.resize(count);
+    return count == 0 || std::fread(data.data(), sizeof(T), count, file) == count;
+}
+
+static bool writeEntry(const std::string& path, const WarmStartEntry& entry)
+{
+    // write aside and rename, so concurrent readers never see half a file
+    std::string tmpPath = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file) {
+        std::cout << "Cannot write " << tmpPath << std::endl;
+        return false;
+    }
+    const WarmStartFileHeader& h = entry.header;
+    bool ok = writeArray(file, &h, 1) && writeArray(file, entry.solution.data(), entry.solution.size());
+    if (entry.basis) {
+        ok = ok && writeArray(file, entry.basis->getStructuralStatus(), statusBytes(h.basisStructurals))
+            && writeArray(file, entry.basis->getArtificialStatus(), statusBytes(h.basisArtificials));
+    }
+    ok = ok && writeArray(file, entry.cutLb.data(), entry.cutLb.size())
+        && writeArray(file, entry.cutUb.data(), entry.cutUb.size())
+        && writeArray(file, entry.cutStart.data(), entry.cutStart.size())
+        && writeArray(file, entry.cutIdx.data(), entry.cutIdx.size())
+        && writeArray(file, entry.cutVal.data(), entry.cutVal.size());
+    ok = std::fclose(file) == 0 && ok;
+
+    std::error_code error;
+    if (ok)
+        std::filesystem::rename(tmpPath, path, error);
+    if (!ok || error) {
+        std::cout << "Write " << path << " failed" << std::endl;
+        std::filesystem::remove(tmpPath, error);
+        return false;
+    }
+    return true;
+}
+
+// Returns false for a missing, foreign or truncated file.
+static bool readEntry(const std::string& path, WarmStartEntry& entry)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    WarmStartFileHeader& h = entry.header;
+    bool ok = std::fread(&h, sizeof(h), 1, file) == 1 && std::memcmp(h.magic, kEntryMagic, sizeof(kEntryMagic)) == 0
+        && h.version == kEntryVersion && h.numCols >= 0 && h.numRows >= 0 && h.numCuts >= 0 && h.cutNonZeros >= 0;
+    ok = ok && readArray(file, entry.solution, h.hasSolution ? h.numCols : 0);
+    if (ok && h.basisStructurals > 0) {
+        std::vector<char> structural, artificial;
+        ok = readArray(file, structural, statusBytes(h.basisStructurals))
+            && readArray(file, artificial, statusBytes(h.basisArtificials));
+        if (ok)
+            entry.basis = std::make_unique<CoinWarmStartBasis>(h.basisStructurals, h.basisArtificials,
+                structural.data(), artificial.data());
+    }
+    ok = ok && readArray(file, entry.cutLb, h.numCuts) && readArray(file, entry.cutUb, h.numCuts)
+        && readArray(file, entry.cutStart, h.numCuts + 1) && readArray(file, entry.cutIdx, h.cutNonZeros)
+        && readArray(file, entry.cutVal, h.cutNonZeros);
+    std::fclose(file);
+    return ok;
+}
+
+// Takes the basis of the model's current LP, cut down to the original rows.
+// A cut whose slack is nonbasic leaves its basic variable behind, so for each
+// such cut one basic structural nearest a bound is made nonbasic at it; no
+// basis if there are not enough of them.
+static std::unique_ptr<CoinWarmStartBasis> originalRowsBasis(const OsiSolverInterface& solver, int numRows, int numCols)
+{
+    std::unique_ptr<CoinWarmStartBasis> basis(dynamic_cast<CoinWarmStartBasis*>(solver.getWarmStart()));
+    if (!basis || basis->getNumStructural() != numCols || basis->getNumArtificial() < numRows)
+        return nullptr;
+    int excess = 0;
+    for (int i = numRows; i < basis->getNumArtificial(); i++)
+        excess += basis->getArtifStatus(i) != CoinWarmStartBasis::basic;
+    basis->resize(numRows, numCols);
+    if (excess == 0)
+        return basis;
+
+    const double* value = solver.getColSolution();
+    const double* lower = solver.getColLower();
+    const double* upper = solver.getColUpper();
+    std::vector<std::pair<double, int>> candidates; // distance to the nearest finite bound, column
+    for (int j = 0; j < numCols; j++) {
+        if (basis->getStructStatus(j) != CoinWarmStartBasis::basic)
+            continue;
+        double distance = std::min(lower[j] > -COIN_DBL_MAX ? value[j] - lower[j] : COIN_DBL_MAX,
+            upper[j] < COIN_DBL_MAX ? upper[j] - value[j] : COIN_DBL_MAX);
+        if (distance < COIN_DBL_MAX)
+            candidates.emplace_back(std::fabs(distance), j);
+    }
+    if (static_cast<int>(candidates.size()) < excess)
+        return nullptr;
+    std::partial_sort(candidates.begin(), candidates.begin() + excess, candidates.end());
+    for (int k = 0; k < excess; k++) {
+        int j = candidates[k].second;
+        bool atLower = lower[j] > -COIN_DBL_MAX && (upper[j] >= COIN_DBL_MAX || value[j] - lower[j] <= upper[j] - value[j]);
+        basis->setStructStatus(j, atLower ? CoinWarmStartBasis::atLowerBound : CoinWarmStartBasis::atUpperBound);
+    }
+    return basis;
+}
+
+// Collects the root basis and the cuts that are tight at the root optimum.
+class RootCapture : public CbcEventHandler
+{
+public:
+    RootCapture(CbcModel* model, std::shared_ptr<WarmStartPending> pending, int numRows, int numCols)
+        : CbcEventHandler(model), pending_(std::move(pending)), numRows_(numRows), numCols_(numCols)
+    {
+    }
+
+    CbcAction event(CbcEvent whichEvent) override
+    {
+        if (whichEvent == afterRootCuts && model_ && !pending_->rootCaptured)
+            capture(*model_->solver());
+        return noAction;
+    }
+
+    CbcEventHandler* clone() const override { return new RootCapture(*this); }
+
+    const std::shared_ptr<WarmStartPending>& pending() const { return pending_; }
+
+private:
+    void capture(const OsiSolverInterface& solver)
+    {
+        WarmStartEntry& root = pending_->root;
+        pending_->rootCaptured = true;
+        root.basis = originalRowsBasis(solver, numRows_, numCols_);
+
+        int rows = solver.getNumRows();
+        if (rows <= numRows_ || solver.getNumCols() != numCols_)
+            return;
+        const CoinPackedMatrix* matrix = solver.getMatrixByRow();
+        const double* activity = solver.getRowActivity();
+        const double* lower = solver.getRowLower();
+        const double* upper = solver.getRowUpper();
+        for (int i = numRows_; i < rows; i++) {
+            double tolerance = 1e-6 * (1.0 + std::fabs(activity[i]));
+            bool tight = std::fabs(activity[i] - lower[i]) <= tolerance || std::fabs(activity[i] - upper[i]) <= tolerance;
+            if (!tight)
+                continue;
+            CoinShallowPackedVector row = matrix->getVector(i);
+            root.cutLb.push_back(lower[i]);
+            root.cutUb.push_back(upper[i]);
+            root.cutIdx.insert(root.cutIdx.end(), row.getIndices(), row.getIndices() + row.getNumElements());
+            root.cutVal.insert(root.cutVal.end(), row.getElements(), row.getElements() + row.getNumElements());
+            root.cutStart.push_back(static_cast<std::int64_t>(root.cutIdx.size()));
+        }
+    }
+
+    std::shared_ptr<WarmStartPending> pending_; // shared by the clones, freed with the model
+    int numRows_;
+    int numCols_;
+};
+
+WarmStartCache::WarmStartCache(std::string directory)
+    : directory_(std::move(directory))
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    if (error)
+        std::cout << "Cannot create " << directory_ << ": " << error.message() << std::endl;
+}
+
+WarmStartCache::~WarmStartCache() = default;
+
+std::string WarmStartCache::entryPath(std::uint64_t fingerprint) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.wsc", static_cast<unsigned long long>(fingerprint));
+    return (std::filesystem::path(directory_) / name).string();
+}
+
+bool WarmStartCache::apply(const ProblemInstance& data, CbcModel& model)
+{
+    auto pending = std::make_shared<WarmStartPending>();
+    pending->start = std::chrono::steady_clock::now();
+    pending->fingerprint = structuralFingerprint(data);
+    pending->dataFingerprint = dataFingerprint(data);
+
+    WarmStartEntry entry;
+    const WarmStartFileHeader& h = entry.header;
+    pending->hit = readEntry(entryPath(pending->fingerprint), entry) && h.fingerprint == pending->fingerprint
+        && h.numCols == data.numCols && h.numRows == data.numRows;
+    bool exact = pending->hit && h.dataFingerprint == pending->dataFingerprint;
+
+    if (pending->hit) {
+        pending->coldSeconds = h.coldSeconds;
+        if (entry.basis)
+            model.solver()->setWarmStart(entry.basis.get());
+        // setMIPStart is only read by the CbcMain driver; check=true drops an infeasible start
+        if (h.hasSolution)
+            model.setBestSolution(entry.solution.data(), data.numCols, COIN_DBL_MAX, true);
+        if (exact && h.numCuts > 0) {
+            CglStored stored(data.numCols);
+            for (std::int64_t k = 0; k < h.numCuts; k++) {
+                std::int64_t begin = entry.cutStart[k];
+                stored.addCut(entry.cutLb[k], entry.cutUb[k], static_cast<int>(entry.cutStart[k + 1] - begin),
+                    entry.cutIdx.data() + begin, entry.cutVal.data() + begin);
+            }
+            model.addCutGenerator(&stored, -99, "WarmStartCuts"); // root only
+        }
+    }
+
+    RootCapture capture(&model, pending, data.numRows, data.numCols);
+    model.passInEventHandler(&capture);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending->hit) {
+        stats_.hits++;
+        stats_.exactHits += exact ? 1 : 0;
+    } else {
+        stats_.misses++;
+    }
+    return pending->hit;
+}
+
+bool WarmStartCache::store(const ProblemInstance& data, CbcModel& model)
+{
+    // what apply() left in the model's handler; a solve that never gets here frees it with the model
+    std::shared_ptr<WarmStartPending> pending;
+    if (const auto* capture = dynamic_cast<const RootCapture*>(model.getEventHandler()))
+        pending = capture->pending();
+    double seconds = 0.0;
+    if (pending) {
+        seconds = secondsSince(pending->start);
+    } else {
+        // store() without apply(), or its handler was replaced: nothing to time, no root data
+        pending = std::make_shared<WarmStartPending>();
+        pending->fingerprint = structuralFingerprint(data);
+        pending->dataFingerprint = dataFingerprint(data);
+    }
+    std::string path = entryPath(pending->fingerprint);
+
+    WarmStartEntry entry;
+    WarmStartFileHeader& h = entry.header;
+    std::memcpy(h.magic, kEntryMagic, sizeof(kEntryMagic));
+    h.version = kEntryVersion;
+    h.numCols = data.numCols;
+    h.numRows = data.numRows;
+    h.fingerprint = pending->fingerprint;
+    h.dataFingerprint = pending->dataFingerprint;
+    h.coldSeconds = pending->hit ? pending->coldSeconds : seconds;
+
+    const double* best = model.bestSolution();
+    h.hasSolution = best != nullptr;
+    h.objValue = best ? model.getObjValue() : 0.0;
+    if (best) {
+        entry.solution.assign(best, best + data.numCols);
+    } else if (pending->hit) {
+        // keep the previous incumbent, it may still be a useful start
+        WarmStartEntry previous;
+        if (readEntry(path, previous) && previous.header.hasSolution) {
+            entry.solution = std::move(previous.solution);
+            h.hasSolution = 1;
+            h.objValue = previous.header.objValue;
+        }
+    }
+
+    WarmStartEntry& root = pending->root;
+    entry.basis = root.basis ? std::move(root.basis) : originalRowsBasis(*model.solver(), data.numRows, data.numCols);
+    h.basisStructurals = entry.basis ? entry.basis->getNumStructural() : 0;
+    h.basisArtificials = entry.basis ? entry.basis->getNumArtificial() : 0;
+    entry.cutLb = std::move(root.cutLb);
+    entry.cutUb = std::move(root.cutUb);
+    entry.cutStart = std::move(root.cutStart);
+    entry.cutIdx = std::move(root.cutIdx);
+    entry.cutVal = std::move(root.cutVal);
+    h.numCuts = static_cast<std::int64_t>(entry.cutLb.size());
+    h.cutNonZeros = static_cast<std::int64_t>(entry.cutIdx.size());
+
+    bool ok = writeEntry(path, entry);
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.stores += ok ? 1 : 0;
+    if (pending->hit)
+        stats_.secondsSaved += pending->coldSeconds - seconds;
+    return ok;
+}
+
+WarmStartStats WarmStartCache::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
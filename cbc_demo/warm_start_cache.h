@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+class CbcModel;
+struct ProblemInstance;
+
+struct WarmStartStats
+{
+    int hits = 0;        // structural fingerprint found on disk
+    int exactHits = 0;   // rhs and bounds matched too, stored cuts were applied
+    int misses = 0;
+    int stores = 0;
+    double secondsSaved = 0.0; // sum over hits of (cold solve time - this solve time)
+};
+
+/*
+  On-disk cache of warm start data, one file per structural fingerprint
+  (fingerprint.h) in the cache directory. Each entry keeps the root LP basis,
+  the best solution, the tight cuts of the root node and the time of the cold
+  solve that created it.
+
+    WarmStartCache cache("./warm_start");
+    CbcModel model(solver);
+    cache.apply(data, model);  // basis + MIP start, cuts if rhs/bounds match exactly
+    model.branchAndBound();
+    cache.store(data, model);  // root basis/cuts, best solution, stats
+
+  The basis and the MIP start are only hints, so they are applied whenever the
+  structure matches; a start that the new rhs or bounds make infeasible is
+  dropped. Cuts depend on rhs and bounds, so they are only reused for the
+  exact same model. apply() installs an event handler to collect the root
+  basis and cuts, which also carries the state from apply() to store() and
+  goes with the model; a handler passed in after apply() replaces it, and
+  store() then falls back to the final basis without cuts or timing.
+*/
+class WarmStartCache
+{
+public:
+    explicit WarmStartCache(std::string directory); // created if missing
+    ~WarmStartCache();
+
+    // Returns true on a hit. Call after the model is set up, before branchAndBound.
+    bool apply(const ProblemInstance& data, CbcModel& model);
+
+    // Writes the entry after branchAndBound. The cold solve time of an
+    // existing entry is kept, so later hits are measured against it.
+    bool store(const ProblemInstance& data, CbcModel& model);
+
+    WarmStartStats stats() const;
+    const std::string& directory() const { return directory_; }
+
+private:
+    std::string entryPath(std::uint64_t fingerprint) const;
+
+    std::string directory_;
+    mutable std::mutex mutex_;
+    WarmStartStats stats_;
+};
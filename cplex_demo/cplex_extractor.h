@@ -0,0 +1,151 @@
+#pragma once
+
+#include "model_extractor.h"
+#include "name_table.h"
+#include "problem_instance.h"
+
+#include "CoinFinite.hpp"
+
+#include <ilcplex/cplexx.h>
+
+#include <cstdint>
+#include <vector>
+
+/*
+  ModelExtractor over the CPLEX callable library (model_extractor.h in
+  cbc_demo). Every read is one CPXX call over the whole index range, the
+  matrix a single CPXXgetrows; nothing goes coefficient by coefficient.
+
+    CplexExtractor source(env, lp);
+    ProblemInstance data;
+    if (!extractProblemData(source, data))
+        return 1;
+
+  Ranged rows come back in Osi form (rhs the upper bound, range upper -
+  lower), +-CPX_INFBOUND as +-COIN_DBL_MAX. Column types are read only from
+  a MIP; semi-continuous columns are 'C', semi-integer ones 'I'. Quadratic
+  terms are not extracted.
+*/
+class CplexExtractor : public ModelExtractor
+{
+public:
+    CplexExtractor(CPXCENVptr env, CPXCLPptr lp) : env_(env), lp_(lp) {}
+
+    const char* backendName() const override { return "cplex"; }
+    int numCols() override { return CPXXgetnumcols(env_, lp_); }
+    int numRows() override { return CPXXgetnumrows(env_, lp_); }
+    std::int64_t numNonZeros() override { return CPXXgetnumnz(env_, lp_); }
+
+    bool getObjectiveSense(int& sense, double& offset) override
+    {
+        sense = CPXXgetobjsen(env_, lp_) == CPX_MAX ? -1 : 1;
+        return CPXXgetobjoffset(env_, lp_, &offset) == 0;
+    }
+
+    bool getColumns(char* types, double* lower, double* upper, double* objective) override
+    {
+        const CPXDIM n = CPXXgetnumcols(env_, lp_);
+        if (n == 0)
+            return true;
+        if (CPXXgetlb(env_, lp_, lower, 0, n - 1) || CPXXgetub(env_, lp_, upper, 0, n - 1)
+            || CPXXgetobj(env_, lp_, objective, 0, n - 1))
+            return false;
+        for (CPXDIM j = 0; j < n; j++) {
+            lower[j] = toCoin(lower[j]);
+            upper[j] = toCoin(upper[j]);
+        }
+
+        const int type = CPXXgetprobtype(env_, lp_);
+        if (type != CPXPROB_MILP && type != CPXPROB_MIQP && type != CPXPROB_MIQCP) {
+            for (CPXDIM j = 0; j < n; j++)
+                types[j] = 'C';
+            return true;
+        }
+        if (CPXXgetctype(env_, lp_, types, 0, n - 1))
+            return false;
+        for (CPXDIM j = 0; j < n; j++)
+            types[j] = (types[j] == CPX_CONTINUOUS || types[j] == CPX_SEMICONT) ? 'C' : 'I';
+        return true;
+    }
+
+    bool getRowBounds(char* sense, double* rhs, double* range) override
+    {
+        const CPXDIM m = CPXXgetnumrows(env_, lp_);
+        if (m == 0)
+            return true;
+        if (CPXXgetsense(env_, lp_, sense, 0, m - 1) || CPXXgetrhs(env_, lp_, rhs, 0, m - 1)
+            || CPXXgetrngval(env_, lp_, range, 0, m - 1))
+            return false;
+        for (CPXDIM i = 0; i < m; i++) {
+            if (sense[i] != 'R') {
+                rhs[i] = toCoin(rhs[i]);
+                range[i] = 0.0;
+                continue;
+            }
+            // CPLEX ranges are [rhs, rhs + rng] for rng >= 0, [rhs + rng, rhs] otherwise
+            double lower = range[i] >= 0 ? rhs[i] : rhs[i] + range[i];
+            double upper = range[i] >= 0 ? rhs[i] + range[i] : rhs[i];
+            rowBoundsToSense(toCoin(lower), toCoin(upper), sense[i], rhs[i], range[i]);
+        }
+        return true;
+    }
+
+    bool getRows(int first, int last, std::int64_t* rowStart, int* colIdxs, double* values,
+        std::int64_t capacity) override
+    {
+        rowStart[0] = 0;
+        if (first >= last)
+            return true;
+        std::vector<CPXNNZ> begins(last - first);
+        CPXNNZ count = 0, surplus = 0;
+        if (CPXXgetrows(env_, lp_, &count, begins.data(), colIdxs, values, capacity, &surplus, first, last - 1))
+            return false;
+        for (int i = 1; i < last - first; i++)
+            rowStart[i] = begins[i];
+        rowStart[last - first] = count;
+        return true;
+    }
+
+    bool getColNames(NameTable& names) override
+    {
+        return getNames(names, CPXXgetnumcols(env_, lp_), CPXXgetcolname);
+    }
+
+    bool getRowNames(NameTable& names) override
+    {
+        return getNames(names, CPXXgetnumrows(env_, lp_), CPXXgetrowname);
+    }
+
+private:
+    static double toCoin(double value)
+    {
+        if (value >= CPX_INFBOUND)
+            return COIN_DBL_MAX;
+        if (value <= -CPX_INFBOUND)
+            return -COIN_DBL_MAX;
+        return value;
+    }
+
+    // CPXXgetcolname and CPXXgetrowname share a signature: ask for the size
+    // with no room, then read every name into one buffer.
+    template <typename GetNames>
+    bool getNames(NameTable& names, CPXDIM count, GetNames getName)
+    {
+        if (count == 0)
+            return false;
+        CPXSIZE surplus = 0;
+        int status = getName(env_, lp_, nullptr, nullptr, 0, &surplus, 0, count - 1);
+        if (status != CPXERR_NEGATIVE_SURPLUS)
+            return false; // CPXERR_NO_NAMES, or an error
+        std::vector<char*> name(count);
+        std::vector<char> store(-surplus);
+        if (getName(env_, lp_, name.data(), store.data(), static_cast<CPXSIZE>(store.size()), &surplus, 0, count - 1))
+            return false;
+        for (CPXDIM k = 0; k < count; k++)
+            names.push_back(name[k]);
+        return true;
+    }
+
+    CPXCENVptr env_;
+    CPXCLPptr lp_;
+};
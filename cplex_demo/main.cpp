@@ -5,6 +5,9 @@
 #include <numeric> 
 #include <iostream>
 
+#include "cplex_extractor.h"
+#include "problem_instance.h"
+
 int main(int argc, const char ** argv)
 {
     int status = 0;
@@ -81,7 +84,6 @@ int main(int argc, const char ** argv)
     
     numCols = CPXgetnumcols(env, lp);
     int numRows = CPXgetnumrows(env, lp);
-    int numNonZeros = CPXgetnumnz(env, lp);
 
     std::vector<int> delstat(numRows, 0);
     status = CPXdelsetrows(env, lp, delstat.data());
@@ -104,48 +106,13 @@ int main(int argc, const char ** argv)
 		status = CPXgetobjval(env, lp, &objValue);
 	}
 
-    // get problem data
-    std::vector<char> varTypes(numCols);
-    status = CPXgetctype(env, lp, varTypes.data(), 0, numCols - 1);
-     
-    lb = std::vector<double>(numCols, 0.0);
-    status = CPXgetlb(env, lp, lb.data(), 0, numCols - 1);
-
-    ub = std::vector<double>(numCols, 0.0);
-    status = CPXgetub(env, lp, ub.data(), 0, numCols - 1);
-
-    int objSense = CPXgetobjsen(env, lp); // -1 means max, 1 means min;
+    // get problem data: every array in one CPXX call, the rows in one CPXXgetrows
+    // data.objSense: -1 means max, 1 means min
     // status = CPXchgobjsen(env, lp, 1);  change objective sense
-
-    std::vector<double> objCoeffs = std::vector<double>(numCols);
-    status = CPXXgetobj(env, lp, objCoeffs.data(), 0, numCols - 1);
-
-    std::vector<char> rowtypes = std::vector<char>(numRows);
-    status = CPXgetsense(env, lp, rowtypes.data(), 0, numRows - 1);
-
-    std::vector<double> rhs_get = std::vector<double>(numRows);
-    status = CPXgetrhs(env, lp, rhs_get.data(), 0, numRows - 1);
-
-    std::vector<double> rhsrange = std::vector<double>(numRows);
-    status = CPXgetrngval(env, lp, rhsrange.data(), 0, numRows - 1);
-
-    double objOffset = 0;
-    status = CPXgetobjoffset(env, lp, &objOffset);
-
-    std::vector<int> rowStart = std::vector<int>(numRows);
-    std::vector<int> colIdxs = std::vector<int>(numNonZeros);
-    std::vector<double> colCoeffs = std::vector<double>(numNonZeros);
-    
-    int count = 0, surplus_p;
-    status = CPXgetrows(env, lp, &count, rowStart.data(), colIdxs.data(), colCoeffs.data(),
-    numNonZeros, &surplus_p, 0, numRows - 1);
-    
-    std::vector<int> cmatbeg = std::vector<int>(numCols);
-	std::vector<int> cmatind = std::vector<int>(numNonZeros);
-	std::vector<double> cmatval = std::vector<double>(numNonZeros);
-    status = CPXgetcols(env, lp, &count, cmatbeg.data(), cmatind.data(), cmatval.data(), 
-    numNonZeros, &surplus_p, 0, numCols - 1);
-
+    ProblemInstance data;
+    CplexExtractor extractor(env, lp);
+    if (!extractProblemData(extractor, data))
+        std::cout << "Cannot extract the model" << std::endl;
 
     status = CPXchgprobtype(env, lp, CPXPROB_LP); // problem type: CPXPROB_MILP, CPXPROB_LP
     status = CPXlpopt(env, lp);
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "model_extractor.h"
+#include "name_table.h"
+
+#include "CoinFinite.hpp"
+
+#include <gurobi_c++.h>
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+/*
+  ModelExtractor over the Gurobi C++ API (model_extractor.h in cbc_demo).
+  Attributes are read for all variables or constraints in one call each; the
+  C++ API has no bulk matrix read, so the rows come one getRow per
+  constraint, column indices from GRBVar::index(). That is rows + a few
+  calls and time linear in the nonzeros, where getCoeff over every
+  row/column pair is rows x cols calls.
+
+    model.update();                      // pending changes are invisible until then
+    GurobiExtractor source(model);
+    ProblemInstance data;
+    if (!extractProblemData(source, data))
+        return 1;
+
+  Binary, integer and semi-integer variables are 'I', the rest 'C';
+  +-GRB_INFINITY becomes +-COIN_DBL_MAX. addRange constraints are read as
+  Gurobi stores them, an equality over the range's slack variable. A
+  GRBException fails the read and its message is printed.
+*/
+class GurobiExtractor : public ModelExtractor
+{
+public:
+    explicit GurobiExtractor(GRBModel& model) : model_(model) {}
+
+    const char* backendName() const override { return "gurobi"; }
+
+    int numCols() override
+    {
+        try {
+            return model_.get(GRB_IntAttr_NumVars);
+        } catch (const GRBException& e) {
+            return fail(e, -1);
+        }
+    }
+
+    int numRows() override
+    {
+        try {
+            return model_.get(GRB_IntAttr_NumConstrs);
+        } catch (const GRBException& e) {
+            return fail(e, -1);
+        }
+    }
+
+    std::int64_t numNonZeros() override
+    {
+        try {
+            return static_cast<std::int64_t>(model_.get(GRB_DoubleAttr_DNumNZs));
+        } catch (const GRBException& e) {
+            return fail(e, -1);
+        }
+    }
+
+    bool getObjectiveSense(int& sense, double& offset) override
+    {
+        try {
+            sense = model_.get(GRB_IntAttr_ModelSense) == GRB_MAXIMIZE ? -1 : 1;
+            offset = model_.get(GRB_DoubleAttr_ObjCon);
+            return true;
+        } catch (const GRBException& e) {
+            return fail(e, false);
+        }
+    }
+
+    bool getColumns(char* types, double* lower, double* upper, double* objective) override
+    {
+        try {
+            const int n = model_.get(GRB_IntAttr_NumVars);
+            std::unique_ptr<GRBVar[]> vars(model_.getVars());
+            std::unique_ptr<char[]> vtype(model_.get(GRB_CharAttr_VType, vars.get(), n));
+            std::unique_ptr<double[]> lb(model_.get(GRB_DoubleAttr_LB, vars.get(), n));
+            std::unique_ptr<double[]> ub(model_.get(GRB_DoubleAttr_UB, vars.get(), n));
+            std::unique_ptr<double[]> obj(model_.get(GRB_DoubleAttr_Obj, vars.get(), n));
+            for (int j = 0; j < n; j++) {
+                types[j] = (vtype[j] == GRB_CONTINUOUS || vtype[j] == GRB_SEMICONT) ? 'C' : 'I';
+                lower[j] = toCoin(lb[j]);
+                upper[j] = toCoin(ub[j]);
+                objective[j] = obj[j];
+            }
+            return true;
+        } catch (const GRBException& e) {
+            return fail(e, false);
+        }
+    }
+
+    bool getRowBounds(char* sense, double* rhs, double* range) override
+    {
+        try {
+            const int m = model_.get(GRB_IntAttr_NumConstrs);
+            std::unique_ptr<GRBConstr[]> constrs(model_.getConstrs());
+            std::unique_ptr<char[]> grbSense(model_.get(GRB_CharAttr_Sense, constrs.get(), m));
+            std::unique_ptr<double[]> grbRhs(model_.get(GRB_DoubleAttr_RHS, constrs.get(), m));
+            for (int i = 0; i < m; i++) {
+                sense[i] = grbSense[i] == GRB_LESS_EQUAL ? 'L' : (grbSense[i] == GRB_GREATER_EQUAL ? 'G' : 'E');
+                rhs[i] = toCoin(grbRhs[i]);
+                range[i] = 0.0;
+            }
+            return true;
+        } catch (const GRBException& e) {
+            return fail(e, false);
+        }
+    }
+
+    bool getRows(int first, int last, std::int64_t* rowStart, int* colIdxs, double* values,
+        std::int64_t capacity) override
+    {
+        try {
+            std::unique_ptr<GRBConstr[]> constrs(model_.getConstrs());
+            std::int64_t count = 0;
+            rowStart[0] = 0;
+            for (int i = first; i < last; i++) {
+                GRBLinExpr row = model_.getRow(constrs[i]);
+                const unsigned int size = row.size();
+                if (count + size > capacity)
+                    return false;
+                for (unsigned int k = 0; k < size; k++) {
+                    colIdxs[count] = row.getVar(k).index();
+                    values[count++] = row.getCoeff(k);
+                }
+                rowStart[i - first + 1] = count;
+            }
+            return true;
+        } catch (const GRBException& e) {
+            return fail(e, false);
+        }
+    }
+
+    bool getColNames(NameTable& names) override
+    {
+        try {
+            const int n = model_.get(GRB_IntAttr_NumVars);
+            std::unique_ptr<GRBVar[]> vars(model_.getVars());
+            std::unique_ptr<std::string[]> varName(model_.get(GRB_StringAttr_VarName, vars.get(), n));
+            for (int j = 0; j < n; j++)
+                names.push_back(varName[j]);
+            return n > 0;
+        } catch (const GRBException& e) {
+            return fail(e, false);
+        }
+    }
+
+    bool getRowNames(NameTable& names) override
+    {
+        try {
+            const int m = model_.get(GRB_IntAttr_NumConstrs);
+            std::unique_ptr<GRBConstr[]> constrs(model_.getConstrs());
+            std::unique_ptr<std::string[]> constrName(model_.get(GRB_StringAttr_ConstrName, constrs.get(), m));
+            for (int i = 0; i < m; i++)
+                names.push_back(constrName[i]);
+            return m > 0;
+        } catch (const GRBException& e) {
+            return fail(e, false);
+        }
+    }
+
+private:
+    static double toCoin(double value)
+    {
+        if (value >= GRB_INFINITY)
+            return COIN_DBL_MAX;
+        if (value <= -GRB_INFINITY)
+            return -COIN_DBL_MAX;
+        return value;
+    }
+
+    template <typename T>
+    static T fail(const GRBException& e, T result)
+    {
+        std::cout << "gurobi: " << e.getMessage() << " (" << e.getErrorCode() << ")" << std::endl;
+        return result;
+    }
+
+    GRBModel& model_;
+};
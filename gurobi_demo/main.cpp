@@ -2,27 +2,31 @@
 #include <string>
 #include <gurobi_c++.h>
 
+#include "gurobi_extractor.h"
+#include "problem_instance.h"
+
+// One getRow per constraint, column indices from GRBVar::index(): linear in
+// the nonzeros. getCoeff over every row/column pair is rows x cols calls.
 void getCSRFormat(GRBModel& model, std::vector<int>& rowStart, std::vector<int>& colIdx, std::vector<double>& colCoeff) {
-    rowStart.clear();
+    int numRows = model.get(GRB_IntAttr_NumConstrs);
+    int numNonZeros = model.get(GRB_IntAttr_NumNZs);
+    rowStart.assign(1, 0); // 初始化第一个元素
     colIdx.clear();
     colCoeff.clear();
+    rowStart.reserve(numRows + 1);
+    colIdx.reserve(numNonZeros);
+    colCoeff.reserve(numNonZeros);
+
     GRBConstr* constrs = model.getConstrs();
-    int numCols = model.get(GRB_IntAttr_NumVars);
-    int numRows = model.get(GRB_IntAttr_NumConstrs);
-    int nzCount = 0;
-    rowStart.push_back(0); // 初始化第一个元素
-    
     for (int i = 0; i < numRows; ++i) {
-        for (int j = 0; j < numCols; ++j) {
-            double coeff = model.getCoeff(model.getConstr(i), model.getVar(j));
-            if (coeff != 0) {
-                colIdx.push_back(j);
-                colCoeff.push_back(coeff);
-                nzCount++;
-            }
+        GRBLinExpr row = model.getRow(constrs[i]);
+        for (unsigned int k = 0; k < row.size(); ++k) {
+            colIdx.push_back(row.getVar(k).index());
+            colCoeff.push_back(row.getCoeff(k));
         }
-        rowStart.push_back(nzCount);
+        rowStart.push_back(static_cast<int>(colIdx.size()));
     }
+    delete[] constrs;
 }
 
 int main(int argc, const char ** argv)
@@ -150,19 +154,11 @@ int main(int argc, const char ** argv)
 
     getCSRFormat(model, rowStart, colIdx, colCoeff);
 
-    // rowStart.push_back(0);
-    // int numOfIdx = 0;
-    // for (int i = 0; i < numRows; ++i) {
-    //     for (int j = 0; j < numCols; ++j) {
-    //         double coeff = model.getCoeff(model.getConstr(i), model.getVar(j));
-    //         if (coeff != 0) {
-    //             colIdx.push_back(j);
-    //             colCoeff.push_back(coeff);
-    //             numOfIdx++;
-    //         }
-    //     }
-    //     rowStart.push_back(numOfIdx);
-    // }
+    // or the whole model in cbc_demo's ProblemInstance, in bulk attribute reads
+    ProblemInstance data;
+    GurobiExtractor extractor(model);
+    if (!extractProblemData(extractor, data))
+        std::cout << "Cannot extract the model" << std::endl;
     
     
     // read model file